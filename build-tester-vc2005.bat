@@ -18,15 +18,32 @@ del /Q obj\*
 @echo --- compile ---
 
 %COMPILER% %COMPILE_OPTIONS% general/Array.cpp /Foobj/Array.obj
+%COMPILER% %COMPILE_OPTIONS% general/ArrayFlat.cpp /Foobj/ArrayFlat.obj
 %COMPILER% %COMPILE_OPTIONS% general/Bounded.cpp /Foobj/Bounded.obj
 %COMPILER% %COMPILE_OPTIONS% general/Clamps.cpp /Foobj/Clamps.obj
 %COMPILER% %COMPILE_OPTIONS% general/Float01.cpp /Foobj/Float01.obj
 %COMPILER% %COMPILE_OPTIONS% general/FpToInt.cpp /Foobj/FpToInt.obj
+%COMPILER% %COMPILE_OPTIONS% general/Half.cpp /Foobj/Half.obj
 %COMPILER% %COMPILE_OPTIONS% general/LogFast.cpp /Foobj/LogFast.obj
+%COMPILER% %COMPILE_OPTIONS% general/MathFast.cpp /Foobj/MathFast.obj
+%COMPILER% %COMPILE_OPTIONS% general/NumaLocal.cpp /Foobj/NumaLocal.obj
 %COMPILER% %COMPILE_OPTIONS% general/PowFast.cpp /Foobj/PowFast.obj
 %COMPILER% %COMPILE_OPTIONS% general/RandomMwc1.cpp /Foobj/RandomMwc1.obj
 %COMPILER% %COMPILE_OPTIONS% general/RandomMwc2.cpp /Foobj/RandomMwc2.obj
+%COMPILER% %COMPILE_OPTIONS% general/RandomPhilox.cpp /Foobj/RandomPhilox.obj
+%COMPILER% %COMPILE_OPTIONS% general/RandomXoshiro.cpp /Foobj/RandomXoshiro.obj
 %COMPILER% %COMPILE_OPTIONS% general/Sheet.cpp /Foobj/Sheet.obj
+%COMPILER% %COMPILE_OPTIONS% general/SheetBulk.cpp /Foobj/SheetBulk.obj
+%COMPILER% %COMPILE_OPTIONS% general/SheetFile.cpp /Foobj/SheetFile.obj
+%COMPILER% %COMPILE_OPTIONS% general/SheetFlat.cpp /Foobj/SheetFlat.obj
+%COMPILER% %COMPILE_OPTIONS% general/SheetTiled.cpp /Foobj/SheetTiled.obj
+%COMPILER% %COMPILE_OPTIONS% general/SheetView.cpp /Foobj/SheetView.obj
+%COMPILER% %COMPILE_OPTIONS% general/Stopwatch.cpp /Foobj/Stopwatch.obj
+%COMPILER% %COMPILE_OPTIONS% general/Storage.cpp /Foobj/Storage.obj
+%COMPILER% %COMPILE_OPTIONS% general/ThreadPool.cpp /Foobj/ThreadPool.obj
+%COMPILER% %COMPILE_OPTIONS% general/TileExecutor.cpp /Foobj/TileExecutor.obj
+%COMPILER% %COMPILE_OPTIONS% general/Wrap.cpp /Foobj/Wrap.obj
+%COMPILER% %COMPILE_OPTIONS% general/hxa7241vector.cpp /Foobj/hxa7241vector.obj
 
 %COMPILER% %COMPILE_OPTIONS% graphics/ColorConstants.cpp /Foobj/ColorConstants.obj
 %COMPILER% %COMPILE_OPTIONS% graphics/ColorSpace.cpp /Foobj/ColorSpace.obj
@@ -37,6 +54,7 @@ del /Q obj\*
 %COMPILER% %COMPILE_OPTIONS% graphics/Matrix4f.cpp /Foobj/Matrix4f.obj
 %COMPILER% %COMPILE_OPTIONS% graphics/Polar.cpp /Foobj/Polar.obj
 %COMPILER% %COMPILE_OPTIONS% graphics/Quaternion.cpp /Foobj/Quaternion.obj
+%COMPILER% %COMPILE_OPTIONS% graphics/Samplers.cpp /Foobj/Samplers.obj
 %COMPILER% %COMPILE_OPTIONS% graphics/SobolSequence.cpp /Foobj/SobolSequence.obj
 %COMPILER% %COMPILE_OPTIONS% graphics/Spherahedron.cpp /Foobj/Spherahedron.obj
 %COMPILER% %COMPILE_OPTIONS% graphics/UnitVector3f.cpp /Foobj/UnitVector3f.obj
@@ -23,22 +23,37 @@
 
 #include <iostream>
 
+#include "Stopwatch.hpp"
 
-namespace hxa7241_general
+
+namespace
 {
+using namespace hxa7241_general;
 
 
-bool test_Array
+/**
+ * Storage for adopting, from the policy the container will free it with.
+ */
+template<class STORAGE>
+word* newWords
+(
+   const dword length
+)
+{
+   return STORAGE().template allocate<word>( length );
+}
+
+
+template<template<class, class> class ARRAY, class STORAGE>
+bool testArray
 (
    std::ostream* pOut,
    const bool    isVerbose,
-   const dword   //seed
+   const char*   name
 )
 {
    bool isOk = true;
 
-   if( pOut ) *pOut << "[ test_Array ]\n\n";
-
 
    // this is a *long* method, but do not panic! -- it is very simple:
    // (almost) every 'test-expression' is isolated and atomic.
@@ -52,7 +67,7 @@ bool test_Array
       {
          // default
          {
-            const Array<word> aw;
+            const ARRAY<word, STORAGE> aw;
 
             bool ok = (0 == aw.getStorage()) & (0 == aw.getLength()) &
                aw.isOwning();
@@ -65,7 +80,7 @@ bool test_Array
          // length
          {
             const dword awl = 7;
-            const Array<word> aw( awl );
+            const ARRAY<word, STORAGE> aw( awl );
 
             bool ok = (0 != aw.getStorage()) & (awl == aw.getLength()) &
                aw.isOwning();
@@ -75,7 +90,7 @@ bool test_Array
                "\n";
          }
          {
-            const Array<word> aw( -7 );
+            const ARRAY<word, STORAGE> aw( -7 );
 
             bool ok = (0 == aw.getStorage()) & (0 == aw.getLength()) &
                aw.isOwning();
@@ -89,7 +104,7 @@ bool test_Array
          word awa[] = { 11, 12, 13 };
          const dword awal  = sizeof(awa) / sizeof(awa[0]);
          {
-            const Array<word> aw( awa, awal, false );
+            const ARRAY<word, STORAGE> aw( awa, awal, false );
 
             bool ok = (awa == aw.getStorage()) & (awal == aw.getLength()) &
                !aw.isOwning();
@@ -99,8 +114,8 @@ bool test_Array
                "\n";
          }
          {
-            word* pawa = new word[ awal ];
-            const Array<word> aw( pawa, awal, true );
+            word* pawa = newWords<STORAGE>( awal );
+            const ARRAY<word, STORAGE> aw( pawa, awal, true );
 
             bool ok = (pawa == aw.getStorage()) & (awal == aw.getLength()) &
                aw.isOwning();
@@ -110,7 +125,7 @@ bool test_Array
                "\n";
          }
          {
-            const Array<word> aw( 0, 3, false );
+            const ARRAY<word, STORAGE> aw( 0, 3, false );
 
             bool ok = (0 == aw.getStorage()) & (3 == aw.getLength()) &
                !aw.isOwning();
@@ -120,7 +135,7 @@ bool test_Array
                "\n";
          }
          {
-            const Array<word> aw( 0, 3, true );
+            const ARRAY<word, STORAGE> aw( 0, 3, true );
 
             bool ok = (0 == aw.getStorage()) & (3 == aw.getLength()) &
                aw.isOwning();
@@ -130,7 +145,7 @@ bool test_Array
                "\n";
          }
          {
-            const Array<word> aw( awa, -3, false );
+            const ARRAY<word, STORAGE> aw( awa, -3, false );
 
             bool ok = (awa == aw.getStorage()) & (0 == aw.getLength()) &
                !aw.isOwning();
@@ -140,8 +155,8 @@ bool test_Array
                "\n";
          }
          {
-            word* pawa = new word[ awal ];
-            const Array<word> aw( pawa, -3, true );
+            word* pawa = newWords<STORAGE>( awal );
+            const ARRAY<word, STORAGE> aw( pawa, -3, true );
 
             bool ok = (pawa == aw.getStorage()) & (0 == aw.getLength()) &
                aw.isOwning();
@@ -153,8 +168,8 @@ bool test_Array
 
          // copy
          {
-            const Array<word> aww( awa, awal, false );
-            const Array<word> aw( aww );
+            const ARRAY<word, STORAGE> aww( awa, awal, false );
+            const ARRAY<word, STORAGE> aw( aww );
 
             bool ok = (aww.getStorage() != aw.getStorage()) &
                (aww.getLength() == aw.getLength()) & aw.isOwning();
@@ -169,9 +184,9 @@ bool test_Array
                "\n";
          }
          {
-            word* pawa = new word[ awal ];
-            const Array<word> awo( pawa, awal, true );
-            const Array<word> aw( awo );
+            word* pawa = newWords<STORAGE>( awal );
+            const ARRAY<word, STORAGE> awo( pawa, awal, true );
+            const ARRAY<word, STORAGE> aw( awo );
 
             bool ok = (awo.getStorage() != aw.getStorage()) &
                (awo.getLength() == aw.getLength()) & aw.isOwning();
@@ -187,9 +202,9 @@ bool test_Array
          {
             word  awa[] = { 11, 12, 13 };
             const dword awal  = sizeof(awa) / sizeof(awa[0]);
-            const Array<word> aww( awa, awal, false );
+            const ARRAY<word, STORAGE> aww( awa, awal, false );
 
-            Array<word> aw( 5 );
+            ARRAY<word, STORAGE> aw( 5 );
             aw = aww;
 
             bool ok = (aww.getStorage() != aw.getStorage()) &
@@ -208,8 +223,8 @@ bool test_Array
                aw.isOwning() << "  " << ok << "\n";
          }
          {
-            const Array<word> aww( 0, 0, false );
-            Array<word> aw( 5 );
+            const ARRAY<word, STORAGE> aww( 0, 0, false );
+            ARRAY<word, STORAGE> aw( 5 );
             aw = aww;
 
             bool ok = (aww.getStorage() != aw.getStorage()) &
@@ -223,7 +238,7 @@ bool test_Array
 
       if( pOut && isVerbose ) *pOut << "\n";
 
-      if( pOut ) *pOut << "basics : " <<
+      if( pOut ) *pOut << name << " basics : " <<
          (is ? "--- succeeded" : "*** failed") << "\n\n";
 
       isOk &= is;
@@ -234,16 +249,16 @@ bool test_Array
    {
       bool is = true;
 
-      for( dword j = 0;  j < 11;  ++j )
+      for( dword j = 0;  j < 13;  ++j )
       {
          word wa[] = { 11, 12, 13 };
          const dword wal  = sizeof(wa) / sizeof(wa[0]);
-         Array<word> aww( wa, wal, false );
+         ARRAY<word, STORAGE> aww( wa, wal, false );
 
-         word* pwa = new word[ wal ];
-         Array<word> awo( pwa, wal, true );
+         word* pwa = newWords<STORAGE>( wal );
+         ARRAY<word, STORAGE> awo( pwa, wal, true );
 
-         Array<word> awm( wal );
+         ARRAY<word, STORAGE> awm( wal );
 
          for( dword i = wal;  i-- > 0; )
          {
@@ -251,12 +266,12 @@ bool test_Array
             awm[i] = wa[i];
          }
 
-         Array<word>* aws[] = { &aww, &awo, &awm };
+         ARRAY<word, STORAGE>* aws[] = { &aww, &awo, &awm };
 
          // using made, adopted, reffed
          for( dword a = 0;  a < 3;  ++a )
          {
-            Array<word>& ar = *(aws[a]);
+            ARRAY<word, STORAGE>& ar = *(aws[a]);
 
             bool ok = true;
 
@@ -287,7 +302,7 @@ bool test_Array
                // setStorage adopt
                {
                   const dword pal = 5;
-                  word* pa = new word[ pal ];
+                  word* pa = newWords<STORAGE>( pal );
                   ar.setStorage( pa, pal, true );
                   ok &= (pa == ar.getStorage()) & (pal == ar.getLength()) &
                      ar.isOwning();
@@ -297,7 +312,7 @@ bool test_Array
             case 3 :
                // swap made
                {
-                  Array<word> a2( 5 );
+                  ARRAY<word, STORAGE> a2( 5 );
                   const word* m1 = ar.getStorage();
                   const dword l1 = ar.getLength();
                   const bool  o1 = ar.isOwning();
@@ -315,8 +330,8 @@ bool test_Array
             case 4 :
                // swap adopted
                {
-                  word* paa2 = new word[ 5 ];
-                  Array<word> a2( paa2, 5, true );
+                  word* paa2 = newWords<STORAGE>( 5 );
+                  ARRAY<word, STORAGE> a2( paa2, 5, true );
                   const word* m1 = ar.getStorage();
                   const dword l1 = ar.getLength();
                   const bool  o1 = ar.isOwning();
@@ -335,7 +350,7 @@ bool test_Array
                // swap reffed
                {
                   word aa2[] = { 31, 32, 33, 34, 35 };
-                  Array<word> a2( aa2, 5, false );
+                  ARRAY<word, STORAGE> a2( aa2, 5, false );
                   const word* m1 = ar.getStorage();
                   const dword l1 = ar.getLength();
                   const bool  o1 = ar.isOwning();
@@ -430,6 +445,53 @@ bool test_Array
                   }
                }
                break;
+
+            case 11 :
+               // reserve
+               {
+                  const dword l1 = ar.getLength();
+
+                  ar.reserve( 20 );
+                  const word* m1 = ar.getStorage();
+                  ok &= (20 == ar.capacity()) & (l1 == ar.getLength()) &
+                     ar.isOwning();
+                  for( dword i = wal;  i-- > 0; )
+                  {
+                     ok &= (ar[i] == wa[i]);
+                  }
+
+                  // appending within reserve keeps storage
+                  for( dword i = l1;  i < 20;  ++i )
+                  {
+                     ar.append( static_cast<word>(i) );
+                  }
+                  ok &= (m1 == ar.getStorage()) & (20 == ar.getLength()) &
+                     (19 == ar[19]);
+
+                  // smaller reserve does nothing
+                  ar.reserve( 5 );
+                  ok &= (m1 == ar.getStorage()) & (20 == ar.capacity());
+               }
+               break;
+
+            case 12 :
+               // shrinkToFit
+               {
+                  const dword l1 = ar.getLength();
+
+                  ar.append( static_cast<word>(-100) );
+                  ok &= (ar.capacity() > ar.getLength());
+
+                  ar.shrinkToFit();
+                  ok &= (l1 + 1 == ar.getLength()) &
+                     (ar.getLength() == ar.capacity()) & ar.isOwning();
+                  for( dword i = wal;  i-- > 0; )
+                  {
+                     ok &= (ar[i] == wa[i]);
+                  }
+                  ok &= (-100 == ar[wal]);
+               }
+               break;
             }
             if( pOut && isVerbose ) *pOut << "commands " << j << " " << a <<
                "  " << ok << "\n";
@@ -437,9 +499,34 @@ bool test_Array
          }
       }
 
+      // append growth is geometric
+      {
+         ARRAY<dword, STORAGE> ad;
+         const dword* m = ad.getStorage();
+         dword reallocations = 0;
+
+         bool ok = true;
+         for( dword i = 0;  i < 100000;  ++i )
+         {
+            ad.append( i );
+            reallocations += static_cast<dword>(m != ad.getStorage());
+            m = ad.getStorage();
+         }
+         for( dword i = ad.getLength();  i-- > 0; )
+         {
+            ok &= (i == ad[i]);
+         }
+         ok &= (100000 == ad.getLength()) & (ad.capacity() >= 100000) &
+            (reallocations <= 18);
+
+         is &= ok;
+         if( pOut && isVerbose ) *pOut << "append growth  " << reallocations <<
+            " " << ad.capacity() << "  " << ok << "\n";
+      }
+
       if( pOut && isVerbose ) *pOut << "\n";
 
-      if( pOut ) *pOut << "commands : " <<
+      if( pOut ) *pOut << name << " commands : " <<
          (is ? "--- succeeded" : "*** failed") << "\n\n";
 
       isOk &= is;
@@ -452,12 +539,12 @@ bool test_Array
 
       word wa[] = { 41, 42, 43 };
       const dword wal  = sizeof(wa) / sizeof(wa[0]);
-      Array<word> aww( wa, wal, false );
+      ARRAY<word, STORAGE> aww( wa, wal, false );
 
-      word* pwa = new word[ wal ];
-      Array<word> awo( pwa, wal, true );
+      word* pwa = newWords<STORAGE>( wal );
+      ARRAY<word, STORAGE> awo( pwa, wal, true );
 
-      Array<word> awm( wal );
+      ARRAY<word, STORAGE> awm( wal );
 
       for( dword i = wal;  i-- > 0; )
       {
@@ -465,12 +552,12 @@ bool test_Array
          awm[i] = wa[i];
       }
 
-      Array<word>* aws[] = { &aww, &awo, &awm };
+      ARRAY<word, STORAGE>* aws[] = { &aww, &awo, &awm };
 
       // using made, adopted, reffed
       for( dword a = 0;  a < 3;  ++a )
       {
-         Array<word>& ar = *(aws[a]);
+         ARRAY<word, STORAGE>& ar = *(aws[a]);
 
          // getLength
          is &= (wal == ar.getLength());
@@ -487,6 +574,11 @@ bool test_Array
          if( pOut && isVerbose ) *pOut << "isOwning  " << a << "  " << is <<
             "\n";
 
+         // capacity
+         is &= (ar.getLength() == ar.capacity());
+         if( pOut && isVerbose ) *pOut << "capacity  " << a << "  " << is <<
+            "\n";
+
          // getStorage
          is &= (0 == a) ? (wa == ar.getStorage()) : (wa != ar.getStorage());
          is &= (0 != ar.getStorage());
@@ -505,17 +597,165 @@ bool test_Array
       }
 
       // getMaxLength
-      is &= (DWORD_MAX == Array<word>::getMaxLength());
+      is &= (DWORD_MAX == ARRAY<word, STORAGE>::getMaxLength());
       if( pOut && isVerbose ) *pOut << "getMaxLength " << is << "\n";
 
       if( pOut && isVerbose ) *pOut << "\n";
 
-      if( pOut ) *pOut << "queries : " <<
+      if( pOut ) *pOut << name << " queries : " <<
+         (is ? "--- succeeded" : "*** failed") << "\n\n";
+
+      isOk &= is;
+   }
+
+
+   return isOk;
+}
+
+
+template<class ARRAY>
+udword sumElements
+(
+   const ARRAY& a,
+   const dword  passes,
+   const bool   isWrapped
+)
+{
+   udword sum = 0;
+
+   const dword length = a.getLength();
+   for( dword p = passes;  p-- > 0; )
+   {
+      if( !isWrapped )
+      {
+         for( dword i = length;  i-- > 0; )
+         {
+            sum += a[i];
+         }
+      }
+      else
+      {
+         for( dword i = length;  i-- > 0; )
+         {
+            sum += a.get(i);
+         }
+      }
+   }
+
+   return sum;
+}
+
+
+/**
+ * Time per-element access through Array (virtual) and ArrayFlat.
+ */
+void benchmarkArray
+(
+   std::ostream& out
+)
+{
+   static const dword LENGTH = 1 << 16;
+   static const dword PASSES = 1000;
+
+   Array<udword> av( LENGTH );
+   for( dword i = LENGTH;  i-- > 0; )
+   {
+      av[i] = static_cast<udword>(i & 0xFF);
+   }
+   const ArrayFlat<udword>& af = av.getFlat();
+
+   // hide the dynamic type, so virtual calls are not resolved statically
+   const Array<udword>* volatile pV = &av;
+
+   static const char* NAMES[] = { "operator[]", "get" };
+   for( dword w = 0;  w < 2;  ++w )
+   {
+      udword sums[2];
+      double times[2];
+
+      Stopwatch stopwatch;
+      sums[0]  = sumElements( *pV, PASSES, (0 != w) );
+      times[0] = stopwatch.getSeconds();
+
+      stopwatch.start();
+      sums[1]  = sumElements( af, PASSES, (0 != w) );
+      times[1] = stopwatch.getSeconds();
+
+      const double scale = 1e9 / (static_cast<double>(LENGTH) *
+         static_cast<double>(PASSES));
+      out << "benchmark " << NAMES[w] << "  Array " << (times[0] * scale) <<
+         " ns  ArrayFlat " << (times[1] * scale) << " ns  speedup " <<
+         (times[0] / (times[1] > 0.0 ? times[1] : 1e-9)) << "  (" <<
+         (sums[0] == sums[1]) << ")\n";
+   }
+   out << "\n";
+}
+
+}
+
+
+namespace hxa7241_general
+{
+
+
+bool test_Array
+(
+   std::ostream* pOut,
+   const bool    isVerbose,
+   const dword   //seed
+)
+{
+   bool isOk = true;
+
+   if( pOut ) *pOut << "[ test_Array ]\n\n";
+
+
+   isOk &= testArray<Array, StorageNew>( pOut, isVerbose, "Array" );
+   isOk &= testArray<ArrayFlat, StorageNew>( pOut, isVerbose, "ArrayFlat" );
+   isOk &= testArray<ArrayFlat, StorageAligned<64> >( pOut, isVerbose,
+      "ArrayFlat aligned" );
+
+   // moving
+   {
+      bool is = true;
+
+      // factory, by value
+      word* p = new word[ 5 ];
+      p[3] = 33;
+      Array<word> a( adoptArray( p, 5 ) );
+      is &= (5 == a.getLength()) & a.isOwning() & (33 == a[3]);
+
+#if __cplusplus >= 201103L
+      // (with C++98, only return value optimization avoids a copy)
+      is &= (p == a.getStorage());
+
+      // move construct
+      Array<word> b( std::move( a ) );
+      is &= (p == b.getStorage()) & (5 == b.getLength()) & b.isOwning();
+      is &= (0 == a.getStorage()) & (0 == a.getLength()) & a.isOwning();
+
+      // move assign, non-owning stays non-owning
+      word w[] = { 1, 2, 3 };
+      Array<word> r( w, 3, false );
+      b = std::move( r );
+      is &= (w == b.getStorage()) & (3 == b.getLength()) & !b.isOwning();
+      is &= (0 == r.getStorage()) & (0 == r.getLength());
+
+      ArrayFlat<word> f( adoptArrayFlat( new word[ 4 ], 4 ) );
+      word* const pf = f.getStorage();
+      ArrayFlat<word> g;
+      g = std::move( f );
+      is &= (pf == g.getStorage()) & (4 == g.capacity()) & (0 == f.capacity());
+#endif
+
+      if( pOut ) *pOut << "moving : " <<
          (is ? "--- succeeded" : "*** failed") << "\n\n";
 
       isOk &= is;
    }
 
+   if( pOut && isVerbose ) benchmarkArray( *pOut );
+
 
    if( pOut ) *pOut << (isOk ? "--- successfully" : "*** failurefully") <<
       " completed " << "\n\n\n";
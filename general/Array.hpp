@@ -14,6 +14,15 @@
 
 
 
+#if __cplusplus >= 201103L
+#include <utility>
+#endif
+
+#include "ArrayFlat.hpp"
+
+
+
+
 #include "hxa7241_general.hpp"
 namespace hxa7241_general
 {
@@ -22,12 +31,15 @@ namespace hxa7241_general
 /**
  * A simpler, compacter alternative to std::vector.<br/><br/>
  *
- * Length is explicit - there is no hidden reserve.<br/>
+ * Length is explicit, but append grows a hidden reserve geometrically (so
+ * building element by element is amortized constant time). reserve and
+ * shrinkToFit control the reserve directly, capacity queries it.<br/>
  * Non-owning reference capability.<br/><br/>
  *
  * isAdopt false means make a non-owning reference to supplied storage: Array
  * will not delete the pointer. But subsequent use of copy-assignor, setLength,
- * append, or remove will revert Array back to owning new storage.<br/><br/>
+ * append, remove, or enlarging reserve will revert Array back to owning new
+ * storage.<br/><br/>
  *
  * isAdopt true means take ownership of a pointer to storage: Array will delete
  * the pointer when needed.<br/><br/>
@@ -35,36 +47,51 @@ namespace hxa7241_general
  * Copy constructor and copy assignor always make new owned storage (rather
  * than copy ref-status from a non-owning ref).<br/><br/>
  *
- * @implementation
- * free-store ethics (ethics is what one ought to do)<br/>
- * basic rules (ensuring correctness):<br/>
- * * in constructors, pointer is initialized to zero<br/>
- * * in destructor, pointer is deleted<br/>
- * * when pointer is changed:<br/>
- *   * first delete it<br/>
- *   * value changed to must be: zero, or from new<br/>
- * refinement rules:<br/>
- * * if storage is not owned, don't delete pointer<br/>
+ * Move constructor and move assignor (C++11) transfer the storage as it is
+ * (owned, or a non-owning ref), leaving the source empty -- no allocation or
+ * element copying. In C++98, swap does the same.<br/><br/>
+ *
+ * setLength, setStorage, copy constructor and copy assignor all leave no
+ * reserve (capacity equals length).<br/><br/>
+ *
+ * STORAGE is the allocation policy (see Storage.hpp): StorageNew (the
+ * default), StorageAligned<ALIGNMENT> for storage aligned for SIMD loads, or
+ * StorageArena or StoragePool for temporaries. A policy instance (eg. saying
+ * which arena) can be given at construction; copies, moves and swaps take it
+ * along with the storage. Adopted storage must come from the same policy.
+ * <br/><br/>
  *
- * @invariants
- * * pStorage_m is 0 or a valid address<br/>
- * * length_m low 15 bits is >= 0 and <= getMaxLength() (DWORD_MAX)<br/>
- * * length_m highest bit is logical not of isOwning()<br/>
+ * get wraps around out of bound indexs (magnitude, length-wise).
+ * getWrapped takes the addressing mode as template parameter: WrapRepeat,
+ * WrapMirror, or WrapClamp (non-virtual, as member templates cannot be).
+ * <br/><br/>
+ *
+ * @implementation
+ * A virtual, derivable, 'Decorator' for ArrayFlat -- which does all the
+ * storage management. For per-element loops, getFlat gives the non-virtual
+ * core.
  */
-template<class TYPE>
+template<class TYPE, class STORAGE = StorageNew>
 class Array
 {
 /// standard object services ---------------------------------------------------
 public:
                   Array();
-   explicit       Array( dword length );                               // throws
-                  Array( TYPE* pStorage,
-                         dword length,
-                         bool  isAdopt );                              // throws
+   explicit       Array( const STORAGE& storage );
+   explicit       Array( dword          length,
+                         const STORAGE& storage = STORAGE() );         // throws
+                  Array( TYPE*          pStorage,
+                         dword          length,
+                         bool           isAdopt,
+                         const STORAGE& storage = STORAGE() );         // throws
 
    virtual       ~Array();
                   Array( const Array& );                               // throws
            Array& operator=( const Array& );                           // throws
+#if __cplusplus >= 201103L
+                  Array( Array&& )                                   noexcept;
+           Array& operator=( Array&& )                               noexcept;
+#endif
 
 
 /// commands -------------------------------------------------------------------
@@ -77,120 +104,133 @@ public:
    virtual void   append( const TYPE& );                               // throws
    virtual void   remove( int index );                                 // throws
 
+   virtual void   reserve( dword capacity );                           // throws
+   virtual void   shrinkToFit();                                       // throws
+
    virtual void   zeroStorage();
 
    virtual TYPE*  getStorage();
    virtual TYPE&  operator[]( int index );
    virtual TYPE&  get( int index );
+   template<class WRAP>
+           TYPE&  getWrapped( int index );
+
+           ArrayFlat<TYPE, STORAGE>& getFlat();
 
 
 /// queries --------------------------------------------------------------------
    virtual dword  getLength()                                             const;
    virtual bool   isEmpty()                                               const;
    virtual bool   isOwning()                                              const;
+   virtual dword  capacity()                                              const;
    static  dword  getMaxLength();
 
    virtual const TYPE* getStorage()                                       const;
    virtual const TYPE& operator[]( int index )                            const;
    virtual const TYPE& get( int index )                                   const;
+   template<class WRAP>
+           const TYPE& getWrapped( int index )                            const;
+
+           const ArrayFlat<TYPE, STORAGE>& getFlat()                      const;
 
 
 /// implementation -------------------------------------------------------------
 protected:
-   virtual void   assign( const Array<TYPE>& );
-
-   virtual void   acquireStorage( dword length,
-                                  bool  isCopied );
-
-   static  void   copyObjects( TYPE*       lValStart,
-                               const TYPE* rValStart,
-                               dword       length );
+   virtual void   assign( const Array<TYPE, STORAGE>& );
 
 
 /// fields ---------------------------------------------------------------------
 private:
-   TYPE* pStorage_m;
-   dword length_m;
-
-   static const char ALLOCATION_EXCEPTION_MESSAGE[];
+   ArrayFlat<TYPE, STORAGE> array_m;
 };
 
 
 
 
+/**
+ * Make an Array owning orphaned storage (from new[]), returned by value.<br/>
+ * <br/>
+ *
+ * The elements are never copied: C++11 moves the result out, C++98 relies on
+ * return value optimization.
+ */
+template<class TYPE>
+Array<TYPE> adoptArray
+(
+   TYPE* pStorage,
+   dword length
+);
 
 
 
 
-/// statics --------------------------------------------------------------------
-template<class TYPE>
-const char Array<TYPE>::ALLOCATION_EXCEPTION_MESSAGE[] =
-   "Array<>::acquireStorage() - storage allocation failed";
 
 
 
 
 /// standard object services ---------------------------------------------------
-template<class TYPE>
-Array<TYPE>::Array()
- : pStorage_m( 0 )
- , length_m  ( 0 )
+template<class TYPE, class STORAGE>
+Array<TYPE, STORAGE>::Array()
+ : array_m()
 {
 }
 
 
-template<class TYPE>
-Array<TYPE>::Array
+template<class TYPE, class STORAGE>
+Array<TYPE, STORAGE>::Array
 (
-   const dword length
+   const STORAGE& storage
 )
- : pStorage_m( 0 )
- , length_m  ( 0 )
+ : array_m( storage )
 {
-   Array<TYPE>::setLength( length );
 }
 
 
-template<class TYPE>
-Array<TYPE>::Array
+template<class TYPE, class STORAGE>
+Array<TYPE, STORAGE>::Array
 (
-   TYPE*const  pStorage,
-   const dword length,
-   const bool  isAdopt
+   const dword    length,
+   const STORAGE& storage
 )
- : pStorage_m( 0 )
- , length_m  ( 0 )
+ : array_m( length, storage )
 {
-   Array<TYPE>::setStorage( pStorage, length, isAdopt );
 }
 
 
-template<class TYPE>
-Array<TYPE>::~Array()
+template<class TYPE, class STORAGE>
+Array<TYPE, STORAGE>::Array
+(
+   TYPE*const     pStorage,
+   const dword    length,
+   const bool     isAdopt,
+   const STORAGE& storage
+)
+ : array_m( pStorage, length, isAdopt, storage )
 {
-   if( isOwning() )
-   {
-      delete[] pStorage_m;
-   }
 }
 
 
-template<class TYPE>
-Array<TYPE>::Array
+template<class TYPE, class STORAGE>
+Array<TYPE, STORAGE>::~Array()
+{
+}
+
+
+template<class TYPE, class STORAGE>
+Array<TYPE, STORAGE>::Array
 (
-   const Array<TYPE>& other
+   const Array<TYPE, STORAGE>& other
 )
- : pStorage_m( 0 )
- , length_m  ( 0 )
+ : array_m( other.array_m.getStoragePolicy() )
 {
-   Array<TYPE>::assign( other );
+   Array<TYPE, STORAGE>::assign( other );
 }
 
 
-template<class TYPE>
-Array<TYPE>& Array<TYPE>::operator=
+template<class TYPE, class STORAGE>
+Array<TYPE, STORAGE>& Array<TYPE, STORAGE>::operator=
 (
-   const Array<TYPE>& other
+   const Array<TYPE, STORAGE>& other
 )
 {
    assign( other );
@@ -199,290 +239,276 @@ Array<TYPE>& Array<TYPE>::operator=
 }
 
 
+#if __cplusplus >= 201103L
+template<class TYPE, class STORAGE>
+Array<TYPE, STORAGE>::Array
+(
+   Array<TYPE, STORAGE>&& other
+) noexcept
+ : array_m( std::move( other.array_m ) )
+{
+}
+
+
+template<class TYPE, class STORAGE>
+Array<TYPE, STORAGE>& Array<TYPE, STORAGE>::operator=
+(
+   Array<TYPE, STORAGE>&& other
+) noexcept
+{
+   array_m = std::move( other.array_m );
+
+   return *this;
+}
+#endif
+
+
 
 
 /// commands -------------------------------------------------------------------
-template<class TYPE>
-void Array<TYPE>::setLength
+template<class TYPE, class STORAGE>
+void Array<TYPE, STORAGE>::setLength
 (
    const dword length
 )
 {
-   acquireStorage( length, false );
+   array_m.setLength( length );
 }
 
 
-template<class TYPE>
-void Array<TYPE>::setStorage
+template<class TYPE, class STORAGE>
+void Array<TYPE, STORAGE>::setStorage
 (
    TYPE*const  pStorage,
-   dword       length,
+   const dword length,
    const bool  isAdopt
 )
 {
-   if( pStorage != pStorage_m )
-   {
-      if( isOwning() )
-      {
-         delete[] pStorage_m;
-      }
-      pStorage_m = pStorage;
-   }
-
-   length_m  = (length >= 0) ? length : 0;
-   length_m |= (static_cast<dword>(!isAdopt) << 31);
+   array_m.setStorage( pStorage, length, isAdopt );
 }
 
 
-template<class TYPE>
-void Array<TYPE>::swap
+template<class TYPE, class STORAGE>
+void Array<TYPE, STORAGE>::swap
 (
-   Array<TYPE>& other
+   Array<TYPE, STORAGE>& other
 )
 {
-   TYPE*const tmpM  = pStorage_m;
-   pStorage_m       = other.pStorage_m;
-   other.pStorage_m = tmpM;
-
-   const dword tmpL = length_m;
-   length_m         = other.length_m;
-   other.length_m   = tmpL;
+   array_m.swap( other.array_m );
 }
 
 
-template<class TYPE>
-void Array<TYPE>::append
+template<class TYPE, class STORAGE>
+void Array<TYPE, STORAGE>::append
 (
    const TYPE& element
 )
 {
-   // expand storage, duplicating elements
-   acquireStorage( getLength() + 1, true );
-
-   // write new element into last position
-   *(pStorage_m + getLength() - 1) = element;
+   array_m.append( element );
+}
 
 
-// // make larger storage
-// Array<TYPE> newArray( getLength() + 1 );
-//
-// // duplicate elements, and append new element
-// copyObjects( newArray.pStorage_m, pStorage_m, getLength() );
-// *(newArray.pStorage_m + getLength()) = element;
-//
-// // swap new storage with this
-// swap( newArray );
+template<class TYPE, class STORAGE>
+void Array<TYPE, STORAGE>::remove
+(
+   const int index
+)
+{
+   array_m.remove( index );
 }
 
 
-template<class TYPE>
-void Array<TYPE>::remove
+template<class TYPE, class STORAGE>
+void Array<TYPE, STORAGE>::reserve
 (
-   const int index
+   const dword capacity
 )
 {
-   // check index is within range
-   if( (index >= 0) & (index < getLength())  )
-   {
-      // make smaller storage
-      Array<TYPE> newArray( getLength() - 1 );
+   array_m.reserve( capacity );
+}
 
-      // copy elements, skipping element at index
-      {
-               TYPE* pDestination = newArray.pStorage_m;
-               TYPE* pEnd         = pDestination + newArray.getLength();
-         const TYPE* pSource      = pStorage_m;
-         const TYPE* pIndex       = pSource + index;
-         while( pDestination < pEnd )
-         {
-            pSource += static_cast<dword>(pSource == pIndex);
-            *(pDestination++) = *(pSource++);
-         }
-      }
 
-      // swap new storage with this
-      swap( newArray );
-   }
+template<class TYPE, class STORAGE>
+void Array<TYPE, STORAGE>::shrinkToFit()
+{
+   array_m.shrinkToFit();
 }
 
 
-template<class TYPE>
-void Array<TYPE>::zeroStorage()
+template<class TYPE, class STORAGE>
+void Array<TYPE, STORAGE>::zeroStorage()
 {
-   for( dword i = getLength();  i-- > 0; )
-   {
-      pStorage_m[ i ] = TYPE();
-   }
+   array_m.zeroStorage();
 }
 
 
-template<class TYPE>
+template<class TYPE, class STORAGE>
 inline
-TYPE* Array<TYPE>::getStorage()
+TYPE* Array<TYPE, STORAGE>::getStorage()
 {
-   return pStorage_m;
+   return array_m.getStorage();
 }
 
 
-template<class TYPE>
+template<class TYPE, class STORAGE>
 inline
-TYPE& Array<TYPE>::operator[]
+TYPE& Array<TYPE, STORAGE>::operator[]
 (
    const int index
 )
 {
-   return pStorage_m[ index ];
+   return array_m[ index ];
 }
 
 
-template<class TYPE>
-TYPE& Array<TYPE>::get
+template<class TYPE, class STORAGE>
+TYPE& Array<TYPE, STORAGE>::get
 (
    const int index
 )
 {
-   return pStorage_m[ (index >= 0 ? index : -index) % getLength() ];
+   return array_m.get( index );
+}
+
+
+template<class TYPE, class STORAGE>
+template<class WRAP>
+inline
+TYPE& Array<TYPE, STORAGE>::getWrapped
+(
+   const int index
+)
+{
+   return array_m.template getWrapped<WRAP>( index );
+}
+
+
+template<class TYPE, class STORAGE>
+inline
+ArrayFlat<TYPE, STORAGE>& Array<TYPE, STORAGE>::getFlat()
+{
+   return array_m;
 }
 
 
 
 
 /// queries --------------------------------------------------------------------
-template<class TYPE>
+template<class TYPE, class STORAGE>
 inline
-dword Array<TYPE>::getLength() const
+dword Array<TYPE, STORAGE>::getLength() const
 {
-   return length_m & 0x7FFFFFFF;
+   return array_m.getLength();
 }
 
 
-template<class TYPE>
+template<class TYPE, class STORAGE>
 inline
-bool Array<TYPE>::isEmpty() const
+bool Array<TYPE, STORAGE>::isEmpty() const
 {
-   return getLength() == 0;
+   return array_m.isEmpty();
 }
 
 
-template<class TYPE>
+template<class TYPE, class STORAGE>
 inline
-bool Array<TYPE>::isOwning() const
+bool Array<TYPE, STORAGE>::isOwning() const
 {
-   return (length_m & 0x80000000) == 0;
+   return array_m.isOwning();
 }
 
 
-template<class TYPE>
+template<class TYPE, class STORAGE>
 inline
-dword Array<TYPE>::getMaxLength()
+dword Array<TYPE, STORAGE>::capacity() const
 {
-   return DWORD_MAX;
+   return array_m.capacity();
 }
 
 
-template<class TYPE>
+template<class TYPE, class STORAGE>
 inline
-const TYPE* Array<TYPE>::getStorage() const
+dword Array<TYPE, STORAGE>::getMaxLength()
 {
-   return pStorage_m;
+   return ArrayFlat<TYPE, STORAGE>::getMaxLength();
 }
 
 
-template<class TYPE>
+template<class TYPE, class STORAGE>
+inline
+const TYPE* Array<TYPE, STORAGE>::getStorage() const
+{
+   return array_m.getStorage();
+}
+
+
+template<class TYPE, class STORAGE>
 inline
-const TYPE& Array<TYPE>::operator[]
+const TYPE& Array<TYPE, STORAGE>::operator[]
 (
    const int index
 ) const
 {
-   return pStorage_m[ index ];
+   return array_m[ index ];
 }
 
 
-template<class TYPE>
-const TYPE& Array<TYPE>::get
+template<class TYPE, class STORAGE>
+const TYPE& Array<TYPE, STORAGE>::get
 (
    const int index
 ) const
 {
-   return pStorage_m[ (index >= 0 ? index : -index) % getLength() ];
+   return array_m.get( index );
 }
 
 
-
-
-/// implementation -------------------------------------------------------------
-template<class TYPE>
-void Array<TYPE>::assign
+template<class TYPE, class STORAGE>
+template<class WRAP>
+inline
+const TYPE& Array<TYPE, STORAGE>::getWrapped
 (
-   const Array<TYPE>& other
-)
+   const int index
+) const
 {
-   if( &other != this )
-   {
-      acquireStorage( other.getLength(), false );
+   return array_m.template getWrapped<WRAP>( index );
+}
+
 
-      copyObjects( getStorage(), other.getStorage(), other.getLength() );
-   }
+template<class TYPE, class STORAGE>
+inline
+const ArrayFlat<TYPE, STORAGE>& Array<TYPE, STORAGE>::getFlat() const
+{
+   return array_m;
 }
 
 
-template<class TYPE>
-void Array<TYPE>::acquireStorage
+
+
+/// implementation -------------------------------------------------------------
+template<class TYPE, class STORAGE>
+void Array<TYPE, STORAGE>::assign
 (
-   dword      newLength,
-   const bool isCopied
+   const Array<TYPE, STORAGE>& other
 )
 {
-   // clamp to 0 min
-   newLength = (newLength >= 0) ? newLength : 0;
-
-   // only allocate if different length
-   if( newLength != getLength() )
-   {
-      // allocate new storage
-      TYPE* pNewStorage = new TYPE[ newLength ];
-      if( pNewStorage == 0 )
-      {
-         throw ALLOCATION_EXCEPTION_MESSAGE;
-      }
-
-      // copy elements to new storage
-      if( isCopied )
-      {
-         copyObjects( pNewStorage, pStorage_m,
-            (getLength() <= newLength ? getLength() : newLength) );
-      }
-
-      // delete old storage and set the members
-      if( isOwning() )
-      {
-         delete[] pStorage_m;
-      }
-      pStorage_m = pNewStorage;
-      length_m   = newLength;
-   }
+   array_m = other.array_m;
 }
 
 
+
+
+/// other ----------------------------------------------------------------------
 template<class TYPE>
-void Array<TYPE>::copyObjects
+Array<TYPE> adoptArray
 (
-   TYPE*const       pDestination,
-   const TYPE*const pSource,
-   const dword      length
+   TYPE*const  pStorage,
+   const dword length
 )
 {
-   if( length >= 0 )
-   {
-            TYPE* pDestinationCursor = pDestination + length;
-      const TYPE* pSourceCursor      = pSource      + length;
+   Array<TYPE> array( pStorage, length, true );
 
-      while( pDestinationCursor > pDestination )
-      {
-         *(--pDestinationCursor) = *(--pSourceCursor);
-      }
-   }
+   return array;
 }
 
 
@@ -0,0 +1,710 @@
+/*------------------------------------------------------------------------------
+
+   HXA7241 General library.
+   Copyright (c) 2004-2007,  Harrison Ainsworth / HXA7241.
+
+   http://www.hxa7241.org/
+
+------------------------------------------------------------------------------*/
+
+
+#ifndef ArrayFlat_h
+#define ArrayFlat_h
+
+
+#include "Storage.hpp"
+#include "Wrap.hpp"
+
+
+
+
+#include "hxa7241_general.hpp"
+namespace hxa7241_general
+{
+
+
+/**
+ * Array with no dynamic dispatch: same interface and semantics as Array, but
+ * all members non-virtual.<br/><br/>
+ *
+ * No vtable pointer, and every accessor can be inlined -- for per-element
+ * loops. Not for deriving from (destructor is non-virtual).<br/><br/>
+ *
+ * Reserve, non-owning reference, copying and moving semantics are exactly as
+ * documented for Array.<br/><br/>
+ *
+ * STORAGE is the allocation policy (see Storage.hpp): StorageNew (the
+ * default), or StorageAligned<16, 32 or 64> for aligned SIMD loads, or
+ * StorageArena or StoragePool for temporaries. It is a private base, so an
+ * empty policy adds no size. A policy instance can be given at construction;
+ * copies, moves and swaps take it along with the storage.
+ *
+ * @see Array -- the virtual, derivable, version, implemented with this.
+ *
+ * @implementation
+ * free-store ethics (ethics is what one ought to do)<br/>
+ * basic rules (ensuring correctness):<br/>
+ * * in constructors, pointer is initialized to zero<br/>
+ * * in destructor, pointer is deleted<br/>
+ * * when pointer is changed:<br/>
+ *   * first delete it<br/>
+ *   * value changed to must be: zero, or from STORAGE allocate<br/>
+ * refinement rules:<br/>
+ * * if storage is not owned, don't delete pointer<br/>
+ *
+ * @invariants
+ * * pStorage_m is 0 or a valid address<br/>
+ * * length_m low 31 bits is >= 0 and <= getMaxLength() (DWORD_MAX)<br/>
+ * * length_m highest bit is logical not of isOwning()<br/>
+ * * capacity_m >= length_m low 31 bits, and is the allocated length<br/>
+ * * capacity_m == length_m low 31 bits, if not isOwning()<br/>
+ */
+template<class TYPE, class STORAGE = StorageNew>
+class ArrayFlat
+   : private STORAGE
+{
+/// standard object services ---------------------------------------------------
+public:
+                      ArrayFlat();
+   explicit           ArrayFlat( const STORAGE& storage );
+   explicit           ArrayFlat( dword          length,
+                                 const STORAGE& storage = STORAGE() ); // throws
+                      ArrayFlat( TYPE*          pStorage,
+                                 dword          length,
+                                 bool           isAdopt,
+                                 const STORAGE& storage = STORAGE() ); // throws
+
+                     ~ArrayFlat();
+                      ArrayFlat( const ArrayFlat& );                   // throws
+           ArrayFlat& operator=( const ArrayFlat& );                   // throws
+#if __cplusplus >= 201103L
+                      ArrayFlat( ArrayFlat&& )                       noexcept;
+           ArrayFlat& operator=( ArrayFlat&& )                       noexcept;
+#endif
+
+
+/// commands -------------------------------------------------------------------
+           void   setLength( dword length );                           // throws
+           void   setStorage( TYPE* pStorage,
+                              dword length,
+                              bool  isAdopt );
+
+           void   swap( ArrayFlat& );
+           void   append( const TYPE& );                               // throws
+           void   remove( int index );                                 // throws
+
+           void   reserve( dword capacity );                           // throws
+           void   shrinkToFit();                                       // throws
+
+           void   zeroStorage();
+
+           TYPE*  getStorage();
+           TYPE&  operator[]( int index );
+           TYPE&  get( int index );
+   template<class WRAP>
+           TYPE&  getWrapped( int index );
+
+
+/// queries --------------------------------------------------------------------
+           dword  getLength()                                             const;
+           bool   isEmpty()                                               const;
+           bool   isOwning()                                              const;
+           dword  capacity()                                              const;
+   static  dword  getMaxLength();
+
+           const STORAGE& getStoragePolicy()                              const;
+
+           const TYPE* getStorage()                                       const;
+           const TYPE& operator[]( int index )                            const;
+           const TYPE& get( int index )                                   const;
+   template<class WRAP>
+           const TYPE& getWrapped( int index )                            const;
+
+
+/// implementation -------------------------------------------------------------
+private:
+           void   assign( const ArrayFlat<TYPE, STORAGE>& );
+
+           void   acquireStorage( dword length,
+                                  bool  isCopied );
+           void   reallocate( dword capacity,
+                              dword length,
+                              bool  isCopied );
+
+   static  void   copyObjects( TYPE*       lValStart,
+                               const TYPE* rValStart,
+                               dword       length );
+
+
+/// fields ---------------------------------------------------------------------
+private:
+   TYPE* pStorage_m;
+   dword length_m;
+   dword capacity_m;
+
+   static const char ALLOCATION_EXCEPTION_MESSAGE[];
+   static const char LENGTH_EXCEPTION_MESSAGE[];
+};
+
+
+
+
+/**
+ * Make an ArrayFlat owning orphaned storage (from new[]), returned by value.
+ * <br/><br/>
+ *
+ * The elements are never copied: C++11 moves the result out, C++98 relies on
+ * return value optimization.
+ */
+template<class TYPE>
+ArrayFlat<TYPE> adoptArrayFlat
+(
+   TYPE* pStorage,
+   dword length
+);
+
+
+
+
+
+
+
+
+/// statics --------------------------------------------------------------------
+template<class TYPE, class STORAGE>
+const char ArrayFlat<TYPE, STORAGE>::ALLOCATION_EXCEPTION_MESSAGE[] =
+   "ArrayFlat<>::acquireStorage() - storage allocation failed";
+template<class TYPE, class STORAGE>
+const char ArrayFlat<TYPE, STORAGE>::LENGTH_EXCEPTION_MESSAGE[] =
+   "ArrayFlat<>::append() - length at maximum";
+
+
+
+
+/// standard object services ---------------------------------------------------
+template<class TYPE, class STORAGE>
+ArrayFlat<TYPE, STORAGE>::ArrayFlat()
+ : pStorage_m( 0 )
+ , length_m  ( 0 )
+ , capacity_m( 0 )
+{
+}
+
+
+template<class TYPE, class STORAGE>
+ArrayFlat<TYPE, STORAGE>::ArrayFlat
+(
+   const STORAGE& storage
+)
+ : STORAGE   ( storage )
+ , pStorage_m( 0 )
+ , length_m  ( 0 )
+ , capacity_m( 0 )
+{
+}
+
+
+template<class TYPE, class STORAGE>
+ArrayFlat<TYPE, STORAGE>::ArrayFlat
+(
+   const dword    length,
+   const STORAGE& storage
+)
+ : STORAGE   ( storage )
+ , pStorage_m( 0 )
+ , length_m  ( 0 )
+ , capacity_m( 0 )
+{
+   ArrayFlat<TYPE, STORAGE>::setLength( length );
+}
+
+
+template<class TYPE, class STORAGE>
+ArrayFlat<TYPE, STORAGE>::ArrayFlat
+(
+   TYPE*const     pStorage,
+   const dword    length,
+   const bool     isAdopt,
+   const STORAGE& storage
+)
+ : STORAGE   ( storage )
+ , pStorage_m( 0 )
+ , length_m  ( 0 )
+ , capacity_m( 0 )
+{
+   ArrayFlat<TYPE, STORAGE>::setStorage( pStorage, length, isAdopt );
+}
+
+
+template<class TYPE, class STORAGE>
+ArrayFlat<TYPE, STORAGE>::~ArrayFlat()
+{
+   if( isOwning() )
+   {
+      STORAGE::deallocate( pStorage_m, capacity_m );
+   }
+}
+
+
+template<class TYPE, class STORAGE>
+ArrayFlat<TYPE, STORAGE>::ArrayFlat
+(
+   const ArrayFlat<TYPE, STORAGE>& other
+)
+ : STORAGE   ( other )
+ , pStorage_m( 0 )
+ , length_m  ( 0 )
+ , capacity_m( 0 )
+{
+   ArrayFlat<TYPE, STORAGE>::assign( other );
+}
+
+
+template<class TYPE, class STORAGE>
+ArrayFlat<TYPE, STORAGE>& ArrayFlat<TYPE, STORAGE>::operator=
+(
+   const ArrayFlat<TYPE, STORAGE>& other
+)
+{
+   assign( other );
+
+   return *this;
+}
+
+
+#if __cplusplus >= 201103L
+template<class TYPE, class STORAGE>
+ArrayFlat<TYPE, STORAGE>::ArrayFlat
+(
+   ArrayFlat<TYPE, STORAGE>&& other
+) noexcept
+ : STORAGE   ( other )
+ , pStorage_m( 0 )
+ , length_m  ( 0 )
+ , capacity_m( 0 )
+{
+   swap( other );
+}
+
+
+template<class TYPE, class STORAGE>
+ArrayFlat<TYPE, STORAGE>& ArrayFlat<TYPE, STORAGE>::operator=
+(
+   ArrayFlat<TYPE, STORAGE>&& other
+) noexcept
+{
+   // take other's, leaving it empty (with its own policy, as move construct
+   // does), and free the old at scope end
+   ArrayFlat<TYPE, STORAGE> old( static_cast<const STORAGE&>(other) );
+   old.swap( other );
+   swap( old );
+
+   return *this;
+}
+#endif
+
+
+
+
+/// commands -------------------------------------------------------------------
+template<class TYPE, class STORAGE>
+void ArrayFlat<TYPE, STORAGE>::setLength
+(
+   const dword length
+)
+{
+   acquireStorage( length, false );
+}
+
+
+template<class TYPE, class STORAGE>
+void ArrayFlat<TYPE, STORAGE>::setStorage
+(
+   TYPE*const  pStorage,
+   dword       length,
+   const bool  isAdopt
+)
+{
+   if( pStorage != pStorage_m )
+   {
+      if( isOwning() )
+      {
+         STORAGE::deallocate( pStorage_m, capacity_m );
+      }
+      pStorage_m = pStorage;
+   }
+
+   length_m   = (length >= 0) ? length : 0;
+   capacity_m = length_m;
+   length_m  |= (static_cast<dword>(!isAdopt) << 31);
+}
+
+
+template<class TYPE, class STORAGE>
+void ArrayFlat<TYPE, STORAGE>::swap
+(
+   ArrayFlat<TYPE, STORAGE>& other
+)
+{
+   TYPE*const tmpM  = pStorage_m;
+   pStorage_m       = other.pStorage_m;
+   other.pStorage_m = tmpM;
+
+   const dword tmpL = length_m;
+   length_m         = other.length_m;
+   other.length_m   = tmpL;
+
+   const dword tmpC = capacity_m;
+   capacity_m       = other.capacity_m;
+   other.capacity_m = tmpC;
+
+   // the storage policy goes with its storage
+   STORAGE&      mine   = *this;
+   STORAGE&      theirs = other;
+   const STORAGE tmpS( mine );
+   mine   = theirs;
+   theirs = tmpS;
+}
+
+
+template<class TYPE, class STORAGE>
+void ArrayFlat<TYPE, STORAGE>::append
+(
+   const TYPE& element
+)
+{
+   const dword length = getLength();
+
+   // expand storage geometrically when full (or not owned), duplicating
+   // elements
+   if( (length >= capacity_m) | !isOwning() )
+   {
+      if( length >= getMaxLength() )
+      {
+         throw LENGTH_EXCEPTION_MESSAGE;
+      }
+
+      const dword capacity = (length <= (getMaxLength() / 2)) ?
+         (length > 0 ? length * 2 : 1) : getMaxLength();
+      reallocate( capacity, length, true );
+   }
+
+   // write new element into last position
+   pStorage_m[ length ] = element;
+   ++length_m;
+}
+
+
+template<class TYPE, class STORAGE>
+void ArrayFlat<TYPE, STORAGE>::remove
+(
+   const int index
+)
+{
+   // check index is within range
+   if( (index >= 0) & (index < getLength())  )
+   {
+      // make smaller storage
+      ArrayFlat<TYPE, STORAGE> newArray( getLength() - 1, *this );
+
+      // copy elements, skipping element at index
+      {
+               TYPE* pDestination = newArray.pStorage_m;
+               TYPE* pEnd         = pDestination + newArray.getLength();
+         const TYPE* pSource      = pStorage_m;
+         const TYPE* pIndex       = pSource + index;
+         while( pDestination < pEnd )
+         {
+            pSource += static_cast<dword>(pSource == pIndex);
+            *(pDestination++) = *(pSource++);
+         }
+      }
+
+      // swap new storage with this
+      swap( newArray );
+   }
+}
+
+
+template<class TYPE, class STORAGE>
+void ArrayFlat<TYPE, STORAGE>::reserve
+(
+   const dword capacity
+)
+{
+   // only enlarge (which makes a non-owning ref owning)
+   if( capacity > capacity_m )
+   {
+      reallocate( capacity, getLength(), true );
+   }
+}
+
+
+template<class TYPE, class STORAGE>
+void ArrayFlat<TYPE, STORAGE>::shrinkToFit()
+{
+   // only owned storage has a reserve
+   if( isOwning() & (capacity_m > getLength()) )
+   {
+      reallocate( getLength(), getLength(), true );
+   }
+}
+
+
+template<class TYPE, class STORAGE>
+void ArrayFlat<TYPE, STORAGE>::zeroStorage()
+{
+   for( dword i = getLength();  i-- > 0; )
+   {
+      pStorage_m[ i ] = TYPE();
+   }
+}
+
+
+template<class TYPE, class STORAGE>
+inline
+TYPE* ArrayFlat<TYPE, STORAGE>::getStorage()
+{
+   return pStorage_m;
+}
+
+
+template<class TYPE, class STORAGE>
+inline
+TYPE& ArrayFlat<TYPE, STORAGE>::operator[]
+(
+   const int index
+)
+{
+   return pStorage_m[ index ];
+}
+
+
+template<class TYPE, class STORAGE>
+inline
+TYPE& ArrayFlat<TYPE, STORAGE>::get
+(
+   const int index
+)
+{
+   return pStorage_m[ WrapRepeat::index( (index >= 0 ? index : -index),
+      getLength() ) ];
+}
+
+
+template<class TYPE, class STORAGE>
+template<class WRAP>
+inline
+TYPE& ArrayFlat<TYPE, STORAGE>::getWrapped
+(
+   const int index
+)
+{
+   return pStorage_m[ WRAP::index( index, getLength() ) ];
+}
+
+
+
+
+/// queries --------------------------------------------------------------------
+template<class TYPE, class STORAGE>
+inline
+dword ArrayFlat<TYPE, STORAGE>::getLength() const
+{
+   return length_m & 0x7FFFFFFF;
+}
+
+
+template<class TYPE, class STORAGE>
+inline
+bool ArrayFlat<TYPE, STORAGE>::isEmpty() const
+{
+   return getLength() == 0;
+}
+
+
+template<class TYPE, class STORAGE>
+inline
+bool ArrayFlat<TYPE, STORAGE>::isOwning() const
+{
+   return (length_m & 0x80000000) == 0;
+}
+
+
+template<class TYPE, class STORAGE>
+inline
+dword ArrayFlat<TYPE, STORAGE>::capacity() const
+{
+   return capacity_m;
+}
+
+
+template<class TYPE, class STORAGE>
+inline
+dword ArrayFlat<TYPE, STORAGE>::getMaxLength()
+{
+   return DWORD_MAX;
+}
+
+
+template<class TYPE, class STORAGE>
+inline
+const STORAGE& ArrayFlat<TYPE, STORAGE>::getStoragePolicy() const
+{
+   return *this;
+}
+
+
+template<class TYPE, class STORAGE>
+inline
+const TYPE* ArrayFlat<TYPE, STORAGE>::getStorage() const
+{
+   return pStorage_m;
+}
+
+
+template<class TYPE, class STORAGE>
+inline
+const TYPE& ArrayFlat<TYPE, STORAGE>::operator[]
+(
+   const int index
+) const
+{
+   return pStorage_m[ index ];
+}
+
+
+template<class TYPE, class STORAGE>
+inline
+const TYPE& ArrayFlat<TYPE, STORAGE>::get
+(
+   const int index
+) const
+{
+   return pStorage_m[ WrapRepeat::index( (index >= 0 ? index : -index),
+      getLength() ) ];
+}
+
+
+template<class TYPE, class STORAGE>
+template<class WRAP>
+inline
+const TYPE& ArrayFlat<TYPE, STORAGE>::getWrapped
+(
+   const int index
+) const
+{
+   return pStorage_m[ WRAP::index( index, getLength() ) ];
+}
+
+
+
+
+/// implementation -------------------------------------------------------------
+template<class TYPE, class STORAGE>
+void ArrayFlat<TYPE, STORAGE>::assign
+(
+   const ArrayFlat<TYPE, STORAGE>& other
+)
+{
+   if( &other != this )
+   {
+      acquireStorage( other.getLength(), false );
+
+      copyObjects( getStorage(), other.getStorage(), other.getLength() );
+   }
+}
+
+
+template<class TYPE, class STORAGE>
+void ArrayFlat<TYPE, STORAGE>::acquireStorage
+(
+   dword      newLength,
+   const bool isCopied
+)
+{
+   // clamp to 0 min
+   newLength = (newLength >= 0) ? newLength : 0;
+
+   // only allocate if different length
+   if( newLength != getLength() )
+   {
+      reallocate( newLength, newLength, isCopied );
+   }
+}
+
+
+template<class TYPE, class STORAGE>
+void ArrayFlat<TYPE, STORAGE>::reallocate
+(
+   const dword newCapacity,
+   const dword newLength,
+   const bool  isCopied
+)
+{
+   // allocate new storage
+   TYPE* pNewStorage = STORAGE::template allocate<TYPE>( newCapacity );
+   if( pNewStorage == 0 )
+   {
+      throw ALLOCATION_EXCEPTION_MESSAGE;
+   }
+
+   // copy elements to new storage
+   if( isCopied )
+   {
+      copyObjects( pNewStorage, pStorage_m,
+         (getLength() <= newLength ? getLength() : newLength) );
+   }
+
+   // delete old storage and set the members
+   if( isOwning() )
+   {
+      STORAGE::deallocate( pStorage_m, capacity_m );
+   }
+   pStorage_m = pNewStorage;
+   length_m   = newLength;
+   capacity_m = newCapacity;
+}
+
+
+template<class TYPE, class STORAGE>
+void ArrayFlat<TYPE, STORAGE>::copyObjects
+(
+   TYPE*const       pDestination,
+   const TYPE*const pSource,
+   const dword      length
+)
+{
+   if( length >= 0 )
+   {
+            TYPE* pDestinationCursor = pDestination + length;
+      const TYPE* pSourceCursor      = pSource      + length;
+
+      while( pDestinationCursor > pDestination )
+      {
+         *(--pDestinationCursor) = *(--pSourceCursor);
+      }
+   }
+}
+
+
+/// other ----------------------------------------------------------------------
+template<class TYPE>
+ArrayFlat<TYPE> adoptArrayFlat
+(
+   TYPE*const  pStorage,
+   const dword length
+)
+{
+   ArrayFlat<TYPE> array( pStorage, length, true );
+
+   return array;
+}
+
+
+}//namespace
+
+
+
+
+#endif//ArrayFlat_h
@@ -8,11 +8,128 @@
 ------------------------------------------------------------------------------*/
 
 
+/// conditional compilations
+#if defined(__AVX2__)
+#define CLAMPS_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (_M_IX86_FP >= 2)
+#define CLAMPS_SSE2
+#include <emmintrin.h>
+#endif
+
+#include <cstring>
+
 #include "Clamps.hpp"
 
 
 
 
+/// implementation /////////////////////////////////////////////////////////////
+namespace
+{
+using namespace hxa7241_general;
+
+
+/// NaN test by bits (-ffast-math may drop a NaN comparison, and lets max and
+/// min swap operands, so which one a NaN gives is not fixed)
+inline
+bool isNan
+(
+   const float f
+)
+{
+   udword bits;
+   std::memcpy( &bits, &f, sizeof(bits) );
+
+   return (bits & 0x7FFFFFFFu) > 0x7F800000u;
+}
+
+
+/// vector clamps: NaNs to min, then max with min, then min with max (as
+/// clamp_, given min <= max)
+
+#if defined(CLAMPS_AVX2)
+
+inline
+__m256 nanToMin
+(
+   const __m256 v,
+   const __m256 min
+)
+{
+   const __m256i bits = _mm256_and_si256( _mm256_castps_si256( v ),
+      _mm256_set1_epi32( 0x7FFFFFFF ) );
+
+   return _mm256_blendv_ps( v, min, _mm256_castsi256_ps( _mm256_cmpgt_epi32(
+      bits, _mm256_set1_epi32( 0x7F800000 ) ) ) );
+}
+
+
+inline
+__m256 clampV
+(
+   const __m256 v,
+   const __m256 min,
+   const __m256 max
+)
+{
+   return _mm256_min_ps( _mm256_max_ps( nanToMin( v, min ), min ), max );
+}
+
+#elif defined(CLAMPS_SSE2)
+
+inline
+__m128 nanToMin
+(
+   const __m128 v,
+   const __m128 min
+)
+{
+   const __m128 isNan = _mm_castsi128_ps( _mm_cmpgt_epi32( _mm_and_si128(
+      _mm_castps_si128( v ), _mm_set1_epi32( 0x7FFFFFFF ) ), _mm_set1_epi32(
+      0x7F800000 ) ) );
+
+   return _mm_or_ps( _mm_and_ps( isNan, min ), _mm_andnot_ps( isNan, v ) );
+}
+
+
+inline
+__m128 clampV
+(
+   const __m128 v,
+   const __m128 min,
+   const __m128 max
+)
+{
+   return _mm_min_ps( _mm_max_ps( nanToMin( v, min ), min ), max );
+}
+
+
+/// (no 32-bit min or max in SSE2: compare and select)
+inline
+__m128i clampV
+(
+   __m128i       v,
+   const __m128i min,
+   const __m128i max
+)
+{
+   const __m128i isLow  = _mm_cmplt_epi32( v, min );
+   v = _mm_or_si128( _mm_and_si128( isLow, min ), _mm_andnot_si128( isLow,
+      v ) );
+   const __m128i isHigh = _mm_cmpgt_epi32( v, max );
+
+   return _mm_or_si128( _mm_and_si128( isHigh, max ), _mm_andnot_si128(
+      isHigh, v ) );
+}
+
+#endif
+
+}
+
+
+
+
 namespace hxa7241_general
 {
 
@@ -69,4 +186,552 @@ float clamp01c
 }
 
 
+
+
+/// arrays ---------------------------------------------------------------------
+template<>
+void clamp
+(
+   const float* pIn,
+   float*       pOut,
+   const dword  count,
+   const float  min,
+   const float  max
+)
+{
+   dword i = 0;
+
+#if defined(CLAMPS_AVX2)
+   const __m256 vMin = _mm256_set1_ps( min );
+   const __m256 vMax = _mm256_set1_ps( max );
+
+   for( ;  (i + 8) <= count;  i += 8 )
+   {
+      _mm256_storeu_ps( pOut + i, clampV( _mm256_loadu_ps( pIn + i ), vMin,
+         vMax ) );
+   }
+#elif defined(CLAMPS_SSE2)
+   const __m128 vMin = _mm_set1_ps( min );
+   const __m128 vMax = _mm_set1_ps( max );
+
+   for( ;  (i + 4) <= count;  i += 4 )
+   {
+      _mm_storeu_ps( pOut + i, clampV( _mm_loadu_ps( pIn + i ), vMin,
+         vMax ) );
+   }
+#endif
+
+   for( ;  i < count;  ++i )
+   {
+      pOut[i] = isNan( pIn[i] ) ? min : clamp_( pIn[i], min, max );
+   }
+}
+
+
+template<>
+void clamp
+(
+   const dword* pIn,
+   dword*       pOut,
+   const dword  count,
+   const dword  min,
+   const dword  max
+)
+{
+   dword i = 0;
+
+#if defined(CLAMPS_AVX2)
+   const __m256i vMin = _mm256_set1_epi32( min );
+   const __m256i vMax = _mm256_set1_epi32( max );
+
+   for( ;  (i + 8) <= count;  i += 8 )
+   {
+      _mm256_storeu_si256( reinterpret_cast<__m256i*>(pOut + i),
+         _mm256_min_epi32( _mm256_max_epi32( _mm256_loadu_si256(
+         reinterpret_cast<const __m256i*>(pIn + i) ), vMin ), vMax ) );
+   }
+#elif defined(CLAMPS_SSE2)
+   const __m128i vMin = _mm_set1_epi32( min );
+   const __m128i vMax = _mm_set1_epi32( max );
+
+   for( ;  (i + 4) <= count;  i += 4 )
+   {
+      _mm_storeu_si128( reinterpret_cast<__m128i*>(pOut + i), clampV(
+         _mm_loadu_si128( reinterpret_cast<const __m128i*>(pIn + i) ), vMin,
+         vMax ) );
+   }
+#endif
+
+   for( ;  i < count;  ++i )
+   {
+      pOut[i] = clamp_( pIn[i], min, max );
+   }
+}
+
+
+template<>
+void clamp
+(
+   const uword* pIn,
+   uword*       pOut,
+   const dword  count,
+   const uword  min,
+   const uword  max
+)
+{
+   dword i = 0;
+
+#if defined(CLAMPS_AVX2)
+   const __m256i vMin = _mm256_set1_epi16( static_cast<word>(min) );
+   const __m256i vMax = _mm256_set1_epi16( static_cast<word>(max) );
+
+   for( ;  (i + 16) <= count;  i += 16 )
+   {
+      _mm256_storeu_si256( reinterpret_cast<__m256i*>(pOut + i),
+         _mm256_min_epu16( _mm256_max_epu16( _mm256_loadu_si256(
+         reinterpret_cast<const __m256i*>(pIn + i) ), vMin ), vMax ) );
+   }
+#elif defined(CLAMPS_SSE2)
+   // (no unsigned 16-bit min or max in SSE2: offset to signed and back)
+   const __m128i offset = _mm_set1_epi16( WORD_MIN );
+   const __m128i vMin   = _mm_xor_si128( _mm_set1_epi16( static_cast<word>(
+      min) ), offset );
+   const __m128i vMax   = _mm_xor_si128( _mm_set1_epi16( static_cast<word>(
+      max) ), offset );
+
+   for( ;  (i + 8) <= count;  i += 8 )
+   {
+      const __m128i v = _mm_xor_si128( _mm_loadu_si128(
+         reinterpret_cast<const __m128i*>(pIn + i) ), offset );
+      _mm_storeu_si128( reinterpret_cast<__m128i*>(pOut + i), _mm_xor_si128(
+         _mm_min_epi16( _mm_max_epi16( v, vMin ), vMax ), offset ) );
+   }
+#endif
+
+   for( ;  i < count;  ++i )
+   {
+      pOut[i] = clamp_( pIn[i], min, max );
+   }
+}
+
+
+void clamp01o
+(
+   const float* pIn,
+   float*       pOut,
+   const dword  count
+)
+{
+   dword i = 0;
+
+   // (not a plain min: floats between almost-one and one are kept)
+#if defined(CLAMPS_AVX2)
+   const __m256 zero   = _mm256_setzero_ps();
+   const __m256 one    = _mm256_set1_ps( 1.0f );
+   const __m256 almost = _mm256_set1_ps( FLOAT_ALMOST_ONE );
+
+   for( ;  (i + 8) <= count;  i += 8 )
+   {
+      const __m256 v = _mm256_max_ps( nanToMin( _mm256_loadu_ps( pIn + i ),
+         zero ), zero );
+      _mm256_storeu_ps( pOut + i, _mm256_blendv_ps( v, almost,
+         _mm256_cmp_ps( v, one, _CMP_GE_OQ ) ) );
+   }
+#elif defined(CLAMPS_SSE2)
+   const __m128 zero   = _mm_setzero_ps();
+   const __m128 one    = _mm_set1_ps( 1.0f );
+   const __m128 almost = _mm_set1_ps( FLOAT_ALMOST_ONE );
+
+   for( ;  (i + 4) <= count;  i += 4 )
+   {
+      const __m128 v      = _mm_max_ps( nanToMin( _mm_loadu_ps( pIn + i ),
+         zero ), zero );
+      const __m128 isHigh = _mm_cmpge_ps( v, one );
+      _mm_storeu_ps( pOut + i, _mm_or_ps( _mm_and_ps( isHigh, almost ),
+         _mm_andnot_ps( isHigh, v ) ) );
+   }
+#endif
+
+   for( ;  i < count;  ++i )
+   {
+      pOut[i] = isNan( pIn[i] ) ? 0.0f : clamp01o_( pIn[i] );
+   }
+}
+
+
+void clamp01c
+(
+   const float* pIn,
+   float*       pOut,
+   const dword  count
+)
+{
+   clamp( pIn, pOut, count, 0.0f, 1.0f );
+}
+
+
+void clampScale
+(
+   const float* pIn,
+   float*       pOut,
+   const dword  count,
+   const float  min,
+   const float  max,
+   const float  scale,
+   const float  offset
+)
+{
+   dword i = 0;
+
+#if defined(CLAMPS_AVX2)
+   const __m256 vMin    = _mm256_set1_ps( min );
+   const __m256 vMax    = _mm256_set1_ps( max );
+   const __m256 vScale  = _mm256_set1_ps( scale );
+   const __m256 vOffset = _mm256_set1_ps( offset );
+
+   for( ;  (i + 8) <= count;  i += 8 )
+   {
+      _mm256_storeu_ps( pOut + i, _mm256_add_ps( _mm256_mul_ps( clampV(
+         _mm256_loadu_ps( pIn + i ), vMin, vMax ), vScale ), vOffset ) );
+   }
+#elif defined(CLAMPS_SSE2)
+   const __m128 vMin    = _mm_set1_ps( min );
+   const __m128 vMax    = _mm_set1_ps( max );
+   const __m128 vScale  = _mm_set1_ps( scale );
+   const __m128 vOffset = _mm_set1_ps( offset );
+
+   for( ;  (i + 4) <= count;  i += 4 )
+   {
+      _mm_storeu_ps( pOut + i, _mm_add_ps( _mm_mul_ps( clampV( _mm_loadu_ps(
+         pIn + i ), vMin, vMax ), vScale ), vOffset ) );
+   }
+#endif
+
+   for( ;  i < count;  ++i )
+   {
+      pOut[i] = ((isNan( pIn[i] ) ? min : clamp_( pIn[i], min, max )) *
+         scale) + offset;
+   }
+}
+
+
+}//namespace
+
+
+
+
+
+
+
+
+/// test -----------------------------------------------------------------------
+#ifdef TESTING
+
+
+#include <float.h>
+#include <ostream>
+#include <iomanip>
+#include <vector>
+
+#include "Stopwatch.hpp"
+
+
+namespace
+{
+
+/// simple LCG, just for varied numbers
+udword nextRandom
+(
+   udword& state
+)
+{
+   state = (state * 1664525u) + 1013904223u;
+   return state;
+}
+
+
+/// arrays against one at a time, for every short length and offset, out of
+/// place and in place
+template<class TYPE>
+bool testArray
+(
+   std::ostream*            pOut,
+   const std::vector<TYPE>& numbers,
+   const TYPE               min,
+   const TYPE               max
+)
+{
+   bool isOk = true;
+
+   const dword count = static_cast<dword>(numbers.size());
+   std::vector<TYPE> results( count );
+
+   for( dword length = 0;  length < 40;  ++length )
+   {
+      const dword offset = length % 3;
+      const dword n      = (0 == length) ? (count - offset) : length;
+
+      clamp( &numbers[offset], &results[offset], n, min, max );
+      std::vector<TYPE> inPlace( numbers );
+      clamp( &inPlace[offset], &inPlace[offset], n, min, max );
+
+      for( dword i = offset;  i < (offset + n);  ++i )
+      {
+         const TYPE expected = clamp_( numbers[i], min, max );
+         const bool is = (results[i] == expected) & (inPlace[i] == expected);
+
+         if( pOut && !is ) *pOut << length << " " << i << "  " << numbers[i] <<
+            "  " << results[i] << "  " << expected << "\n";
+         isOk &= is;
+      }
+   }
+
+   return isOk;
+}
+
+
+/// a full-HD RGB frame: one at a time (out of line, inline), and array
+void benchmark
+(
+   std::ostream& out
+)
+{
+   static const dword COUNT = 1920 * 1080 * 3;
+   static const dword TIMES = 4;
+
+   udword state = 1;
+   std::vector<float> floats( COUNT );
+   std::vector<dword> dwords( COUNT );
+   std::vector<uword> uwords( COUNT );
+   for( dword i = 0;  i < COUNT;  ++i )
+   {
+      const udword r = nextRandom( state );
+      floats[i] = (static_cast<float>(r >> 8) * (1.4f / 16777216.0f)) - 0.2f;
+      dwords[i] = static_cast<dword>(r >> 8) - 0x100000;
+      uwords[i] = static_cast<uword>(r >> 16);
+   }
+   std::vector<float> floatsOut( COUNT );
+   std::vector<dword> dwordsOut( COUNT );
+   std::vector<uword> uwordsOut( COUNT );
+
+   // (changing an input each time, so the work is not hoisted)
+   double times[4][3];
+   Stopwatch stopwatch;
+
+   for( dword f = 0;  f < 4;  ++f )
+   {
+      for( dword k = 0;  k < 3;  ++k )
+      {
+         stopwatch.start();
+         for( dword t = TIMES;  t-- > 0; )
+         {
+            floats[t] += 1e-3f;
+            dwords[t] += 1;
+            uwords[t] += 1;
+            switch( (f * 3) + k )
+            {
+               case 0 : for( dword i = 0;  i < COUNT;  ++i ) {
+                  floatsOut[i] = clamp( floats[i], 0.0f, 1.0f ); }  break;
+               case 1 : for( dword i = 0;  i < COUNT;  ++i ) {
+                  floatsOut[i] = clamp_( floats[i], 0.0f, 1.0f ); }  break;
+               case 2 : clamp( &floats[0], &floatsOut[0], COUNT, 0.0f, 1.0f );
+                  break;
+
+               case 3 : for( dword i = 0;  i < COUNT;  ++i ) {
+                  dwordsOut[i] = clamp( dwords[i], 0, 0xFFFFFF ); }  break;
+               case 4 : for( dword i = 0;  i < COUNT;  ++i ) {
+                  dwordsOut[i] = clamp_( dwords[i], 0, 0xFFFFFF ); }  break;
+               case 5 : clamp( &dwords[0], &dwordsOut[0], COUNT, 0,
+                  0xFFFFFF );  break;
+
+               case 6 : for( dword i = 0;  i < COUNT;  ++i ) {
+                  uwordsOut[i] = clamp<uword>( uwords[i], 256, 65279 ); }
+                  break;
+               case 7 : for( dword i = 0;  i < COUNT;  ++i ) {
+                  uwordsOut[i] = clamp_<uword>( uwords[i], 256, 65279 ); }
+                  break;
+               case 8 : clamp<uword>( &uwords[0], &uwordsOut[0], COUNT, 256,
+                  65279 );  break;
+
+               case 9 : for( dword i = 0;  i < COUNT;  ++i ) {
+                  floatsOut[i] = (clamp( floats[i], 0.0f, 1.0f ) * 255.0f) +
+                     0.5f; }  break;
+               case 10 : for( dword i = 0;  i < COUNT;  ++i ) {
+                  floatsOut[i] = (clamp_( floats[i], 0.0f, 1.0f ) * 255.0f) +
+                     0.5f; }  break;
+               case 11 : clampScale( &floats[0], &floatsOut[0], COUNT, 0.0f,
+                  1.0f, 255.0f, 0.5f );  break;
+            }
+         }
+         times[f][k] = stopwatch.getSeconds();
+      }
+   }
+
+   static const char* NAMES[] = { "float        ", "dword        ",
+      "uword        ", "float, scale " };
+
+   const double scale = 1e3 / static_cast<double>(TIMES);
+   out << std::fixed << std::setprecision( 2 ) << "benchmark  (ms per "
+      "1920x1080 RGB frame: clamp, clamp_, array)\n";
+   for( dword f = 0;  f < 4;  ++f )
+   {
+      out << "   " << NAMES[f] << (times[f][0] * scale) << "  " <<
+         (times[f][1] * scale) << "  " << (times[f][2] * scale) << "\n";
+   }
+   out << "   (check " << floatsOut[7] << " " << dwordsOut[7] << " " <<
+      uwordsOut[7] << ")\n\n" << std::setprecision( 6 );
+}
+
+}
+
+
+namespace hxa7241_general
+{
+
+
+bool test_Clamps
+(
+   std::ostream* pOut,
+   const bool    isVerbose,
+   const dword   seed
+)
+{
+   bool isOk = true;
+
+   if( pOut ) *pOut << "[ test_Clamps ]\n\n";
+
+
+   // one at a time
+   {
+      bool is = true;
+
+      is &= (clamp( 5, 0, 3 ) == 3) & (clamp( -5, 0, 3 ) == 0) &
+         (clamp( 2, 0, 3 ) == 2);
+      is &= (clampMin( -1.0f, 0.0f ) == 0.0f) & (clampMax( 2.0f, 1.0f ) ==
+         1.0f) & (clampMin( 0.5f, 0.0f ) == 0.5f);
+      is &= (clamp01o( 1.0f ) == FLOAT_ALMOST_ONE) & (clamp01o( -1.0f ) ==
+         0.0f) & (clamp01o( 0.25f ) == 0.25f);
+      is &= (clamp01c( 1.5f ) == 1.0f) & (clamp01c( -1.0f ) == 0.0f) &
+         (clamp01c( 1.0f ) == 1.0f);
+
+      if( pOut ) *pOut << "one : " <<
+         (is ? "--- succeeded" : "*** failed") << "\n\n";
+
+      isOk &= is;
+   }
+
+   // arrays
+   {
+      bool is = true;
+      std::ostream* pOutV = (pOut && isVerbose) ? pOut : 0;
+
+      static const dword COUNT = 1000;
+      udword state = static_cast<udword>(seed) + 1u;
+
+      // (edges, then random)
+      static const float EDGES[] = { 0.0f, -0.0f, 1.0f, FLOAT_ALMOST_ONE,
+         1.0f - (FLT_EPSILON / 2.0f), -1.0f, 2.0f, FLT_MAX, -FLT_MAX,
+         FLT_MIN };
+      std::vector<float> floats( EDGES, EDGES + (sizeof(EDGES) /
+         sizeof(EDGES[0])) );
+      std::vector<dword> dwords;
+      std::vector<uword> uwords;
+      for( dword i = 0;  i < COUNT;  ++i )
+      {
+         const udword r = nextRandom( state );
+         floats.push_back( (static_cast<float>(r >> 8) * (6.0f / 16777216.0f))
+            - 3.0f );
+         dwords.push_back( static_cast<dword>(nextRandom( state )) );
+         uwords.push_back( static_cast<uword>(r >> 16) );
+      }
+      dwords.push_back( DWORD_MIN );
+      dwords.push_back( DWORD_MAX );
+
+      is &= testArray( pOutV, floats, -1.0f, 2.0f );
+      is &= testArray( pOutV, floats, 0.0f, 1.0f );
+      is &= testArray( pOutV, floats, 0.5f, 0.5f );
+      is &= testArray( pOutV, dwords, -1000, 123456 );
+      is &= testArray( pOutV, dwords, DWORD_MIN, DWORD_MAX );
+      is &= testArray( pOutV, dwords, -7, -7 );
+      is &= testArray<uword>( pOutV, uwords, 100, 60000 );
+      is &= testArray<uword>( pOutV, uwords, 0, UWORD_MAX );
+      is &= testArray<uword>( pOutV, uwords, 40000, 40001 );
+
+      // (a type with no specialization)
+      std::vector<word> words;
+      for( dword i = 0;  i < COUNT;  ++i )
+      {
+         words.push_back( static_cast<word>(nextRandom( state ) >> 16) );
+      }
+      is &= testArray<word>( pOutV, words, -300, 300 );
+
+      // clamp01o, clamp01c, clampScale
+      const dword count = static_cast<dword>(floats.size());
+      std::vector<float> o( count );
+      std::vector<float> c( count );
+      std::vector<float> s( count );
+      for( dword length = 0;  length < 20;  ++length )
+      {
+         const dword n = (0 == length) ? count : length;
+         clamp01o( &floats[0], &o[0], n );
+         clamp01c( &floats[0], &c[0], n );
+         clampScale( &floats[0], &s[0], n, 0.0f, 1.0f, 255.0f, 0.5f );
+
+         for( dword i = 0;  i < n;  ++i )
+         {
+            is &= (o[i] == clamp01o_( floats[i] )) &
+               (c[i] == clamp01c_( floats[i] )) &
+               (s[i] == ((clamp_( floats[i], 0.0f, 1.0f ) * 255.0f) + 0.5f));
+         }
+      }
+
+      // NaNs give min, in vector body and remainder alike
+      static const udword NAN_BITS[] = { 0x7FC00000u, 0xFFC00000u,
+         0x7F800001u };
+      std::vector<float> nans( floats.begin(), floats.begin() + 40 );
+      for( dword i = 0;  i < 40;  i += 3 )
+      {
+         std::memcpy( &nans[i], &NAN_BITS[(i / 3) % 3], sizeof(float) );
+      }
+      for( dword length = 0;  length <= 40;  ++length )
+      {
+         std::vector<float> f( 40 );
+         clamp( &nans[0], &f[0], length, -1.0f, 2.0f );
+         clamp01o( &nans[0], &o[0], length );
+         clamp01c( &nans[0], &c[0], length );
+         clampScale( &nans[0], &s[0], length, 0.0f, 1.0f, 255.0f, 0.5f );
+
+         for( dword i = 0;  i < length;  ++i )
+         {
+            const bool isN = isNan( nans[i] );
+            is &= (f[i] == (isN ? -1.0f : clamp_( nans[i], -1.0f, 2.0f ))) &
+               (o[i] == (isN ? 0.0f : clamp01o_( nans[i] ))) &
+               (c[i] == (isN ? 0.0f : clamp01c_( nans[i] ))) &
+               (s[i] == (isN ? 0.5f : ((clamp_( nans[i], 0.0f, 1.0f ) *
+               255.0f) + 0.5f)));
+         }
+      }
+
+      if( pOut ) *pOut << "arrays : " <<
+         (is ? "--- succeeded" : "*** failed") << "\n\n";
+
+      isOk &= is;
+   }
+
+   if( pOut && isVerbose ) benchmark( *pOut );
+
+
+   if( pOut ) *pOut << (isOk ? "--- successfully" : "*** failurefully") <<
+      " completed " << "\n\n\n";
+
+   if( pOut ) pOut->flush();
+
+
+   return isOk;
+}
+
+
 }//namespace
+
+
+#endif//TESTING
@@ -54,6 +54,66 @@ float clamp01o_( float );
 float clamp01c_( float );
 
 
+/// arrays ///
+
+/**
+ * Arrays: count numbers from pIn, results to pOut (which may be pIn).<br/><br/>
+ *
+ * Same results as one at a time, except that float NaNs give min (0 for
+ * clamp01o and clamp01c). Specialized for float, dword and uword, to use
+ * SSE2 or AVX2 min and max when compiled for them -- other types go one at a
+ * time. min must not be greater than max.
+ */
+template<class TYPE>
+void clamp( const TYPE* pIn,
+            TYPE*       pOut,
+            dword       count,
+            TYPE        min,
+            TYPE        max );
+
+template<>
+void clamp( const float* pIn,
+            float*       pOut,
+            dword        count,
+            float        min,
+            float        max );
+
+template<>
+void clamp( const dword* pIn,
+            dword*       pOut,
+            dword        count,
+            dword        min,
+            dword        max );
+
+template<>
+void clamp( const uword* pIn,
+            uword*       pOut,
+            dword        count,
+            uword        min,
+            uword        max );
+
+void clamp01o( const float* pIn,
+               float*       pOut,
+               dword        count );
+
+void clamp01c( const float* pIn,
+               float*       pOut,
+               dword        count );
+
+/**
+ * Fused clamp, scale, and offset: ( clamp_( f, min, max ) * scale ) + offset.
+ * Eg. for quantizing: clamp to [0,1], scale by the maximum integer, and offset
+ * by 0.5 to round when truncated.
+ */
+void clampScale( const float* pIn,
+                 float*       pOut,
+                 dword        count,
+                 float        min,
+                 float        max,
+                 float        scale,
+                 float        offset );
+
+
 
 
 /// INLINES ///
@@ -152,6 +212,27 @@ float clamp01c_
 }
 
 
+
+
+/// TEMPLATES ///
+
+template<class TYPE>
+void clamp
+(
+   const TYPE* pIn,
+   TYPE*       pOut,
+   const dword count,
+   const TYPE  min,
+   const TYPE  max
+)
+{
+   for( dword i = 0;  i < count;  ++i )
+   {
+      pOut[i] = clamp_( pIn[i], min, max );
+   }
+}
+
+
 }//namespace
 
 
@@ -8,11 +8,241 @@
 ------------------------------------------------------------------------------*/
 
 
+/// conditional compilations
+#if defined(__AVX2__)
+#define FPTOINT_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (_M_IX86_FP >= 2)
+#define FPTOINT_SSE2
+#include <emmintrin.h>
+#endif
+
 #include "FpToInt.hpp"
 
 
 
 
+/// implementation /////////////////////////////////////////////////////////////
+namespace
+{
+using namespace hxa7241_general;
+
+
+/// scalar forms of the clamped arrays
+
+inline
+word clampWord
+(
+   const dword d
+)
+{
+   return static_cast<word>( (d < WORD_MIN) ? WORD_MIN :
+      ((d > WORD_MAX) ? WORD_MAX : d) );
+}
+
+
+inline
+dword clampUnsigned
+(
+   const dword d,
+   const dword max
+)
+{
+   return (d < 0) ? 0 : ((d > max) ? max : d);
+}
+
+
+/// vector forms of the scalar parts
+///
+/// * truncate: cvttps2dq gives 0x80000000 for all out of range, so the too
+///   big are flipped to 0x7FFFFFFF, as fpToIntTrunc clamps
+/// * addHalf: the addition in fpToIntRound, with the sign taken from f (-0
+///   gets -0.5 instead of +0.5, but still truncates to 0)
+/// * clampTruncate: clamping before truncating is the same as after, for
+///   whole-number bounds
+
+const dword SIGN_BIT    = static_cast<dword>(0x80000000u);
+const float WORD_LOWER  = static_cast<float>(WORD_MIN);
+const float WORD_UPPER  = static_cast<float>(WORD_MAX);
+const float UWORD_UPPER = static_cast<float>(UWORD_MAX);
+const float UBYTE_UPPER = static_cast<float>(UBYTE_MAX);
+
+#if defined(FPTOINT_AVX2)
+
+inline
+__m256i truncate
+(
+   const __m256 f
+)
+{
+   const __m256 isOver = _mm256_cmp_ps( f, _mm256_set1_ps( 2147483648.0f ),
+      _CMP_GE_OQ );
+
+   return _mm256_xor_si256( _mm256_cvttps_epi32( f ),
+      _mm256_castps_si256( isOver ) );
+}
+
+
+inline
+__m256 addHalf
+(
+   const __m256 f
+)
+{
+   const __m256 sign = _mm256_and_ps( f, _mm256_castsi256_ps(
+      _mm256_set1_epi32( SIGN_BIT ) ) );
+
+   return _mm256_add_ps( f, _mm256_or_ps( sign, _mm256_set1_ps( 0.5f ) ) );
+}
+
+
+inline
+__m256i clampTruncate
+(
+   const __m256 f,
+   const float  lower,
+   const float  upper
+)
+{
+   return _mm256_cvttps_epi32( _mm256_min_ps( _mm256_max_ps( f,
+      _mm256_set1_ps( lower ) ), _mm256_set1_ps( upper ) ) );
+}
+
+#elif defined(FPTOINT_SSE2)
+
+inline
+__m128i truncate
+(
+   const __m128 f
+)
+{
+   const __m128 isOver = _mm_cmpge_ps( f, _mm_set1_ps( 2147483648.0f ) );
+
+   return _mm_xor_si128( _mm_cvttps_epi32( f ), _mm_castps_si128( isOver ) );
+}
+
+
+inline
+__m128 addHalf
+(
+   const __m128 f
+)
+{
+   const __m128 sign = _mm_and_ps( f, _mm_castsi128_ps(
+      _mm_set1_epi32( SIGN_BIT ) ) );
+
+   return _mm_add_ps( f, _mm_or_ps( sign, _mm_set1_ps( 0.5f ) ) );
+}
+
+
+inline
+__m128i clampTruncate
+(
+   const __m128 f,
+   const float  lower,
+   const float  upper
+)
+{
+   return _mm_cvttps_epi32( _mm_min_ps( _mm_max_ps( f,
+      _mm_set1_ps( lower ) ), _mm_set1_ps( upper ) ) );
+}
+
+#endif
+
+
+void toDwords
+(
+   const float* pIn,
+   dword*       pOut,
+   const dword  count,
+   const bool   isRound
+)
+{
+   dword i = 0;
+
+#if defined(FPTOINT_AVX2)
+   for( ;  (i + 8) <= count;  i += 8 )
+   {
+      __m256 f = _mm256_loadu_ps( pIn + i );
+      if( isRound ) f = addHalf( f );
+
+      _mm256_storeu_si256( reinterpret_cast<__m256i*>(pOut + i),
+         truncate( f ) );
+   }
+#elif defined(FPTOINT_SSE2)
+   for( ;  (i + 4) <= count;  i += 4 )
+   {
+      __m128 f = _mm_loadu_ps( pIn + i );
+      if( isRound ) f = addHalf( f );
+
+      _mm_storeu_si128( reinterpret_cast<__m128i*>(pOut + i), truncate( f ) );
+   }
+#endif
+
+   for( ;  i < count;  ++i )
+   {
+      pOut[i] = isRound ? fpToIntRound( pIn[i] ) : fpToIntTrunc( pIn[i] );
+   }
+}
+
+
+void toWords
+(
+   const float* pIn,
+   word*        pOut,
+   const dword  count,
+   const bool   isRound
+)
+{
+   dword i = 0;
+
+#if defined(FPTOINT_AVX2)
+   for( ;  (i + 16) <= count;  i += 16 )
+   {
+      __m256 f0 = _mm256_loadu_ps( pIn + i );
+      __m256 f1 = _mm256_loadu_ps( pIn + i + 8 );
+      if( isRound )
+      {
+         f0 = addHalf( f0 );
+         f1 = addHalf( f1 );
+      }
+
+      // (packs interleaves the 128-bit lanes: 64-bit permute puts back)
+      const __m256i w = _mm256_packs_epi32(
+         clampTruncate( f0, WORD_LOWER, WORD_UPPER ),
+         clampTruncate( f1, WORD_LOWER, WORD_UPPER ) );
+      _mm256_storeu_si256( reinterpret_cast<__m256i*>(pOut + i),
+         _mm256_permute4x64_epi64( w, 0xD8 ) );
+   }
+#elif defined(FPTOINT_SSE2)
+   for( ;  (i + 8) <= count;  i += 8 )
+   {
+      __m128 f0 = _mm_loadu_ps( pIn + i );
+      __m128 f1 = _mm_loadu_ps( pIn + i + 4 );
+      if( isRound )
+      {
+         f0 = addHalf( f0 );
+         f1 = addHalf( f1 );
+      }
+
+      _mm_storeu_si128( reinterpret_cast<__m128i*>(pOut + i), _mm_packs_epi32(
+         clampTruncate( f0, WORD_LOWER, WORD_UPPER ),
+         clampTruncate( f1, WORD_LOWER, WORD_UPPER ) ) );
+   }
+#endif
+
+   for( ;  i < count;  ++i )
+   {
+      pOut[i] = clampWord( isRound ? fpToIntRound( pIn[i] ) :
+         fpToIntTrunc( pIn[i] ) );
+   }
+}
+
+}
+
+
+
+
 namespace hxa7241_general
 {
 
@@ -76,6 +306,153 @@ dword fpToIntTrunc
 
 
 
+void fpToIntTrunc
+(
+   const float* pIn,
+   dword*       pOut,
+   const dword  count
+)
+{
+   toDwords( pIn, pOut, count, false );
+}
+
+
+void fpToIntRound
+(
+   const float* pIn,
+   dword*       pOut,
+   const dword  count
+)
+{
+   toDwords( pIn, pOut, count, true );
+}
+
+
+void fpToWordTrunc
+(
+   const float* pIn,
+   word*        pOut,
+   const dword  count
+)
+{
+   toWords( pIn, pOut, count, false );
+}
+
+
+void fpToWordRound
+(
+   const float* pIn,
+   word*        pOut,
+   const dword  count
+)
+{
+   toWords( pIn, pOut, count, true );
+}
+
+
+void fp01ToWord
+(
+   const float* pIn,
+   uword*       pOut,
+   const dword  count
+)
+{
+   dword i = 0;
+
+#if defined(FPTOINT_AVX2)
+   const __m256 scale = _mm256_set1_ps( 65536.0f );
+
+   for( ;  (i + 16) <= count;  i += 16 )
+   {
+      const __m256i w = _mm256_packus_epi32(
+         clampTruncate( _mm256_mul_ps( _mm256_loadu_ps( pIn + i ), scale ),
+            0.0f, UWORD_UPPER ),
+         clampTruncate( _mm256_mul_ps( _mm256_loadu_ps( pIn + i + 8 ), scale ),
+            0.0f, UWORD_UPPER ) );
+      _mm256_storeu_si256( reinterpret_cast<__m256i*>(pOut + i),
+         _mm256_permute4x64_epi64( w, 0xD8 ) );
+   }
+#elif defined(FPTOINT_SSE2)
+   // (no unsigned 32-to-16 pack in SSE2: offset to signed, pack, offset back)
+   const __m128  scale  = _mm_set1_ps( 65536.0f );
+   const __m128i offset = _mm_set1_epi32( 32768 );
+
+   for( ;  (i + 8) <= count;  i += 8 )
+   {
+      const __m128i d0 = _mm_sub_epi32( clampTruncate( _mm_mul_ps(
+         _mm_loadu_ps( pIn + i ), scale ), 0.0f, UWORD_UPPER ), offset );
+      const __m128i d1 = _mm_sub_epi32( clampTruncate( _mm_mul_ps(
+         _mm_loadu_ps( pIn + i + 4 ), scale ), 0.0f, UWORD_UPPER ), offset );
+
+      _mm_storeu_si128( reinterpret_cast<__m128i*>(pOut + i), _mm_xor_si128(
+         _mm_packs_epi32( d0, d1 ), _mm_set1_epi16( WORD_MIN ) ) );
+   }
+#endif
+
+   for( ;  i < count;  ++i )
+   {
+      pOut[i] = static_cast<uword>( clampUnsigned(
+         fpToIntTrunc( pIn[i] * 65536.0f ), UWORD_MAX ) );
+   }
+}
+
+
+void fp01ToByte
+(
+   const float* pIn,
+   ubyte*       pOut,
+   const dword  count
+)
+{
+   dword i = 0;
+
+#if defined(FPTOINT_AVX2)
+   const __m256  scale = _mm256_set1_ps( 256.0f );
+   // (two packs interleave the 128-bit lanes: 32-bit permute puts back)
+   const __m256i order = _mm256_setr_epi32( 0, 4, 1, 5, 2, 6, 3, 7 );
+
+   for( ;  (i + 32) <= count;  i += 32 )
+   {
+      __m256i d[4];
+      for( dword j = 0;  j < 4;  ++j )
+      {
+         d[j] = clampTruncate( _mm256_mul_ps( _mm256_loadu_ps( pIn + i +
+            (j * 8) ), scale ), 0.0f, UBYTE_UPPER );
+      }
+
+      const __m256i b = _mm256_packus_epi16( _mm256_packs_epi32( d[0], d[1] ),
+         _mm256_packs_epi32( d[2], d[3] ) );
+      _mm256_storeu_si256( reinterpret_cast<__m256i*>(pOut + i),
+         _mm256_permutevar8x32_epi32( b, order ) );
+   }
+#elif defined(FPTOINT_SSE2)
+   const __m128 scale = _mm_set1_ps( 256.0f );
+
+   for( ;  (i + 16) <= count;  i += 16 )
+   {
+      __m128i d[4];
+      for( dword j = 0;  j < 4;  ++j )
+      {
+         d[j] = clampTruncate( _mm_mul_ps( _mm_loadu_ps( pIn + i + (j * 4) ),
+            scale ), 0.0f, UBYTE_UPPER );
+      }
+
+      _mm_storeu_si128( reinterpret_cast<__m128i*>(pOut + i),
+         _mm_packus_epi16( _mm_packs_epi32( d[0], d[1] ),
+         _mm_packs_epi32( d[2], d[3] ) ) );
+   }
+#endif
+
+   for( ;  i < count;  ++i )
+   {
+      pOut[i] = static_cast<ubyte>( clampUnsigned(
+         fpToIntTrunc( pIn[i] * 256.0f ), UBYTE_MAX ) );
+   }
+}
+
+
+
+
 const float FRACTIONALIZER::_16BIT =       1.0f / 16777216.0f;
 const float FRACTIONALIZER::_8BIT  =   65793.0f / 16777216.0f;
 const float FRACTIONALIZER::_4BIT  = 1118481.0f / 16777216.0f;
@@ -95,7 +472,13 @@ const float FRACTIONALIZER::_4BIT  = 1118481.0f / 16777216.0f;
 
 
 #include <math.h>
+#include <float.h>
+#include <cstring>
 #include <iostream>
+#include <iomanip>
+#include <vector>
+
+#include "Stopwatch.hpp"
 
 
 namespace hxa7241_general
@@ -167,6 +550,153 @@ static dword getRand2()
 
 
 
+/// scalar references for the clamped arrays
+
+static dword clampTo
+(
+   const dword d,
+   const dword lower,
+   const dword upper
+)
+{
+   return (d < lower) ? lower : ((d > upper) ? upper : d);
+}
+
+
+/// arrays against one at a time, for every length, offset, and form
+static bool testArrays
+(
+   std::ostream*             pOut,
+   const std::vector<float>& numbers
+)
+{
+   bool isOk = true;
+
+   const dword count = static_cast<dword>(numbers.size());
+   std::vector<dword> dwords( count );
+   std::vector<word>  words( count );
+   std::vector<uword> uwords( count );
+   std::vector<ubyte> ubytes( count );
+
+   // short lengths and offsets exercise the scalar remainders
+   for( dword k = 0;  k < 2;  ++k )
+   {
+      for( dword length = 0;  length < 70;  ++length )
+      {
+         const dword offset = (length * 7) % 5;
+         const dword n      = (0 == length) ? (count - offset) : length;
+         const float* pIn   = &numbers[0] + offset;
+
+         if( 0 == k ) fpToIntTrunc( pIn, &dwords[0], n );
+         else         fpToIntRound( pIn, &dwords[0], n );
+         if( 0 == k ) fpToWordTrunc( pIn, &words[0], n );
+         else         fpToWordRound( pIn, &words[0], n );
+         fp01ToWord( pIn, &uwords[0], n );
+         fp01ToByte( pIn, &ubytes[0], n );
+
+         for( dword i = 0;  i < n;  ++i )
+         {
+            const float f = pIn[i];
+            const dword d = (0 == k) ? fpToIntTrunc( f ) : fpToIntRound( f );
+            const dword u16 = clampTo( fpToIntTrunc( f * 65536.0f ), 0,
+               UWORD_MAX );
+            const dword u8  = clampTo( fpToIntTrunc( f * 256.0f ), 0,
+               UBYTE_MAX );
+
+            bool is = (dwords[i] == d) &
+               (words[i] == clampTo( d, WORD_MIN, WORD_MAX )) &
+               (uwords[i] == u16) & (ubytes[i] == u8);
+
+            // in [0,1): same as the unclamped scalars
+            if( (f >= 0.0f) & (f < 1.0f) )
+            {
+               is &= (uwords[i] == fp01ToWord( f )) &
+                  (ubytes[i] == fp01ToByte( f ));
+            }
+
+            if( pOut && !is ) *pOut << k << " " << length << " " << i <<
+               "  " << f << "  " << dwords[i] << " " << d << "  " <<
+               words[i] << "  " << uwords[i] << " " << u16 << "  " <<
+               static_cast<dword>(ubytes[i]) << " " << u8 << "\n";
+            isOk &= is;
+         }
+      }
+   }
+
+   return isOk;
+}
+
+
+/// a full-HD RGB frame, scalar against array
+static void benchmark
+(
+   std::ostream& out
+)
+{
+   static const dword COUNT = 1920 * 1080 * 3;
+   static const dword TIMES = 4;
+
+   // (a little outside [0,1), as out of a filter)
+   std::vector<float> numbers( COUNT );
+   for( dword i = 0;  i < COUNT;  ++i )
+   {
+      numbers[i] = (static_cast<float>(getRand2() & 0xFFFFFF) *
+         (1.2f / 16777216.0f)) - 0.1f;
+   }
+   std::vector<dword> dwords( COUNT );
+   std::vector<word>  words( COUNT );
+   std::vector<ubyte> ubytes( COUNT );
+
+   // (changing an input each time, so the work is not hoisted)
+   double times[3][2];
+   Stopwatch stopwatch;
+
+   for( dword f = 0;  f < 3;  ++f )
+   {
+      for( dword k = 0;  k < 2;  ++k )
+      {
+         stopwatch.start();
+         for( dword t = TIMES;  t-- > 0; )
+         {
+            numbers[t] += 1e-3f;
+            switch( (f * 2) + k )
+            {
+               case 0 : for( dword i = 0;  i < COUNT;  ++i ) {
+                  dwords[i] = fpToIntRound( numbers[i] ); }  break;
+               case 1 : fpToIntRound( &numbers[0], &dwords[0], COUNT );  break;
+
+               case 2 : for( dword i = 0;  i < COUNT;  ++i ) {
+                  words[i] = static_cast<word>( clampTo( fpToIntRound(
+                     numbers[i] ), WORD_MIN, WORD_MAX ) ); }  break;
+               case 3 : fpToWordRound( &numbers[0], &words[0], COUNT );  break;
+
+               case 4 : for( dword i = 0;  i < COUNT;  ++i ) {
+                  ubytes[i] = static_cast<ubyte>( clampTo( fp01ToByte(
+                     numbers[i] ), 0, UBYTE_MAX ) ); }  break;
+               case 5 : fp01ToByte( &numbers[0], &ubytes[0], COUNT );  break;
+            }
+         }
+         times[f][k] = stopwatch.getSeconds();
+      }
+   }
+
+   static const char* NAMES[] = { "fpToIntRound  ", "fpToWordRound ",
+      "fp01ToByte    " };
+
+   const double scale = 1e3 / static_cast<double>(TIMES);
+   out << std::fixed << std::setprecision( 2 ) << "benchmark  (ms per "
+      "1920x1080 RGB frame: one at a time, array)\n";
+   for( dword f = 0;  f < 3;  ++f )
+   {
+      out << "   " << NAMES[f] << (times[f][0] * scale) << "  " <<
+         (times[f][1] * scale) << "\n";
+   }
+   out << "   (check " << dwords[7] << " " << words[7] << " " <<
+      static_cast<dword>(ubytes[7]) << ")\n\n" << std::setprecision( 6 );
+}
+
+
+
 bool test_FpToInt
 (
    std::ostream* pOut,
@@ -436,6 +966,54 @@ bool test_FpToInt
    }
 
 
+   // arrays
+   {
+      bool isOk_ = true;
+
+      // edges: halves, word and dword range, [0,1) ends
+      static const float EDGES[] = { 0.0f, 0.5f, 0.49999997f, 1.5f, 2.5f,
+         FLOAT_ALMOST_ONE, 1.0f, 255.5f / 256.0f, 32767.5f, 32768.0f,
+         32768.5f, 65535.5f, 65536.0f, 2147483520.0f, 2147483648.0f,
+         4294967296.0f, 1e30f, FLT_MAX, FLT_MIN, 1e-30f };
+
+      std::vector<float> numbers;
+      for( dword i = 0;  i < static_cast<dword>(sizeof(EDGES) /
+         sizeof(EDGES[0]));  ++i )
+      {
+         numbers.push_back( EDGES[i] );
+         numbers.push_back( -EDGES[i] );
+      }
+
+      // random: any (finite) bits, and scaled to each range
+      static const float SCALES[] = { 1.0f, 1.2f, 300.0f, 70000.0f, 3e9f };
+      for( dword i = 0;  i < 20000;  ++i )
+      {
+         float f = 0.0f;
+         if( 0 == (i & 1) )
+         {
+            const udword bits = static_cast<udword>(getRand2());
+            if( 0x7F800000u == (bits & 0x7F800000u) ) continue;
+            std::memcpy( &f, &bits, sizeof(f) );
+         }
+         else
+         {
+            f = static_cast<float>(getRand2()) * (SCALES[(i >> 1) % 5] /
+               2147483648.0f);
+         }
+         numbers.push_back( f );
+      }
+
+      isOk_ &= testArrays( (pOut && isVerbose) ? pOut : 0, numbers );
+
+      if( pOut ) *pOut << "arrays : " <<
+         (isOk_ ? "--- succeeded" : "*** failed") << "\n\n";
+
+      isOk &= isOk_;
+   }
+
+   if( pOut && isVerbose ) benchmark( *pOut );
+
+
    if( pOut ) *pOut << (isOk ? "--- successfully" : "*** failurefully") <<
       " completed " << "\n\n\n";
 
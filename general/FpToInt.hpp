@@ -151,6 +151,49 @@ dword fp01ToNybble
 
 
 
+/// arrays ---------------------------------------------------------------------
+/**
+ * Arrays: count floats from pIn, results to pOut.<br/><br/>
+ *
+ * Same results as one at a time, bit for bit, but in SSE2 or AVX2 registers
+ * when compiled for them. NaNs produce undefined results.
+ */
+void fpToIntTrunc( const float* pIn,
+                   dword*       pOut,
+                   dword        count );
+
+void fpToIntRound( const float* pIn,
+                   dword*       pOut,
+                   dword        count );
+
+
+/**
+ * As fpToIntTrunc and fpToIntRound, then clamped to word range.
+ */
+void fpToWordTrunc( const float* pIn,
+                    word*        pOut,
+                    dword        count );
+
+void fpToWordRound( const float* pIn,
+                    word*        pOut,
+                    dword        count );
+
+
+/**
+ * As fp01ToWord and fp01ToByte, but floats outside [0-1) are clamped: to 0,
+ * and UWORD_MAX or UBYTE_MAX.
+ */
+void fp01ToWord( const float* pIn,
+                 uword*       pOut,
+                 dword        count );
+
+void fp01ToByte( const float* pIn,
+                 ubyte*       pOut,
+                 dword        count );
+
+
+
+
 /// int to fp ------------------------------------------------------------------
 struct FRACTIONALIZER
 {
@@ -0,0 +1,894 @@
+/*------------------------------------------------------------------------------
+
+   HXA7241 General library.
+   Copyright (c) 2004-2007,  Harrison Ainsworth / HXA7241.
+
+   http://www.hxa7241.org/
+
+------------------------------------------------------------------------------*/
+
+
+/// conditional compilations
+// (MSVC has no __F16C__, but all AVX2 processors have F16C)
+#if defined(__F16C__) || (defined(_MSC_VER) && defined(__AVX2__))
+#define HALF_F16C
+#endif
+#if defined(__AVX2__)
+#define HALF_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (_M_IX86_FP >= 2)
+#define HALF_SSE2
+#include <emmintrin.h>
+#endif
+#if defined(HALF_F16C) && !defined(HALF_AVX2)
+#include <immintrin.h>
+#endif
+
+#include <cstring>
+
+#include "Half.hpp"
+
+
+using namespace hxa7241_general;
+
+
+
+
+/// implementation /////////////////////////////////////////////////////////////
+namespace
+{
+
+inline
+udword floatToBits
+(
+   const float f
+)
+{
+   udword u;
+   std::memcpy( &u, &f, sizeof(u) );
+   return u;
+}
+
+
+inline
+float bitsToFloat
+(
+   const udword u
+)
+{
+   float f;
+   std::memcpy( &f, &u, sizeof(f) );
+   return f;
+}
+
+
+/// float to half, for one sign-and-exponent
+///
+/// the fraction (with the implicit 1, for results below half normal range)
+/// is shifted down, rounding to nearest even, and added to a base of sign and
+/// exponent -- so rounding up can carry into the exponent, up to infinity
+///
+/// * exponent > 142: too big, base infinity, shift out everything
+/// * exponent 113 to 142: normal, shift 13
+/// * exponent 102 to 112: subnormal, shift 14 to 24
+/// * exponent < 102: under half the smallest subnormal, shift out everything
+///   (NaN is done separately)
+
+inline
+void halfBaseShift
+(
+   const udword signExponent,
+   udword&      base,
+   udword&      shift
+)
+{
+   const udword sign     = (signExponent & 0x100u) << 7;
+   const udword exponent = signExponent & 0xFFu;
+
+   if( exponent > 142u )
+   {
+      base  = sign | 0x7C00u;
+      shift = 25u;
+   }
+   else if( exponent >= 113u )
+   {
+      base  = sign | ((exponent - 112u) << 10);
+      shift = 13u;
+   }
+   else if( exponent >= 102u )
+   {
+      base  = sign;
+      shift = 126u - exponent;
+   }
+   else
+   {
+      base  = sign;
+      shift = 25u;
+   }
+}
+
+
+inline
+udword halfRound
+(
+   const udword bits,
+   const udword base,
+   const udword shift
+)
+{
+   const udword fraction = (bits & 0x007FFFFFu) | ((shift > 13u) ?
+      0x00800000u : 0u);
+
+   return base + ((fraction + ((1u << (shift - 1u)) - 1u) +
+      ((fraction >> shift) & 1u)) >> shift);
+}
+
+
+inline
+bool isNan
+(
+   const udword bits
+)
+{
+   return (bits & 0x7FFFFFFFu) > 0x7F800000u;
+}
+
+
+inline
+uword halfNan
+(
+   const udword bits
+)
+{
+   return static_cast<uword>( ((bits >> 16) & 0x8000u) | 0x7E00u |
+      ((bits & 0x007FFFFFu) >> 13) );
+}
+
+
+#if !defined(HALF_F16C)
+
+/// lookup tables (after van der Meulen, 'Fast Half Float Conversions')
+///
+/// half to float: exponent by sign-and-exponent, plus mantissa by offset (per
+/// sign-and-exponent) and fraction. mantissas are three blocks: subnormals
+/// (whole float bits), normals, and infinity and NaNs (made quiet).
+///
+/// float to half: base and shift by float sign-and-exponent, as above.
+
+struct Tables
+{
+   Tables();
+
+   udword toFloatMantissa[3072];
+   udword toFloatExponent[64];
+   uword  toFloatOffset[64];
+
+   uword  toHalfBase[512];
+   ubyte  toHalfShift[512];
+};
+
+
+Tables::Tables()
+{
+   for( udword i = 0;  i < 1024;  ++i )
+   {
+      toFloatMantissa[i]        = floatToBits( halfToFloat(
+         static_cast<uword>(i) ) );
+      toFloatMantissa[i + 1024] = i << 13;
+      toFloatMantissa[i + 2048] = (0 == i) ? 0u : ((i << 13) | 0x00400000u);
+   }
+
+   for( udword i = 0;  i < 64;  ++i )
+   {
+      const udword sign     = (i & 32u) << 26;
+      const udword exponent = i & 31u;
+
+      toFloatExponent[i] = sign | ((0 == exponent) ? 0u : ((31 == exponent) ?
+         0x7F800000u : ((exponent + 112u) << 23)));
+      toFloatOffset[i]   = static_cast<uword>( (0 == exponent) ? 0u :
+         ((31 == exponent) ? 2048u : 1024u) );
+   }
+
+   for( udword i = 0;  i < 512;  ++i )
+   {
+      udword base  = 0;
+      udword shift = 0;
+      halfBaseShift( i, base, shift );
+
+      toHalfBase[i]  = static_cast<uword>(base);
+      toHalfShift[i] = static_cast<ubyte>(shift);
+   }
+}
+
+
+const Tables& tables()
+{
+   static const Tables k;
+   return k;
+}
+
+#endif
+
+
+/// bfloat16: round to nearest even, NaNs made quiet
+inline
+uword bfloat16Round
+(
+   const udword bits
+)
+{
+   return static_cast<uword>( isNan( bits ) ? ((bits >> 16) | 0x40u) :
+      ((bits + 0x7FFFu + ((bits >> 16) & 1u)) >> 16) );
+}
+
+
+#if defined(HALF_AVX2)
+
+inline
+__m256i bfloat16Round
+(
+   const __m256i bits
+)
+{
+   const __m256i isNans = _mm256_cmpgt_epi32( _mm256_and_si256( bits,
+      _mm256_set1_epi32( 0x7FFFFFFF ) ), _mm256_set1_epi32( 0x7F800000 ) );
+
+   const __m256i rounded = _mm256_add_epi32( bits, _mm256_add_epi32(
+      _mm256_set1_epi32( 0x7FFF ), _mm256_and_si256( _mm256_srli_epi32( bits,
+      16 ), _mm256_set1_epi32( 1 ) ) ) );
+   const __m256i quiet   = _mm256_or_si256( bits,
+      _mm256_set1_epi32( 0x00400000 ) );
+
+   // (arithmetic shift keeps each in signed 16-bit range, for packing)
+   return _mm256_srai_epi32( _mm256_or_si256( _mm256_and_si256( isNans, quiet ),
+      _mm256_andnot_si256( isNans, rounded ) ), 16 );
+}
+
+#elif defined(HALF_SSE2)
+
+inline
+__m128i bfloat16Round
+(
+   const __m128i bits
+)
+{
+   const __m128i isNans = _mm_cmpgt_epi32( _mm_and_si128( bits,
+      _mm_set1_epi32( 0x7FFFFFFF ) ), _mm_set1_epi32( 0x7F800000 ) );
+
+   const __m128i rounded = _mm_add_epi32( bits, _mm_add_epi32(
+      _mm_set1_epi32( 0x7FFF ), _mm_and_si128( _mm_srli_epi32( bits, 16 ),
+      _mm_set1_epi32( 1 ) ) ) );
+   const __m128i quiet   = _mm_or_si128( bits, _mm_set1_epi32( 0x00400000 ) );
+
+   // (arithmetic shift keeps each in signed 16-bit range, for packing)
+   return _mm_srai_epi32( _mm_or_si128( _mm_and_si128( isNans, quiet ),
+      _mm_andnot_si128( isNans, rounded ) ), 16 );
+}
+
+#endif
+
+}
+
+
+
+
+/// binary16 ///////////////////////////////////////////////////////////////////
+uword hxa7241_general::floatToHalf
+(
+   const float f
+)
+{
+   const udword bits = floatToBits( f );
+
+   if( isNan( bits ) )
+   {
+      return halfNan( bits );
+   }
+
+   udword base  = 0;
+   udword shift = 0;
+   halfBaseShift( bits >> 23, base, shift );
+
+   return static_cast<uword>( halfRound( bits, base, shift ) );
+}
+
+
+float hxa7241_general::halfToFloat
+(
+   const uword h
+)
+{
+   const udword sign     = static_cast<udword>(h & 0x8000u) << 16;
+   const udword exponent = (h >> 10) & 0x1Fu;
+   udword       fraction = h & 0x03FFu;
+
+   udword bits = 0;
+   if( 31 == exponent )
+   {
+      bits = sign | 0x7F800000u | ((0 == fraction) ? 0u :
+         ((fraction << 13) | 0x00400000u));
+   }
+   else if( 0 != exponent )
+   {
+      bits = sign | ((exponent + 112u) << 23) | (fraction << 13);
+   }
+   else if( 0 != fraction )
+   {
+      // subnormal: normalize (in integers, so flush-to-zero cannot touch it)
+      udword e = 113;
+      for( ;  0 == (fraction & 0x0400u);  fraction <<= 1, --e ) {}
+      bits = sign | (e << 23) | ((fraction & 0x03FFu) << 13);
+   }
+   else
+   {
+      bits = sign;
+   }
+
+   return bitsToFloat( bits );
+}
+
+
+void hxa7241_general::floatToHalf
+(
+   const float* pIn,
+   half*        pOut,
+   const dword  count
+)
+{
+   dword i = 0;
+
+#if defined(HALF_F16C)
+   for( ;  (i + 8) <= count;  i += 8 )
+   {
+      _mm_storeu_si128( reinterpret_cast<__m128i*>(pOut + i), _mm256_cvtps_ph(
+         _mm256_loadu_ps( pIn + i ), 0 ) );
+   }
+#else
+   const Tables& t = tables();
+
+   for( ;  i < count;  ++i )
+   {
+      const udword bits = floatToBits( pIn[i] );
+      const udword se   = bits >> 23;
+
+      pOut[i] = half::fromBits( isNan( bits ) ? halfNan( bits ) :
+         static_cast<uword>( halfRound( bits, t.toHalfBase[se],
+         t.toHalfShift[se] ) ) );
+   }
+#endif
+
+   for( ;  i < count;  ++i )
+   {
+      pOut[i] = half::fromBits( floatToHalf( pIn[i] ) );
+   }
+}
+
+
+void hxa7241_general::halfToFloat
+(
+   const half*  pIn,
+   float*       pOut,
+   const dword  count
+)
+{
+   dword i = 0;
+
+#if defined(HALF_F16C)
+   for( ;  (i + 8) <= count;  i += 8 )
+   {
+      _mm256_storeu_ps( pOut + i, _mm256_cvtph_ps( _mm_loadu_si128(
+         reinterpret_cast<const __m128i*>(pIn + i) ) ) );
+   }
+#else
+   const Tables& t = tables();
+
+   for( ;  i < count;  ++i )
+   {
+      const udword h  = pIn[i].getBits();
+      const udword se = h >> 10;
+
+      pOut[i] = bitsToFloat( t.toFloatExponent[se] +
+         t.toFloatMantissa[t.toFloatOffset[se] + (h & 0x03FFu)] );
+   }
+#endif
+
+   for( ;  i < count;  ++i )
+   {
+      pOut[i] = halfToFloat( pIn[i].getBits() );
+   }
+}
+
+
+
+
+/// bfloat16 ///////////////////////////////////////////////////////////////////
+uword hxa7241_general::floatToBfloat16
+(
+   const float f
+)
+{
+   return bfloat16Round( floatToBits( f ) );
+}
+
+
+float hxa7241_general::bfloat16ToFloat
+(
+   const uword b
+)
+{
+   return bitsToFloat( static_cast<udword>(b) << 16 );
+}
+
+
+void hxa7241_general::floatToBfloat16
+(
+   const float* pIn,
+   uword*       pOut,
+   const dword  count
+)
+{
+   dword i = 0;
+
+#if defined(HALF_AVX2)
+   for( ;  (i + 16) <= count;  i += 16 )
+   {
+      // (packs interleaves the 128-bit lanes: 64-bit permute puts back)
+      const __m256i b = _mm256_packs_epi32(
+         bfloat16Round( _mm256_loadu_si256( reinterpret_cast<const __m256i*>(
+            pIn + i) ) ),
+         bfloat16Round( _mm256_loadu_si256( reinterpret_cast<const __m256i*>(
+            pIn + i + 8) ) ) );
+      _mm256_storeu_si256( reinterpret_cast<__m256i*>(pOut + i),
+         _mm256_permute4x64_epi64( b, 0xD8 ) );
+   }
+#elif defined(HALF_SSE2)
+   for( ;  (i + 8) <= count;  i += 8 )
+   {
+      _mm_storeu_si128( reinterpret_cast<__m128i*>(pOut + i), _mm_packs_epi32(
+         bfloat16Round( _mm_loadu_si128( reinterpret_cast<const __m128i*>(
+            pIn + i) ) ),
+         bfloat16Round( _mm_loadu_si128( reinterpret_cast<const __m128i*>(
+            pIn + i + 4) ) ) ) );
+   }
+#endif
+
+   for( ;  i < count;  ++i )
+   {
+      pOut[i] = floatToBfloat16( pIn[i] );
+   }
+}
+
+
+void hxa7241_general::bfloat16ToFloat
+(
+   const uword* pIn,
+   float*       pOut,
+   const dword  count
+)
+{
+   dword i = 0;
+
+#if defined(HALF_AVX2)
+   for( ;  (i + 8) <= count;  i += 8 )
+   {
+      _mm256_storeu_si256( reinterpret_cast<__m256i*>(pOut + i),
+         _mm256_slli_epi32( _mm256_cvtepu16_epi32( _mm_loadu_si128(
+         reinterpret_cast<const __m128i*>(pIn + i) ) ), 16 ) );
+   }
+#elif defined(HALF_SSE2)
+   const __m128i zero = _mm_setzero_si128();
+
+   for( ;  (i + 8) <= count;  i += 8 )
+   {
+      // (interleaving with zeros puts each in the top half)
+      const __m128i b = _mm_loadu_si128( reinterpret_cast<const __m128i*>(
+         pIn + i) );
+      _mm_storeu_si128( reinterpret_cast<__m128i*>(pOut + i),
+         _mm_unpacklo_epi16( zero, b ) );
+      _mm_storeu_si128( reinterpret_cast<__m128i*>(pOut + i + 4),
+         _mm_unpackhi_epi16( zero, b ) );
+   }
+#endif
+
+   for( ;  i < count;  ++i )
+   {
+      pOut[i] = bfloat16ToFloat( pIn[i] );
+   }
+}
+
+
+
+
+/// test ///////////////////////////////////////////////////////////////////////
+#ifdef TESTING
+
+
+#include <math.h>
+#include <ostream>
+#include <iomanip>
+#include <vector>
+
+#include "Sheet.hpp"
+#include "Stopwatch.hpp"
+
+
+namespace
+{
+
+/// values of bit patterns (without sign), as double -- in integers, so no
+/// denormal is flushed; infinity is the next power of two, which is where
+/// rounding to it starts
+
+double floatValue
+(
+   const udword magnitude
+)
+{
+   const udword exponent = magnitude >> 23;
+   const udword fraction = magnitude & 0x007FFFFFu;
+
+   return (0 == exponent) ? ::ldexp( static_cast<double>(fraction), -149 ) :
+      ::ldexp( static_cast<double>(fraction + 0x00800000u), static_cast<int>(
+      exponent) - 150 );
+}
+
+
+double halfValue
+(
+   const udword magnitude
+)
+{
+   const udword exponent = magnitude >> 10;
+   const udword fraction = magnitude & 0x03FFu;
+
+   return (0 == exponent) ? ::ldexp( static_cast<double>(fraction), -24 ) :
+      ::ldexp( static_cast<double>(fraction + 1024u), static_cast<int>(
+      exponent) - 25 );
+}
+
+
+double bfloat16Value
+(
+   const udword magnitude
+)
+{
+   return floatValue( magnitude << 16 );
+}
+
+
+/// nearest, ties to even: among the neighbours (of the same sign)
+bool isNearest
+(
+   const double x,
+   const udword magnitude,
+   const udword max,
+   double       (*value)( udword )
+)
+{
+   const double d = ::fabs( x - value( magnitude ) );
+
+   bool is = true;
+   if( magnitude > 0 )
+   {
+      const double below = ::fabs( x - value( magnitude - 1 ) );
+      is &= (d < below) | ((d == below) & (0 == (magnitude & 1)));
+   }
+   if( magnitude < max )
+   {
+      const double above = ::fabs( x - value( magnitude + 1 ) );
+      is &= (d < above) | ((d == above) & (0 == (magnitude & 1)));
+   }
+
+   return is;
+}
+
+
+/// every half: to float, exactly, and back
+bool testHalfToFloat
+(
+   std::ostream* pOut
+)
+{
+   bool isOk = true;
+
+   std::vector<half>  halfs( 65536 );
+   std::vector<float> floats( 65536 );
+   for( udword h = 0;  h < 65536;  ++h )
+   {
+      halfs[h] = half::fromBits( static_cast<uword>(h) );
+   }
+   halfToFloat( &halfs[0], &floats[0], 65536 );
+
+   for( udword h = 0;  h < 65536;  ++h )
+   {
+      const udword sign      = (h & 0x8000u) << 16;
+      const udword magnitude = h & 0x7FFFu;
+      const udword bits      = floatToBits( halfToFloat( static_cast<uword>(
+         h) ) );
+
+      // (the double is exact, and is a normal float)
+      udword expected = sign | 0x7F800000u;
+      if( magnitude < 0x7C00u )
+      {
+         expected = sign | floatToBits( static_cast<float>(halfValue(
+            magnitude )) );
+      }
+      else if( magnitude > 0x7C00u )
+      {
+         expected |= 0x00400000u | ((h & 0x03FFu) << 13);
+      }
+
+      const bool is = (bits == expected) &
+         (floatToBits( floats[h] ) == expected) &
+         (floatToHalf( bitsToFloat( expected ) ) == static_cast<uword>(h |
+            ((magnitude > 0x7C00u) ? 0x0200u : 0u)));
+
+      if( pOut && !is ) *pOut << std::hex << h << "  " << bits << " " <<
+         floatToBits( floats[h] ) << " " << expected << std::dec << "\n";
+      isOk &= is;
+   }
+
+   return isOk;
+}
+
+
+/// floats spread over every bit pattern (and specials): to half and bfloat16,
+/// nearest, and arrays the same
+bool testFromFloat
+(
+   std::ostream* pOut,
+   const udword  step
+)
+{
+   static const udword SPECIALS[] = { 0x00000000u, 0x477FE000u /*65504*/,
+      0x477FEFFFu, 0x477FF000u /*65520*/, 0x477FF001u, 0x7F7FFFFFu,
+      0x7F7F8000u, 0x33800000u /*2^-24*/, 0x33000000u /*2^-25*/,
+      0x33000001u, 0x33C00000u, 0x38800000u /*2^-14*/, 0x387FE000u,
+      0x387FF000u, 0x3F801000u /*tie, even*/, 0x3F803000u /*tie, odd*/,
+      0x3F808000u, 0x3F818000u, 0x7F800000u, 0x7F800001u, 0x7FC00000u,
+      0x7FFFFFFFu, 0x00000001u };
+
+   std::vector<float> floats;
+   for( udword i = 0;  i < sizeof(SPECIALS) / sizeof(SPECIALS[0]);  ++i )
+   {
+      floats.push_back( bitsToFloat( SPECIALS[i] ) );
+      floats.push_back( bitsToFloat( SPECIALS[i] | 0x80000000u ) );
+   }
+   for( udword bits = 0x12345u;  bits >= step;  bits += step )
+   {
+      floats.push_back( bitsToFloat( bits ) );
+   }
+
+   const dword count = static_cast<dword>(floats.size());
+   std::vector<half>  halfs( count );
+   std::vector<uword> bfloats( count );
+
+   bool isOk = true;
+
+   // arrays, at every offset and some remainder lengths
+   for( dword k = 0;  k < 8;  ++k )
+   {
+      const dword n = (0 == k) ? count : (k * 5);
+      floatToHalf( &floats[k], &halfs[k], n - k );
+      floatToBfloat16( &floats[k], &bfloats[k], n - k );
+
+      for( dword i = k;  i < n;  ++i )
+      {
+         isOk &= (halfs[i].getBits() == floatToHalf( floats[i] )) &
+            (bfloats[i] == floatToBfloat16( floats[i] ));
+      }
+   }
+
+   for( dword i = 0;  (i < count) & isOk;  ++i )
+   {
+      const udword bits = floatToBits( floats[i] );
+      const udword h    = floatToHalf( floats[i] );
+      const udword b    = floatToBfloat16( floats[i] );
+
+      bool is = true;
+      if( isNan( bits ) )
+      {
+         is &= (h == halfNan( bits )) & (b == ((bits >> 16) | 0x40u));
+      }
+      else
+      {
+         const double x = floatValue( bits & 0x7FFFFFFFu );
+
+         is &= ((h & 0x8000u) == ((bits >> 16) & 0x8000u)) &
+            ((b & 0x8000u) == ((bits >> 16) & 0x8000u));
+         is &= isNearest( x, h & 0x7FFFu, 0x7C00u, &halfValue );
+         is &= isNearest( x, b & 0x7FFFu, 0x7F80u, &bfloat16Value );
+      }
+
+      if( pOut && !is ) *pOut << std::hex << bits << "  " << h << "  " << b <<
+         std::dec << "\n";
+      isOk &= is;
+   }
+
+   // bfloat16 back to float: exact
+   for( udword b = 0;  b < 65536;  ++b )
+   {
+      bfloats[b & 0xFFFFu] = static_cast<uword>(b);
+   }
+   std::vector<float> back( 65536 );
+   bfloat16ToFloat( &bfloats[0], &back[0], 65536 );
+   for( udword b = 0;  b < 65536;  ++b )
+   {
+      isOk &= (floatToBits( back[b] ) == (b << 16)) &
+         (floatToBits( bfloat16ToFloat( static_cast<uword>(b) ) ) ==
+         (b << 16));
+   }
+
+   return isOk;
+}
+
+
+/// a full-HD RGB frame, one at a time against array
+void benchmark
+(
+   std::ostream& out
+)
+{
+   static const dword COUNT = 1920 * 1080 * 3;
+   static const dword TIMES = 4;
+
+   std::vector<float> floats( COUNT );
+   for( dword i = 0;  i < COUNT;  ++i )
+   {
+      floats[i] = static_cast<float>(i % 4093) * (1.0f / 1024.0f);
+   }
+   std::vector<half>  halfs( COUNT );
+   std::vector<uword> bfloats( COUNT );
+   std::vector<float> results( COUNT );
+
+   // (changing an input each time, so the work is not hoisted)
+   double times[4][2];
+   Stopwatch stopwatch;
+
+   for( dword f = 0;  f < 4;  ++f )
+   {
+      for( dword k = 0;  k < 2;  ++k )
+      {
+         stopwatch.start();
+         for( dword t = TIMES;  t-- > 0; )
+         {
+            floats[t] += 1e-3f;
+            halfs[t]   = half::fromBits( static_cast<uword>(t) );
+            switch( (f * 2) + k )
+            {
+               case 0 : for( dword i = 0;  i < COUNT;  ++i ) {
+                  halfs[i] = floats[i]; }  break;
+               case 1 : floatToHalf( &floats[0], &halfs[0], COUNT );  break;
+
+               case 2 : for( dword i = 0;  i < COUNT;  ++i ) {
+                  results[i] = halfs[i]; }  break;
+               case 3 : halfToFloat( &halfs[0], &results[0], COUNT );  break;
+
+               case 4 : for( dword i = 0;  i < COUNT;  ++i ) {
+                  bfloats[i] = floatToBfloat16( floats[i] ); }  break;
+               case 5 : floatToBfloat16( &floats[0], &bfloats[0], COUNT );
+                  break;
+
+               case 6 : for( dword i = 0;  i < COUNT;  ++i ) {
+                  results[i] = bfloat16ToFloat( bfloats[i] ); }  break;
+               case 7 : bfloat16ToFloat( &bfloats[0], &results[0], COUNT );
+                  break;
+            }
+         }
+         times[f][k] = stopwatch.getSeconds();
+      }
+   }
+
+   static const char* NAMES[] = { "float to half      ",
+      "half to float      ", "float to bfloat16  ", "bfloat16 to float  " };
+
+   const double scale = 1e3 / static_cast<double>(TIMES);
+   out << std::fixed << std::setprecision( 2 ) << "benchmark  (ms per "
+      "1920x1080 RGB frame: one at a time, array)\n";
+   for( dword f = 0;  f < 4;  ++f )
+   {
+      out << "   " << NAMES[f] << (times[f][0] * scale) << "  " <<
+         (times[f][1] * scale) << "\n";
+   }
+   out << "   (check " << results[7] << " " << halfs[7].getBits() << ")\n\n" <<
+      std::setprecision( 6 );
+}
+
+}
+
+
+namespace hxa7241_general
+{
+
+
+bool test_Half
+(
+   std::ostream* pOut,
+   const bool    isVerbose,
+   const dword   //seed
+)
+{
+   bool isOk = true;
+
+   if( pOut ) *pOut << "[ test_Half ]\n\n";
+
+
+   // half to float
+   {
+      const bool is = testHalfToFloat( (pOut && isVerbose) ? pOut : 0 );
+
+      if( pOut ) *pOut << "half to float : " <<
+         (is ? "--- succeeded" : "*** failed") << "\n\n";
+
+      isOk &= is;
+   }
+
+   // from float
+   {
+      const bool is = testFromFloat( (pOut && isVerbose) ? pOut : 0,
+         isVerbose ? 509u : 4093u );
+
+      if( pOut ) *pOut << "from float : " <<
+         (is ? "--- succeeded" : "*** failed") << "\n\n";
+
+      isOk &= is;
+   }
+
+   // half type, and Sheet<half>
+   {
+      bool is = true;
+
+      is &= (2 == sizeof(half));
+
+      const half  h = 0.5f;
+      const float f = h;
+      is &= (0.5f == f) & (0x3800u == h.getBits()) & (0 == half().getBits());
+
+      // pixels in, back out: within half precision
+      static const dword WIDTH  = 13;
+      static const dword HEIGHT = 5;
+      std::vector<float> triples( WIDTH * HEIGHT * 3 );
+      for( dword i = 0;  i < static_cast<dword>(triples.size());  ++i )
+      {
+         triples[i] = static_cast<float>(i * i) * 0.37f;
+      }
+
+      Sheet<half> sheet( WIDTH * 3, HEIGHT );
+      floatToHalf( &triples[0], sheet.getStorage(), sheet.getLength() );
+
+      std::vector<float> back( triples.size() );
+      halfToFloat( sheet.getStorage(), &back[0], sheet.getLength() );
+      for( dword i = 0;  i < static_cast<dword>(triples.size());  ++i )
+      {
+         is &= ::fabsf( back[i] - triples[i] ) <= (triples[i] *
+            (1.0f / 2048.0f));
+         is &= (back[i] == static_cast<float>(sheet[i]));
+      }
+
+      sheet.get( 2, 1 ) = 3.0f;
+      is &= (3.0f == sheet.get( 2, 1 ));
+      sheet.zeroStorage();
+      is &= (0 == sheet[0].getBits());
+
+      if( pOut ) *pOut << "half : " <<
+         (is ? "--- succeeded" : "*** failed") << "\n\n";
+
+      isOk &= is;
+   }
+
+   if( pOut && isVerbose ) benchmark( *pOut );
+
+
+   if( pOut ) *pOut << (isOk ? "--- successfully" : "*** failurefully") <<
+      " completed " << "\n\n\n";
+
+   if( pOut ) pOut->flush();
+
+
+   return isOk;
+}
+
+}
+
+
+#endif//TESTING
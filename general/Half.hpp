@@ -0,0 +1,197 @@
+/*------------------------------------------------------------------------------
+
+   HXA7241 General library.
+   Copyright (c) 2004-2007,  Harrison Ainsworth / HXA7241.
+
+   http://www.hxa7241.org/
+
+------------------------------------------------------------------------------*/
+
+
+#ifndef Half_h
+#define Half_h
+
+
+
+
+#include "hxa7241_general.hpp"
+namespace hxa7241_general
+{
+
+
+/**
+ * 16-bit float conversions: IEEE binary16 (half), and bfloat16.<br/><br/>
+ *
+ * binary16: sign, 5 exponent bits, 10 fraction bits -- about 3 decimal
+ * digits, 6e-8 (subnormal) to 65504. bfloat16: the top half of a float --
+ * float range, about 2 decimal digits.<br/><br/>
+ *
+ * From float rounds to nearest, ties to even. Too big gives infinity. NaNs
+ * stay NaNs, made quiet. To float is exact (half NaNs are made quiet,
+ * bfloat16 NaNs are kept as they are).<br/><br/>
+ *
+ * Arrays: count numbers from pIn, results to pOut. Same results as one at a
+ * time, bit for bit: half with F16C when compiled for it, else
+ * lookup tables; bfloat16 in SSE2 or AVX2 registers when compiled for them.
+ *
+ * @see half
+ */
+
+
+/// binary16 -------------------------------------------------------------------
+uword floatToHalf( float f );
+float halfToFloat( uword h );
+
+
+/// bfloat16 -------------------------------------------------------------------
+uword floatToBfloat16( float f );
+float bfloat16ToFloat( uword b );
+
+
+/// arrays ---------------------------------------------------------------------
+class half;
+
+void floatToHalf( const float* pIn,
+                  half*        pOut,
+                  dword        count );
+
+void halfToFloat( const half*  pIn,
+                  float*       pOut,
+                  dword        count );
+
+void floatToBfloat16( const float* pIn,
+                      uword*       pOut,
+                      dword        count );
+
+void bfloat16ToFloat( const uword* pIn,
+                      float*       pOut,
+                      dword        count );
+
+
+
+
+/**
+ * A binary16 float value, for storage.<br/><br/>
+ *
+ * Provides implicit conversion to and from float (arithmetic is done in
+ * float). Two bytes, so Sheet<half> keeps pixels at 16 bits (and the array
+ * conversions fill or read a whole Sheet<half> storage at once). Named like
+ * the primitive types, as it stands for one.<br/><br/>
+ *
+ * Constant.
+ */
+class half
+{
+/// standard object services ---------------------------------------------------
+public:
+            half();
+           ~half();
+            half( const half& );
+   half&    operator=( const half& );
+
+/// implicit conversions
+            half( float );
+            operator float() const;
+
+
+/// queries --------------------------------------------------------------------
+   static  half  fromBits( uword bits );
+           uword getBits()                                                const;
+
+
+/// fields ---------------------------------------------------------------------
+private:
+   uword bits_m;
+};
+
+
+
+
+
+
+
+
+/// INLINES ///
+
+/// standard object services ---------------------------------------------------
+inline
+half::half()
+ : bits_m( 0 )
+{
+}
+
+
+inline
+half::~half()
+{
+}
+
+
+inline
+half::half
+(
+   const half& other
+)
+ : bits_m( other.bits_m )
+{
+}
+
+
+inline
+half& half::operator=
+(
+   const half& other
+)
+{
+   bits_m = other.bits_m;
+
+   return *this;
+}
+
+
+inline
+half::half
+(
+   const float f
+)
+ : bits_m( floatToHalf( f ) )
+{
+}
+
+
+inline
+half::operator float() const
+{
+   return halfToFloat( bits_m );
+}
+
+
+
+
+/// queries --------------------------------------------------------------------
+inline
+half half::fromBits
+(
+   const uword bits
+)
+{
+   half h;
+   h.bits_m = bits;
+
+   return h;
+}
+
+
+inline
+uword half::getBits() const
+{
+   return bits_m;
+}
+
+
+}//namespace
+
+
+
+
+#endif//Half_h
@@ -8,6 +8,15 @@
 ------------------------------------------------------------------------------*/
 
 
+/// conditional compilations
+#if defined(__AVX2__)
+#define LOGFAST_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (_M_IX86_FP >= 2)
+#define LOGFAST_SSE2
+#include <emmintrin.h>
+#endif
+
 #include <math.h>
 
 #include "LogFast.hpp"
@@ -79,6 +88,116 @@ float hxa7241_general::logFast2
 }
 
 
+/// arrays ---------------------------------------------------------------------
+
+namespace
+{
+
+/**
+ * log2 * scale, of each. As logFast2, in vectors, then the rest one at a time.
+ */
+void logFast2s
+(
+   const float* pIn,
+   float*       pOut,
+   const dword  count,
+   const float  scale
+)
+{
+   dword i = 0;
+
+#if defined(LOGFAST_AVX2)
+   const __m256i exponentMask = _mm256_set1_epi32( 0xFF );
+   const __m256i bias         = _mm256_set1_epi32( 128 );
+   const __m256i mantissaMask = _mm256_set1_epi32( ~(0xFF << 23) );
+   const __m256i zeroExponent = _mm256_set1_epi32( 127 << 23 );
+   const __m256  s            = _mm256_set1_ps( scale );
+
+   for( ;  (i + 8) <= count;  i += 8 )
+   {
+      const __m256i val  = _mm256_castps_si256( _mm256_loadu_ps( pIn + i ) );
+
+      // extract exponent, and reset val exponent to zero
+      const __m256  log2 = _mm256_cvtepi32_ps( _mm256_sub_epi32(
+         _mm256_and_si256( _mm256_srli_epi32( val, 23 ), exponentMask ),
+         bias ) );
+      const __m256  m    = _mm256_castsi256_ps( _mm256_or_si256(
+         _mm256_and_si256( val, mantissaMask ), zeroExponent ) );
+
+      // make refinement by interpolation
+      const __m256  v    = _mm256_sub_ps( _mm256_mul_ps( _mm256_add_ps(
+         _mm256_mul_ps( _mm256_set1_ps( -1.0f / 3.0f ), m ),
+         _mm256_set1_ps( 2.0f ) ), m ), _mm256_set1_ps( 2.0f / 3.0f ) );
+
+      _mm256_storeu_ps( pOut + i, _mm256_mul_ps( _mm256_add_ps( log2, v ),
+         s ) );
+   }
+#elif defined(LOGFAST_SSE2)
+   const __m128i exponentMask = _mm_set1_epi32( 0xFF );
+   const __m128i bias         = _mm_set1_epi32( 128 );
+   const __m128i mantissaMask = _mm_set1_epi32( ~(0xFF << 23) );
+   const __m128i zeroExponent = _mm_set1_epi32( 127 << 23 );
+   const __m128  s            = _mm_set1_ps( scale );
+
+   for( ;  (i + 4) <= count;  i += 4 )
+   {
+      const __m128i val  = _mm_castps_si128( _mm_loadu_ps( pIn + i ) );
+
+      const __m128  log2 = _mm_cvtepi32_ps( _mm_sub_epi32( _mm_and_si128(
+         _mm_srli_epi32( val, 23 ), exponentMask ), bias ) );
+      const __m128  m    = _mm_castsi128_ps( _mm_or_si128( _mm_and_si128(
+         val, mantissaMask ), zeroExponent ) );
+
+      const __m128  v    = _mm_sub_ps( _mm_mul_ps( _mm_add_ps( _mm_mul_ps(
+         _mm_set1_ps( -1.0f / 3.0f ), m ), _mm_set1_ps( 2.0f ) ), m ),
+         _mm_set1_ps( 2.0f / 3.0f ) );
+
+      _mm_storeu_ps( pOut + i, _mm_mul_ps( _mm_add_ps( log2, v ), s ) );
+   }
+#endif
+
+   for( ;  i < count;  ++i )
+   {
+      pOut[i] = logFast2( pIn[i] ) * scale;
+   }
+}
+
+}
+
+
+void hxa7241_general::logFast2
+(
+   const float* pIn,
+   float*       pOut,
+   const dword  count
+)
+{
+   logFast2s( pIn, pOut, count, 1.0f );
+}
+
+
+void hxa7241_general::logFastE
+(
+   const float* pIn,
+   float*       pOut,
+   const dword  count
+)
+{
+   logFast2s( pIn, pOut, count, 0.69314718055995f );
+}
+
+
+void hxa7241_general::logFast10
+(
+   const float* pIn,
+   float*       pOut,
+   const dword  count
+)
+{
+   logFast2s( pIn, pOut, count, 0.30102999566398f );
+}
+
+
 
 
 
@@ -150,6 +269,76 @@ float log2Lookup
    return static_cast<float>(exp) + pTable[ man ];
 }
 
+
+/**
+ * log2Lookup * scale, of each. In vectors (with gathers for AVX2), then the
+ * rest one at a time.
+ */
+void log2Lookups
+(
+   const float* pIn,
+   float*       pOut,
+   const dword  count,
+   float* const pTable,
+   const udword precision,
+   const float  scale
+)
+{
+   dword i = 0;
+
+#if defined(LOGFAST_AVX2)
+   const __m256i exponentMask = _mm256_set1_epi32( 0xFF );
+   const __m256i bias         = _mm256_set1_epi32( 127 );
+   const __m256i mantissaMask = _mm256_set1_epi32( 0x7FFFFF );
+   const __m128i quantize     = _mm_cvtsi32_si128( 23 - precision );
+   const __m256  s            = _mm256_set1_ps( scale );
+
+   for( ;  (i + 8) <= count;  i += 8 )
+   {
+      const __m256i val = _mm256_castps_si256( _mm256_loadu_ps( pIn + i ) );
+
+      // extract exponent and mantissa (quantized)
+      const __m256  exp = _mm256_cvtepi32_ps( _mm256_sub_epi32(
+         _mm256_and_si256( _mm256_srli_epi32( val, 23 ), exponentMask ),
+         bias ) );
+      const __m256i man = _mm256_srl_epi32( _mm256_and_si256( val,
+         mantissaMask ), quantize );
+
+      // exponent plus lookup refinement
+      _mm256_storeu_ps( pOut + i, _mm256_mul_ps( _mm256_add_ps( exp,
+         _mm256_i32gather_ps( pTable, man, 4 ) ), s ) );
+   }
+#elif defined(LOGFAST_SSE2)
+   const __m128i exponentMask = _mm_set1_epi32( 0xFF );
+   const __m128i bias         = _mm_set1_epi32( 127 );
+   const __m128i mantissaMask = _mm_set1_epi32( 0x7FFFFF );
+   const __m128i quantize     = _mm_cvtsi32_si128( 23 - precision );
+   const __m128  s            = _mm_set1_ps( scale );
+
+   for( ;  (i + 4) <= count;  i += 4 )
+   {
+      const __m128i val = _mm_castps_si128( _mm_loadu_ps( pIn + i ) );
+
+      const __m128  exp = _mm_cvtepi32_ps( _mm_sub_epi32( _mm_and_si128(
+         _mm_srli_epi32( val, 23 ), exponentMask ), bias ) );
+
+      // (no gather in SSE2)
+      dword man[4];
+      _mm_storeu_si128( reinterpret_cast<__m128i*>(man), _mm_srl_epi32(
+         _mm_and_si128( val, mantissaMask ), quantize ) );
+      const __m128  t   = _mm_set_ps( pTable[man[3]], pTable[man[2]],
+         pTable[man[1]], pTable[man[0]] );
+
+      _mm_storeu_ps( pOut + i, _mm_mul_ps( _mm_add_ps( exp, t ), s ) );
+   }
+#endif
+
+   for( ;  i < count;  ++i )
+   {
+      pOut[i] = log2Lookup( pIn[i], pTable, precision ) * scale;
+   }
+}
+
 }
 
 
@@ -184,6 +373,39 @@ float LogFast::two
 }
 
 
+void LogFast::two
+(
+   const float* pIn,
+   float*       pOut,
+   const dword  count
+) const
+{
+   log2Lookups( pIn, pOut, count, pTable_m, precision_m, 1.0f );
+}
+
+
+void LogFast::e
+(
+   const float* pIn,
+   float*       pOut,
+   const dword  count
+) const
+{
+   log2Lookups( pIn, pOut, count, pTable_m, precision_m, 0.69314718055995f );
+}
+
+
+void LogFast::ten
+(
+   const float* pIn,
+   float*       pOut,
+   const dword  count
+) const
+{
+   log2Lookups( pIn, pOut, count, pTable_m, precision_m, 0.30102999566398f );
+}
+
+
 
 
 /// default instance -----------------------------------------------------------
@@ -197,6 +419,105 @@ const LogFast& hxa7241_general::LOGFAST()
 
 
 
+
+
+
+
+/// compile-time ///////////////////////////////////////////////////////////////
+
+/// tables ---------------------------------------------------------------------
+
+/**
+ * Table elements as constant expressions, so the compiler evaluates them and
+ * the arrays are static data.<br/><br/>
+ *
+ * Element i is log2(1 + x), x = (i + 0.5) / 2^precision (as log2SetTable).
+ * With s = x / (2 + x), log2(1 + x) = (2 / ln 2) * (s + s^3/3 + s^5/5 ...),
+ * and s < 1/3, so to s^13 is within 2e-8.<br/><br/>
+ *
+ * Indexes are hex literals made by token pasting (eg. 0x7F3), which keeps the
+ * expansions small.
+ */
+#define LOGFAST_S(P, I) \
+   ((2.0 * (I) + 1.0) / ((4.0 * (1 << (P))) + (2.0 * (I) + 1.0)))
+#define LOGFAST_S2(P, I) \
+   (LOGFAST_S(P, I) * LOGFAST_S(P, I))
+#define LOGFAST_ENTRY(P, I) \
+   static_cast<float>( 2.8853900817779268 * LOGFAST_S(P, I) * (1.0 + \
+   LOGFAST_S2(P, I) * ((1.0 / 3.0) + LOGFAST_S2(P, I) * ((1.0 / 5.0) + \
+   LOGFAST_S2(P, I) * ((1.0 / 7.0) + LOGFAST_S2(P, I) * ((1.0 / 9.0) + \
+   LOGFAST_S2(P, I) * ((1.0 / 11.0) + LOGFAST_S2(P, I) * (1.0 / 13.0)))))))),
+
+#define LOGFAST_2(P, H) \
+   LOGFAST_ENTRY(P, H##0) LOGFAST_ENTRY(P, H##1)
+#define LOGFAST_4(P, H) \
+   LOGFAST_2(P, H) LOGFAST_ENTRY(P, H##2) LOGFAST_ENTRY(P, H##3)
+#define LOGFAST_8(P, H) \
+   LOGFAST_4(P, H) LOGFAST_ENTRY(P, H##4) LOGFAST_ENTRY(P, H##5) \
+   LOGFAST_ENTRY(P, H##6) LOGFAST_ENTRY(P, H##7)
+#define LOGFAST_16(P, H) \
+   LOGFAST_8(P, H) LOGFAST_ENTRY(P, H##8) LOGFAST_ENTRY(P, H##9) \
+   LOGFAST_ENTRY(P, H##A) LOGFAST_ENTRY(P, H##B) LOGFAST_ENTRY(P, H##C) \
+   LOGFAST_ENTRY(P, H##D) LOGFAST_ENTRY(P, H##E) LOGFAST_ENTRY(P, H##F)
+#define LOGFAST_32(P, H) \
+   LOGFAST_16(P, H##0) LOGFAST_16(P, H##1)
+#define LOGFAST_64(P, H) \
+   LOGFAST_32(P, H) LOGFAST_16(P, H##2) LOGFAST_16(P, H##3)
+#define LOGFAST_128(P, H) \
+   LOGFAST_64(P, H) LOGFAST_16(P, H##4) LOGFAST_16(P, H##5) \
+   LOGFAST_16(P, H##6) LOGFAST_16(P, H##7)
+#define LOGFAST_256(P, H) \
+   LOGFAST_128(P, H) LOGFAST_16(P, H##8) LOGFAST_16(P, H##9) \
+   LOGFAST_16(P, H##A) LOGFAST_16(P, H##B) LOGFAST_16(P, H##C) \
+   LOGFAST_16(P, H##D) LOGFAST_16(P, H##E) LOGFAST_16(P, H##F)
+#define LOGFAST_512(P, H) \
+   LOGFAST_256(P, H##0) LOGFAST_256(P, H##1)
+#define LOGFAST_1024(P, H) \
+   LOGFAST_512(P, H) LOGFAST_256(P, H##2) LOGFAST_256(P, H##3)
+#define LOGFAST_2048(P, H) \
+   LOGFAST_1024(P, H) LOGFAST_256(P, H##4) LOGFAST_256(P, H##5) \
+   LOGFAST_256(P, H##6) LOGFAST_256(P, H##7)
+#define LOGFAST_4096(P, H) \
+   LOGFAST_2048(P, H) LOGFAST_256(P, H##8) LOGFAST_256(P, H##9) \
+   LOGFAST_256(P, H##A) LOGFAST_256(P, H##B) LOGFAST_256(P, H##C) \
+   LOGFAST_256(P, H##D) LOGFAST_256(P, H##E) LOGFAST_256(P, H##F)
+
+
+namespace hxa7241_general
+{
+
+template<> const float LogFastT< 0>::TABLE[ 1 <<  0 ] =
+   { LOGFAST_ENTRY(  0, 0x0 ) };
+template<> const float LogFastT< 1>::TABLE[ 1 <<  1 ] =
+   { LOGFAST_2(  1, 0x ) };
+template<> const float LogFastT< 2>::TABLE[ 1 <<  2 ] =
+   { LOGFAST_4(  2, 0x ) };
+template<> const float LogFastT< 3>::TABLE[ 1 <<  3 ] =
+   { LOGFAST_8(  3, 0x ) };
+template<> const float LogFastT< 4>::TABLE[ 1 <<  4 ] =
+   { LOGFAST_16(  4, 0x ) };
+template<> const float LogFastT< 5>::TABLE[ 1 <<  5 ] =
+   { LOGFAST_32(  5, 0x ) };
+template<> const float LogFastT< 6>::TABLE[ 1 <<  6 ] =
+   { LOGFAST_64(  6, 0x ) };
+template<> const float LogFastT< 7>::TABLE[ 1 <<  7 ] =
+   { LOGFAST_128(  7, 0x ) };
+template<> const float LogFastT< 8>::TABLE[ 1 <<  8 ] =
+   { LOGFAST_256(  8, 0x ) };
+template<> const float LogFastT< 9>::TABLE[ 1 <<  9 ] =
+   { LOGFAST_512(  9, 0x ) };
+template<> const float LogFastT<10>::TABLE[ 1 << 10 ] =
+   { LOGFAST_1024( 10, 0x ) };
+template<> const float LogFastT<11>::TABLE[ 1 << 11 ] =
+   { LOGFAST_2048( 11, 0x ) };
+template<> const float LogFastT<12>::TABLE[ 1 << 12 ] =
+   { LOGFAST_4096( 12, 0x ) };
+
+}
+
+
+
+
 // original:
 //
 ///* Creates the ICSILog lookup table. Must be called
@@ -256,6 +577,9 @@ const LogFast& hxa7241_general::LOGFAST()
 #include <stdlib.h>
 #include <ostream>
 #include <iomanip>
+#include <vector>
+
+#include "Stopwatch.hpp"
 
 
 namespace
@@ -306,6 +630,225 @@ float logFastAdj10( const float f )
    return logFastAdj.ten( f );
 }
 
+
+void logFastAdj2s( const float* pIn, float* pOut, const dword count )
+{
+   logFastAdj.two( pIn, pOut, count );
+}
+
+void logFastAdjEs( const float* pIn, float* pOut, const dword count )
+{
+   logFastAdj.e( pIn, pOut, count );
+}
+
+void logFastAdj10s( const float* pIn, float* pOut, const dword count )
+{
+   logFastAdj.ten( pIn, pOut, count );
+}
+
+
+float logFastT2( const float f )
+{
+   return LogFastT<11>().two( f );
+}
+
+float logFastTE( const float f )
+{
+   return LogFastT<11>().e( f );
+}
+
+float logFastT10( const float f )
+{
+   return LogFastT<11>().ten( f );
+}
+
+
+/**
+ * Compile-time table same as run-time table (to float rounding), over the
+ * float range.
+ */
+template<udword PRECISION>
+bool testCompileTime
+(
+   std::ostream* pOut
+)
+{
+   const LogFastT<PRECISION> compileTime;
+   const LogFast             runTime( PRECISION );
+
+   bool isOk = true;
+   for( dword i = 0;  i < 100000;  ++i )
+   {
+      const float f = ::powf( 10.0f, (randFloat() * 74.0f) - 37.0f );
+
+      const float a[] = { compileTime.two( f ), compileTime.e( f ),
+         compileTime.ten( f ) };
+      const float b[] = { runTime.two( f ), runTime.e( f ),
+         runTime.ten( f ) };
+      for( dword j = 0;  j < 3;  ++j )
+      {
+         isOk &= ::fabsf( a[j] - b[j] ) <= 1e-6f * (1.0f + ::fabsf( b[j] ));
+      }
+   }
+   isOk &= (PRECISION == compileTime.precision());
+
+   if( pOut ) *pOut << "compile-time(" << PRECISION << ") : " <<
+      (isOk ? "--- succeeded" : "*** failed") << "\n";
+
+   return isOk;
+}
+
+
+typedef float (*One)( float );
+typedef void  (*Many)( const float*, float*, dword );
+
+/**
+ * Arrays same as one at a time: for various counts and alignments, and in
+ * place.
+ */
+bool testArrays
+(
+   std::ostream* pOut,
+   const char*   name,
+   One           one,
+   Many          many
+)
+{
+   bool isOk = true;
+
+   static const dword COUNTS[] = { 0, 1, 7, 8, 9, 31, 1003 };
+
+   std::vector<float> numbers( 1003 + 2 );
+   for( dword i = 0;  i < 1003 + 2;  ++i )
+   {
+      numbers[i] = ::powf( 10.0f, ((static_cast<float>(i) + randFloat()) /
+         (1003.0f / 13.0f)) - 6.0f );
+   }
+
+   for( dword c = 0;  c < 7;  ++c )
+   {
+      for( dword start = 0;  start < 2;  ++start )
+      {
+         const dword count = COUNTS[c];
+
+         std::vector<float> results( count + 1, -1.0f );
+         std::vector<float> inPlace( numbers.begin() + start,
+            numbers.begin() + start + count + 1 );
+         many( &numbers[start], &results[0], count );
+         many( &inPlace[0], &inPlace[0], count );
+
+         for( dword i = 0;  i < count;  ++i )
+         {
+            const float expected  = one( numbers[start + i] );
+            const float tolerance = 1e-6f * (1.0f + ::fabsf( expected ));
+            isOk &= (::fabsf( results[i] - expected ) <= tolerance) &
+               (::fabsf( inPlace[i] - expected ) <= tolerance);
+         }
+         isOk &= (-1.0f == results[count]) &
+            (numbers[start + count] == inPlace[count]);
+      }
+   }
+
+   if( pOut ) *pOut << name << " : " <<
+      (isOk ? "--- succeeded" : "*** failed") << "\n\n";
+
+   return isOk;
+}
+
+
+void benchmark
+(
+   std::ostream& out
+)
+{
+   static const dword COUNT = 1 << 16;
+   static const dword TIMES = 64;
+
+   std::vector<float> numbers( COUNT );
+   std::vector<float> results( COUNT );
+   for( dword i = 0;  i < COUNT;  ++i )
+   {
+      numbers[i] = ::powf( 10.0f, ((static_cast<float>(i) + randFloat()) /
+         (static_cast<float>(COUNT) / 13.0f)) - 6.0f );
+   }
+
+   // (changing an input each time, so the work is not hoisted)
+   double times[6];
+   Stopwatch stopwatch;
+
+   stopwatch.start();
+   for( dword t = TIMES;  t-- > 0; )
+   {
+      numbers[t] += 1e-3f;
+      for( dword i = 0;  i < COUNT;  ++i )
+      {
+         results[i] = ::logf( numbers[i] );
+      }
+   }
+   times[0] = stopwatch.getSeconds();
+
+   stopwatch.start();
+   for( dword t = TIMES;  t-- > 0; )
+   {
+      numbers[t] += 1e-3f;
+      for( dword i = 0;  i < COUNT;  ++i )
+      {
+         results[i] = logFastE( numbers[i] );
+      }
+   }
+   times[1] = stopwatch.getSeconds();
+
+   stopwatch.start();
+   for( dword t = TIMES;  t-- > 0; )
+   {
+      numbers[t] += 1e-3f;
+      logFastE( &numbers[0], &results[0], COUNT );
+   }
+   times[2] = stopwatch.getSeconds();
+
+   stopwatch.start();
+   for( dword t = TIMES;  t-- > 0; )
+   {
+      numbers[t] += 1e-3f;
+      for( dword i = 0;  i < COUNT;  ++i )
+      {
+         results[i] = logFastAdj.e( numbers[i] );
+      }
+   }
+   times[3] = stopwatch.getSeconds();
+
+   stopwatch.start();
+   for( dword t = TIMES;  t-- > 0; )
+   {
+      numbers[t] += 1e-3f;
+      logFastAdj.e( &numbers[0], &results[0], COUNT );
+   }
+   times[4] = stopwatch.getSeconds();
+
+   stopwatch.start();
+   for( dword t = TIMES;  t-- > 0; )
+   {
+      const LogFastT<11> logFastT;
+      numbers[t] += 1e-3f;
+      for( dword i = 0;  i < COUNT;  ++i )
+      {
+         results[i] = logFastT.e( numbers[i] );
+      }
+   }
+   times[5] = stopwatch.getSeconds();
+
+   const double scale = 1e9 / (static_cast<double>(COUNT) * TIMES);
+   out << std::fixed << std::setprecision( 2 ) <<
+      "benchmark  (ns per element)\n" <<
+      "   ::logf                  " << (times[0] * scale) << "\n" <<
+      "   rough       one, array  " << (times[1] * scale) << "  " <<
+      (times[2] * scale) << "\n" <<
+      "   adjustable  one, array  " << (times[3] * scale) << "  " <<
+      (times[4] * scale) << "\n" <<
+      "   compile-time one        " << (times[5] * scale) << "\n" <<
+      "   (check " << results[7] << ")\n\n" << std::setprecision( 6 );
+}
+
 }
 
 
@@ -357,6 +900,49 @@ bool test_LogFast
          COUNT, 0.00004f, 0.0002f, "adjustable(11) 10", &logFastAdj10 );
    }
 
+   // compile-time
+   {
+      isOk &= testOneFunction( pOut, isVerbose, &::log2f, 2.0f,
+         COUNT, 0.0002f, 0.0004f, "compile-time(11) 2", &logFastT2 );
+
+      isOk &= testOneFunction( pOut, isVerbose, &::logf, 2.71828182845905f,
+         COUNT, 0.00009f, 0.0003f, "compile-time(11) E", &logFastTE );
+
+      isOk &= testOneFunction( pOut, isVerbose, &::log10f, 10.0f,
+         COUNT, 0.00004f, 0.0002f, "compile-time(11) 10", &logFastT10 );
+
+      isOk &= testCompileTime< 0>( pOut );
+      isOk &= testCompileTime< 1>( pOut );
+      isOk &= testCompileTime< 2>( pOut );
+      isOk &= testCompileTime< 3>( pOut );
+      isOk &= testCompileTime< 4>( pOut );
+      isOk &= testCompileTime< 5>( pOut );
+      isOk &= testCompileTime< 6>( pOut );
+      isOk &= testCompileTime< 7>( pOut );
+      isOk &= testCompileTime< 8>( pOut );
+      isOk &= testCompileTime< 9>( pOut );
+      isOk &= testCompileTime<10>( pOut );
+      isOk &= testCompileTime<11>( pOut );
+      isOk &= testCompileTime<12>( pOut );
+      if( pOut ) *pOut << "\n";
+   }
+
+   // arrays
+   {
+      isOk &= testArrays( pOut, "rough 2 arrays", &logFast2, &logFast2 );
+      isOk &= testArrays( pOut, "rough E arrays", &logFastE, &logFastE );
+      isOk &= testArrays( pOut, "rough 10 arrays", &logFast10, &logFast10 );
+
+      isOk &= testArrays( pOut, "adjustable(11) 2 arrays", &logFastAdj2,
+         &logFastAdj2s );
+      isOk &= testArrays( pOut, "adjustable(11) E arrays", &logFastAdjE,
+         &logFastAdjEs );
+      isOk &= testArrays( pOut, "adjustable(11) 10 arrays", &logFastAdj10,
+         &logFastAdj10s );
+   }
+
+   if( pOut && isVerbose ) benchmark( *pOut );
+
 
    if( pOut ) *pOut << (isOk ? "--- successfully" : "*** failurefully") <<
       " completed " << "\n\n\n";
@@ -12,6 +12,7 @@
 #define LogFast_h
 
 
+#include <cstring>
 
 
 #include "hxa7241_general.hpp"
@@ -37,6 +38,25 @@ float logFastE( float f );
 float logFast10( float f );
 
 
+/**
+ * Arrays: count numbers from pIn, results to pOut (which may be pIn).<br/><br/>
+ *
+ * Same results as one at a time, but in SSE2 or AVX2 registers when compiled
+ * for them.
+ */
+void logFast2 ( const float* pIn,
+                float*       pOut,
+                dword        count );
+
+void logFastE ( const float* pIn,
+                float*       pOut,
+                dword        count );
+
+void logFast10( const float* pIn,
+                float*       pOut,
+                dword        count );
+
+
 
 
 /// adjustable /////////////////////////////////////////////////////////////////
@@ -71,6 +91,17 @@ public:
              * Error (11): mean < 0.00004, max < 0.0002. */
            float ten( float )                                             const;
 
+           /** arrays (pOut may be pIn), AVX2 gathers when compiled for. */
+           void  two( const float* pIn,
+                      float*       pOut,
+                      dword        count )                                const;
+           void  e  ( const float* pIn,
+                      float*       pOut,
+                      dword        count )                                const;
+           void  ten( const float* pIn,
+                      float*       pOut,
+                      dword        count )                                const;
+
            udword precision()                                             const;
 
 /// fields ---------------------------------------------------------------------
@@ -86,6 +117,65 @@ const LogFast& LOGFAST();
 
 
 
+/// compile-time ///////////////////////////////////////////////////////////////
+
+/**
+ * Fast approximation to log, with adjustable precision, and its table made at
+ * compile time.<br/><br/>
+ *
+ * The table is constant data (in .rodata): nothing to construct, no locking
+ * on first use, and shared read-only between processes. Otherwise as LogFast
+ * (the table values differ from LogFast's only in float rounding).<br/><br/>
+ *
+ * Precision can be 0 to 12. Storage is (2 ^ precision) * 4 bytes.
+ */
+template<udword PRECISION>
+class LogFastT
+{
+/// standard object services ---------------------------------------------------
+// use defaults
+//          LogFastT();
+//         ~LogFastT();
+//          LogFastT( const LogFastT& );
+//          LogFastT& operator=( const LogFastT& );
+
+/// queries --------------------------------------------------------------------
+public:
+           /** log2( number ). Number must be > 0. */
+           float two( float )                                             const;
+
+           /** ln( number ). Number must be > 0. */
+           float e  ( float )                                             const;
+
+           /** log10( number ). Number must be > 0. */
+           float ten( float )                                             const;
+
+           udword precision()                                             const;
+
+/// constants ------------------------------------------------------------------
+private:
+   static const float TABLE[ 1 << PRECISION ];
+};
+
+
+/// tables (defined in LogFast.cpp)
+template<> const float LogFastT< 0>::TABLE[ 1 <<  0 ];
+template<> const float LogFastT< 1>::TABLE[ 1 <<  1 ];
+template<> const float LogFastT< 2>::TABLE[ 1 <<  2 ];
+template<> const float LogFastT< 3>::TABLE[ 1 <<  3 ];
+template<> const float LogFastT< 4>::TABLE[ 1 <<  4 ];
+template<> const float LogFastT< 5>::TABLE[ 1 <<  5 ];
+template<> const float LogFastT< 6>::TABLE[ 1 <<  6 ];
+template<> const float LogFastT< 7>::TABLE[ 1 <<  7 ];
+template<> const float LogFastT< 8>::TABLE[ 1 <<  8 ];
+template<> const float LogFastT< 9>::TABLE[ 1 <<  9 ];
+template<> const float LogFastT<10>::TABLE[ 1 << 10 ];
+template<> const float LogFastT<11>::TABLE[ 1 << 11 ];
+template<> const float LogFastT<12>::TABLE[ 1 << 12 ];
+
+
+
+
 
 
 
@@ -142,6 +232,59 @@ udword LogFast::precision() const
    return precision_m;
 }
 
+
+
+
+/// compile-time ---------------------------------------------------------------
+template<udword PRECISION>
+inline
+float LogFastT<PRECISION>::two
+(
+   const float f
+) const
+{
+   // get access to float bits
+   dword bits;
+   std::memcpy( &bits, &f, sizeof(bits) );
+
+   // extract exponent and mantissa (quantized)
+   const dword exp = ((bits >> 23) & 0xFF) - 127;
+   const dword man = (bits & 0x7FFFFF) >> (23 - PRECISION);
+
+   // exponent plus lookup refinement
+   return static_cast<float>(exp) + TABLE[ man ];
+}
+
+
+template<udword PRECISION>
+inline
+float LogFastT<PRECISION>::e
+(
+   const float f
+) const
+{
+   return two( f ) * 0.69314718055995f;
+}
+
+
+template<udword PRECISION>
+inline
+float LogFastT<PRECISION>::ten
+(
+   const float f
+) const
+{
+   return two( f ) * 0.30102999566398f;
+}
+
+
+template<udword PRECISION>
+inline
+udword LogFastT<PRECISION>::precision() const
+{
+   return PRECISION;
+}
+
 }//namespace
 
 
@@ -0,0 +1,1203 @@
+/*------------------------------------------------------------------------------
+
+   HXA7241 General library.
+   Copyright (c) 2004-2007,  Harrison Ainsworth / HXA7241.
+
+   http://www.hxa7241.org/
+
+------------------------------------------------------------------------------*/
+
+
+/// conditional compilations
+#if defined(__AVX2__)
+#define MATHFAST_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (_M_IX86_FP >= 2)
+#define MATHFAST_SSE2
+#include <emmintrin.h>
+#endif
+
+#include <cstring>
+
+#include "MathFast.hpp"
+
+
+using namespace hxa7241_general;
+
+
+
+
+/// implementation /////////////////////////////////////////////////////////////
+
+namespace
+{
+
+const udword SIGN_BIT = 0x80000000u;
+
+// exp
+const float  EXP_MAX  = 88.37f;
+const float  EXP_MIN  = -87.3f;
+const float  LOG2_E   = 1.44269504088896f;
+const double LN_2     = 0.69314718055994531;
+const float  EXP_P0   = 1.9875691500e-4f;
+const float  EXP_P1   = 1.3981999507e-3f;
+const float  EXP_P2   = 8.3334519073e-3f;
+const float  EXP_P3   = 4.1665795894e-2f;
+const float  EXP_P4   = 1.6666665459e-1f;
+const float  EXP_P5   = 5.0000001201e-1f;
+
+// sin cos
+const float  TWO_PI_R = 0.63661977236758f;
+const double PI_2     = 1.5707963267948966;
+const float  SIN_P0   = -1.9515295891e-4f;
+const float  SIN_P1   = 8.3321608736e-3f;
+const float  SIN_P2   = -1.6666654611e-1f;
+const float  COS_P0   = 2.443315711809948e-5f;
+const float  COS_P1   = -1.388731625493765e-3f;
+const float  COS_P2   = 4.166664568298827e-2f;
+
+// atan2
+const float  TAN_PI_8 = 0.41421356237310f;
+const float  PI_4F    = 0.78539816339745f;
+const float  PI_2F    = 1.57079632679490f;
+const float  PIF      = 3.14159265358979f;
+const float  ATAN_P0  = 8.05374449538e-2f;
+const float  ATAN_P1  = -1.38776856032e-1f;
+const float  ATAN_P2  = 1.99777106478e-1f;
+const float  ATAN_P3  = -3.33329491539e-1f;
+const udword INF_BITS = 0x7F800000u;
+const float  ATAN_MIN = 1.17549435e-38f;    // FLT_MIN
+const float  ATAN_MAX = 1.84467441e+19f;    // 2^64
+const float  ATAN_UP  = 1.84467441e+19f;    // 2^64
+const float  ATAN_DN  = 5.42101086e-20f;    // 2^-64
+
+// rsqrt
+const udword RSQRT_MAGIC = 0x5F375A86u;
+
+
+inline
+udword floatToBits
+(
+   const float f
+)
+{
+   udword u;
+   std::memcpy( &u, &f, sizeof(u) );
+   return u;
+}
+
+
+inline
+float bitsToFloat
+(
+   const udword u
+)
+{
+   float f;
+   std::memcpy( &f, &u, sizeof(f) );
+   return f;
+}
+
+
+/**
+ * number - (n * constant), in double.<br/><br/>
+ *
+ * (A float hi/lo split would be as good, but -ffast-math is allowed to sum
+ * the parts first.)
+ */
+inline
+float reduce
+(
+   const float  f,
+   const dword  n,
+   const double constant
+)
+{
+   return static_cast<float>( static_cast<double>(f) -
+      (static_cast<double>(n) * constant) );
+}
+
+
+#if defined(MATHFAST_AVX2)
+
+inline
+__m256 reduce
+(
+   const __m256  f,
+   const __m256i n,
+   const double  constant
+)
+{
+   const __m256d c  = _mm256_set1_pd( constant );
+   const __m256d lo = _mm256_sub_pd( _mm256_cvtps_pd( _mm256_castps256_ps128(
+      f ) ), _mm256_mul_pd( _mm256_cvtepi32_pd( _mm256_castsi256_si128( n ) ),
+      c ) );
+   const __m256d hi = _mm256_sub_pd( _mm256_cvtps_pd( _mm256_extractf128_ps(
+      f, 1 ) ), _mm256_mul_pd( _mm256_cvtepi32_pd( _mm256_extracti128_si256(
+      n, 1 ) ), c ) );
+
+   return _mm256_insertf128_ps( _mm256_castps128_ps256( _mm256_cvtpd_ps(
+      lo ) ), _mm256_cvtpd_ps( hi ), 1 );
+}
+
+#elif defined(MATHFAST_SSE2)
+
+inline
+__m128 reduce
+(
+   const __m128  f,
+   const __m128i n,
+   const double  constant
+)
+{
+   const __m128d c  = _mm_set1_pd( constant );
+   const __m128d lo = _mm_sub_pd( _mm_cvtps_pd( f ), _mm_mul_pd(
+      _mm_cvtepi32_pd( n ), c ) );
+   const __m128d hi = _mm_sub_pd( _mm_cvtps_pd( _mm_movehl_ps( f, f ) ),
+      _mm_mul_pd( _mm_cvtepi32_pd( _mm_shuffle_epi32( n, 0x4E ) ), c ) );
+
+   return _mm_movelh_ps( _mm_cvtpd_ps( lo ), _mm_cvtpd_ps( hi ) );
+}
+
+#endif
+
+}
+
+
+
+
+/// exp ////////////////////////////////////////////////////////////////////////
+
+/**
+ * e^f = 2^n * e^r, n = round(f / ln 2), r = f - (n ln 2), |r| <= (ln 2) / 2.
+ *
+ * The rounding is by truncation of a positive number (the clamping keeps
+ * f / ln 2 above -128).
+ */
+float hxa7241_general::expFast
+(
+   float f
+)
+{
+   // clamp to the normal range of the result
+   f = (f < EXP_MAX) ? f : EXP_MAX;
+   f = (f > EXP_MIN) ? f : EXP_MIN;
+
+   // split into power of two and remainder
+   const dword n = static_cast<dword>( (f * LOG2_E) + 128.5f ) - 128;
+   const float r = reduce( f, n, LN_2 );
+
+   // polynomial for e^r
+   const float p = (((((((((((EXP_P0 * r) + EXP_P1) * r) + EXP_P2) * r) +
+      EXP_P3) * r) + EXP_P4) * r) + EXP_P5) * (r * r)) + r + 1.0f;
+
+   // scale by 2^n
+   return p * bitsToFloat( static_cast<udword>(n + 127) << 23 );
+}
+
+
+void hxa7241_general::expFast
+(
+   const float* pIn,
+   float*       pOut,
+   const dword  count
+)
+{
+   dword i = 0;
+
+#if defined(MATHFAST_AVX2)
+   const __m256  max    = _mm256_set1_ps( EXP_MAX );
+   const __m256  min    = _mm256_set1_ps( EXP_MIN );
+   const __m256  log2e  = _mm256_set1_ps( LOG2_E );
+   const __m256  offset = _mm256_set1_ps( 128.5f );
+   const __m256i i128   = _mm256_set1_epi32( 128 );
+   const __m256i bias   = _mm256_set1_epi32( 127 );
+
+   for( ;  (i + 8) <= count;  i += 8 )
+   {
+      const __m256  f = _mm256_max_ps( _mm256_min_ps( _mm256_loadu_ps( pIn +
+         i ), max ), min );
+
+      // split into power of two and remainder
+      const __m256i n = _mm256_sub_epi32( _mm256_cvttps_epi32( _mm256_add_ps(
+         _mm256_mul_ps( f, log2e ), offset ) ), i128 );
+      const __m256  r = reduce( f, n, LN_2 );
+
+      // polynomial for e^r
+      __m256 p = _mm256_add_ps( _mm256_mul_ps( _mm256_set1_ps( EXP_P0 ), r ),
+         _mm256_set1_ps( EXP_P1 ) );
+      p = _mm256_add_ps( _mm256_mul_ps( p, r ), _mm256_set1_ps( EXP_P2 ) );
+      p = _mm256_add_ps( _mm256_mul_ps( p, r ), _mm256_set1_ps( EXP_P3 ) );
+      p = _mm256_add_ps( _mm256_mul_ps( p, r ), _mm256_set1_ps( EXP_P4 ) );
+      p = _mm256_add_ps( _mm256_mul_ps( p, r ), _mm256_set1_ps( EXP_P5 ) );
+      p = _mm256_add_ps( _mm256_add_ps( _mm256_mul_ps( p, _mm256_mul_ps( r,
+         r ) ), r ), _mm256_set1_ps( 1.0f ) );
+
+      // scale by 2^n
+      _mm256_storeu_ps( pOut + i, _mm256_mul_ps( p, _mm256_castsi256_ps(
+         _mm256_slli_epi32( _mm256_add_epi32( n, bias ), 23 ) ) ) );
+   }
+#elif defined(MATHFAST_SSE2)
+   const __m128  max    = _mm_set1_ps( EXP_MAX );
+   const __m128  min    = _mm_set1_ps( EXP_MIN );
+   const __m128  log2e  = _mm_set1_ps( LOG2_E );
+   const __m128  offset = _mm_set1_ps( 128.5f );
+   const __m128i i128   = _mm_set1_epi32( 128 );
+   const __m128i bias   = _mm_set1_epi32( 127 );
+
+   for( ;  (i + 4) <= count;  i += 4 )
+   {
+      const __m128  f = _mm_max_ps( _mm_min_ps( _mm_loadu_ps( pIn + i ),
+         max ), min );
+
+      const __m128i n = _mm_sub_epi32( _mm_cvttps_epi32( _mm_add_ps(
+         _mm_mul_ps( f, log2e ), offset ) ), i128 );
+      const __m128  r = reduce( f, n, LN_2 );
+
+      __m128 p = _mm_add_ps( _mm_mul_ps( _mm_set1_ps( EXP_P0 ), r ),
+         _mm_set1_ps( EXP_P1 ) );
+      p = _mm_add_ps( _mm_mul_ps( p, r ), _mm_set1_ps( EXP_P2 ) );
+      p = _mm_add_ps( _mm_mul_ps( p, r ), _mm_set1_ps( EXP_P3 ) );
+      p = _mm_add_ps( _mm_mul_ps( p, r ), _mm_set1_ps( EXP_P4 ) );
+      p = _mm_add_ps( _mm_mul_ps( p, r ), _mm_set1_ps( EXP_P5 ) );
+      p = _mm_add_ps( _mm_add_ps( _mm_mul_ps( p, _mm_mul_ps( r, r ) ), r ),
+         _mm_set1_ps( 1.0f ) );
+
+      _mm_storeu_ps( pOut + i, _mm_mul_ps( p, _mm_castsi128_ps(
+         _mm_slli_epi32( _mm_add_epi32( n, bias ), 23 ) ) ) );
+   }
+#endif
+
+   for( ;  i < count;  ++i )
+   {
+      pOut[i] = expFast( pIn[i] );
+   }
+}
+
+
+
+
+/// sin cos ////////////////////////////////////////////////////////////////////
+
+/**
+ * Of |angle|, j = round(|angle| / (pi/2)), r = |angle| - (j pi/2),
+ * |r| <= pi/4. The quadrant (j mod 4) then chooses polynomial and sign:
+ * 0: sin cos, 1: cos -sin, 2: -sin -cos, 3: -cos sin. And sin takes the sign
+ * of angle.
+ */
+void hxa7241_general::sinCosFast
+(
+   const float angle,
+   float&      sin,
+   float&      cos
+)
+{
+   // reduce to +-pi/4, and quadrant
+   const float  a = bitsToFloat( floatToBits( angle ) & ~SIGN_BIT );
+   const dword  j = static_cast<dword>( (a * TWO_PI_R) + 0.5f );
+   const float  r = reduce( a, j, PI_2 );
+   const float  z = r * r;
+
+   // polynomials for sin r and cos r
+   const float ps = ((((((SIN_P0 * z) + SIN_P1) * z) + SIN_P2) * z) * r) + r;
+   const float pc = ((((((COS_P0 * z) + COS_P1) * z) + COS_P2) * z) * z) -
+      (0.5f * z) + 1.0f;
+
+   // choose and sign by quadrant
+   const udword q     = static_cast<udword>(j);
+   const udword signS = ((q & 2u) << 30) ^ (floatToBits( angle ) & SIGN_BIT);
+   const udword signC = ((q + 1u) & 2u) << 30;
+
+   sin = bitsToFloat( floatToBits( (q & 1u) ? pc : ps ) ^ signS );
+   cos = bitsToFloat( floatToBits( (q & 1u) ? ps : pc ) ^ signC );
+}
+
+
+void hxa7241_general::sinCosFast
+(
+   const float* pAngles,
+   float*       pSins,
+   float*       pCoss,
+   const dword  count
+)
+{
+   dword i = 0;
+
+#if defined(MATHFAST_AVX2)
+   const __m256  sign   = _mm256_castsi256_ps( _mm256_set1_epi32( SIGN_BIT ) );
+   const __m256  twoPiR = _mm256_set1_ps( TWO_PI_R );
+   const __m256  half   = _mm256_set1_ps( 0.5f );
+   const __m256i one    = _mm256_set1_epi32( 1 );
+   const __m256i two    = _mm256_set1_epi32( 2 );
+
+   for( ;  (i + 8) <= count;  i += 8 )
+   {
+      // reduce to +-pi/4, and quadrant
+      const __m256  angle = _mm256_loadu_ps( pAngles + i );
+      const __m256  a     = _mm256_andnot_ps( sign, angle );
+      const __m256i j     = _mm256_cvttps_epi32( _mm256_add_ps( _mm256_mul_ps(
+         a, twoPiR ), half ) );
+      const __m256  r     = reduce( a, j, PI_2 );
+      const __m256  z     = _mm256_mul_ps( r, r );
+
+      // polynomials for sin r and cos r
+      __m256 ps = _mm256_add_ps( _mm256_mul_ps( _mm256_set1_ps( SIN_P0 ), z ),
+         _mm256_set1_ps( SIN_P1 ) );
+      ps = _mm256_add_ps( _mm256_mul_ps( ps, z ), _mm256_set1_ps( SIN_P2 ) );
+      ps = _mm256_add_ps( _mm256_mul_ps( _mm256_mul_ps( ps, z ), r ), r );
+
+      __m256 pc = _mm256_add_ps( _mm256_mul_ps( _mm256_set1_ps( COS_P0 ), z ),
+         _mm256_set1_ps( COS_P1 ) );
+      pc = _mm256_add_ps( _mm256_mul_ps( pc, z ), _mm256_set1_ps( COS_P2 ) );
+      pc = _mm256_add_ps( _mm256_sub_ps( _mm256_mul_ps( _mm256_mul_ps( pc, z ),
+         z ), _mm256_mul_ps( half, z ) ), _mm256_set1_ps( 1.0f ) );
+
+      // choose and sign by quadrant
+      const __m256  swap  = _mm256_castsi256_ps( _mm256_cmpeq_epi32(
+         _mm256_and_si256( j, one ), one ) );
+      const __m256  signS = _mm256_xor_ps( _mm256_castsi256_ps(
+         _mm256_slli_epi32( _mm256_and_si256( j, two ), 30 ) ),
+         _mm256_and_ps( angle, sign ) );
+      const __m256  signC = _mm256_castsi256_ps( _mm256_slli_epi32(
+         _mm256_and_si256( _mm256_add_epi32( j, one ), two ), 30 ) );
+
+      _mm256_storeu_ps( pSins + i, _mm256_xor_ps( _mm256_blendv_ps( ps, pc,
+         swap ), signS ) );
+      _mm256_storeu_ps( pCoss + i, _mm256_xor_ps( _mm256_blendv_ps( pc, ps,
+         swap ), signC ) );
+   }
+#elif defined(MATHFAST_SSE2)
+   const __m128  sign   = _mm_castsi128_ps( _mm_set1_epi32( SIGN_BIT ) );
+   const __m128  twoPiR = _mm_set1_ps( TWO_PI_R );
+   const __m128  half   = _mm_set1_ps( 0.5f );
+   const __m128i one    = _mm_set1_epi32( 1 );
+   const __m128i two    = _mm_set1_epi32( 2 );
+
+   for( ;  (i + 4) <= count;  i += 4 )
+   {
+      const __m128  angle = _mm_loadu_ps( pAngles + i );
+      const __m128  a     = _mm_andnot_ps( sign, angle );
+      const __m128i j     = _mm_cvttps_epi32( _mm_add_ps( _mm_mul_ps( a,
+         twoPiR ), half ) );
+      const __m128  r     = reduce( a, j, PI_2 );
+      const __m128  z     = _mm_mul_ps( r, r );
+
+      __m128 ps = _mm_add_ps( _mm_mul_ps( _mm_set1_ps( SIN_P0 ), z ),
+         _mm_set1_ps( SIN_P1 ) );
+      ps = _mm_add_ps( _mm_mul_ps( ps, z ), _mm_set1_ps( SIN_P2 ) );
+      ps = _mm_add_ps( _mm_mul_ps( _mm_mul_ps( ps, z ), r ), r );
+
+      __m128 pc = _mm_add_ps( _mm_mul_ps( _mm_set1_ps( COS_P0 ), z ),
+         _mm_set1_ps( COS_P1 ) );
+      pc = _mm_add_ps( _mm_mul_ps( pc, z ), _mm_set1_ps( COS_P2 ) );
+      pc = _mm_add_ps( _mm_sub_ps( _mm_mul_ps( _mm_mul_ps( pc, z ), z ),
+         _mm_mul_ps( half, z ) ), _mm_set1_ps( 1.0f ) );
+
+      // (no blendv in SSE2)
+      const __m128  swap  = _mm_castsi128_ps( _mm_cmpeq_epi32( _mm_and_si128(
+         j, one ), one ) );
+      const __m128  signS = _mm_xor_ps( _mm_castsi128_ps( _mm_slli_epi32(
+         _mm_and_si128( j, two ), 30 ) ), _mm_and_ps( angle, sign ) );
+      const __m128  signC = _mm_castsi128_ps( _mm_slli_epi32( _mm_and_si128(
+         _mm_add_epi32( j, one ), two ), 30 ) );
+
+      _mm_storeu_ps( pSins + i, _mm_xor_ps( _mm_or_ps( _mm_and_ps( swap, pc ),
+         _mm_andnot_ps( swap, ps ) ), signS ) );
+      _mm_storeu_ps( pCoss + i, _mm_xor_ps( _mm_or_ps( _mm_and_ps( swap, ps ),
+         _mm_andnot_ps( swap, pc ) ), signC ) );
+   }
+#endif
+
+   for( ;  i < count;  ++i )
+   {
+      sinCosFast( pAngles[i], pSins[i], pCoss[i] );
+   }
+}
+
+
+
+
+/// atan2 //////////////////////////////////////////////////////////////////////
+
+/**
+ * atan of a = min(|x|,|y|) / max(|x|,|y|), in 0 to 1; reduced further to
+ * 0 to tan(pi/8) by atan a = pi/4 + atan((a - 1) / (a + 1)). Then reflected
+ * into the octant of (x, y).<br/><br/>
+ *
+ * Infinities become 1, and the other magnitude 0, so inf / inf is not taken.
+ * (The array forms also scale very small and very big magnitudes by 2^64 or
+ * 2^-64 before dividing, since -ffast-math compiles a vector divide to a
+ * reciprocal estimate, which flushes outside the normal range.)
+ */
+float hxa7241_general::atan2Fast
+(
+   const float y,
+   const float x
+)
+{
+   // infinities to 1, and the other magnitude to 0
+   const udword bx    = floatToBits( x ) & ~SIGN_BIT;
+   const udword by    = floatToBits( y ) & ~SIGN_BIT;
+   const bool   isInf = (INF_BITS == bx) | (INF_BITS == by);
+   const float  ax    = isInf ? static_cast<float>(INF_BITS == bx) :
+      bitsToFloat( bx );
+   const float  ay    = isInf ? static_cast<float>(INF_BITS == by) :
+      bitsToFloat( by );
+
+   // ratio of smaller to larger magnitude
+   const float  mx    = (ax > ay) ? ax : ay;
+   const float  mn    = (ax > ay) ? ay : ax;
+   const float  a     = (mx > 0.0f) ? (mn / mx) : 0.0f;
+
+   // reduce to 0 to tan(pi/8)
+   const bool  isBig = a > TAN_PI_8;
+   const float b     = isBig ? ((a - 1.0f) / (a + 1.0f)) : a;
+   const float z     = b * b;
+
+   // polynomial for atan b
+   float r = ((((((((ATAN_P0 * z) + ATAN_P1) * z) + ATAN_P2) * z) + ATAN_P3) *
+      z) * b) + b + (isBig ? PI_4F : 0.0f);
+
+   // reflect into octant
+   r = (ay > ax)   ? (PI_2F - r) : r;
+   r = (x < 0.0f) ? (PIF - r)   : r;
+
+   return bitsToFloat( floatToBits( r ) ^ (floatToBits( y ) & SIGN_BIT) );
+}
+
+
+void hxa7241_general::atan2Fast
+(
+   const float* pYs,
+   const float* pXs,
+   float*       pOut,
+   const dword  count
+)
+{
+   dword i = 0;
+
+#if defined(MATHFAST_AVX2)
+   const __m256 sign   = _mm256_castsi256_ps( _mm256_set1_epi32( SIGN_BIT ) );
+   const __m256 zero   = _mm256_setzero_ps();
+   const __m256 one    = _mm256_set1_ps( 1.0f );
+   const __m256 tanPi8 = _mm256_set1_ps( TAN_PI_8 );
+   const __m256i inf   = _mm256_set1_epi32( INF_BITS );
+
+   for( ;  (i + 8) <= count;  i += 8 )
+   {
+      // infinities to 1, and the other magnitude to 0
+      const __m256 y     = _mm256_loadu_ps( pYs + i );
+      const __m256 x     = _mm256_loadu_ps( pXs + i );
+      const __m256 xInf  = _mm256_castsi256_ps( _mm256_cmpeq_epi32(
+         _mm256_castps_si256( _mm256_andnot_ps( sign, x ) ), inf ) );
+      const __m256 yInf  = _mm256_castsi256_ps( _mm256_cmpeq_epi32(
+         _mm256_castps_si256( _mm256_andnot_ps( sign, y ) ), inf ) );
+      const __m256 isInf = _mm256_or_ps( xInf, yInf );
+      __m256 ax = _mm256_blendv_ps( _mm256_andnot_ps( sign, x ),
+         _mm256_and_ps( xInf, one ), isInf );
+      __m256 ay = _mm256_blendv_ps( _mm256_andnot_ps( sign, y ),
+         _mm256_and_ps( yInf, one ), isInf );
+
+      // scale into the reciprocal estimate's range (exactly)
+      __m256 mx = _mm256_max_ps( ax, ay );
+      const __m256 isTiny = _mm256_cmp_ps( mx, _mm256_set1_ps( ATAN_MIN ),
+         _CMP_LT_OQ );
+      const __m256 isHuge = _mm256_cmp_ps( mx, _mm256_set1_ps( ATAN_MAX ),
+         _CMP_GE_OQ );
+      const __m256 scale  = _mm256_blendv_ps( _mm256_blendv_ps( one,
+         _mm256_set1_ps( ATAN_UP ), isTiny ), _mm256_set1_ps( ATAN_DN ),
+         isHuge );
+      ax = _mm256_mul_ps( ax, scale );
+      ay = _mm256_mul_ps( ay, scale );
+      mx = _mm256_mul_ps( mx, scale );
+
+      // ratio of smaller to larger magnitude
+      const __m256 a  = _mm256_and_ps( _mm256_cmp_ps( mx, zero, _CMP_GT_OQ ),
+         _mm256_div_ps( _mm256_min_ps( ax, ay ), mx ) );
+
+      // reduce to 0 to tan(pi/8)
+      const __m256 isBig = _mm256_cmp_ps( a, tanPi8, _CMP_GT_OQ );
+      const __m256 b     = _mm256_blendv_ps( a, _mm256_div_ps( _mm256_sub_ps(
+         a, one ), _mm256_add_ps( a, one ) ), isBig );
+      const __m256 z     = _mm256_mul_ps( b, b );
+
+      // polynomial for atan b
+      __m256 r = _mm256_add_ps( _mm256_mul_ps( _mm256_set1_ps( ATAN_P0 ), z ),
+         _mm256_set1_ps( ATAN_P1 ) );
+      r = _mm256_add_ps( _mm256_mul_ps( r, z ), _mm256_set1_ps( ATAN_P2 ) );
+      r = _mm256_add_ps( _mm256_mul_ps( r, z ), _mm256_set1_ps( ATAN_P3 ) );
+      r = _mm256_add_ps( _mm256_add_ps( _mm256_mul_ps( _mm256_mul_ps( r, z ),
+         b ), b ), _mm256_and_ps( isBig, _mm256_set1_ps( PI_4F ) ) );
+
+      // reflect into octant
+      r = _mm256_blendv_ps( r, _mm256_sub_ps( _mm256_set1_ps( PI_2F ), r ),
+         _mm256_cmp_ps( ay, ax, _CMP_GT_OQ ) );
+      r = _mm256_blendv_ps( r, _mm256_sub_ps( _mm256_set1_ps( PIF ), r ),
+         _mm256_cmp_ps( x, zero, _CMP_LT_OQ ) );
+
+      _mm256_storeu_ps( pOut + i, _mm256_xor_ps( r, _mm256_and_ps( y,
+         sign ) ) );
+   }
+#elif defined(MATHFAST_SSE2)
+   const __m128 sign   = _mm_castsi128_ps( _mm_set1_epi32( SIGN_BIT ) );
+   const __m128 zero   = _mm_setzero_ps();
+   const __m128 one    = _mm_set1_ps( 1.0f );
+   const __m128 tanPi8 = _mm_set1_ps( TAN_PI_8 );
+   const __m128i inf   = _mm_set1_epi32( INF_BITS );
+
+   for( ;  (i + 4) <= count;  i += 4 )
+   {
+      const __m128 y     = _mm_loadu_ps( pYs + i );
+      const __m128 x     = _mm_loadu_ps( pXs + i );
+      const __m128 xInf  = _mm_castsi128_ps( _mm_cmpeq_epi32(
+         _mm_castps_si128( _mm_andnot_ps( sign, x ) ), inf ) );
+      const __m128 yInf  = _mm_castsi128_ps( _mm_cmpeq_epi32(
+         _mm_castps_si128( _mm_andnot_ps( sign, y ) ), inf ) );
+      const __m128 isInf = _mm_or_ps( xInf, yInf );
+      __m128 ax = _mm_or_ps( _mm_and_ps( isInf, _mm_and_ps( xInf, one ) ),
+         _mm_andnot_ps( isInf, _mm_andnot_ps( sign, x ) ) );
+      __m128 ay = _mm_or_ps( _mm_and_ps( isInf, _mm_and_ps( yInf, one ) ),
+         _mm_andnot_ps( isInf, _mm_andnot_ps( sign, y ) ) );
+
+      __m128 mx = _mm_max_ps( ax, ay );
+      const __m128 isTiny = _mm_cmplt_ps( mx, _mm_set1_ps( ATAN_MIN ) );
+      const __m128 isHuge = _mm_cmpge_ps( mx, _mm_set1_ps( ATAN_MAX ) );
+      const __m128 scale  = _mm_or_ps( _mm_or_ps( _mm_and_ps( isTiny,
+         _mm_set1_ps( ATAN_UP ) ), _mm_and_ps( isHuge, _mm_set1_ps(
+         ATAN_DN ) ) ), _mm_andnot_ps( _mm_or_ps( isTiny, isHuge ), one ) );
+      ax = _mm_mul_ps( ax, scale );
+      ay = _mm_mul_ps( ay, scale );
+      mx = _mm_mul_ps( mx, scale );
+
+      const __m128 a  = _mm_and_ps( _mm_cmpgt_ps( mx, zero ), _mm_div_ps(
+         _mm_min_ps( ax, ay ), mx ) );
+
+      const __m128 isBig = _mm_cmpgt_ps( a, tanPi8 );
+      const __m128 b     = _mm_or_ps( _mm_and_ps( isBig, _mm_div_ps(
+         _mm_sub_ps( a, one ), _mm_add_ps( a, one ) ) ), _mm_andnot_ps(
+         isBig, a ) );
+      const __m128 z     = _mm_mul_ps( b, b );
+
+      __m128 r = _mm_add_ps( _mm_mul_ps( _mm_set1_ps( ATAN_P0 ), z ),
+         _mm_set1_ps( ATAN_P1 ) );
+      r = _mm_add_ps( _mm_mul_ps( r, z ), _mm_set1_ps( ATAN_P2 ) );
+      r = _mm_add_ps( _mm_mul_ps( r, z ), _mm_set1_ps( ATAN_P3 ) );
+      r = _mm_add_ps( _mm_add_ps( _mm_mul_ps( _mm_mul_ps( r, z ), b ), b ),
+         _mm_and_ps( isBig, _mm_set1_ps( PI_4F ) ) );
+
+      // (no blendv in SSE2)
+      const __m128 isSteep = _mm_cmpgt_ps( ay, ax );
+      r = _mm_or_ps( _mm_and_ps( isSteep, _mm_sub_ps( _mm_set1_ps( PI_2F ),
+         r ) ), _mm_andnot_ps( isSteep, r ) );
+      const __m128 isLeft  = _mm_cmplt_ps( x, zero );
+      r = _mm_or_ps( _mm_and_ps( isLeft, _mm_sub_ps( _mm_set1_ps( PIF ),
+         r ) ), _mm_andnot_ps( isLeft, r ) );
+
+      _mm_storeu_ps( pOut + i, _mm_xor_ps( r, _mm_and_ps( y, sign ) ) );
+   }
+#endif
+
+   for( ;  i < count;  ++i )
+   {
+      pOut[i] = atan2Fast( pYs[i], pXs[i] );
+   }
+}
+
+
+
+
+/// rsqrt //////////////////////////////////////////////////////////////////////
+
+/**
+ * Integer estimate from the float bits (Lomont's constant), then two
+ * Newton-Raphson steps: y' = (y / 2) (3 - f y y).<br/><br/>
+ *
+ * (Grouped so no intermediate leaves the normal range, else flush-to-zero
+ * would lose it: hence the domain limits.)
+ */
+float hxa7241_general::rsqrtFast
+(
+   const float f
+)
+{
+   const float y0 = bitsToFloat( RSQRT_MAGIC - (floatToBits( f ) >> 1) );
+   const float y1 = (0.5f * y0) * (3.0f - (f * y0 * y0));
+
+   return (0.5f * y1) * (3.0f - (f * y1 * y1));
+}
+
+
+void hxa7241_general::rsqrtFast
+(
+   const float* pIn,
+   float*       pOut,
+   const dword  count
+)
+{
+   dword i = 0;
+
+#if defined(MATHFAST_AVX2)
+   const __m256i magic = _mm256_set1_epi32( RSQRT_MAGIC );
+   const __m256  half  = _mm256_set1_ps( 0.5f );
+   const __m256  three = _mm256_set1_ps( 3.0f );
+
+   for( ;  (i + 8) <= count;  i += 8 )
+   {
+      const __m256 f  = _mm256_loadu_ps( pIn + i );
+      const __m256 y0 = _mm256_castsi256_ps( _mm256_sub_epi32( magic,
+         _mm256_srli_epi32( _mm256_castps_si256( f ), 1 ) ) );
+      const __m256 y1 = _mm256_mul_ps( _mm256_mul_ps( half, y0 ),
+         _mm256_sub_ps( three, _mm256_mul_ps( _mm256_mul_ps( f, y0 ), y0 ) ) );
+
+      _mm256_storeu_ps( pOut + i, _mm256_mul_ps( _mm256_mul_ps( half, y1 ),
+         _mm256_sub_ps( three, _mm256_mul_ps( _mm256_mul_ps( f, y1 ),
+         y1 ) ) ) );
+   }
+#elif defined(MATHFAST_SSE2)
+   const __m128i magic = _mm_set1_epi32( RSQRT_MAGIC );
+   const __m128  half  = _mm_set1_ps( 0.5f );
+   const __m128  three = _mm_set1_ps( 3.0f );
+
+   for( ;  (i + 4) <= count;  i += 4 )
+   {
+      const __m128 f  = _mm_loadu_ps( pIn + i );
+      const __m128 y0 = _mm_castsi128_ps( _mm_sub_epi32( magic,
+         _mm_srli_epi32( _mm_castps_si128( f ), 1 ) ) );
+      const __m128 y1 = _mm_mul_ps( _mm_mul_ps( half, y0 ), _mm_sub_ps(
+         three, _mm_mul_ps( _mm_mul_ps( f, y0 ), y0 ) ) );
+
+      _mm_storeu_ps( pOut + i, _mm_mul_ps( _mm_mul_ps( half, y1 ),
+         _mm_sub_ps( three, _mm_mul_ps( _mm_mul_ps( f, y1 ), y1 ) ) ) );
+   }
+#endif
+
+   for( ;  i < count;  ++i )
+   {
+      pOut[i] = rsqrtFast( pIn[i] );
+   }
+}
+
+
+
+
+/// test ///////////////////////////////////////////////////////////////////////
+#ifdef TESTING
+
+
+#include <float.h>
+#include <math.h>
+#include <ostream>
+#include <iomanip>
+#include <vector>
+
+#include "Stopwatch.hpp"
+
+
+namespace
+{
+
+typedef double (*Reference)( double );
+typedef float  (*One)( float );
+typedef void   (*Many)( const float*, float*, dword );
+
+
+/// one-argument forms of everything, to scan and compare alike
+
+double expD( const double d )
+{
+   return ::exp( d );
+}
+
+double sinD( const double d )
+{
+   return ::sin( d );
+}
+
+double cosD( const double d )
+{
+   return ::cos( d );
+}
+
+double rsqrtD( const double d )
+{
+   return 1.0 / ::sqrt( d );
+}
+
+template<dword X>
+double atan2YD( const double y )
+{
+   return ::atan2( y, static_cast<double>(X) );
+}
+
+template<dword Y>
+double atan2XD( const double x )
+{
+   return ::atan2( static_cast<double>(Y), x );
+}
+
+
+float sinOne( const float f )
+{
+   float s, c;
+   sinCosFast( f, s, c );
+   return s;
+}
+
+float cosOne( const float f )
+{
+   float s, c;
+   sinCosFast( f, s, c );
+   return c;
+}
+
+void sinMany( const float* pIn, float* pOut, const dword count )
+{
+   std::vector<float> other( count + 1 );
+   sinCosFast( pIn, pOut, &other[0], count );
+}
+
+void cosMany( const float* pIn, float* pOut, const dword count )
+{
+   std::vector<float> other( count + 1 );
+   sinCosFast( pIn, &other[0], pOut, count );
+}
+
+template<dword X>
+float atan2YOne( const float y )
+{
+   return atan2Fast( y, static_cast<float>(X) );
+}
+
+template<dword Y>
+float atan2XOne( const float x )
+{
+   return atan2Fast( static_cast<float>(Y), x );
+}
+
+template<dword X>
+void atan2YMany( const float* pIn, float* pOut, const dword count )
+{
+   const std::vector<float> xs( count + 1, static_cast<float>(X) );
+   atan2Fast( pIn, &xs[0], pOut, count );
+}
+
+template<dword Y>
+void atan2XMany( const float* pIn, float* pOut, const dword count )
+{
+   const std::vector<float> ys( count + 1, static_cast<float>(Y) );
+   atan2Fast( &ys[0], pIn, pOut, count );
+}
+
+
+/**
+ * Error against double precision, of every float in [lower,upper] when
+ * verbose, else every 4093rd (prime, so the low mantissa bits vary too). And
+ * arrays same as one at a time.
+ */
+bool scanOneFunction
+(
+   std::ostream* pOut,
+   const bool    isVerbose,
+   const char*   name,
+   Reference     reference,
+   One           one,
+   Many          many,
+   const float   lower,
+   const float   upper,
+   const bool    isRelative,
+   const double  meanMax,
+   const double  maxMax
+)
+{
+   static const dword BATCH = 1024;
+   const udword stride = isVerbose ? 1 : 4093;
+
+   std::vector<float> numbers( BATCH );
+   std::vector<float> results( BATCH );
+
+   double sumDif = 0.0;
+   double maxDif = 0.0;
+   float  maxAt  = 0.0f;
+   double count  = 0.0;
+   bool   isSame = true;
+
+   for( udword u = 0;  ; )
+   {
+      // gather a batch of numbers in range (and not inf or nan)
+      dword n = 0;
+      for( ;  (n < BATCH) && (u <= (0xFFFFFFFFu - stride));  u += stride )
+      {
+         if( (u & ~SIGN_BIT) < 0x7F800000u )
+         {
+            const float f = bitsToFloat( u );
+            if( (f >= lower) & (f <= upper) )
+            {
+               numbers[n++] = f;
+            }
+         }
+      }
+      if( 0 == n )
+      {
+         break;
+      }
+
+      many( &numbers[0], &results[0], n );
+
+      for( dword i = 0;  i < n;  ++i )
+      {
+         const double r     = static_cast<double>(one( numbers[i] ));
+         const double e     = reference( static_cast<double>(numbers[i]) );
+         const double scale = isRelative ? ::fabs( e ) : 1.0;
+
+         const double dif = ::fabs( r - e ) / scale;
+         sumDif += dif;
+         if( dif > maxDif )
+         {
+            maxDif = dif;
+            maxAt  = numbers[i];
+         }
+
+         isSame &= ::fabs( static_cast<double>(results[i]) - r ) <=
+            (2.5e-7 * scale);
+      }
+      count += static_cast<double>(n);
+   }
+
+   const double meanDif = sumDif / count;
+
+   if( pOut && isVerbose ) *pOut << std::scientific <<
+      "count: " << count << "  mean diff: " << meanDif << "  max diff: " <<
+      maxDif << "  (at " << maxAt << ")\n";
+
+   const bool isOk = (meanDif < meanMax) & (maxDif < maxMax) & isSame;
+
+   if( pOut ) *pOut << name << " : " <<
+      (isOk ? "--- succeeded" : "*** failed") << "\n\n";
+
+   return isOk;
+}
+
+
+/**
+ * Arrays: for various counts and alignments, and in place, and not writing
+ * beyond.
+ */
+bool testArrays
+(
+   std::ostream* pOut
+)
+{
+   bool isOk = true;
+
+   static const dword COUNTS[] = { 0, 1, 7, 8, 9, 31 };
+
+   std::vector<float> numbers( 31 + 2 );
+   std::vector<float> magnitudes( 31 + 2 );
+   for( dword i = 0;  i < 31 + 2;  ++i )
+   {
+      numbers[i]    = (static_cast<float>(i) * 0.61803399f) - 9.5f;
+      magnitudes[i] = ::fabsf( numbers[i] ) + 0.1f;
+   }
+
+   for( dword c = 0;  c < 6;  ++c )
+   {
+      for( dword start = 0;  start < 2;  ++start )
+      {
+         const dword  count = COUNTS[c];
+         const float* pIn   = &numbers[start];
+         const float* pMag  = &magnitudes[start];
+
+         std::vector<float> results( count + 1, -1.0f );
+         std::vector<float> sins( count + 1, -1.0f );
+         std::vector<float> coss( count + 1, -1.0f );
+         std::vector<float> inPlace( pIn, pIn + count + 1 );
+
+         bool isInPlaceOk = true;
+         for( dword f = 0;  f < 4;  ++f )
+         {
+            switch( f )
+            {
+               case 0 : expFast( pIn, &results[0], count );  break;
+               case 1 : atan2Fast( pIn, pIn + 1, &results[0], count );  break;
+               case 2 : rsqrtFast( pMag, &results[0], count );  break;
+               case 3 : sinCosFast( pIn, &sins[0], &coss[0], count );  break;
+            }
+
+            for( dword i = 0;  i < count;  ++i )
+            {
+               switch( f )
+               {
+                  case 0 : isOk &= ::fabsf( results[i] - expFast( pIn[i] ) )
+                     <= 2.5e-7f * expFast( pIn[i] );  break;
+                  case 1 : isOk &= ::fabsf( results[i] - atan2Fast( pIn[i],
+                     pIn[i + 1] ) ) <= 2.5e-7f;  break;
+                  case 2 : isOk &= ::fabsf( results[i] - rsqrtFast(
+                     pMag[i] ) ) <= 2.5e-7f * results[i];  break;
+                  case 3 :
+                  {
+                     float s, c;
+                     sinCosFast( pIn[i], s, c );
+                     isOk &= (::fabsf( sins[i] - s ) <= 2.5e-7f) &
+                        (::fabsf( coss[i] - c ) <= 2.5e-7f);
+                     break;
+                  }
+               }
+            }
+            isOk &= (-1.0f == results[count]) & (-1.0f == sins[count]) &
+               (-1.0f == coss[count]);
+         }
+
+         // in place
+         expFast( &inPlace[0], &inPlace[0], count );
+         sinCosFast( &inPlace[0], &inPlace[0], &coss[0], count );
+         for( dword i = 0;  i < count;  ++i )
+         {
+            float s, c;
+            sinCosFast( expFast( pIn[i] ), s, c );
+            isInPlaceOk &= (::fabsf( inPlace[i] - s ) <= 2.5e-7f);
+         }
+         isOk &= isInPlaceOk & (pIn[count] == inPlace[count]);
+      }
+   }
+
+   if( pOut ) *pOut << "arrays : " <<
+      (isOk ? "--- succeeded" : "*** failed") << "\n\n";
+
+   return isOk;
+}
+
+
+/**
+ * Particular values: exact points, clamping, quadrants.
+ */
+bool testSpecials
+(
+   std::ostream* pOut
+)
+{
+   bool isOk = true;
+
+   static const float PI = 3.14159265358979f;
+
+   // exp
+   isOk &= ::fabsf( expFast( 0.0f ) - 1.0f ) <= 1e-7f;
+   isOk &= ::fabsf( expFast( 1.0f ) - 2.71828183f ) <= 3e-7f;
+   isOk &= (expFast( 1000.0f ) == expFast( 88.37f )) &
+      (expFast( 1000.0f ) <= FLT_MAX);
+   isOk &= (expFast( -1000.0f ) == expFast( -87.3f )) &
+      (expFast( -1000.0f ) >= FLT_MIN);
+
+   // sin cos
+   {
+      static const float ANGLES[] = { 0.0f, PI / 6.0f, PI / 2.0f, PI,
+         -PI / 2.0f, 3.0f * PI / 2.0f, 1000.0f };
+      static const float SINS[]   = { 0.0f, 0.5f, 1.0f, 0.0f, -1.0f, -1.0f,
+         0.826879541f };
+      static const float COSS[]   = { 1.0f, 0.866025404f, 0.0f, -1.0f, 0.0f,
+         0.0f, 0.562379076f };
+      for( dword i = 0;  i < 7;  ++i )
+      {
+         float s, c;
+         sinCosFast( ANGLES[i], s, c );
+         isOk &= (::fabsf( s - SINS[i] ) <= 2e-7f) &
+            (::fabsf( c - COSS[i] ) <= 2e-7f);
+      }
+   }
+
+   // atan2 (and subnormals, very big, and infinities)
+   {
+      static const dword COUNT = 23;
+
+      const float INF  = bitsToFloat( 0x7F800000u );
+      const float SUB1 = bitsToFloat( 0x00000100u );
+      const float SUB3 = bitsToFloat( 0x00000300u );
+
+      const float YS[]     = { 0.0f, 1.0f, 1.0f, 0.0f, -1.0f, -1.0f,
+         -1.0f, 0.0f, 1.0f, 1e-30f, 1e30f,
+         1e-38f, 1e-40f, -SUB3, 1e-40f, 3.4e38f, -3e38f,
+         INF, -INF, INF, 1.0f, -1.0f, INF };
+      const float XS[]     = { 0.0f, 1.0f, 0.0f, -1.0f, -1.0f, 0.0f,
+         1.0f, 1.0f, -1.0f, -1e30f, 1e-30f,
+         -1e-38f, 1e-40f, SUB1, 0.0f, 3.4e38f, -1e38f,
+         INF, -INF, -1.0f, -INF, INF, 1e30f };
+      const float ANGLES[] = { 0.0f, PI / 4.0f, PI / 2.0f, PI,
+         -3.0f * PI / 4.0f, -PI / 2.0f, -PI / 4.0f, 0.0f, 3.0f * PI / 4.0f, PI,
+         PI / 2.0f,
+         3.0f * PI / 4.0f, PI / 4.0f, -1.24904577f, PI / 2.0f, PI / 4.0f,
+         -1.89254688f,
+         PI / 4.0f, -3.0f * PI / 4.0f, PI / 2.0f, PI, 0.0f, PI / 2.0f };
+
+      // arrays: each repeated, to fill whole registers
+      std::vector<float> ys( COUNT * 8 );
+      std::vector<float> xs( COUNT * 8 );
+      std::vector<float> angles( COUNT * 8 );
+      for( dword i = 0;  i < (COUNT * 8);  ++i )
+      {
+         ys[i] = YS[i / 8];
+         xs[i] = XS[i / 8];
+      }
+      atan2Fast( &ys[0], &xs[0], &angles[0], COUNT * 8 );
+
+      for( dword i = 0;  i < (COUNT * 8);  ++i )
+      {
+         const float angle = atan2Fast( ys[i], xs[i] );
+         isOk &= (::fabsf( angle - ANGLES[i / 8] ) <= 3e-7f) &
+            (::fabsf( angles[i] - angle ) <= 2.5e-7f);
+      }
+   }
+
+   // rsqrt
+   isOk &= ::fabsf( rsqrtFast( 4.0f ) - 0.5f ) <= 0.5f * 5e-6f;
+   isOk &= ::fabsf( rsqrtFast( 1e-30f ) - 1e15f ) <= 1e15f * 5e-6f;
+
+   if( pOut ) *pOut << "specials : " <<
+      (isOk ? "--- succeeded" : "*** failed") << "\n\n";
+
+   return isOk;
+}
+
+
+void benchmark
+(
+   std::ostream& out
+)
+{
+   static const dword COUNT = 1 << 16;
+   static const dword TIMES = 64;
+
+   std::vector<float> numbers( COUNT );
+   std::vector<float> numbers2( COUNT );
+   std::vector<float> results( COUNT );
+   std::vector<float> results2( COUNT );
+   for( dword i = 0;  i < COUNT;  ++i )
+   {
+      numbers[i]  = (static_cast<float>(i) * (20.0f / COUNT)) - 10.0f + 1e-3f;
+      numbers2[i] = 13.5f - (static_cast<float>(i) * (13.0f / COUNT));
+   }
+
+   // (changing an input each time, so the work is not hoisted)
+   double times[4][3];
+   Stopwatch stopwatch;
+
+   for( dword f = 0;  f < 4;  ++f )
+   {
+      for( dword k = 0;  k < 3;  ++k )
+      {
+         stopwatch.start();
+         for( dword t = TIMES;  t-- > 0; )
+         {
+            numbers[t]  += 1e-3f;
+            numbers2[t] += 1e-3f;
+            switch( (f * 3) + k )
+            {
+               case 0 : for( dword i = 0;  i < COUNT;  ++i ) {
+                  results[i] = ::expf( numbers[i] ); }  break;
+               case 1 : for( dword i = 0;  i < COUNT;  ++i ) {
+                  results[i] = expFast( numbers[i] ); }  break;
+               case 2 : expFast( &numbers[0], &results[0], COUNT );  break;
+
+               case 3 : for( dword i = 0;  i < COUNT;  ++i ) {
+                  results[i]  = ::sinf( numbers[i] );
+                  results2[i] = ::cosf( numbers[i] ); }  break;
+               case 4 : for( dword i = 0;  i < COUNT;  ++i ) {
+                  sinCosFast( numbers[i], results[i], results2[i] ); }  break;
+               case 5 : sinCosFast( &numbers[0], &results[0], &results2[0],
+                  COUNT );  break;
+
+               case 6 : for( dword i = 0;  i < COUNT;  ++i ) {
+                  results[i] = ::atan2f( numbers[i], numbers2[i] ); }  break;
+               case 7 : for( dword i = 0;  i < COUNT;  ++i ) {
+                  results[i] = atan2Fast( numbers[i], numbers2[i] ); }  break;
+               case 8 : atan2Fast( &numbers[0], &numbers2[0], &results[0],
+                  COUNT );  break;
+
+               case 9 : for( dword i = 0;  i < COUNT;  ++i ) {
+                  results[i] = 1.0f / ::sqrtf( numbers2[i] ); }  break;
+               case 10 : for( dword i = 0;  i < COUNT;  ++i ) {
+                  results[i] = rsqrtFast( numbers2[i] ); }  break;
+               case 11 : rsqrtFast( &numbers2[0], &results[0], COUNT );  break;
+            }
+         }
+         times[f][k] = stopwatch.getSeconds();
+      }
+   }
+
+   static const char* NAMES[] = { "exp     ", "sin cos ", "atan2   ",
+      "rsqrt   " };
+
+   const double scale = 1e9 / (static_cast<double>(COUNT) * TIMES);
+   out << std::fixed << std::setprecision( 2 ) <<
+      "benchmark  (ns per element: std, fast one, fast array)\n";
+   for( dword f = 0;  f < 4;  ++f )
+   {
+      out << "   " << NAMES[f] << (times[f][0] * scale) << "  " <<
+         (times[f][1] * scale) << "  " << (times[f][2] * scale) << "\n";
+   }
+   out << "   (check " << results[7] << " " << results2[7] << ")\n\n" <<
+      std::setprecision( 6 );
+}
+
+}
+
+
+namespace hxa7241_general
+{
+
+bool test_MathFast
+(
+   std::ostream* pOut,
+   const bool    isVerbose,
+   const dword   //seed
+)
+{
+   bool isOk = true;
+
+   if( pOut ) *pOut << "[ test_MathFast ]\n\n";
+
+
+   // scans
+   {
+      isOk &= scanOneFunction( pOut, isVerbose, "exp", &expD, &expFast,
+         &expFast, -87.3f, 88.3f, true, 1e-8, 2e-7 );
+
+      isOk &= scanOneFunction( pOut, isVerbose, "sin", &sinD, &sinOne,
+         &sinMany, -65536.0f, 65536.0f, false, 1e-8, 1e-7 );
+      isOk &= scanOneFunction( pOut, isVerbose, "cos", &cosD, &cosOne,
+         &cosMany, -65536.0f, 65536.0f, false, 1e-8, 1e-7 );
+
+      isOk &= scanOneFunction( pOut, isVerbose, "atan2 (f, +1)",
+         &atan2YD<+1>, &atan2YOne<+1>, &atan2YMany<+1>, -FLT_MAX, FLT_MAX,
+         false, 1e-7, 3e-7 );
+      isOk &= scanOneFunction( pOut, isVerbose, "atan2 (f, -1)",
+         &atan2YD<-1>, &atan2YOne<-1>, &atan2YMany<-1>, -FLT_MAX, FLT_MAX,
+         false, 1e-7, 3e-7 );
+      isOk &= scanOneFunction( pOut, isVerbose, "atan2 (+1, f)",
+         &atan2XD<+1>, &atan2XOne<+1>, &atan2XMany<+1>, -FLT_MAX, FLT_MAX,
+         false, 1e-7, 3e-7 );
+      isOk &= scanOneFunction( pOut, isVerbose, "atan2 (-1, f)",
+         &atan2XD<-1>, &atan2XOne<-1>, &atan2XMany<-1>, -FLT_MAX, FLT_MAX,
+         false, 1e-7, 3e-7 );
+
+      isOk &= scanOneFunction( pOut, isVerbose, "rsqrt", &rsqrtD, &rsqrtFast,
+         &rsqrtFast, FLT_MIN, 1e37f, true, 2e-6, 5e-6 );
+   }
+
+   isOk &= testArrays( pOut );
+   isOk &= testSpecials( pOut );
+
+   if( pOut && isVerbose ) benchmark( *pOut );
+
+
+   if( pOut ) *pOut << (isOk ? "--- successfully" : "*** failurefully") <<
+      " completed " << "\n\n\n";
+
+   if( pOut ) pOut->flush();
+
+
+   return isOk;
+}
+
+}
+
+
+#endif//TESTING
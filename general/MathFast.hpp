@@ -0,0 +1,91 @@
+/*------------------------------------------------------------------------------
+
+   HXA7241 General library.
+   Copyright (c) 2004-2007,  Harrison Ainsworth / HXA7241.
+
+   http://www.hxa7241.org/
+
+------------------------------------------------------------------------------*/
+
+
+#ifndef MathFast_h
+#define MathFast_h
+
+
+
+
+#include "hxa7241_general.hpp"
+namespace hxa7241_general
+{
+
+
+/**
+ * Fast approximations to exp, sin and cos, atan2, and reciprocal square
+ * root.<br/><br/>
+ *
+ * Polynomials after a range reduction (and a Newton-Raphson refinement for
+ * rsqrt), about float precision, except rsqrt. Errors are from a scan of
+ * every float over the whole valid range, against double
+ * precision.<br/><br/>
+ *
+ * Arrays: count numbers from pIn, results to pOut (which may be pIn). Same
+ * results as one at a time, but in SSE2 or AVX2 registers when compiled for
+ * them.<br/><br/>
+ *
+ * @implementation
+ * Polynomial coefficients are from Cephes (Moshier). Range reductions are in
+ * double, since -ffast-math may regroup a float Cody-Waite reduction and lose
+ * the precision it is for.
+ */
+
+
+/** e ^ number. Number must be > -87.3 and < 88.3 (else clamped).
+  * Error (relative): mean < 1e-8, max < 2e-7. */
+float expFast( float f );
+
+void  expFast( const float* pIn,
+               float*       pOut,
+               dword        count );
+
+
+/** sin and cos of angle (radians). Angle must be > -65536 and < +65536.
+  * Error (absolute): mean < 1e-8, max < 1e-7. */
+void  sinCosFast( float  angle,
+                  float& sin,
+                  float& cos );
+
+/** pSins and pCoss may be pAngles. */
+void  sinCosFast( const float* pAngles,
+                  float*       pSins,
+                  float*       pCoss,
+                  dword        count );
+
+
+/** angle of (x, y) from the x axis, -pi to +pi. atan2Fast( 0, 0 ) is 0.
+  * Infinities and subnormals are allowed (atan2Fast( inf, inf ) is pi/4),
+  * NaNs are not. Error (absolute): mean < 1e-7, max < 3e-7. */
+float atan2Fast( float y,
+                 float x );
+
+/** pOut may be pYs or pXs. */
+void  atan2Fast( const float* pYs,
+                 const float* pXs,
+                 float*       pOut,
+                 dword        count );
+
+
+/** 1 / sqrt( number ). Number must be >= FLT_MIN and < 1e+37.
+  * Error (relative): mean < 2e-6, max < 5e-6. */
+float rsqrtFast( float f );
+
+void  rsqrtFast( const float* pIn,
+                 float*       pOut,
+                 dword        count );
+
+
+}//namespace
+
+
+
+
+#endif//MathFast_h
@@ -0,0 +1,589 @@
+/*------------------------------------------------------------------------------
+
+   HXA7241 General library.
+   Copyright (c) 2004-2007,  Harrison Ainsworth / HXA7241.
+
+   http://www.hxa7241.org/
+
+------------------------------------------------------------------------------*/
+
+
+/// conditional compilations
+#if defined(_WIN32)
+#define NUMALOCAL_WIN32
+#include <windows.h>
+#elif defined(__linux__)
+#define NUMALOCAL_LINUX
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+#endif
+
+#include "NumaLocal.hpp"
+
+
+using namespace hxa7241_general;
+
+
+
+
+/// platform ///////////////////////////////////////////////////////////////////
+namespace
+{
+
+/// a job and its node, for a thread to run
+struct Call
+{
+   NumaNodes::Job* pJob;
+   dword           node;
+   bool            isFailed;
+};
+
+
+void call
+(
+   Call& c
+)
+{
+   try
+   {
+      c.pJob->run( c.node );
+   }
+   catch( ... )
+   {
+      c.isFailed = true;
+   }
+}
+
+
+#if defined(NUMALOCAL_WIN32)
+
+DWORD WINAPI entry
+(
+   LPVOID pCall
+)
+{
+   call( *static_cast<Call*>(pCall) );
+   return 0;
+}
+
+#elif defined(NUMALOCAL_LINUX)
+
+void* entry
+(
+   void* pCall
+)
+{
+   call( *static_cast<Call*>(pCall) );
+   return 0;
+}
+
+
+/**
+ * Read a sysfs id list, eg. "0-3,8-11".
+ *
+ * @return false if unreadable or empty
+ */
+bool readIds
+(
+   const char*         pPath,
+   std::vector<dword>& ids
+)
+{
+   ids.clear();
+
+   std::ifstream file( pPath );
+   std::string   line;
+   if( !std::getline( file, line ) )
+   {
+      return false;
+   }
+
+   // ranges separated by commas
+   dword first  = 0;
+   dword number = 0;
+   bool  isDigits = false;
+   bool  isRange  = false;
+   for( std::string::size_type i = 0;  i <= line.size();  ++i )
+   {
+      const char c = (i < line.size()) ? line[i] : ',';
+      if( (c >= '0') & (c <= '9') )
+      {
+         number   = (number * 10) + (c - '0');
+         isDigits = true;
+      }
+      else if( '-' == c )
+      {
+         first   = number;
+         number  = 0;
+         isRange = true;
+      }
+      else if( isDigits )
+      {
+         for( dword id = (isRange ? first : number);  id <= number;  ++id )
+         {
+            ids.push_back( id );
+         }
+         number   = 0;
+         isDigits = false;
+         isRange  = false;
+      }
+   }
+
+   return !ids.empty();
+}
+
+#endif
+
+}
+
+
+
+
+/// NumaNodes //////////////////////////////////////////////////////////////////
+
+
+/// statics --------------------------------------------------------------------
+const char NumaNodes::THREAD_EXCEPTION_MESSAGE[] =
+   "NumaNodes::runOn() - thread creation failed";
+const char NumaNodes::JOB_EXCEPTION_MESSAGE[] =
+   "NumaNodes::runOn() - job threw exception";
+
+
+
+
+/// standard object services ---------------------------------------------------
+NumaNodes::Job::~Job()
+{
+}
+
+
+
+
+/// queries --------------------------------------------------------------------
+dword NumaNodes::getNodeCount()
+{
+   dword count = 1;
+
+#if defined(NUMALOCAL_WIN32)
+
+   ULONG highest = 0;
+   if( ::GetNumaHighestNodeNumber( &highest ) )
+   {
+      count = static_cast<dword>(highest) + 1;
+   }
+
+#elif defined(NUMALOCAL_LINUX)
+
+   // highest online node id, plus one
+   std::vector<dword> ids;
+   if( readIds( "/sys/devices/system/node/online", ids ) )
+   {
+      count = ids.back() + 1;
+   }
+
+#endif
+
+   return count;
+}
+
+
+dword NumaNodes::getCurrentNode()
+{
+   dword node = 0;
+
+#if defined(NUMALOCAL_WIN32)
+
+   UCHAR n = 0;
+   if( ::GetNumaProcessorNode( static_cast<UCHAR>(
+      ::GetCurrentProcessorNumber()), &n ) )
+   {
+      node = static_cast<dword>(n);
+   }
+
+#elif defined(NUMALOCAL_LINUX)
+
+   unsigned cpu = 0;
+   unsigned n   = 0;
+   if( 0 == ::syscall( SYS_getcpu, &cpu, &n, 0 ) )
+   {
+      node = static_cast<dword>(n);
+   }
+
+#endif
+
+   return node;
+}
+
+
+
+
+/// commands -------------------------------------------------------------------
+void NumaNodes::runOn
+(
+   const dword node,
+   Job&        job
+)
+{
+   Call c = { &job, node, false };
+
+#if defined(NUMALOCAL_WIN32)
+
+   // start suspended, bind to the node's processors, then let go
+   ULONGLONG mask = 0;
+   ::GetNumaNodeProcessorMask( static_cast<UCHAR>(node), &mask );
+
+   const HANDLE thread = ::CreateThread( 0, 0, &entry, &c, CREATE_SUSPENDED,
+      0 );
+   if( 0 == thread )
+   {
+      throw THREAD_EXCEPTION_MESSAGE;
+   }
+   if( 0 != mask )
+   {
+      ::SetThreadAffinityMask( thread, static_cast<DWORD_PTR>(mask) );
+   }
+   ::ResumeThread( thread );
+   ::WaitForSingleObject( thread, INFINITE );
+   ::CloseHandle( thread );
+
+#elif defined(NUMALOCAL_LINUX)
+
+   // bind to the node's processors (if known)
+   char path[64];
+   std::sprintf( path, "/sys/devices/system/node/node%d/cpulist",
+      static_cast<int>(node) );
+
+   std::vector<dword> cpus;
+   readIds( path, cpus );
+
+   cpu_set_t set;
+   CPU_ZERO( &set );
+   bool isBound = false;
+   for( dword i = 0;  i < static_cast<dword>(cpus.size());  ++i )
+   {
+      if( cpus[i] < CPU_SETSIZE )
+      {
+         CPU_SET( cpus[i], &set );
+         isBound = true;
+      }
+   }
+
+   pthread_attr_t attributes;
+   ::pthread_attr_init( &attributes );
+   if( isBound )
+   {
+      ::pthread_attr_setaffinity_np( &attributes, sizeof(set), &set );
+   }
+
+   pthread_t  thread;
+   const bool isStarted = (0 == ::pthread_create( &thread, &attributes,
+      &entry, &c ));
+   ::pthread_attr_destroy( &attributes );
+   if( !isStarted )
+   {
+      throw THREAD_EXCEPTION_MESSAGE;
+   }
+   ::pthread_join( thread, 0 );
+
+#else
+
+   call( c );
+
+#endif
+
+   if( c.isFailed )
+   {
+      throw JOB_EXCEPTION_MESSAGE;
+   }
+}
+
+
+
+
+/// test ///////////////////////////////////////////////////////////////////////
+#ifdef TESTING
+
+
+#include <ostream>
+#include <iomanip>
+#include <vector>
+
+#include "PowFast.hpp"
+#include "LogFast.hpp"
+#include "ThreadPool.hpp"
+#include "Stopwatch.hpp"
+
+
+namespace
+{
+
+/// counts runs per node, optionally throwing
+class RecordJob
+   : public NumaNodes::Job
+{
+public:
+   RecordJob( std::vector<dword>& runs, const bool isThrowing )
+    : runs_m( runs )
+    , isThrowing_m( isThrowing )
+    , isOnNode_m( true )
+   {
+   }
+
+   virtual void run( const dword node )
+   {
+      if( isThrowing_m ) throw "RecordJob";
+
+      ++runs_m[node];
+
+      // (bound to the node, when there is more than one)
+      isOnNode_m &= (runs_m.size() < 2) ||
+         (NumaNodes::getCurrentNode() == node);
+   }
+
+   bool isOnNode() const
+   {
+      return isOnNode_m;
+   }
+
+private:
+   std::vector<dword>& runs_m;
+   bool                isThrowing_m;
+   bool                isOnNode_m;
+};
+
+
+/// random-ish pow lookups, recording which node each item ran on
+class LookupJob
+   : public ThreadPool::Job
+{
+public:
+   static const dword LOOKUPS = 1 << 18;
+
+   LookupJob( const PowFast* pShared, const NumaLocal<PowFast>* pLocal,
+      std::vector<dword>& nodes, std::vector<float>& sums )
+    : pShared_m( pShared )
+    , pLocal_m ( pLocal )
+    , nodes_m  ( nodes )
+    , sums_m   ( sums )
+   {
+   }
+
+   virtual void run( const dword item, dword )
+   {
+      // fetch the copy once per item, not per lookup
+      const dword    node    = NumaNodes::getCurrentNode();
+      const PowFast& powFast = pLocal_m ? pLocal_m->get() : *pShared_m;
+
+      // inputs all over the table, so lookups mostly miss cache
+      udword state = (static_cast<udword>(item) * 2654435761u) + 1u;
+      float  sum   = 0.0f;
+      for( dword i = LOOKUPS;  i-- > 0; )
+      {
+         state = (state * 1664525u) + 1013904223u;
+         sum  += powFast.e( (static_cast<float>(state >> 8) *
+            (40.0f / 16777216.0f)) - 20.0f );
+      }
+
+      nodes_m[item] = node;
+      sums_m[item]  = sum;
+   }
+
+private:
+   const PowFast*            pShared_m;
+   const NumaLocal<PowFast>* pLocal_m;
+   std::vector<dword>&       nodes_m;
+   std::vector<float>&       sums_m;
+};
+
+
+void benchmark
+(
+   std::ostream& out
+)
+{
+   static const udword PRECISION = 18;
+
+   ThreadPool pool( 0 );
+   const dword items = pool.getThreadCount() * 8;
+
+   const PowFast            shared( PRECISION );
+   const NumaLocal<PowFast> local( PRECISION );
+   const dword              nodeCount = local.getNodeCount();
+
+   out << std::fixed << std::setprecision( 1 ) << "benchmark  PowFast e(), "
+      "precision " << PRECISION << ", threads " << pool.getThreadCount() <<
+      ", nodes " << nodeCount << "  (million lookups per second)\n";
+
+   for( dword k = 0;  k < 2;  ++k )
+   {
+      std::vector<dword> nodes( items );
+      std::vector<float> sums( items );
+      LookupJob job( &shared, (0 == k) ? 0 : &local, nodes, sums );
+
+      Stopwatch stopwatch;
+      pool.run( job, items );
+      const double time = stopwatch.getSeconds();
+
+      // total, and by node the items ran on
+      std::vector<double> perNode( nodeCount );
+      for( dword i = 0;  i < items;  ++i )
+      {
+         perNode[ (nodes[i] < nodeCount) ? nodes[i] : 0 ] +=
+            LookupJob::LOOKUPS;
+      }
+
+      const double scale = 1e-6 / time;
+      out << ((0 == k) ? "   shared      total " : "   replicated  total ") <<
+         (static_cast<double>(items) * LookupJob::LOOKUPS * scale);
+      for( dword n = 0;  n < nodeCount;  ++n )
+      {
+         out << "   node " << n << " " << (perNode[n] * scale);
+      }
+      out << "   (check " << sums[0] << ")\n";
+   }
+   out << "\n" << std::setprecision( 6 );
+}
+
+}
+
+
+namespace hxa7241_general
+{
+
+
+bool test_NumaLocal
+(
+   std::ostream* pOut,
+   const bool    isVerbose,
+   const dword   //seed
+)
+{
+   bool isOk = true;
+
+   if( pOut ) *pOut << "[ test_NumaLocal ]\n\n";
+
+
+   const dword nodeCount = NumaNodes::getNodeCount();
+
+   // nodes
+   {
+      bool is = true;
+
+      is &= (nodeCount >= 1);
+      is &= (NumaNodes::getCurrentNode() >= 0) &
+         (NumaNodes::getCurrentNode() < nodeCount);
+
+      if( pOut && isVerbose ) *pOut << "nodes " << nodeCount << "  current " <<
+         NumaNodes::getCurrentNode() << "\n\n";
+
+      if( pOut ) *pOut << "nodes : " <<
+         (is ? "--- succeeded" : "*** failed") << "\n\n";
+
+      isOk &= is;
+   }
+
+   // runOn
+   {
+      bool is = true;
+
+      // each node once
+      std::vector<dword> runs( nodeCount );
+      RecordJob job( runs, false );
+      for( dword n = 0;  n < nodeCount;  ++n )
+      {
+         NumaNodes::runOn( n, job );
+      }
+      for( dword n = 0;  n < nodeCount;  ++n )
+      {
+         is &= (1 == runs[n]);
+      }
+      is &= job.isOnNode();
+
+      // a failing job: throws
+      {
+         RecordJob failing( runs, true );
+         bool isThrown = false;
+         try
+         {
+            NumaNodes::runOn( 0, failing );
+         }
+         catch( const char* )
+         {
+            isThrown = true;
+         }
+         is &= isThrown;
+      }
+
+      if( pOut ) *pOut << "runOn : " <<
+         (is ? "--- succeeded" : "*** failed") << "\n\n";
+
+      isOk &= is;
+   }
+
+   // copies: same results as a plain instance
+   {
+      bool is = true;
+
+      const NumaLocal<PowFast> powLocal( 11 );
+      const NumaLocal<LogFast> logLocal( 11 );
+      const PowFast            powFast( 11 );
+      const LogFast            logFast( 11 );
+
+      is &= (nodeCount == powLocal.getNodeCount()) &
+         (nodeCount == logLocal.getNodeCount());
+
+      // get() is one of the copies
+      bool isPowFound = false;
+      bool isLogFound = false;
+      for( dword n = 0;  n < nodeCount;  ++n )
+      {
+         isPowFound |= (&powLocal.get() == &powLocal.get( n ));
+         isLogFound |= (&logLocal.get() == &logLocal.get( n ));
+      }
+      is &= isPowFound & isLogFound;
+
+      for( dword n = 0;  n < nodeCount;  ++n )
+      {
+         const PowFast& p = powLocal.get( n );
+         const LogFast& l = logLocal.get( n );
+         is &= (11 == p.precision()) & (11 == l.precision());
+
+         for( float f = -20.0f;  f < 20.0f;  f += 0.37f )
+         {
+            is &= (p.e( f ) == powFast.e( f )) & (p.two( f ) ==
+               powFast.two( f ));
+
+            const float g = powFast.e( f );
+            is &= (l.e( g ) == logFast.e( g )) & (l.ten( g ) ==
+               logFast.ten( g ));
+         }
+      }
+
+      if( pOut ) *pOut << "copies : " <<
+         (is ? "--- succeeded" : "*** failed") << "\n\n";
+
+      isOk &= is;
+   }
+
+   if( pOut && isVerbose ) benchmark( *pOut );
+
+
+   if( pOut ) *pOut << (isOk ? "--- successfully" : "*** failurefully") <<
+      " completed " << "\n\n\n";
+
+   if( pOut ) pOut->flush();
+
+
+   return isOk;
+}
+
+}
+
+
+#endif//TESTING
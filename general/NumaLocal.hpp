@@ -0,0 +1,260 @@
+/*------------------------------------------------------------------------------
+
+   HXA7241 General library.
+   Copyright (c) 2004-2007,  Harrison Ainsworth / HXA7241.
+
+   http://www.hxa7241.org/
+
+------------------------------------------------------------------------------*/
+
+
+#ifndef NumaLocal_h
+#define NumaLocal_h
+
+
+
+
+#include "hxa7241_general.hpp"
+namespace hxa7241_general
+{
+
+
+/**
+ * NUMA nodes: how many, which one the calling thread is on, and running
+ * something on a thread bound to a node.<br/><br/>
+ *
+ * Linux (sysfs and getcpu), or Win32 (Vista on). Elsewhere, or when the
+ * information is missing, there is one node, and runOn runs in the
+ * caller.<br/><br/>
+ *
+ * @implementation
+ * Platform parts are hidden in the .cpp.
+ */
+class NumaNodes
+{
+/// types ----------------------------------------------------------------------
+public:
+   class Job
+   {
+   public:
+      virtual ~Job();
+
+      virtual void run( dword node ) = 0;
+   };
+
+
+/// queries --------------------------------------------------------------------
+   /** at least 1. */
+   static  dword getNodeCount();
+   /** node of the processor the calling thread is on now (a system call:
+     * fetch once per batch of work, not per use). */
+   static  dword getCurrentNode();
+
+
+/// commands -------------------------------------------------------------------
+   /** calls job.run( node ) on a new thread bound to the node's processors,
+     * and waits for it. */
+   static  void  runOn( dword node,
+                        Job&  job );                                   // throws
+
+
+/// fields ---------------------------------------------------------------------
+private:
+   static const char THREAD_EXCEPTION_MESSAGE[];
+   static const char JOB_EXCEPTION_MESSAGE[];
+};
+
+
+
+
+/**
+ * One copy of an object per NUMA node, each made in memory local to its node,
+ * and a query for the calling thread's copy.<br/><br/>
+ *
+ * Intended for big read-only tables, like PowFast or LogFast of high
+ * precision: with one shared copy, threads on other sockets pay remote-memory
+ * latency for every lookup.<br/><br/>
+ *
+ * Each copy is constructed on a thread bound to its node, so its storage is
+ * first touched there, and (with the usual first-touch policy) placed
+ * there.<br/><br/>
+ *
+ * TYPE must be constructible from a udword (eg. precision).<br/><br/>
+ *
+ * Constant (after construction, copies can be used concurrently if TYPE's
+ * const queries can).
+ *
+ * @see NumaNodes
+ */
+template<class TYPE>
+class NumaLocal
+{
+/// standard object services ---------------------------------------------------
+public:
+   explicit NumaLocal( udword parameter );                             // throws
+
+           ~NumaLocal();
+private:
+            NumaLocal( const NumaLocal& );
+   NumaLocal& operator=( const NumaLocal& );
+public:
+
+
+/// queries --------------------------------------------------------------------
+           /** copy for the calling thread's node (see
+             * NumaNodes::getCurrentNode). */
+           const TYPE& get()                                              const;
+           const TYPE& get( dword node )                                  const;
+
+           dword       getNodeCount()                                     const;
+
+
+/// implementation -------------------------------------------------------------
+private:
+   class Make : public NumaNodes::Job
+   {
+   public:
+               Make( TYPE** ppCopies, udword parameter );
+      virtual ~Make();
+      virtual void run( dword node );
+
+   private:
+      TYPE** ppCopies_m;
+      udword parameter_m;
+   };
+
+           void        deleteCopies();
+
+
+/// fields ---------------------------------------------------------------------
+private:
+   dword  count_m;
+   TYPE** ppCopies_m;
+};
+
+
+
+
+
+
+
+
+/// TEMPLATES ///
+
+/// standard object services ---------------------------------------------------
+template<class TYPE>
+NumaLocal<TYPE>::NumaLocal
+(
+   const udword parameter
+)
+ : count_m   ( NumaNodes::getNodeCount() )
+ , ppCopies_m( new TYPE*[ count_m ] )
+{
+   for( dword i = 0;  i < count_m;  ++i )
+   {
+      ppCopies_m[i] = 0;
+   }
+
+   try
+   {
+      Make make( ppCopies_m, parameter );
+      for( dword i = 0;  i < count_m;  ++i )
+      {
+         NumaNodes::runOn( i, make );
+      }
+   }
+   catch( ... )
+   {
+      deleteCopies();
+      throw;
+   }
+}
+
+
+template<class TYPE>
+NumaLocal<TYPE>::~NumaLocal()
+{
+   deleteCopies();
+}
+
+
+
+
+/// queries --------------------------------------------------------------------
+template<class TYPE>
+inline
+const TYPE& NumaLocal<TYPE>::get() const
+{
+   const dword node = NumaNodes::getCurrentNode();
+
+   return *ppCopies_m[ (node < count_m) ? node : 0 ];
+}
+
+
+template<class TYPE>
+inline
+const TYPE& NumaLocal<TYPE>::get
+(
+   const dword node
+) const
+{
+   return *ppCopies_m[ node ];
+}
+
+
+template<class TYPE>
+inline
+dword NumaLocal<TYPE>::getNodeCount() const
+{
+   return count_m;
+}
+
+
+
+
+/// implementation -------------------------------------------------------------
+template<class TYPE>
+NumaLocal<TYPE>::Make::Make
+(
+   TYPE** const ppCopies,
+   const udword parameter
+)
+ : ppCopies_m ( ppCopies )
+ , parameter_m( parameter )
+{
+}
+
+
+template<class TYPE>
+NumaLocal<TYPE>::Make::~Make()
+{
+}
+
+
+template<class TYPE>
+void NumaLocal<TYPE>::Make::run
+(
+   const dword node
+)
+{
+   ppCopies_m[node] = new TYPE( parameter_m );
+}
+
+
+template<class TYPE>
+void NumaLocal<TYPE>::deleteCopies()
+{
+   for( dword i = 0;  i < count_m;  ++i )
+   {
+      delete ppCopies_m[i];
+   }
+   delete[] ppCopies_m;
+}
+
+
+}//namespace
+
+
+
+
+#endif//NumaLocal_h
@@ -8,7 +8,17 @@
 ------------------------------------------------------------------------------*/
 
 
+/// conditional compilations
+#if defined(__AVX2__)
+#define POWFAST_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (_M_IX86_FP >= 2)
+#define POWFAST_SSE2
+#include <emmintrin.h>
+#endif
+
 #include <math.h>
+#include <cstring>
 
 #include "PowFast.hpp"
 
@@ -51,7 +61,8 @@ float powFast
    // extract exponent, and mantissa as 1 to 2 float
    const int   exp = i & 0xFF800000;
    const int   man = 0x3F800010 | (i & 0x7FFFFF);
-   const float m12 = *reinterpret_cast<const float*>( &man );
+   float m12;
+   std::memcpy( &m12, &man, sizeof(m12) );
 
    // make quadratic interpolation with mantissa (x[1,2) -> y[1,2))
    // (minimise relative error)
@@ -60,8 +71,13 @@ float powFast
    //const float q12 = (0.344285f * (m12 * m12)) - (0.032855f * m12) + 0.68857f;
 
    // assemble exponent and interpolation, and convert bits to float
-   const int eq = exp | (*reinterpret_cast<const int*>( &q12 ) & 0x7FFFFF);
-   return *reinterpret_cast<const float*>( &eq );
+   // (copying bits, as the pointer casts break strict aliasing)
+   int q12Bits;
+   std::memcpy( &q12Bits, &q12, sizeof(q12Bits) );
+   const int eq = exp | (q12Bits & 0x7FFFFF);
+   float f;
+   std::memcpy( &f, &eq, sizeof(f) );
+   return f;
 
 
    /*// scaling to move point to between exp and man in float bits
@@ -115,6 +131,122 @@ float hxa7241_general::powFastR
 }
 
 
+/// arrays ---------------------------------------------------------------------
+
+namespace
+{
+
+/**
+ * powFast of each. In vectors, then the rest one at a time.
+ */
+void powFasts
+(
+   const float* pIn,
+   float*       pOut,
+   const dword  count,
+   const float  ilog2
+)
+{
+   dword i = 0;
+
+#if defined(POWFAST_AVX2)
+   static const float _2p23 = 8388608.0f;
+
+   const __m256  scale        = _mm256_set1_ps( _2p23 * ilog2 );
+   const __m256  bias         = _mm256_set1_ps( 127.0f * _2p23 );
+   const __m256i exponentMask = _mm256_set1_epi32( 0xFF800000 );
+   const __m256i mantissaMask = _mm256_set1_epi32( 0x7FFFFF );
+   const __m256i one          = _mm256_set1_epi32( 0x3F800010 );
+
+   for( ;  (i + 8) <= count;  i += 8 )
+   {
+      // build float bits, with linear interpolation of fraction
+      const __m256i bits = _mm256_cvttps_epi32( _mm256_add_ps( _mm256_mul_ps(
+         _mm256_loadu_ps( pIn + i ), scale ), bias ) );
+
+      // extract exponent, and mantissa as 1 to 2 float
+      const __m256i exp = _mm256_and_si256( bits, exponentMask );
+      const __m256  m12 = _mm256_castsi256_ps( _mm256_or_si256( one,
+         _mm256_and_si256( bits, mantissaMask ) ) );
+
+      // make quadratic interpolation with mantissa
+      const __m256  q12 = _mm256_add_ps( _mm256_sub_ps( _mm256_mul_ps(
+         _mm256_set1_ps( 0.34f ), _mm256_mul_ps( m12, m12 ) ), _mm256_mul_ps(
+         _mm256_set1_ps( 0.02f ), m12 ) ), _mm256_set1_ps( 0.68f ) );
+
+      // assemble exponent and interpolation
+      _mm256_storeu_ps( pOut + i, _mm256_castsi256_ps( _mm256_or_si256( exp,
+         _mm256_and_si256( _mm256_castps_si256( q12 ), mantissaMask ) ) ) );
+   }
+#elif defined(POWFAST_SSE2)
+   static const float _2p23 = 8388608.0f;
+
+   const __m128  scale        = _mm_set1_ps( _2p23 * ilog2 );
+   const __m128  bias         = _mm_set1_ps( 127.0f * _2p23 );
+   const __m128i exponentMask = _mm_set1_epi32( 0xFF800000 );
+   const __m128i mantissaMask = _mm_set1_epi32( 0x7FFFFF );
+   const __m128i one          = _mm_set1_epi32( 0x3F800010 );
+
+   for( ;  (i + 4) <= count;  i += 4 )
+   {
+      const __m128i bits = _mm_cvttps_epi32( _mm_add_ps( _mm_mul_ps(
+         _mm_loadu_ps( pIn + i ), scale ), bias ) );
+
+      const __m128i exp = _mm_and_si128( bits, exponentMask );
+      const __m128  m12 = _mm_castsi128_ps( _mm_or_si128( one,
+         _mm_and_si128( bits, mantissaMask ) ) );
+
+      const __m128  q12 = _mm_add_ps( _mm_sub_ps( _mm_mul_ps(
+         _mm_set1_ps( 0.34f ), _mm_mul_ps( m12, m12 ) ), _mm_mul_ps(
+         _mm_set1_ps( 0.02f ), m12 ) ), _mm_set1_ps( 0.68f ) );
+
+      _mm_storeu_ps( pOut + i, _mm_castsi128_ps( _mm_or_si128( exp,
+         _mm_and_si128( _mm_castps_si128( q12 ), mantissaMask ) ) ) );
+   }
+#endif
+
+   for( ;  i < count;  ++i )
+   {
+      pOut[i] = powFast( pIn[i], ilog2 );
+   }
+}
+
+}
+
+
+void hxa7241_general::powFast2
+(
+   const float* pIn,
+   float*       pOut,
+   const dword  count
+)
+{
+   powFasts( pIn, pOut, count, 1.0f );
+}
+
+
+void hxa7241_general::powFastE
+(
+   const float* pIn,
+   float*       pOut,
+   const dword  count
+)
+{
+   powFasts( pIn, pOut, count, 1.44269504088896f );
+}
+
+
+void hxa7241_general::powFast10
+(
+   const float* pIn,
+   float*       pOut,
+   const dword  count
+)
+{
+   powFasts( pIn, pOut, count, 3.32192809488736f );
+}
+
+
 
 
 
@@ -202,11 +334,14 @@ float PowFast2::lookup
 
    // replace mantissa with combined lookups
    const float t  = tableH_m[(i >> 14) & 0x1FF] * tableL_m[(i >> 5)  & 0x1FF];
-   const int   it = (i & 0xFF800000) |
-      (*reinterpret_cast<const int*>( &t ) & 0x7FFFFF);
+   int tBits;
+   std::memcpy( &tBits, &t, sizeof(tBits) );
+   const int   it = (i & 0xFF800000) | (tBits & 0x7FFFFF);
 
    // convert bits to float
-   return *reinterpret_cast<const float*>( &it );
+   float f;
+   std::memcpy( &f, &it, sizeof(f) );
+   return f;
 }
 
 
@@ -347,7 +482,77 @@ float powFastLookup
    const int it = (i & 0xFF800000) | pTable[(i & 0x7FFFFF) >> (23 - precision)];
 
    // convert bits to float
-   return *reinterpret_cast<const float*>( &it );
+   float f;
+   std::memcpy( &f, &it, sizeof(f) );
+   return f;
+}
+
+
+/**
+ * powFastLookup of each. In vectors (with gathers for AVX2), then the rest one
+ * at a time.
+ */
+void powFastLookups
+(
+   const float*  pIn,
+   float*        pOut,
+   const dword   count,
+   const float   ilog2,
+   udword* const pTable,
+   const udword  precision
+)
+{
+   dword i = 0;
+
+#if defined(POWFAST_AVX2)
+   const __m256  scale        = _mm256_set1_ps( _2p23 * ilog2 );
+   const __m256  bias         = _mm256_set1_ps( 127.0f * _2p23 );
+   const __m256i exponentMask = _mm256_set1_epi32( 0xFF800000 );
+   const __m256i mantissaMask = _mm256_set1_epi32( 0x7FFFFF );
+   const __m128i quantize     = _mm_cvtsi32_si128( 23 - precision );
+   const int*    pInts        = reinterpret_cast<const int*>(pTable);
+
+   for( ;  (i + 8) <= count;  i += 8 )
+   {
+      // build float bits, with linear interpolation of fraction
+      const __m256i bits = _mm256_cvttps_epi32( _mm256_add_ps( _mm256_mul_ps(
+         _mm256_loadu_ps( pIn + i ), scale ), bias ) );
+
+      // replace mantissa with lookup
+      const __m256i index = _mm256_srl_epi32( _mm256_and_si256( bits,
+         mantissaMask ), quantize );
+      _mm256_storeu_ps( pOut + i, _mm256_castsi256_ps( _mm256_or_si256(
+         _mm256_and_si256( bits, exponentMask ),
+         _mm256_i32gather_epi32( pInts, index, 4 ) ) ) );
+   }
+#elif defined(POWFAST_SSE2)
+   const __m128  scale        = _mm_set1_ps( _2p23 * ilog2 );
+   const __m128  bias         = _mm_set1_ps( 127.0f * _2p23 );
+   const __m128i exponentMask = _mm_set1_epi32( 0xFF800000 );
+   const __m128i mantissaMask = _mm_set1_epi32( 0x7FFFFF );
+   const __m128i quantize     = _mm_cvtsi32_si128( 23 - precision );
+
+   for( ;  (i + 4) <= count;  i += 4 )
+   {
+      const __m128i bits = _mm_cvttps_epi32( _mm_add_ps( _mm_mul_ps(
+         _mm_loadu_ps( pIn + i ), scale ), bias ) );
+
+      // (no gather in SSE2)
+      dword index[4];
+      _mm_storeu_si128( reinterpret_cast<__m128i*>(index), _mm_srl_epi32(
+         _mm_and_si128( bits, mantissaMask ), quantize ) );
+      const __m128i t = _mm_set_epi32( pTable[index[3]], pTable[index[2]],
+         pTable[index[1]], pTable[index[0]] );
+
+      _mm_storeu_ps( pOut + i, _mm_castsi128_ps( _mm_or_si128(
+         _mm_and_si128( bits, exponentMask ), t ) ) );
+   }
+#endif
+
+   for( ;  i < count;  ++i )
+   {
+      pOut[i] = powFastLookup( pIn[i], ilog2, pTable, precision );
+   }
 }
 
 }
@@ -411,6 +616,41 @@ float PowFast::r
 }
 
 
+void PowFast::two
+(
+   const float* pIn,
+   float*       pOut,
+   const dword  count
+) const
+{
+   powFastLookups( pIn, pOut, count, 1.0f, pTable_m, precision_m );
+}
+
+
+void PowFast::e
+(
+   const float* pIn,
+   float*       pOut,
+   const dword  count
+) const
+{
+   powFastLookups( pIn, pOut, count, 1.44269504088896f, pTable_m,
+      precision_m );
+}
+
+
+void PowFast::ten
+(
+   const float* pIn,
+   float*       pOut,
+   const dword  count
+) const
+{
+   powFastLookups( pIn, pOut, count, 3.32192809488736f, pTable_m,
+      precision_m );
+}
+
+
 udword PowFast::precision() const
 {
    return precision_m;
@@ -433,6 +673,105 @@ const PowFast& hxa7241_general::POWFAST()
 
 
 
+/// compile-time ///////////////////////////////////////////////////////////////
+
+/// tables ---------------------------------------------------------------------
+
+/**
+ * Table elements as constant expressions, so the compiler evaluates them and
+ * the arrays are static data.<br/><br/>
+ *
+ * Element i is the mantissa bits of 2^z, z = (i + 0.5) / 2^precision (as
+ * powFastSetTable). 2^z - 1 = t + t^2/2! + t^3/3! ..., with t = z ln 2 < 0.7,
+ * so to t^11 is within 3e-11.<br/><br/>
+ *
+ * Indexes are hex literals made by token pasting (eg. 0x7F3), which keeps the
+ * expansions small.
+ */
+#define POWFAST_T(P, I) \
+   (0.69314718055994531 * (2.0 * (I) + 1.0) / (2.0 * (1 << (P))))
+#define POWFAST_ENTRY(P, I) \
+   static_cast<udword>( 8388608.0 * POWFAST_T(P, I) * (1.0 + \
+   POWFAST_T(P, I) / 2.0 * (1.0 + POWFAST_T(P, I) / 3.0 * (1.0 + \
+   POWFAST_T(P, I) / 4.0 * (1.0 + POWFAST_T(P, I) / 5.0 * (1.0 + \
+   POWFAST_T(P, I) / 6.0 * (1.0 + POWFAST_T(P, I) / 7.0 * (1.0 + \
+   POWFAST_T(P, I) / 8.0 * (1.0 + POWFAST_T(P, I) / 9.0 * (1.0 + \
+   POWFAST_T(P, I) / 10.0 * (1.0 + POWFAST_T(P, I) / 11.0))))))))))),
+
+#define POWFAST_2(P, H) \
+   POWFAST_ENTRY(P, H##0) POWFAST_ENTRY(P, H##1)
+#define POWFAST_4(P, H) \
+   POWFAST_2(P, H) POWFAST_ENTRY(P, H##2) POWFAST_ENTRY(P, H##3)
+#define POWFAST_8(P, H) \
+   POWFAST_4(P, H) POWFAST_ENTRY(P, H##4) POWFAST_ENTRY(P, H##5) \
+   POWFAST_ENTRY(P, H##6) POWFAST_ENTRY(P, H##7)
+#define POWFAST_16(P, H) \
+   POWFAST_8(P, H) POWFAST_ENTRY(P, H##8) POWFAST_ENTRY(P, H##9) \
+   POWFAST_ENTRY(P, H##A) POWFAST_ENTRY(P, H##B) POWFAST_ENTRY(P, H##C) \
+   POWFAST_ENTRY(P, H##D) POWFAST_ENTRY(P, H##E) POWFAST_ENTRY(P, H##F)
+#define POWFAST_32(P, H) \
+   POWFAST_16(P, H##0) POWFAST_16(P, H##1)
+#define POWFAST_64(P, H) \
+   POWFAST_32(P, H) POWFAST_16(P, H##2) POWFAST_16(P, H##3)
+#define POWFAST_128(P, H) \
+   POWFAST_64(P, H) POWFAST_16(P, H##4) POWFAST_16(P, H##5) \
+   POWFAST_16(P, H##6) POWFAST_16(P, H##7)
+#define POWFAST_256(P, H) \
+   POWFAST_128(P, H) POWFAST_16(P, H##8) POWFAST_16(P, H##9) \
+   POWFAST_16(P, H##A) POWFAST_16(P, H##B) POWFAST_16(P, H##C) \
+   POWFAST_16(P, H##D) POWFAST_16(P, H##E) POWFAST_16(P, H##F)
+#define POWFAST_512(P, H) \
+   POWFAST_256(P, H##0) POWFAST_256(P, H##1)
+#define POWFAST_1024(P, H) \
+   POWFAST_512(P, H) POWFAST_256(P, H##2) POWFAST_256(P, H##3)
+#define POWFAST_2048(P, H) \
+   POWFAST_1024(P, H) POWFAST_256(P, H##4) POWFAST_256(P, H##5) \
+   POWFAST_256(P, H##6) POWFAST_256(P, H##7)
+#define POWFAST_4096(P, H) \
+   POWFAST_2048(P, H) POWFAST_256(P, H##8) POWFAST_256(P, H##9) \
+   POWFAST_256(P, H##A) POWFAST_256(P, H##B) POWFAST_256(P, H##C) \
+   POWFAST_256(P, H##D) POWFAST_256(P, H##E) POWFAST_256(P, H##F)
+
+
+namespace hxa7241_general
+{
+
+template<> const udword PowFastT< 0>::TABLE[ 1 <<  0 ] =
+   { POWFAST_ENTRY(  0, 0x0 ) };
+template<> const udword PowFastT< 1>::TABLE[ 1 <<  1 ] =
+   { POWFAST_2(  1, 0x ) };
+template<> const udword PowFastT< 2>::TABLE[ 1 <<  2 ] =
+   { POWFAST_4(  2, 0x ) };
+template<> const udword PowFastT< 3>::TABLE[ 1 <<  3 ] =
+   { POWFAST_8(  3, 0x ) };
+template<> const udword PowFastT< 4>::TABLE[ 1 <<  4 ] =
+   { POWFAST_16(  4, 0x ) };
+template<> const udword PowFastT< 5>::TABLE[ 1 <<  5 ] =
+   { POWFAST_32(  5, 0x ) };
+template<> const udword PowFastT< 6>::TABLE[ 1 <<  6 ] =
+   { POWFAST_64(  6, 0x ) };
+template<> const udword PowFastT< 7>::TABLE[ 1 <<  7 ] =
+   { POWFAST_128(  7, 0x ) };
+template<> const udword PowFastT< 8>::TABLE[ 1 <<  8 ] =
+   { POWFAST_256(  8, 0x ) };
+template<> const udword PowFastT< 9>::TABLE[ 1 <<  9 ] =
+   { POWFAST_512(  9, 0x ) };
+template<> const udword PowFastT<10>::TABLE[ 1 << 10 ] =
+   { POWFAST_1024( 10, 0x ) };
+template<> const udword PowFastT<11>::TABLE[ 1 << 11 ] =
+   { POWFAST_2048( 11, 0x ) };
+template<> const udword PowFastT<12>::TABLE[ 1 << 12 ] =
+   { POWFAST_4096( 12, 0x ) };
+
+}
+
+
+
+
+
+
+
+
 /// test -----------------------------------------------------------------------
 #ifdef TESTING
 
@@ -441,6 +780,9 @@ const PowFast& hxa7241_general::POWFAST()
 #include <stdlib.h>
 #include <ostream>
 #include <iomanip>
+#include <vector>
+
+#include "Stopwatch.hpp"
 
 
 namespace
@@ -523,6 +865,243 @@ float powFastAdj10( const float f )
    return powFastAdj.ten( f );
 }
 
+
+void powFastAdj2s( const float* pIn, float* pOut, const dword count )
+{
+   powFastAdj.two( pIn, pOut, count );
+}
+
+void powFastAdjEs( const float* pIn, float* pOut, const dword count )
+{
+   powFastAdj.e( pIn, pOut, count );
+}
+
+void powFastAdj10s( const float* pIn, float* pOut, const dword count )
+{
+   powFastAdj.ten( pIn, pOut, count );
+}
+
+
+float powFastT2( const float f )
+{
+   return PowFastT<11>().two( f );
+}
+
+float powFastTE( const float f )
+{
+   return PowFastT<11>().e( f );
+}
+
+float powFastT10( const float f )
+{
+   return PowFastT<11>().ten( f );
+}
+
+
+/**
+ * Compile-time table same as run-time table (to float rounding): at the
+ * middle of each table step. And the radix forms the same to within a step
+ * (rounding at step edges can differ), over the valid range.
+ */
+template<udword PRECISION>
+bool testCompileTime
+(
+   std::ostream*    pOut,
+   const RandomMwc& rand
+)
+{
+   const PowFastT<PRECISION> compileTime;
+   const PowFast             runTime( PRECISION );
+
+   bool isOk = true;
+   for( dword i = 0;  i < (1 << PRECISION);  ++i )
+   {
+      for( dword e = -3;  e <= 3;  ++e )
+      {
+         const float f = static_cast<float>(e) + ((static_cast<float>(i) +
+            0.5f) / static_cast<float>(1 << PRECISION));
+
+         const float a = compileTime.two( f );
+         const float b = runTime.two( f );
+         isOk &= ::fabsf( a - b ) <= 1e-6f * b;
+      }
+   }
+
+   const float step = ::powf( 2.0f, 1.0f / static_cast<float>(
+      1 << PRECISION) ) - 1.0f + 1e-6f;
+   for( dword i = 0;  i < 100000;  ++i )
+   {
+      const float f = (rand.getFloat() * 72.0f) - 36.0f;
+
+      const float a[] = { compileTime.two( f ), compileTime.e( f ),
+         compileTime.ten( f ), compileTime.r( 1.5f, f ) };
+      const float b[] = { runTime.two( f ), runTime.e( f ),
+         runTime.ten( f ), runTime.r( 1.5f, f ) };
+      for( dword j = 0;  j < 4;  ++j )
+      {
+         isOk &= ::fabsf( a[j] - b[j] ) <= step * b[j];
+      }
+   }
+   isOk &= (PRECISION == compileTime.precision());
+
+   if( pOut ) *pOut << "compile-time(" << PRECISION << ") : " <<
+      (isOk ? "--- succeeded" : "*** failed") << "\n";
+
+   return isOk;
+}
+
+
+typedef float (*One)( float );
+typedef void  (*Many)( const float*, float*, dword );
+
+/**
+ * Arrays same as one at a time: for various counts and alignments, and in
+ * place.
+ */
+bool testArrays
+(
+   std::ostream*    pOut,
+   const RandomMwc& rand,
+   const char*      name,
+   One              one,
+   Many             many
+)
+{
+   bool isOk = true;
+
+   static const dword COUNTS[] = { 0, 1, 7, 8, 9, 31, 1003 };
+
+   // within range for all radixes
+   std::vector<float> numbers( 1003 + 2 );
+   for( dword i = 0;  i < 1003 + 2;  ++i )
+   {
+      numbers[i] = (rand.getFloat() * 72.0f) - 36.0f;
+   }
+
+   for( dword c = 0;  c < 7;  ++c )
+   {
+      for( dword start = 0;  start < 2;  ++start )
+      {
+         const dword count = COUNTS[c];
+
+         std::vector<float> results( count + 1, -1.0f );
+         std::vector<float> inPlace( numbers.begin() + start,
+            numbers.begin() + start + count + 1 );
+         many( &numbers[start], &results[0], count );
+         many( &inPlace[0], &inPlace[0], count );
+
+         for( dword i = 0;  i < count;  ++i )
+         {
+            const float expected  = one( numbers[start + i] );
+            const float tolerance = 1e-6f * expected;
+            isOk &= (::fabsf( results[i] - expected ) <= tolerance) &
+               (::fabsf( inPlace[i] - expected ) <= tolerance);
+         }
+         isOk &= (-1.0f == results[count]) &
+            (numbers[start + count] == inPlace[count]);
+      }
+   }
+
+   if( pOut ) *pOut << name << " : " <<
+      (isOk ? "--- succeeded" : "*** failed") << "\n\n";
+
+   return isOk;
+}
+
+
+void benchmark
+(
+   std::ostream&    out,
+   const RandomMwc& rand
+)
+{
+   static const dword COUNT = 1 << 16;
+   static const dword TIMES = 64;
+
+   std::vector<float> numbers( COUNT );
+   std::vector<float> results( COUNT );
+   for( dword i = 0;  i < COUNT;  ++i )
+   {
+      numbers[i] = (rand.getFloat() * 160.0f) - 80.0f;
+   }
+
+   // (changing an input each time, so the work is not hoisted)
+   double times[6];
+   Stopwatch stopwatch;
+
+   stopwatch.start();
+   for( dword t = TIMES;  t-- > 0; )
+   {
+      numbers[t] += 1e-3f;
+      for( dword i = 0;  i < COUNT;  ++i )
+      {
+         results[i] = ::powf( 2.71828182845905f, numbers[i] );
+      }
+   }
+   times[0] = stopwatch.getSeconds();
+
+   stopwatch.start();
+   for( dword t = TIMES;  t-- > 0; )
+   {
+      numbers[t] += 1e-3f;
+      for( dword i = 0;  i < COUNT;  ++i )
+      {
+         results[i] = powFastE( numbers[i] );
+      }
+   }
+   times[1] = stopwatch.getSeconds();
+
+   stopwatch.start();
+   for( dword t = TIMES;  t-- > 0; )
+   {
+      numbers[t] += 1e-3f;
+      powFastE( &numbers[0], &results[0], COUNT );
+   }
+   times[2] = stopwatch.getSeconds();
+
+   stopwatch.start();
+   for( dword t = TIMES;  t-- > 0; )
+   {
+      numbers[t] += 1e-3f;
+      for( dword i = 0;  i < COUNT;  ++i )
+      {
+         results[i] = powFastAdj.e( numbers[i] );
+      }
+   }
+   times[3] = stopwatch.getSeconds();
+
+   stopwatch.start();
+   for( dword t = TIMES;  t-- > 0; )
+   {
+      numbers[t] += 1e-3f;
+      powFastAdj.e( &numbers[0], &results[0], COUNT );
+   }
+   times[4] = stopwatch.getSeconds();
+
+   stopwatch.start();
+   for( dword t = TIMES;  t-- > 0; )
+   {
+      const PowFastT<11> powFastT;
+      numbers[t] += 1e-3f;
+      for( dword i = 0;  i < COUNT;  ++i )
+      {
+         results[i] = powFastT.e( numbers[i] );
+      }
+   }
+   times[5] = stopwatch.getSeconds();
+
+   const double scale = 1e9 / (static_cast<double>(COUNT) * TIMES);
+   out << std::fixed << std::setprecision( 2 ) <<
+      "benchmark  (ns per element)\n" <<
+      "   ::powf                  " << (times[0] * scale) << "\n" <<
+      "   rough       one, array  " << (times[1] * scale) << "  " <<
+      (times[2] * scale) << "\n" <<
+      "   adjustable  one, array  " << (times[3] * scale) << "  " <<
+      (times[4] * scale) << "\n" <<
+      "   compile-time one        " << (times[5] * scale) << "\n" <<
+      "   (check " << results[7] << ")\n\n" << std::setprecision( 6 );
+}
+
 }
 
 
@@ -596,6 +1175,55 @@ bool test_PowFast
          "adjustable(11) 10", &powFastAdj10 );
    }
 
+   // compile-time
+   {
+      isOk &= testOneFunction( pOut, isVerbose, rand,
+         2.0f, -125, +127, extraCount, 0.01f, 0.02f,
+         "compile-time(11) 2", &powFastT2 );
+
+      isOk &= testOneFunction( pOut, isVerbose, rand,
+         2.71828182845905f, -86, +88, extraCount, 0.01f, 0.02f,
+         "compile-time(11) E", &powFastTE );
+
+      isOk &= testOneFunction( pOut, isVerbose, rand,
+         10.0f, -36, +38, extraCount, 0.01f, 0.02f,
+         "compile-time(11) 10", &powFastT10 );
+
+      isOk &= testCompileTime< 0>( pOut, rand );
+      isOk &= testCompileTime< 1>( pOut, rand );
+      isOk &= testCompileTime< 2>( pOut, rand );
+      isOk &= testCompileTime< 3>( pOut, rand );
+      isOk &= testCompileTime< 4>( pOut, rand );
+      isOk &= testCompileTime< 5>( pOut, rand );
+      isOk &= testCompileTime< 6>( pOut, rand );
+      isOk &= testCompileTime< 7>( pOut, rand );
+      isOk &= testCompileTime< 8>( pOut, rand );
+      isOk &= testCompileTime< 9>( pOut, rand );
+      isOk &= testCompileTime<10>( pOut, rand );
+      isOk &= testCompileTime<11>( pOut, rand );
+      isOk &= testCompileTime<12>( pOut, rand );
+      if( pOut ) *pOut << "\n";
+   }
+
+   // arrays
+   {
+      isOk &= testArrays( pOut, rand, "rough 2 arrays", &powFast2,
+         &powFast2 );
+      isOk &= testArrays( pOut, rand, "rough E arrays", &powFastE,
+         &powFastE );
+      isOk &= testArrays( pOut, rand, "rough 10 arrays", &powFast10,
+         &powFast10 );
+
+      isOk &= testArrays( pOut, rand, "adjustable(11) 2 arrays", &powFastAdj2,
+         &powFastAdj2s );
+      isOk &= testArrays( pOut, rand, "adjustable(11) E arrays", &powFastAdjE,
+         &powFastAdjEs );
+      isOk &= testArrays( pOut, rand, "adjustable(11) 10 arrays",
+         &powFastAdj10, &powFastAdj10s );
+   }
+
+   if( pOut && isVerbose ) benchmark( *pOut, rand );
+
    if( pOut ) *pOut << (isOk ? "--- successfully" : "*** failurefully") <<
       " completed " << "\n\n\n";
 
@@ -12,6 +12,7 @@
 #define PowFast_h
 
 
+#include <cstring>
 
 
 #include "hxa7241_general.hpp"
@@ -52,6 +53,25 @@ float powFastR
 );
 
 
+/**
+ * Arrays: count numbers from pIn, results to pOut (which may be pIn).<br/><br/>
+ *
+ * Same results as one at a time, but in SSE2 or AVX2 registers when compiled
+ * for them.
+ */
+void powFast2 ( const float* pIn,
+                float*       pOut,
+                dword        count );
+
+void powFastE ( const float* pIn,
+                float*       pOut,
+                dword        count );
+
+void powFast10( const float* pIn,
+                float*       pOut,
+                dword        count );
+
+
 
 
 /// fixed //////////////////////////////////////////////////////////////////////
@@ -131,6 +151,17 @@ public:
            float r  ( float logr,
                       float f )                                           const;
 
+           /** arrays (pOut may be pIn), AVX2 gathers when compiled for. */
+           void  two( const float* pIn,
+                      float*       pOut,
+                      dword        count )                                const;
+           void  e  ( const float* pIn,
+                      float*       pOut,
+                      dword        count )                                const;
+           void  ten( const float* pIn,
+                      float*       pOut,
+                      dword        count )                                const;
+
            udword precision()                                             const;
 
 /// fields ---------------------------------------------------------------------
@@ -143,6 +174,165 @@ private:
 /// default instance
 const PowFast& POWFAST();
 
+
+
+
+/// compile-time ///////////////////////////////////////////////////////////////
+
+/**
+ * Fast approximation to pow, with adjustable precision, and its table made at
+ * compile time.<br/><br/>
+ *
+ * The table is constant data (in .rodata): nothing to construct, no locking
+ * on first use, and shared read-only between processes. Otherwise as PowFast
+ * (the table values differ from PowFast's only in float rounding).<br/><br/>
+ *
+ * Precision can be 0 to 12. Storage is (2 ^ precision) * 4 bytes.
+ */
+template<udword PRECISION>
+class PowFastT
+{
+/// standard object services ---------------------------------------------------
+// use defaults
+//          PowFastT();
+//         ~PowFastT();
+//          PowFastT( const PowFastT& );
+//          PowFastT& operator=( const PowFastT& );
+
+/// queries --------------------------------------------------------------------
+public:
+           /** 2 ^ number. Number must be > -125 and < +128.*/
+           float two( float )                                             const;
+
+           /** e ^ number. Number must be > -87.3ish and < +88.7ish. */
+           float e  ( float )                                             const;
+
+           /** 10 ^ number. Number must be > -37.9ish and < +38.5ish. */
+           float ten( float )                                             const;
+
+          /**
+           * Get r ^ number.<br/><br/>
+           *
+           * @logr  logE of radix for power
+           * @f     power to apply (beware under/over-flow)
+           */
+           float r  ( float logr,
+                      float f )                                           const;
+
+           udword precision()                                             const;
+
+/// implementation -------------------------------------------------------------
+private:
+   static  float lookup( float f,
+                         float ilog2 );
+
+/// constants ------------------------------------------------------------------
+   static const udword TABLE[ 1 << PRECISION ];
+};
+
+
+/// tables (defined in PowFast.cpp)
+template<> const udword PowFastT< 0>::TABLE[ 1 <<  0 ];
+template<> const udword PowFastT< 1>::TABLE[ 1 <<  1 ];
+template<> const udword PowFastT< 2>::TABLE[ 1 <<  2 ];
+template<> const udword PowFastT< 3>::TABLE[ 1 <<  3 ];
+template<> const udword PowFastT< 4>::TABLE[ 1 <<  4 ];
+template<> const udword PowFastT< 5>::TABLE[ 1 <<  5 ];
+template<> const udword PowFastT< 6>::TABLE[ 1 <<  6 ];
+template<> const udword PowFastT< 7>::TABLE[ 1 <<  7 ];
+template<> const udword PowFastT< 8>::TABLE[ 1 <<  8 ];
+template<> const udword PowFastT< 9>::TABLE[ 1 <<  9 ];
+template<> const udword PowFastT<10>::TABLE[ 1 << 10 ];
+template<> const udword PowFastT<11>::TABLE[ 1 << 11 ];
+template<> const udword PowFastT<12>::TABLE[ 1 << 12 ];
+
+
+
+
+
+
+
+
+/// INLINES ///
+
+/// compile-time ---------------------------------------------------------------
+template<udword PRECISION>
+inline
+float PowFastT<PRECISION>::two
+(
+   const float f
+) const
+{
+   return lookup( f, 1.0f );
+}
+
+
+template<udword PRECISION>
+inline
+float PowFastT<PRECISION>::e
+(
+   const float f
+) const
+{
+   return lookup( f, 1.44269504088896f );
+}
+
+
+template<udword PRECISION>
+inline
+float PowFastT<PRECISION>::ten
+(
+   const float f
+) const
+{
+   return lookup( f, 3.32192809488736f );
+}
+
+
+template<udword PRECISION>
+inline
+float PowFastT<PRECISION>::r
+(
+   const float logr,
+   const float f
+) const
+{
+   return lookup( f, (logr * 1.44269504088896f) );
+}
+
+
+template<udword PRECISION>
+inline
+udword PowFastT<PRECISION>::precision() const
+{
+   return PRECISION;
+}
+
+
+template<udword PRECISION>
+inline
+float PowFastT<PRECISION>::lookup
+(
+   const float f,
+   const float ilog2
+)
+{
+   static const float _2p23 = 8388608.0f;
+
+   // build float bits, with linear interpolation of fraction
+   const udword i = static_cast<udword>( static_cast<dword>(
+      (f * (_2p23 * ilog2)) + (127.0f * _2p23) ) );
+
+   // replace mantissa with lookup
+   const udword it = (i & 0xFF800000u) |
+      TABLE[(i & 0x7FFFFFu) >> (23 - PRECISION)];
+
+   // convert bits to float
+   float p;
+   std::memcpy( &p, &it, sizeof(p) );
+   return p;
+}
+
 }//namespace
 
 
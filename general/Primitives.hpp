@@ -14,6 +14,9 @@
 
 #include <limits.h>
 #include <float.h>
+#ifndef _MSC_VER
+#include <stdint.h>
+#endif
 
 
 
@@ -32,6 +35,15 @@ namespace hxa7241
    typedef  signed   int    dword;
    typedef  unsigned int    udword;
 
+   // not standard C++98: from C99 stdint.h, or a compiler extension
+#ifdef _MSC_VER
+   typedef  signed   __int64  qword;
+   typedef  unsigned __int64  uqword;
+#else
+   typedef  int64_t         qword;
+   typedef  uint64_t        uqword;
+#endif
+
    typedef  float           fp;
 
 
@@ -8,6 +8,15 @@
 ------------------------------------------------------------------------------*/
 
 
+/// conditional compilations
+#if defined(__AVX2__)
+#define RANDOMMWC1_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (_M_IX86_FP >= 2)
+#define RANDOMMWC1_SSE2
+#include <emmintrin.h>
+#endif
+
 #include "RandomMwc1.hpp"
 
 
@@ -16,6 +25,299 @@ using namespace hxa7241_general;
 
 
 
+/// lanes //////////////////////////////////////////////////////////////////////
+namespace
+{
+
+const dword  LANES = 8;
+
+const udword A     = 2131995753u;
+const udword AH    = A >> 16;
+const udword AL    = A & 65535;
+
+
+/// seed for lane, not 0
+udword getLaneSeed
+(
+   const udword seed,
+   const dword  lane
+)
+{
+   // murmur3 finalizer
+   udword h = seed + (static_cast<udword>(lane + 1) * 0x9E3779B9u);
+   h = (h ^ (h >> 16)) * 0x85EBCA6Bu;
+   h = (h ^ (h >> 13)) * 0xC2B2AE35u;
+   h =  h ^ (h >> 16);
+
+   return h ? h : 1u;
+}
+
+
+/// output conversions
+struct ToUdword
+{
+   typedef udword Value;
+
+   static udword convert( const udword u )
+   {
+      return u;
+   }
+
+#ifdef RANDOMMWC1_SSE2
+   static void store( udword* pValues, const __m128i u )
+   {
+      _mm_storeu_si128( reinterpret_cast<__m128i*>(pValues), u );
+   }
+#endif
+#ifdef RANDOMMWC1_AVX2
+   static void store( udword* pValues, const __m256i u )
+   {
+      _mm256_storeu_si256( reinterpret_cast<__m256i*>(pValues), u );
+   }
+#endif
+};
+
+
+struct ToFloat
+{
+   typedef float Value;
+
+   static float convert( const udword u )
+   {
+      return static_cast<float>(static_cast<dword>(u >> 8)) *
+         (1.0f / 16777216.0f);
+   }
+
+#ifdef RANDOMMWC1_SSE2
+   static void store( float* pValues, const __m128i u )
+   {
+      _mm_storeu_ps( pValues, _mm_mul_ps( _mm_cvtepi32_ps(
+         _mm_srli_epi32( u, 8 ) ), _mm_set1_ps( 1.0f / 16777216.0f ) ) );
+   }
+#endif
+#ifdef RANDOMMWC1_AVX2
+   static void store( float* pValues, const __m256i u )
+   {
+      _mm256_storeu_ps( pValues, _mm256_mul_ps( _mm256_cvtepi32_ps(
+         _mm256_srli_epi32( u, 8 ) ), _mm256_set1_ps( 1.0f / 16777216.0f ) ) );
+   }
+#endif
+};
+
+
+#if defined(RANDOMMWC1_SSE2)
+
+/// as getUdword, on 4 lanes
+inline
+void step
+(
+   __m128i& x,
+   __m128i& c
+)
+{
+   // 16x16 bit products (xl * AL, xh * AH) and (xl * AH, xh * AL), from low
+   // and high halves
+   const __m128i lowMask  = _mm_set1_epi32( 0x0000FFFF );
+   const __m128i highMask = _mm_set1_epi32( static_cast<dword>(0xFFFF0000u) );
+   const __m128i a1 = _mm_set1_epi32( static_cast<dword>((AH << 16) | AL) );
+   const __m128i a2 = _mm_set1_epi32( static_cast<dword>((AL << 16) | AH) );
+
+   const __m128i low1  = _mm_mullo_epi16( x, a1 );
+   const __m128i high1 = _mm_mulhi_epu16( x, a1 );
+   const __m128i low2  = _mm_mullo_epi16( x, a2 );
+   const __m128i high2 = _mm_mulhi_epu16( x, a2 );
+
+   const __m128i xlAl = _mm_or_si128( _mm_and_si128( low1, lowMask ),
+      _mm_slli_epi32( high1, 16 ) );
+   const __m128i xhAh = _mm_or_si128( _mm_srli_epi32( low1, 16 ),
+      _mm_and_si128( high1, highMask ) );
+   const __m128i xlAh = _mm_or_si128( _mm_and_si128( low2, lowMask ),
+      _mm_slli_epi32( high2, 16 ) );
+   const __m128i xhAl = _mm_or_si128( _mm_srli_epi32( low2, 16 ),
+      _mm_and_si128( high2, highMask ) );
+
+   // x = x * A + c
+   x = _mm_add_epi32( _mm_add_epi32( xlAl, _mm_slli_epi32( _mm_add_epi32(
+      xlAh, xhAl ), 16 ) ), c );
+
+   c = _mm_add_epi32( xhAh, _mm_add_epi32( _mm_srli_epi32( xhAl, 16 ),
+      _mm_srli_epi32( xlAh, 16 ) ) );
+
+   // if( (xl * AL) >= (~c + 1) ) ++c  (unsigned compare, by offset signed)
+   const __m128i sign = _mm_set1_epi32( static_cast<dword>(0x80000000u) );
+   const __m128i less = _mm_cmpgt_epi32( _mm_xor_si128( _mm_sub_epi32(
+      _mm_setzero_si128(), c ), sign ), _mm_xor_si128( xlAl, sign ) );
+   c = _mm_add_epi32( c, _mm_andnot_si128( less, _mm_set1_epi32( 1 ) ) );
+}
+
+
+template<class OUT>
+void fillBlocks
+(
+   udword*                pLanes,
+   typename OUT::Value*   pValues,
+   const dword            blocks
+)
+{
+   __m128i x0 = _mm_loadu_si128( reinterpret_cast<__m128i*>(pLanes +  0) );
+   __m128i x1 = _mm_loadu_si128( reinterpret_cast<__m128i*>(pLanes +  4) );
+   __m128i c0 = _mm_loadu_si128( reinterpret_cast<__m128i*>(pLanes +  8) );
+   __m128i c1 = _mm_loadu_si128( reinterpret_cast<__m128i*>(pLanes + 12) );
+
+   for( dword i = blocks;  i-- > 0;  pValues += LANES )
+   {
+      step( x0, c0 );
+      step( x1, c1 );
+
+      OUT::store( pValues + 0, x0 );
+      OUT::store( pValues + 4, x1 );
+   }
+
+   _mm_storeu_si128( reinterpret_cast<__m128i*>(pLanes +  0), x0 );
+   _mm_storeu_si128( reinterpret_cast<__m128i*>(pLanes +  4), x1 );
+   _mm_storeu_si128( reinterpret_cast<__m128i*>(pLanes +  8), c0 );
+   _mm_storeu_si128( reinterpret_cast<__m128i*>(pLanes + 12), c1 );
+}
+
+#elif defined(RANDOMMWC1_AVX2)
+
+/// as getUdword, on 8 lanes
+inline
+void step
+(
+   __m256i& x,
+   __m256i& c
+)
+{
+   const __m256i lowMask  = _mm256_set1_epi32( 0x0000FFFF );
+   const __m256i highMask = _mm256_set1_epi32(
+      static_cast<dword>(0xFFFF0000u) );
+   const __m256i a1 = _mm256_set1_epi32( static_cast<dword>((AH << 16) | AL) );
+   const __m256i a2 = _mm256_set1_epi32( static_cast<dword>((AL << 16) | AH) );
+
+   const __m256i low1  = _mm256_mullo_epi16( x, a1 );
+   const __m256i high1 = _mm256_mulhi_epu16( x, a1 );
+   const __m256i low2  = _mm256_mullo_epi16( x, a2 );
+   const __m256i high2 = _mm256_mulhi_epu16( x, a2 );
+
+   const __m256i xlAl = _mm256_or_si256( _mm256_and_si256( low1, lowMask ),
+      _mm256_slli_epi32( high1, 16 ) );
+   const __m256i xhAh = _mm256_or_si256( _mm256_srli_epi32( low1, 16 ),
+      _mm256_and_si256( high1, highMask ) );
+   const __m256i xlAh = _mm256_or_si256( _mm256_and_si256( low2, lowMask ),
+      _mm256_slli_epi32( high2, 16 ) );
+   const __m256i xhAl = _mm256_or_si256( _mm256_srli_epi32( low2, 16 ),
+      _mm256_and_si256( high2, highMask ) );
+
+   x = _mm256_add_epi32( _mm256_mullo_epi32( x, _mm256_set1_epi32(
+      static_cast<dword>(A) ) ), c );
+
+   c = _mm256_add_epi32( xhAh, _mm256_add_epi32( _mm256_srli_epi32( xhAl,
+      16 ), _mm256_srli_epi32( xlAh, 16 ) ) );
+
+   const __m256i sign = _mm256_set1_epi32( static_cast<dword>(0x80000000u) );
+   const __m256i less = _mm256_cmpgt_epi32( _mm256_xor_si256( _mm256_sub_epi32(
+      _mm256_setzero_si256(), c ), sign ), _mm256_xor_si256( xlAl, sign ) );
+   c = _mm256_add_epi32( c, _mm256_andnot_si256( less,
+      _mm256_set1_epi32( 1 ) ) );
+}
+
+
+template<class OUT>
+void fillBlocks
+(
+   udword*                pLanes,
+   typename OUT::Value*   pValues,
+   const dword            blocks
+)
+{
+   __m256i x = _mm256_loadu_si256( reinterpret_cast<__m256i*>(pLanes + 0) );
+   __m256i c = _mm256_loadu_si256( reinterpret_cast<__m256i*>(pLanes + 8) );
+
+   for( dword i = blocks;  i-- > 0;  pValues += LANES )
+   {
+      step( x, c );
+
+      OUT::store( pValues, x );
+   }
+
+   _mm256_storeu_si256( reinterpret_cast<__m256i*>(pLanes + 0), x );
+   _mm256_storeu_si256( reinterpret_cast<__m256i*>(pLanes + 8), c );
+}
+
+#else
+
+template<class OUT>
+void fillBlocks
+(
+   udword*                pLanes,
+   typename OUT::Value*   pValues,
+   const dword            blocks
+)
+{
+   udword lanes[ LANES * 2 ];
+   for( dword k = LANES * 2;  k-- > 0; )
+   {
+      lanes[k] = pLanes[k];
+   }
+
+   for( dword i = blocks;  i-- > 0;  pValues += LANES )
+   {
+      for( dword k = 0;  k < LANES;  ++k )
+      {
+         udword& x = lanes[k];
+         udword& c = lanes[k + LANES];
+
+         const udword xh = x >> 16;
+         const udword xl = x & 65535;
+
+         x = x * A + c;
+         c = (xh * AH) + ((xh * AL) >> 16) + ((xl * AH) >> 16);
+         if( (xl * AL) >= (~c + 1) )   ++c;
+
+         pValues[k] = OUT::convert( x );
+      }
+   }
+
+   for( dword k = LANES * 2;  k-- > 0; )
+   {
+      pLanes[k] = lanes[k];
+   }
+}
+
+#endif
+
+
+/// whole blocks, then the rest from a part-used block
+template<class OUT>
+void fill
+(
+   udword*                pLanes,
+   typename OUT::Value*   pValues,
+   const dword            count
+)
+{
+   const dword blocks = (count > 0) ? count / LANES : 0;
+   fillBlocks<OUT>( pLanes, pValues, blocks );
+
+   const dword rest = (count > 0) ? count - (blocks * LANES) : 0;
+   if( rest > 0 )
+   {
+      typename OUT::Value last[ LANES ];
+      fillBlocks<OUT>( pLanes, last, 1 );
+
+      for( dword k = 0;  k < rest;  ++k )
+      {
+         pValues[(blocks * LANES) + k] = last[k];
+      }
+   }
+}
+
+}
+
+
+
+
 /// standard object services ---------------------------------------------------
 RandomMwc1::RandomMwc1
 (
@@ -24,6 +326,11 @@ RandomMwc1::RandomMwc1
  : x_m( seed ? seed : 30903u )
  , c_m( seed )
 {
+   // each lane as RandomMwc1( laneSeed )
+   for( dword k = 0;  k < LANES;  ++k )
+   {
+      lanes_m[k] = lanes_m[k + LANES] = getLaneSeed( seed, k );
+   }
 }
 
 
@@ -71,6 +378,220 @@ float RandomMwc1::getFloat() const
 }*/
 
 
+void RandomMwc1::fillUdwords
+(
+   udword* pValues,
+   dword   count
+) const
+{
+   fill<ToUdword>( lanes_m, pValues, count );
+}
+
+
+void RandomMwc1::fillFloats
+(
+   float* pValues,
+   dword  count
+) const
+{
+   fill<ToFloat>( lanes_m, pValues, count );
+}
+
+
+
+
+
+
+
+
+/// test -----------------------------------------------------------------------
+#ifdef TESTING
+
+
+#include <ostream>
+#include <vector>
+
+#include "Stopwatch.hpp"
+
+
+namespace
+{
+
+void benchmark
+(
+   std::ostream& out
+)
+{
+   static const dword COUNT = 1 << 16;
+   static const dword TIMES = 256;
+
+   std::vector<udword> udwords( COUNT );
+   std::vector<float>  floats( COUNT );
+   const RandomMwc1    random;
+
+   double times[4];
+   Stopwatch stopwatch;
+
+   stopwatch.start();
+   for( dword t = TIMES;  t-- > 0; )
+   {
+      for( dword i = 0;  i < COUNT;  ++i )
+      {
+         udwords[i] = random.getUdword();
+      }
+   }
+   times[0] = stopwatch.getSeconds();
+
+   stopwatch.start();
+   for( dword t = TIMES;  t-- > 0; )
+   {
+      random.fillUdwords( &udwords[0], COUNT );
+   }
+   times[1] = stopwatch.getSeconds();
+
+   stopwatch.start();
+   for( dword t = TIMES;  t-- > 0; )
+   {
+      for( dword i = 0;  i < COUNT;  ++i )
+      {
+         floats[i] = random.getFloat();
+      }
+   }
+   times[2] = stopwatch.getSeconds();
+
+   stopwatch.start();
+   for( dword t = TIMES;  t-- > 0; )
+   {
+      random.fillFloats( &floats[0], COUNT );
+   }
+   times[3] = stopwatch.getSeconds();
+
+   const double values = static_cast<double>(COUNT) * TIMES * 1e-9;
+   out << "benchmark  (values per ns: one at a time, fill)\n";
+   out << "   udword  " << (values / times[0]) << "  " << (values / times[1]) <<
+      "\n";
+   out << "   float   " << (values / times[2]) << "  " << (values / times[3]) <<
+      "\n";
+   out << "   (check " << udwords[7] << " " << floats[7] << ")\n\n";
+}
+
+}
+
+
+namespace hxa7241_general
+{
+
+
+bool test_RandomMwc1
+(
+   std::ostream* pOut,
+   const bool    isVerbose,
+   const dword   seed
+)
+{
+   bool isOk = true;
+
+   if( pOut ) *pOut << "[ test_RandomMwc1 ]\n\n";
+
+
+   // one at a time: documented values
+   {
+      bool is = true;
+
+      static const udword VALUES[] = { 266434319u, 1184179474u, 3729546975u,
+         1269245813u, 3172582254u, 395758859u, 156028346u, 20773141u,
+         1703483041u, 1308543988u, 2416731867u, 3626613104u, 1283819493u,
+         912189592u, 3799492147u, 75739638u };
+
+      const RandomMwc1 random;
+      for( dword i = 0;  i < 16;  ++i )
+      {
+         is &= (VALUES[i] == random.getUdword());
+      }
+      for( dword i = 16;  i < 999999;  ++i )
+      {
+         random.getUdword();
+      }
+      is &= (547770101u == random.getUdword());
+
+      if( pOut ) *pOut << "one at a time : " <<
+         (is ? "--- succeeded" : "*** failed") << "\n\n";
+
+      isOk &= is;
+   }
+
+   // fill: interleaved lanes
+   {
+      bool is = true;
+
+      const udword seeds[] = { 0, 1, static_cast<udword>(seed) };
+      for( dword s = 0;  s < 3;  ++s )
+      {
+         // each lane as a separately seeded generator
+         std::vector<udword> expected( 1003 );
+         for( dword k = 0;  k < LANES;  ++k )
+         {
+            const RandomMwc1 lane( getLaneSeed( seeds[s], k ) );
+            for( dword i = k;  i < 1003;  i += LANES )
+            {
+               expected[i] = lane.getUdword();
+            }
+         }
+
+         const RandomMwc1 random( seeds[s] );
+         const RandomMwc1 copy( random );
+
+         // in whole blocks, then a part block
+         std::vector<udword> udwords( 1003 + 1 );
+         random.fillUdwords( &udwords[0], 1000 );
+         random.fillUdwords( &udwords[1000], 3 );
+         random.fillUdwords( &udwords[1003], 0 );
+         random.fillUdwords( &udwords[1003], -1 );
+         for( dword i = 0;  i < 1003;  ++i )
+         {
+            is &= (expected[i] == udwords[i]);
+         }
+         is &= (0 == udwords[1003]);
+
+         // floats from the same values
+         std::vector<float> floats( 1003 );
+         copy.fillFloats( &floats[0], 1003 );
+         for( dword i = 0;  i < 1003;  ++i )
+         {
+            is &= (floats[i] == (static_cast<float>(expected[i] >> 8) /
+               16777216.0f)) & (floats[i] >= 0.0f) & (floats[i] < 1.0f);
+         }
+
+         // lanes separate from one at a time
+         is &= (copy.getUdword() == RandomMwc1( seeds[s] ).getUdword());
+      }
+
+      if( pOut ) *pOut << "fill : " <<
+         (is ? "--- succeeded" : "*** failed") << "\n\n";
+
+      isOk &= is;
+   }
+
+   if( pOut && isVerbose ) benchmark( *pOut );
+
+
+   if( pOut ) *pOut << (isOk ? "--- successfully" : "*** failurefully") <<
+      " completed " << "\n\n\n";
+
+   if( pOut ) pOut->flush();
+
+
+   return isOk;
+}
+
+
+}//namespace
+
+
+#endif//TESTING
+
+
+
 
 
 
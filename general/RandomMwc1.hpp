@@ -25,6 +25,14 @@ namespace hxa7241_general
  * Perhaps the fastest of any generator that passes the Diehard tests.<br/>
  * Half as fast as RandomMwc2.<br/><br/>
  *
+ * fillUdwords and fillFloats are for bulk use. They run 8 generators (lanes)
+ * interleaved -- in SSE2 or AVX2 registers when compiled for them, else
+ * scalar. Lane k is as if constructed with a hash of the seed and k, and
+ * value i comes from lane i % 8, so the values are the same on any platform.
+ * The lanes are separate from getUdword. Each call steps all lanes, so a
+ * sequence continues across calls only for counts that are multiples of 8.
+ * <br/><br/>
+ *
  * Constant (sort-of: internally/non-semantically modifying).
  *
  * @implementation
@@ -32,6 +40,11 @@ namespace hxa7241_general
  * period = (a*2^31)-1 (approx. between 2e+18 and 5e+18). Algorithm recommended
  * by Marsaglia. Copyright (c) 2005, Glenn Rhoads.<br/><br/>
  *
+ * The carry is computed from 16 bit partial products, and is not always the
+ * exact high word, so the sequence is not exactly the recurrence, and cannot
+ * be skipped by modular arithmetic. Use RandomMwc2 for skip and split.<br/>
+ * <br/>
+ *
  * <cite>http://web.archive.org/web/20050213041650/http://
  * paul.rutgers.edu/~rhoads/Code/code.html</cite>
  *
@@ -76,11 +89,21 @@ public:
            udword getUdword()                                             const;
            float  getFloat()                                              const;
 
+           /** 8 interleaved lanes. */
+           void   fillUdwords( udword* pValues,
+                               dword   count )                            const;
+           /** 8 interleaved lanes, [0,1) from the top 24 bits. */
+           void   fillFloats( float* pValues,
+                              dword  count )                              const;
+
 
 /// fields ---------------------------------------------------------------------
 private:
    mutable udword x_m;
    mutable udword c_m;
+
+   // 8 lanes: xs then cs
+   mutable udword lanes_m[16];
 };
 
 
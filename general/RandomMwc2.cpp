@@ -8,6 +8,15 @@
 ------------------------------------------------------------------------------*/
 
 
+/// conditional compilations
+#if defined(__AVX2__)
+#define RANDOMMWC2_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (_M_IX86_FP >= 2)
+#define RANDOMMWC2_SSE2
+#include <emmintrin.h>
+#endif
+
 #include "RandomMwc2.hpp"
 
 
@@ -16,6 +25,354 @@ using namespace hxa7241_general;
 
 
 
+/// lanes //////////////////////////////////////////////////////////////////////
+namespace
+{
+
+const dword  LANES = 8;
+
+const udword A     = 18000u;
+const udword B     = 30903u;
+
+
+/// seed for lane, avoiding the fixed points (0 and multiplier * 2^16 - 1)
+udword getLaneSeed
+(
+   const udword seed,
+   const dword  lane
+)
+{
+   // murmur3 finalizer
+   udword h = seed + (static_cast<udword>(lane + 1) * 0x9E3779B9u);
+   h = (h ^ (h >> 16)) * 0x85EBCA6Bu;
+   h = (h ^ (h >> 13)) * 0xC2B2AE35u;
+   h =  h ^ (h >> 16);
+
+   return ((0 == h) | (((A << 16) - 1) == h) | (((B << 16) - 1) == h)) ?
+      h ^ 1u : h;
+}
+
+
+/// output conversions
+struct ToUdword
+{
+   typedef udword Value;
+
+   static udword convert( const udword u )
+   {
+      return u;
+   }
+
+#ifdef RANDOMMWC2_SSE2
+   static void store( udword* pValues, const __m128i u )
+   {
+      _mm_storeu_si128( reinterpret_cast<__m128i*>(pValues), u );
+   }
+#endif
+#ifdef RANDOMMWC2_AVX2
+   static void store( udword* pValues, const __m256i u )
+   {
+      _mm256_storeu_si256( reinterpret_cast<__m256i*>(pValues), u );
+   }
+#endif
+};
+
+
+struct ToFloat
+{
+   typedef float Value;
+
+   static float convert( const udword u )
+   {
+      return static_cast<float>(static_cast<dword>(u >> 8)) *
+         (1.0f / 16777216.0f);
+   }
+
+#ifdef RANDOMMWC2_SSE2
+   static void store( float* pValues, const __m128i u )
+   {
+      _mm_storeu_ps( pValues, _mm_mul_ps( _mm_cvtepi32_ps(
+         _mm_srli_epi32( u, 8 ) ), _mm_set1_ps( 1.0f / 16777216.0f ) ) );
+   }
+#endif
+#ifdef RANDOMMWC2_AVX2
+   static void store( float* pValues, const __m256i u )
+   {
+      _mm256_storeu_ps( pValues, _mm256_mul_ps( _mm256_cvtepi32_ps(
+         _mm256_srli_epi32( u, 8 ) ), _mm256_set1_ps( 1.0f / 16777216.0f ) ) );
+   }
+#endif
+};
+
+
+#if defined(RANDOMMWC2_SSE2)
+
+/// multiplier * (s & 0xFFFF) + (s >> 16), for multiplier in the low halves
+inline
+__m128i step
+(
+   const __m128i s,
+   const __m128i multiplier
+)
+{
+   // 16x16 bit products, from low and high halves
+   const __m128i low  = _mm_mullo_epi16( s, multiplier );
+   const __m128i high = _mm_mulhi_epu16( s, multiplier );
+
+   return _mm_add_epi32( _mm_or_si128( low, _mm_slli_epi32( high, 16 ) ),
+      _mm_srli_epi32( s, 16 ) );
+}
+
+
+template<class OUT>
+void fillBlocks
+(
+   udword*                pLanes,
+   typename OUT::Value*   pValues,
+   const dword            blocks
+)
+{
+   __m128i a0 = _mm_loadu_si128( reinterpret_cast<__m128i*>(pLanes +  0) );
+   __m128i a1 = _mm_loadu_si128( reinterpret_cast<__m128i*>(pLanes +  4) );
+   __m128i b0 = _mm_loadu_si128( reinterpret_cast<__m128i*>(pLanes +  8) );
+   __m128i b1 = _mm_loadu_si128( reinterpret_cast<__m128i*>(pLanes + 12) );
+
+   const __m128i a    = _mm_set1_epi32( A );
+   const __m128i b    = _mm_set1_epi32( B );
+   const __m128i mask = _mm_set1_epi32( 0xFFFF );
+
+   for( dword i = blocks;  i-- > 0;  pValues += LANES )
+   {
+      a0 = step( a0, a );
+      a1 = step( a1, a );
+      b0 = step( b0, b );
+      b1 = step( b1, b );
+
+      OUT::store( pValues + 0, _mm_add_epi32( _mm_slli_epi32( a0, 16 ),
+         _mm_and_si128( b0, mask ) ) );
+      OUT::store( pValues + 4, _mm_add_epi32( _mm_slli_epi32( a1, 16 ),
+         _mm_and_si128( b1, mask ) ) );
+   }
+
+   _mm_storeu_si128( reinterpret_cast<__m128i*>(pLanes +  0), a0 );
+   _mm_storeu_si128( reinterpret_cast<__m128i*>(pLanes +  4), a1 );
+   _mm_storeu_si128( reinterpret_cast<__m128i*>(pLanes +  8), b0 );
+   _mm_storeu_si128( reinterpret_cast<__m128i*>(pLanes + 12), b1 );
+}
+
+#elif defined(RANDOMMWC2_AVX2)
+
+inline
+__m256i step
+(
+   const __m256i s,
+   const __m256i multiplier
+)
+{
+   const __m256i low  = _mm256_mullo_epi16( s, multiplier );
+   const __m256i high = _mm256_mulhi_epu16( s, multiplier );
+
+   return _mm256_add_epi32( _mm256_or_si256( low,
+      _mm256_slli_epi32( high, 16 ) ), _mm256_srli_epi32( s, 16 ) );
+}
+
+
+template<class OUT>
+void fillBlocks
+(
+   udword*                pLanes,
+   typename OUT::Value*   pValues,
+   const dword            blocks
+)
+{
+   __m256i as = _mm256_loadu_si256( reinterpret_cast<__m256i*>(pLanes + 0) );
+   __m256i bs = _mm256_loadu_si256( reinterpret_cast<__m256i*>(pLanes + 8) );
+
+   const __m256i a    = _mm256_set1_epi32( A );
+   const __m256i b    = _mm256_set1_epi32( B );
+   const __m256i mask = _mm256_set1_epi32( 0xFFFF );
+
+   for( dword i = blocks;  i-- > 0;  pValues += LANES )
+   {
+      as = step( as, a );
+      bs = step( bs, b );
+
+      OUT::store( pValues, _mm256_add_epi32( _mm256_slli_epi32( as, 16 ),
+         _mm256_and_si256( bs, mask ) ) );
+   }
+
+   _mm256_storeu_si256( reinterpret_cast<__m256i*>(pLanes + 0), as );
+   _mm256_storeu_si256( reinterpret_cast<__m256i*>(pLanes + 8), bs );
+}
+
+#else
+
+template<class OUT>
+void fillBlocks
+(
+   udword*                pLanes,
+   typename OUT::Value*   pValues,
+   const dword            blocks
+)
+{
+   udword lanes[ LANES * 2 ];
+   for( dword k = LANES * 2;  k-- > 0; )
+   {
+      lanes[k] = pLanes[k];
+   }
+
+   for( dword i = blocks;  i-- > 0;  pValues += LANES )
+   {
+      for( dword k = 0;  k < LANES;  ++k )
+      {
+         udword& a = lanes[k];
+         udword& b = lanes[k + LANES];
+         a = (A * (a & 0xFFFFu)) + (a >> 16);
+         b = (B * (b & 0xFFFFu)) + (b >> 16);
+
+         pValues[k] = OUT::convert( (a << 16) + (b & 0xFFFFu) );
+      }
+   }
+
+   for( dword k = LANES * 2;  k-- > 0; )
+   {
+      pLanes[k] = lanes[k];
+   }
+}
+
+#endif
+
+
+/// whole blocks, then the rest from a part-used block
+template<class OUT>
+void fill
+(
+   udword*                pLanes,
+   typename OUT::Value*   pValues,
+   const dword            count
+)
+{
+   const dword blocks = (count > 0) ? count / LANES : 0;
+   fillBlocks<OUT>( pLanes, pValues, blocks );
+
+   const dword rest = (count > 0) ? count - (blocks * LANES) : 0;
+   if( rest > 0 )
+   {
+      typename OUT::Value last[ LANES ];
+      fillBlocks<OUT>( pLanes, last, 1 );
+
+      for( dword k = 0;  k < rest;  ++k )
+      {
+         pValues[(blocks * LANES) + k] = last[k];
+      }
+   }
+}
+
+}
+
+
+
+
+/// skipping ///////////////////////////////////////////////////////////////////
+namespace
+{
+
+/// moduli: multiplier * 2^16 - 1 (prime)
+const udword MODULUS_A = (A << 16) - 1;
+const udword MODULUS_B = (B << 16) - 1;
+
+
+/// one step of one half
+inline
+udword stepHalf
+(
+   const udword s,
+   const udword multiplier
+)
+{
+   return (multiplier * (s & 0xFFFFu)) + (s >> 16);
+}
+
+
+/// (a * b) mod m, for a, b < m < 2^31
+udword mulMod
+(
+   udword       a,
+   udword       b,
+   const udword m
+)
+{
+   udword product = 0;
+
+   for( ;  b;  b >>= 1 )
+   {
+      if( b & 1 )
+      {
+         product += a;
+         product -= (product >= m) ? m : 0;
+      }
+      a += a;
+      a -= (a >= m) ? m : 0;
+   }
+
+   return product;
+}
+
+
+/// multiplier^(steps * 2^power) mod m
+udword powMod
+(
+   udword       multiplier,
+   udword       steps,
+   const dword  power,
+   const udword m
+)
+{
+   for( dword i = power;  i-- > 0; )
+   {
+      multiplier = mulMod( multiplier, multiplier, m );
+   }
+
+   udword result = 1;
+   for( ;  steps;  steps >>= 1 )
+   {
+      if( steps & 1 )
+      {
+         result = mulMod( result, multiplier, m );
+      }
+      multiplier = mulMod( multiplier, multiplier, m );
+   }
+
+   return result;
+}
+
+
+/// two or more steps of one half, given jump = multiplier^steps mod m
+udword skipHalf
+(
+   const udword s,
+   const udword multiplier,
+   const udword m,
+   const udword jump
+)
+{
+   // within two steps s is in [0, m] and stays there, so the congruent value
+   // is exact -- except for 0 and m, both fixed points, reached by stepping
+   const udword r = s % m;
+
+   return r ? mulMod( jump, r, m ) : stepHalf( stepHalf( s, multiplier ),
+      multiplier );
+}
+
+}
+
+
+/// statics --------------------------------------------------------------------
+const dword RandomMwc2::SUBSTREAM_POWER;
+
+
+
+
 /// standard object services ---------------------------------------------------
 RandomMwc2::RandomMwc2
 (
@@ -24,6 +381,58 @@ RandomMwc2::RandomMwc2
 {
    seeds_m[0] = seed ? seed : 521288629u;
    seeds_m[1] = seed ? seed : 362436069u;
+
+   // each lane as RandomMwc2( laneSeed )
+   for( dword k = 0;  k < LANES;  ++k )
+   {
+      lanes_m[k] = lanes_m[k + LANES] = getLaneSeed( seed, k );
+   }
+}
+
+
+
+
+/// commands -------------------------------------------------------------------
+void RandomMwc2::skip
+(
+   const udword steps,
+   const dword  power
+)
+{
+   if( (1 == steps) & (power <= 0) )
+   {
+      seeds_m[0] = stepHalf( seeds_m[0], A );
+      seeds_m[1] = stepHalf( seeds_m[1], B );
+      for( dword k = 0;  k < LANES;  ++k )
+      {
+         lanes_m[k]         = stepHalf( lanes_m[k], A );
+         lanes_m[k + LANES] = stepHalf( lanes_m[k + LANES], B );
+      }
+   }
+   else if( 0 != steps )
+   {
+      const dword  p     = (power > 0) ? power : 0;
+      const udword jumpA = powMod( A, steps, p, MODULUS_A );
+      const udword jumpB = powMod( B, steps, p, MODULUS_B );
+
+      seeds_m[0] = skipHalf( seeds_m[0], A, MODULUS_A, jumpA );
+      seeds_m[1] = skipHalf( seeds_m[1], B, MODULUS_B, jumpB );
+      for( dword k = 0;  k < LANES;  ++k )
+      {
+         lanes_m[k] = skipHalf( lanes_m[k], A, MODULUS_A, jumpA );
+         lanes_m[k + LANES] = skipHalf( lanes_m[k + LANES], B, MODULUS_B,
+            jumpB );
+      }
+   }
+}
+
+
+RandomMwc2 RandomMwc2::split()
+{
+   const RandomMwc2 substream( *this );
+   skip( 1, SUBSTREAM_POWER );
+
+   return substream;
 }
 
 
@@ -65,3 +474,280 @@ float RandomMwc2::getFloat() const
    return static_cast<float>( getUdword() >> (32 - noOfBits) ) /
       ( static_cast<float>( 1 << (noOfBits - 1) ) * 2.0f );
 }*/
+
+
+void RandomMwc2::fillUdwords
+(
+   udword* pValues,
+   dword   count
+) const
+{
+   fill<ToUdword>( lanes_m, pValues, count );
+}
+
+
+void RandomMwc2::fillFloats
+(
+   float* pValues,
+   dword  count
+) const
+{
+   fill<ToFloat>( lanes_m, pValues, count );
+}
+
+
+
+
+
+
+
+
+/// test -----------------------------------------------------------------------
+#ifdef TESTING
+
+
+#include <ostream>
+#include <vector>
+
+#include "Stopwatch.hpp"
+
+
+namespace
+{
+
+void benchmark
+(
+   std::ostream& out
+)
+{
+   static const dword COUNT = 1 << 16;
+   static const dword TIMES = 256;
+
+   std::vector<udword> udwords( COUNT );
+   std::vector<float>  floats( COUNT );
+   const RandomMwc2    random;
+
+   double times[4];
+   Stopwatch stopwatch;
+
+   stopwatch.start();
+   for( dword t = TIMES;  t-- > 0; )
+   {
+      for( dword i = 0;  i < COUNT;  ++i )
+      {
+         udwords[i] = random.getUdword();
+      }
+   }
+   times[0] = stopwatch.getSeconds();
+
+   stopwatch.start();
+   for( dword t = TIMES;  t-- > 0; )
+   {
+      random.fillUdwords( &udwords[0], COUNT );
+   }
+   times[1] = stopwatch.getSeconds();
+
+   stopwatch.start();
+   for( dword t = TIMES;  t-- > 0; )
+   {
+      for( dword i = 0;  i < COUNT;  ++i )
+      {
+         floats[i] = random.getFloat();
+      }
+   }
+   times[2] = stopwatch.getSeconds();
+
+   stopwatch.start();
+   for( dword t = TIMES;  t-- > 0; )
+   {
+      random.fillFloats( &floats[0], COUNT );
+   }
+   times[3] = stopwatch.getSeconds();
+
+   const double values = static_cast<double>(COUNT) * TIMES * 1e-9;
+   out << "benchmark  (values per ns: one at a time, fill)\n";
+   out << "   udword  " << (values / times[0]) << "  " << (values / times[1]) <<
+      "\n";
+   out << "   float   " << (values / times[2]) << "  " << (values / times[3]) <<
+      "\n";
+   out << "   (check " << udwords[7] << " " << floats[7] << ")\n\n";
+}
+
+}
+
+
+namespace hxa7241_general
+{
+
+
+bool test_RandomMwc2
+(
+   std::ostream* pOut,
+   const bool    isVerbose,
+   const dword   seed
+)
+{
+   bool isOk = true;
+
+   if( pOut ) *pOut << "[ test_RandomMwc2 ]\n\n";
+
+
+   // one at a time: documented values
+   {
+      bool is = true;
+
+      static const udword VALUES[] = { 1168299085u, 520487819u, 1761612921u,
+         3632618539u, 610669668u, 2136514290u, 3850311835u, 2494138816u,
+         3923280858u, 1280618954u, 309986706u, 924303156u, 2252542156u,
+         1444019197u, 2955985350u, 1185139548u };
+
+      const RandomMwc2 random;
+      for( dword i = 0;  i < 16;  ++i )
+      {
+         is &= (VALUES[i] == random.getUdword());
+      }
+      for( dword i = 16;  i < 999999;  ++i )
+      {
+         random.getUdword();
+      }
+      is &= (2289498853u == random.getUdword());
+
+      if( pOut ) *pOut << "one at a time : " <<
+         (is ? "--- succeeded" : "*** failed") << "\n\n";
+
+      isOk &= is;
+   }
+
+   // fill: interleaved lanes
+   {
+      bool is = true;
+
+      const udword seeds[] = { 0, 1, static_cast<udword>(seed) };
+      for( dword s = 0;  s < 3;  ++s )
+      {
+         // each lane as a separately seeded generator
+         std::vector<udword> expected( 1003 );
+         for( dword k = 0;  k < LANES;  ++k )
+         {
+            const RandomMwc2 lane( getLaneSeed( seeds[s], k ) );
+            for( dword i = k;  i < 1003;  i += LANES )
+            {
+               expected[i] = lane.getUdword();
+            }
+         }
+
+         const RandomMwc2 random( seeds[s] );
+         const RandomMwc2 copy( random );
+
+         // in whole blocks, then a part block
+         std::vector<udword> udwords( 1003 + 1 );
+         random.fillUdwords( &udwords[0], 1000 );
+         random.fillUdwords( &udwords[1000], 3 );
+         random.fillUdwords( &udwords[1003], 0 );
+         random.fillUdwords( &udwords[1003], -1 );
+         for( dword i = 0;  i < 1003;  ++i )
+         {
+            is &= (expected[i] == udwords[i]);
+         }
+         is &= (0 == udwords[1003]);
+
+         // floats from the same values
+         std::vector<float> floats( 1003 );
+         copy.fillFloats( &floats[0], 1003 );
+         for( dword i = 0;  i < 1003;  ++i )
+         {
+            is &= (floats[i] == (static_cast<float>(expected[i] >> 8) /
+               16777216.0f)) & (floats[i] >= 0.0f) & (floats[i] < 1.0f);
+         }
+
+         // lanes separate from one at a time
+         is &= (copy.getUdword() == RandomMwc2( seeds[s] ).getUdword());
+      }
+
+      if( pOut ) *pOut << "fill : " <<
+         (is ? "--- succeeded" : "*** failed") << "\n\n";
+
+      isOk &= is;
+   }
+
+   // skip and split
+   {
+      bool is = true;
+
+      // including seeds above the moduli, and a fixed point
+      const udword seeds[] = { 0, 1, 0xFFFFFFFFu, MODULUS_A, MODULUS_A + 1,
+         static_cast<udword>(seed) };
+      for( dword s = 0;  s < 6;  ++s )
+      {
+         static const udword STEPS[] = { 0, 1, 2, 3, 8, 1000, 100003 };
+         for( dword t = 0;  t < 7;  ++t )
+         {
+            RandomMwc2       skipped( seeds[s] );
+            const RandomMwc2 stepped( seeds[s] );
+            std::vector<udword> stepFills( (STEPS[t] * LANES) + 16 );
+            stepped.fillUdwords( &stepFills[0], stepFills.size() );
+            for( udword i = STEPS[t];  i-- > 0; )
+            {
+               stepped.getUdword();
+            }
+
+            skipped.skip( STEPS[t] );
+            is &= (stepped.getUdword() == skipped.getUdword());
+
+            udword skipFills[ 16 ];
+            skipped.fillUdwords( skipFills, 16 );
+            for( dword i = 0;  i < 16;  ++i )
+            {
+               is &= (stepFills[(STEPS[t] * LANES) + i] == skipFills[i]);
+            }
+         }
+
+         // steps * 2^power
+         RandomMwc2 a( seeds[s] );
+         RandomMwc2 b( seeds[s] );
+         a.skip( 3, 4 );
+         b.skip( 48 );
+         is &= (a.getUdword() == b.getUdword());
+         a.skip( 1, 40 );
+         a.skip( 1, 40 );
+         b.skip( 2, 40 );
+         is &= (a.getUdword() == b.getUdword());
+
+         // consecutive substreams
+         RandomMwc2       parent( seeds[s] );
+         const RandomMwc2 first( parent.split() );
+         const RandomMwc2 second( parent.split() );
+         RandomMwc2       indexed( seeds[s] );
+         indexed.skip( 1, RandomMwc2::SUBSTREAM_POWER );
+         const udword value = second.getUdword();
+         is &= (value == indexed.getUdword()) &
+            (RandomMwc2( seeds[s] ).getUdword() == first.getUdword());
+         RandomMwc2       third( seeds[s] );
+         third.skip( 2, RandomMwc2::SUBSTREAM_POWER );
+         is &= (parent.getUdword() == third.getUdword());
+         is &= (value != first.getUdword()) | (s == 3);
+      }
+
+      if( pOut ) *pOut << "skip and split : " <<
+         (is ? "--- succeeded" : "*** failed") << "\n\n";
+
+      isOk &= is;
+   }
+
+   if( pOut && isVerbose ) benchmark( *pOut );
+
+
+   if( pOut ) *pOut << (isOk ? "--- successfully" : "*** failurefully") <<
+      " completed " << "\n\n\n";
+
+   if( pOut ) pOut->flush();
+
+
+   return isOk;
+}
+
+
+}//namespace
+
+
+#endif//TESTING
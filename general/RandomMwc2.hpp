@@ -27,6 +27,20 @@ namespace hxa7241_general
  * (Maybe about 1 every 10 CPU clock-cycles, ie. 100 million per second on a
  * 1GHz CPU (timed with a Pentium 3).)<br/><br/>
  *
+ * fillUdwords and fillFloats are for bulk use. They run 8 generators (lanes)
+ * interleaved -- in SSE2 or AVX2 registers when compiled for them, else
+ * scalar. Lane k is as if constructed with a hash of the seed and k, and
+ * value i comes from lane i % 8, so the values are the same on any platform.
+ * The lanes are separate from getUdword. Each call steps all lanes, so a
+ * sequence continues across calls only for counts that are multiples of 8.
+ * <br/><br/>
+ *
+ * skip moves on as many steps as that many getUdword calls (and the fill lanes
+ * as many steps each), in log time. For parallel use, split gives substreams
+ * of 2^SUBSTREAM_POWER steps, disjoint for up to 2^19 of them (the period is
+ * about 2^59). Substreams depend only on the seed and the order of splitting
+ * (or the index given to skip), not on how many threads use them.<br/><br/>
+ *
  * Constant (sort-of: internally/non-semantically modifying).
  *
  * @implementation
@@ -35,6 +49,9 @@ namespace hxa7241_general
  * carry packed within the same 32 bit integer. Algorithm recommended by
  * Marsaglia. Copyright (c) 2005, Glenn Rhoads.<br/><br/>
  *
+ * Packed as carry * 2^16 + x, each step is s(n) = a * s(n-1) mod (a*2^16 - 1),
+ * so skipping n steps is a multiply by a^n.<br/><br/>
+ *
  * <cite>http://web.archive.org/web/20050213041650/http://
  * paul.rutgers.edu/~rhoads/Code/code.html</cite>
  *
@@ -73,16 +90,35 @@ public:
 
 
 /// commands -------------------------------------------------------------------
+           /** steps * 2^power steps on. */
+           void   skip( udword steps,
+                        dword  power = 0 );
+           /** a generator here, and this moved a substream on. */
+           RandomMwc2 split();
 
 
 /// queries --------------------------------------------------------------------
            udword getUdword()                                             const;
            float  getFloat()                                              const;
 
+           /** 8 interleaved lanes. */
+           void   fillUdwords( udword* pValues,
+                               dword   count )                            const;
+           /** 8 interleaved lanes, [0,1) from the top 24 bits. */
+           void   fillFloats( float* pValues,
+                              dword  count )                              const;
+
+
+/// constants ------------------------------------------------------------------
+   static const dword SUBSTREAM_POWER = 40;
+
 
 /// fields ---------------------------------------------------------------------
 private:
    mutable udword seeds_m[2];
+
+   // 8 lanes: firsts then seconds
+   mutable udword lanes_m[16];
 };
 
 
@@ -0,0 +1,714 @@
+/*------------------------------------------------------------------------------
+
+   HXA7241 General library.
+   Copyright (c) 2004-2007,  Harrison Ainsworth / HXA7241.
+
+   http://www.hxa7241.org/
+
+------------------------------------------------------------------------------*/
+
+
+/// conditional compilations
+#if defined(__AVX2__)
+#define RANDOMPHILOX_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (_M_IX86_FP >= 2)
+#define RANDOMPHILOX_SSE2
+#include <emmintrin.h>
+#endif
+
+#include "RandomPhilox.hpp"
+
+
+using namespace hxa7241_general;
+
+
+
+
+/// rounds /////////////////////////////////////////////////////////////////////
+namespace
+{
+
+const dword  ROUNDS     = 10;
+
+// multipliers, and key increments (golden ratio, sqrt(3) - 1)
+const udword M0         = 0xD2511F53u;
+const udword M1         = 0xCD9E8D57u;
+const udword W0         = 0x9E3779B9u;
+const udword W1         = 0xBB67AE85u;
+
+// counter word 0 of a stream: index >> 2
+const udword BLOCK_MASK = 0x3FFFFFFFu;
+
+
+void philox
+(
+   const udword key[2],
+   const udword counter[4],
+   udword       values[4]
+)
+{
+   udword k0 = key[0];
+   udword k1 = key[1];
+
+   udword c0 = counter[0];
+   udword c1 = counter[1];
+   udword c2 = counter[2];
+   udword c3 = counter[3];
+
+   for( dword r = ROUNDS;  r-- > 0; )
+   {
+      const uqword p0 = static_cast<uqword>(M0) * c0;
+      const uqword p1 = static_cast<uqword>(M1) * c2;
+
+      c0 = static_cast<udword>(p1 >> 32) ^ c1 ^ k0;
+      c1 = static_cast<udword>(p1);
+      c2 = static_cast<udword>(p0 >> 32) ^ c3 ^ k1;
+      c3 = static_cast<udword>(p0);
+
+      k0 += W0;
+      k1 += W1;
+   }
+
+   values[0] = c0;
+   values[1] = c1;
+   values[2] = c2;
+   values[3] = c3;
+}
+
+
+/// four values of a stream
+inline
+void getBlock
+(
+   const udword key[2],
+   const udword block,
+   const udword stream,
+   udword       values[4]
+)
+{
+   const udword counter[] = { block & BLOCK_MASK, stream, 0, 0 };
+   philox( key, counter, values );
+}
+
+
+/// value index of a stream
+inline
+udword getWord
+(
+   const udword key[2],
+   const udword index,
+   const udword stream
+)
+{
+   udword values[4];
+   getBlock( key, index >> 2, stream, values );
+
+   return values[index & 3];
+}
+
+
+/// output conversions
+struct ToUdword
+{
+   typedef udword Value;
+
+   static udword convert( const udword u )
+   {
+      return u;
+   }
+
+#ifdef RANDOMPHILOX_SSE2
+   static void store( udword* pValues, const __m128i u )
+   {
+      _mm_storeu_si128( reinterpret_cast<__m128i*>(pValues), u );
+   }
+#endif
+#ifdef RANDOMPHILOX_AVX2
+   static void store( udword* pValues, const __m256i u )
+   {
+      _mm256_storeu_si256( reinterpret_cast<__m256i*>(pValues), u );
+   }
+#endif
+};
+
+
+struct ToFloat
+{
+   typedef float Value;
+
+   static float convert( const udword u )
+   {
+      return static_cast<float>(static_cast<dword>(u >> 8)) *
+         (1.0f / 16777216.0f);
+   }
+
+#ifdef RANDOMPHILOX_SSE2
+   static void store( float* pValues, const __m128i u )
+   {
+      _mm_storeu_ps( pValues, _mm_mul_ps( _mm_cvtepi32_ps(
+         _mm_srli_epi32( u, 8 ) ), _mm_set1_ps( 1.0f / 16777216.0f ) ) );
+   }
+#endif
+#ifdef RANDOMPHILOX_AVX2
+   static void store( float* pValues, const __m256i u )
+   {
+      _mm256_storeu_ps( pValues, _mm256_mul_ps( _mm256_cvtepi32_ps(
+         _mm256_srli_epi32( u, 8 ) ), _mm256_set1_ps( 1.0f / 16777216.0f ) ) );
+   }
+#endif
+};
+
+
+#if defined(RANDOMPHILOX_SSE2)
+
+/// 32x32 bit products of each lane, high and low halves
+inline
+void mulHiLo
+(
+   const __m128i a,
+   const __m128i multiplier,
+   __m128i&      high,
+   __m128i&      low
+)
+{
+   // lanes 0 and 2, then 1 and 3, as 64 bits
+   const __m128i even = _mm_mul_epu32( a, multiplier );
+   const __m128i odd  = _mm_mul_epu32( _mm_srli_epi64( a, 32 ), multiplier );
+   const __m128i mask = _mm_set_epi32( 0, -1, 0, -1 );
+
+   high = _mm_or_si128( _mm_srli_epi64( even, 32 ),
+      _mm_andnot_si128( mask, odd ) );
+   low  = _mm_or_si128( _mm_and_si128( even, mask ),
+      _mm_slli_epi64( odd, 32 ) );
+}
+
+
+/// 4 blocks at a time, returning how many done
+template<class OUT>
+dword fillBlocks
+(
+   const udword           key[2],
+   const udword           block,
+   const udword           stream,
+   typename OUT::Value*   pValues,
+   const dword            blocks
+)
+{
+   const __m128i m0     = _mm_set1_epi32( M0 );
+   const __m128i m1     = _mm_set1_epi32( M1 );
+   const __m128i mask   = _mm_set1_epi32( BLOCK_MASK );
+   const __m128i offset = _mm_set_epi32( 3, 2, 1, 0 );
+
+   dword b = 0;
+   for( ;  (b + 4) <= blocks;  b += 4, pValues += 16 )
+   {
+      // counters: one per lane
+      __m128i c0 = _mm_and_si128( _mm_add_epi32( _mm_set1_epi32( block + b ),
+         offset ), mask );
+      __m128i c1 = _mm_set1_epi32( stream );
+      __m128i c2 = _mm_setzero_si128();
+      __m128i c3 = _mm_setzero_si128();
+
+      udword k0 = key[0];
+      udword k1 = key[1];
+      for( dword r = ROUNDS;  r-- > 0; )
+      {
+         __m128i high0, low0, high1, low1;
+         mulHiLo( c0, m0, high0, low0 );
+         mulHiLo( c2, m1, high1, low1 );
+
+         c0 = _mm_xor_si128( _mm_xor_si128( high1, c1 ),
+            _mm_set1_epi32( k0 ) );
+         c1 = low1;
+         c2 = _mm_xor_si128( _mm_xor_si128( high0, c3 ),
+            _mm_set1_epi32( k1 ) );
+         c3 = low0;
+
+         k0 += W0;
+         k1 += W1;
+      }
+
+      // transpose: lanes to blocks
+      const __m128i t0 = _mm_unpacklo_epi32( c0, c1 );
+      const __m128i t1 = _mm_unpacklo_epi32( c2, c3 );
+      const __m128i t2 = _mm_unpackhi_epi32( c0, c1 );
+      const __m128i t3 = _mm_unpackhi_epi32( c2, c3 );
+
+      OUT::store( pValues +  0, _mm_unpacklo_epi64( t0, t1 ) );
+      OUT::store( pValues +  4, _mm_unpackhi_epi64( t0, t1 ) );
+      OUT::store( pValues +  8, _mm_unpacklo_epi64( t2, t3 ) );
+      OUT::store( pValues + 12, _mm_unpackhi_epi64( t2, t3 ) );
+   }
+
+   return b;
+}
+
+#elif defined(RANDOMPHILOX_AVX2)
+
+inline
+void mulHiLo
+(
+   const __m256i a,
+   const __m256i multiplier,
+   __m256i&      high,
+   __m256i&      low
+)
+{
+   const __m256i even = _mm256_mul_epu32( a, multiplier );
+   const __m256i odd  = _mm256_mul_epu32( _mm256_srli_epi64( a, 32 ),
+      multiplier );
+
+   high = _mm256_blend_epi32( _mm256_srli_epi64( even, 32 ), odd, 0xAA );
+   low  = _mm256_blend_epi32( even, _mm256_slli_epi64( odd, 32 ), 0xAA );
+}
+
+
+/// 8 blocks at a time, returning how many done
+template<class OUT>
+dword fillBlocks
+(
+   const udword           key[2],
+   const udword           block,
+   const udword           stream,
+   typename OUT::Value*   pValues,
+   const dword            blocks
+)
+{
+   const __m256i m0     = _mm256_set1_epi32( M0 );
+   const __m256i m1     = _mm256_set1_epi32( M1 );
+   const __m256i mask   = _mm256_set1_epi32( BLOCK_MASK );
+   const __m256i offset = _mm256_set_epi32( 7, 6, 5, 4, 3, 2, 1, 0 );
+
+   dword b = 0;
+   for( ;  (b + 8) <= blocks;  b += 8, pValues += 32 )
+   {
+      __m256i c0 = _mm256_and_si256( _mm256_add_epi32( _mm256_set1_epi32(
+         block + b ), offset ), mask );
+      __m256i c1 = _mm256_set1_epi32( stream );
+      __m256i c2 = _mm256_setzero_si256();
+      __m256i c3 = _mm256_setzero_si256();
+
+      udword k0 = key[0];
+      udword k1 = key[1];
+      for( dword r = ROUNDS;  r-- > 0; )
+      {
+         __m256i high0, low0, high1, low1;
+         mulHiLo( c0, m0, high0, low0 );
+         mulHiLo( c2, m1, high1, low1 );
+
+         c0 = _mm256_xor_si256( _mm256_xor_si256( high1, c1 ),
+            _mm256_set1_epi32( k0 ) );
+         c1 = low1;
+         c2 = _mm256_xor_si256( _mm256_xor_si256( high0, c3 ),
+            _mm256_set1_epi32( k1 ) );
+         c3 = low0;
+
+         k0 += W0;
+         k1 += W1;
+      }
+
+      // transpose within 128-bit halves (blocks 0-3 and 4-7), then pair them
+      const __m256i t0 = _mm256_unpacklo_epi32( c0, c1 );
+      const __m256i t1 = _mm256_unpacklo_epi32( c2, c3 );
+      const __m256i t2 = _mm256_unpackhi_epi32( c0, c1 );
+      const __m256i t3 = _mm256_unpackhi_epi32( c2, c3 );
+
+      const __m256i b04 = _mm256_unpacklo_epi64( t0, t1 );
+      const __m256i b15 = _mm256_unpackhi_epi64( t0, t1 );
+      const __m256i b26 = _mm256_unpacklo_epi64( t2, t3 );
+      const __m256i b37 = _mm256_unpackhi_epi64( t2, t3 );
+
+      OUT::store( pValues +  0, _mm256_permute2x128_si256( b04, b15, 0x20 ) );
+      OUT::store( pValues +  8, _mm256_permute2x128_si256( b26, b37, 0x20 ) );
+      OUT::store( pValues + 16, _mm256_permute2x128_si256( b04, b15, 0x31 ) );
+      OUT::store( pValues + 24, _mm256_permute2x128_si256( b26, b37, 0x31 ) );
+   }
+
+   return b;
+}
+
+#else
+
+template<class OUT>
+dword fillBlocks
+(
+   const udword*,
+   udword,
+   udword,
+   typename OUT::Value*,
+   dword
+)
+{
+   return 0;
+}
+
+#endif
+
+
+/// part block, whole blocks (wide, then scalar), part block
+template<class OUT>
+void fill
+(
+   const udword           key[2],
+   udword                 index,
+   const udword           stream,
+   typename OUT::Value*   pValues,
+   const dword            count
+)
+{
+   dword i = 0;
+   for( ;  (i < count) && (0 != (index & 3));  ++i, ++index )
+   {
+      pValues[i] = OUT::convert( getWord( key, index, stream ) );
+   }
+
+   const dword blocks = (count > i) ? (count - i) >> 2 : 0;
+   for( dword b = fillBlocks<OUT>( key, index >> 2, stream, pValues + i,
+      blocks );  b < blocks;  ++b )
+   {
+      udword values[4];
+      getBlock( key, (index >> 2) + b, stream, values );
+      for( dword k = 0;  k < 4;  ++k )
+      {
+         pValues[i + (b * 4) + k] = OUT::convert( values[k] );
+      }
+   }
+   i     += blocks * 4;
+   index += blocks * 4;
+
+   for( ;  i < count;  ++i, ++index )
+   {
+      pValues[i] = OUT::convert( getWord( key, index, stream ) );
+   }
+}
+
+}
+
+
+
+
+/// standard object services ---------------------------------------------------
+RandomPhilox::RandomPhilox
+(
+   const udword key0,
+   const udword key1
+)
+{
+   key_m[0] = key0;
+   key_m[1] = key1;
+}
+
+
+
+
+/// queries --------------------------------------------------------------------
+void RandomPhilox::get
+(
+   const udword counter[4],
+   udword       values[4]
+) const
+{
+   philox( key_m, counter, values );
+}
+
+
+udword RandomPhilox::getUdword
+(
+   const udword index,
+   const udword stream
+) const
+{
+   return getWord( key_m, index, stream );
+}
+
+
+float RandomPhilox::getFloat
+(
+   const udword index,
+   const udword stream
+) const
+{
+   return ToFloat::convert( getWord( key_m, index, stream ) );
+}
+
+
+void RandomPhilox::fillUdwords
+(
+   const udword index,
+   const udword stream,
+   udword*      pValues,
+   const dword  count
+) const
+{
+   fill<ToUdword>( key_m, index, stream, pValues, count );
+}
+
+
+void RandomPhilox::fillFloats
+(
+   const udword index,
+   const udword stream,
+   float*       pValues,
+   const dword  count
+) const
+{
+   fill<ToFloat>( key_m, index, stream, pValues, count );
+}
+
+
+void RandomPhilox::get
+(
+   const udword key[2],
+   const udword counter[4],
+   udword       values[4]
+)
+{
+   philox( key, counter, values );
+}
+
+
+
+
+
+
+
+
+/// test -----------------------------------------------------------------------
+#ifdef TESTING
+
+
+#include <ostream>
+#include <vector>
+
+#include "RandomMwc2.hpp"
+#include "Stopwatch.hpp"
+
+
+namespace
+{
+
+void benchmark
+(
+   std::ostream& out
+)
+{
+   static const dword COUNT = 1 << 16;
+   static const dword TIMES = 256;
+
+   std::vector<udword> udwords( COUNT );
+   const RandomPhilox  philox;
+   const RandomMwc2    mwc2;
+
+   double times[4];
+   Stopwatch stopwatch;
+
+   stopwatch.start();
+   for( dword t = TIMES;  t-- > 0; )
+   {
+      for( dword i = 0;  i < COUNT;  ++i )
+      {
+         udwords[i] = philox.getUdword( static_cast<udword>(i), t );
+      }
+   }
+   times[0] = stopwatch.getSeconds();
+
+   stopwatch.start();
+   for( dword t = TIMES;  t-- > 0; )
+   {
+      philox.fillUdwords( 0, t, &udwords[0], COUNT );
+   }
+   times[1] = stopwatch.getSeconds();
+
+   stopwatch.start();
+   for( dword t = TIMES;  t-- > 0; )
+   {
+      for( dword i = 0;  i < COUNT;  ++i )
+      {
+         udwords[i] = mwc2.getUdword();
+      }
+   }
+   times[2] = stopwatch.getSeconds();
+
+   stopwatch.start();
+   for( dword t = TIMES;  t-- > 0; )
+   {
+      mwc2.fillUdwords( &udwords[0], COUNT );
+   }
+   times[3] = stopwatch.getSeconds();
+
+   const double values = static_cast<double>(COUNT) * TIMES * 1e-9;
+   out << "benchmark  (values per ns: one at a time, fill)\n";
+   out << "   RandomPhilox  " << (values / times[0]) << "  " <<
+      (values / times[1]) << "\n";
+   out << "   RandomMwc2    " << (values / times[2]) << "  " <<
+      (values / times[3]) << "\n";
+   out << "   (check " << udwords[7] << ")\n\n";
+}
+
+}
+
+
+namespace hxa7241_general
+{
+
+
+bool test_RandomPhilox
+(
+   std::ostream* pOut,
+   const bool    isVerbose,
+   const dword   seed
+)
+{
+   bool isOk = true;
+
+   if( pOut ) *pOut << "[ test_RandomPhilox ]\n\n";
+
+
+   // known answers (Random123 kat_vectors)
+   {
+      bool is = true;
+
+      static const udword KEYS[][2] = { { 0u, 0u },
+         { 0xFFFFFFFFu, 0xFFFFFFFFu }, { 0xA4093822u, 0x299F31D0u } };
+      static const udword COUNTERS[][4] = { { 0u, 0u, 0u, 0u },
+         { 0xFFFFFFFFu, 0xFFFFFFFFu, 0xFFFFFFFFu, 0xFFFFFFFFu },
+         { 0x243F6A88u, 0x85A308D3u, 0x13198A2Eu, 0x03707344u } };
+      static const udword VALUES[][4] = {
+         { 0x6627E8D5u, 0xE169C58Du, 0xBC57AC4Cu, 0x9B00DBD8u },
+         { 0x408F276Du, 0x41C83B0Eu, 0xA20BC7C6u, 0x6D5451FDu },
+         { 0xD16CFE09u, 0x94FDCCEBu, 0x5001E420u, 0x24126EA1u } };
+
+      for( dword i = 0;  i < 3;  ++i )
+      {
+         udword values[4];
+         RandomPhilox::get( KEYS[i], COUNTERS[i], values );
+
+         udword values2[4];
+         RandomPhilox( KEYS[i][0], KEYS[i][1] ).get( COUNTERS[i], values2 );
+
+         for( dword k = 0;  k < 4;  ++k )
+         {
+            is &= (VALUES[i][k] == values[k]) & (VALUES[i][k] == values2[k]);
+         }
+      }
+
+      if( pOut ) *pOut << "known answers : " <<
+         (is ? "--- succeeded" : "*** failed") << "\n\n";
+
+      isOk &= is;
+   }
+
+   // fill same as one at a time, in any order
+   {
+      bool is = true;
+
+      const RandomPhilox random( static_cast<udword>(seed), 1 );
+
+      // starts and counts off block boundaries, and wrapping
+      static const udword STARTS[] = { 0, 1, 3, 4, 1000, 0xFFFFFFF0u };
+      static const dword  COUNTS[] = { 0, 1, 2, 5, 31, 32, 33, 1003 };
+      for( dword s = 0;  s < 6;  ++s )
+      {
+         for( dword c = 0;  c < 8;  ++c )
+         {
+            const dword count = COUNTS[c];
+            std::vector<udword> udwords( count + 1 );
+            std::vector<float>  floats( count + 1 );
+            random.fillUdwords( STARTS[s], 7, &udwords[0], count );
+            random.fillFloats( STARTS[s], 7, &floats[0], count );
+
+            for( dword i = 0;  i < count;  ++i )
+            {
+               const udword index = STARTS[s] + i;
+               udword values[4];
+               const udword counter[] = { (index >> 2), 7, 0, 0 };
+               random.get( counter, values );
+
+               is &= (udwords[i] == random.getUdword( index, 7 )) &
+                  (udwords[i] == values[index & 3]) &
+                  (floats[i] == random.getFloat( index, 7 )) &
+                  (floats[i] == (static_cast<float>(udwords[i] >> 8) /
+                  16777216.0f));
+            }
+            is &= (0 == udwords[count]) & (0.0f == floats[count]);
+         }
+      }
+
+      // backward, in uneven pieces
+      std::vector<udword> forward( 1000 );
+      std::vector<udword> backward( 1000 );
+      random.fillUdwords( 5, 0, &forward[0], 1000 );
+      for( dword end = 1000;  end > 0; )
+      {
+         const dword start = (end > 7) ? end - 7 : 0;
+         random.fillUdwords( 5 + start, 0, &backward[start], end - start );
+         end = start;
+      }
+      is &= (forward == backward);
+
+      // streams and keys differ
+      is &= (random.getUdword( 0, 0 ) != random.getUdword( 0, 1 ));
+      is &= (random.getUdword( 0, 0 ) !=
+         RandomPhilox( static_cast<udword>(seed), 2 ).getUdword( 0, 0 ));
+
+      if( pOut ) *pOut << "fill : " <<
+         (is ? "--- succeeded" : "*** failed") << "\n\n";
+
+      isOk &= is;
+   }
+
+   // distribution: ranges, mean, bits
+   {
+      bool is = true;
+
+      static const dword COUNT = 1000000;
+
+      const RandomPhilox random( static_cast<udword>(seed) );
+      std::vector<float> floats( COUNT );
+      random.fillFloats( 0, 0, &floats[0], COUNT );
+
+      double sum = 0.0;
+      for( dword i = 0;  i < COUNT;  ++i )
+      {
+         is &= (floats[i] >= 0.0f) & (floats[i] < 1.0f);
+         sum += floats[i];
+      }
+      is &= ((sum / COUNT) > 0.4985) & ((sum / COUNT) < 0.5015);
+
+      // each bit set about half the time
+      std::vector<udword> udwords( COUNT );
+      random.fillUdwords( 0, 1, &udwords[0], COUNT );
+      for( dword b = 0;  b < 32;  ++b )
+      {
+         dword ones = 0;
+         for( dword i = 0;  i < COUNT;  ++i )
+         {
+            ones += (udwords[i] >> b) & 1;
+         }
+         is &= (ones > 497500) & (ones < 502500);
+      }
+
+      if( pOut ) *pOut << "distribution : " <<
+         (is ? "--- succeeded" : "*** failed") << "\n\n";
+
+      isOk &= is;
+   }
+
+   if( pOut && isVerbose ) benchmark( *pOut );
+
+
+   if( pOut ) *pOut << (isOk ? "--- successfully" : "*** failurefully") <<
+      " completed " << "\n\n\n";
+
+   if( pOut ) pOut->flush();
+
+
+   return isOk;
+}
+
+
+}//namespace
+
+
+#endif//TESTING
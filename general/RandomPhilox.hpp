@@ -0,0 +1,102 @@
+/*------------------------------------------------------------------------------
+
+   HXA7241 General library.
+   Copyright (c) 2004-2007,  Harrison Ainsworth / HXA7241.
+
+   http://www.hxa7241.org/
+
+------------------------------------------------------------------------------*/
+
+
+#ifndef RandomPhilox_h
+#define RandomPhilox_h
+
+
+
+
+#include "hxa7241_general.hpp"
+namespace hxa7241_general
+{
+
+
+/**
+ * Counter-based random number generator (Philox4x32-10).<br/><br/>
+ *
+ * No state: each value is a function of the key and its position only. So any
+ * pixel or sample can be evaluated by itself, in any order, on any thread,
+ * and get the same value -- no per-thread generators, no dependence on
+ * scheduling.<br/><br/>
+ *
+ * get is the raw function: 128 bits of counter to 128 bits of value. The other
+ * queries index a value in a stream: value index of stream is word (index & 3)
+ * of the counter (index >> 2, stream, 0, 0). So there are 2^32 streams of 2^32
+ * values (wrapping), and fillUdwords gives exactly what as many getUdword
+ * calls would.<br/><br/>
+ *
+ * fillUdwords and fillFloats compute 4 or 8 counters at once in SSE2 or AVX2
+ * registers when compiled for them, else scalar.<br/><br/>
+ *
+ * Constant.
+ *
+ * @implementation
+ * 'Parallel Random Numbers: As Easy as 1, 2, 3' - Salmon, Moraes, Dror, Shaw
+ * (SC11, 2011). Passes BigCrush.<br/><br/>
+ *
+ * <cite>http://www.deshawresearch.com/resources_random123.html</cite>
+ *
+ * Known answers (key; counter; values):
+ * 0 0; 0 0 0 0; 6627E8D5 E169C58D BC57AC4C 9B00DBD8
+ */
+class RandomPhilox
+{
+/// standard object services ---------------------------------------------------
+public:
+   explicit RandomPhilox( udword key0 = 0,
+                          udword key1 = 0 );
+
+// use defaults
+//         ~RandomPhilox();
+//          RandomPhilox( const RandomPhilox& );
+private:
+   RandomPhilox& operator=( const RandomPhilox& );
+public:
+
+
+/// queries --------------------------------------------------------------------
+           void   get( const udword counter[4],
+                       udword       values[4] )                           const;
+
+           udword getUdword( udword index,
+                             udword stream = 0 )                          const;
+           /** [0,1) from the top 24 bits. */
+           float  getFloat( udword index,
+                            udword stream = 0 )                           const;
+
+           /** values index to index + count - 1 of the stream. */
+           void   fillUdwords( udword  index,
+                               udword  stream,
+                               udword* pValues,
+                               dword   count )                            const;
+           /** values index to index + count - 1 of the stream. */
+           void   fillFloats( udword  index,
+                              udword  stream,
+                              float*  pValues,
+                              dword   count )                             const;
+
+   static  void   get( const udword key[2],
+                       const udword counter[4],
+                       udword       values[4] );
+
+
+/// fields ---------------------------------------------------------------------
+private:
+   udword key_m[2];
+};
+
+
+}//namespace
+
+
+
+
+#endif//RandomPhilox_h
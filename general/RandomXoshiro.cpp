@@ -0,0 +1,628 @@
+/*------------------------------------------------------------------------------
+
+   HXA7241 General library.
+   Copyright (c) 2004-2007,  Harrison Ainsworth / HXA7241.
+
+   http://www.hxa7241.org/
+
+------------------------------------------------------------------------------*/
+
+
+#include <cstring>
+
+#include "RandomXoshiro.hpp"
+
+
+using namespace hxa7241_general;
+
+
+
+
+namespace
+{
+
+/// 64-bit from 32-bit halves (C++98 has no 64-bit literals)
+inline
+uqword makeUqword
+(
+   const udword high,
+   const udword low
+)
+{
+   return (static_cast<uqword>(high) << 32) | static_cast<uqword>(low);
+}
+
+}
+
+
+
+
+/// standard object services ---------------------------------------------------
+RandomXoshiro::RandomXoshiro
+(
+   const udword seed
+)
+{
+   // splitmix64: distinct outputs, so never all zero
+   static const uqword GOLDEN = makeUqword( 0x9E3779B9u, 0x7F4A7C15u );
+   static const uqword MIX1   = makeUqword( 0xBF58476Du, 0x1CE4E5B9u );
+   static const uqword MIX2   = makeUqword( 0x94D049BBu, 0x133111EBu );
+
+   uqword z = static_cast<uqword>(seed);
+   for( dword i = 0;  i < 4;  ++i )
+   {
+      z += GOLDEN;
+
+      uqword r = z;
+      r = (r ^ (r >> 30)) * MIX1;
+      r = (r ^ (r >> 27)) * MIX2;
+      state_m[i] = r ^ (r >> 31);
+   }
+}
+
+
+
+
+/// queries --------------------------------------------------------------------
+uqword RandomXoshiro::getUqword() const
+{
+   const uqword result = state_m[0] + state_m[3];
+   const uqword t      = state_m[1] << 17;
+
+   state_m[2] ^= state_m[0];
+   state_m[3] ^= state_m[1];
+   state_m[1] ^= state_m[2];
+   state_m[0] ^= state_m[3];
+
+   state_m[2] ^= t;
+   state_m[3]  = (state_m[3] << 45) | (state_m[3] >> 19);
+
+   return result;
+}
+
+
+udword RandomXoshiro::getUdword() const
+{
+   return static_cast<udword>(getUqword() >> 32);
+}
+
+
+float RandomXoshiro::getFloat() const
+{
+   // top 23 bits as mantissa of [1,2)
+   const udword bits = 0x3F800000u | static_cast<udword>(getUqword() >> 41);
+
+   float f;
+   std::memcpy( &f, &bits, sizeof(f) );
+
+   return f - 1.0f;
+}
+
+
+double RandomXoshiro::getDouble() const
+{
+   // top 52 bits as mantissa of [1,2)
+   const uqword bits = makeUqword( 0x3FF00000u, 0 ) | (getUqword() >> 12);
+
+   double d;
+   std::memcpy( &d, &bits, sizeof(d) );
+
+   return d - 1.0;
+}
+
+
+
+
+
+
+
+
+/// test -----------------------------------------------------------------------
+#ifdef TESTING
+
+
+#include <ostream>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+#include "RandomMwc1.hpp"
+#include "RandomMwc2.hpp"
+#include "Stopwatch.hpp"
+
+
+namespace
+{
+
+/// statistics -----------------------------------------------------------------
+
+/// log of gamma function (Lanczos, as Numerical Recipes gammln)
+double logGamma( const double x )
+{
+   static const double C[] = { 76.18009172947146, -86.50532032941677,
+      24.01409824083091, -1.231739572450155, 0.1208650973866179e-2,
+      -0.5395239384953e-5 };
+
+   double y = x;
+   double t = x + 5.5;
+   t -= (x + 0.5) * std::log( t );
+
+   double s = 1.000000000190015;
+   for( dword j = 0;  j < 6;  ++j )
+   {
+      s += C[j] / ++y;
+   }
+
+   return -t + std::log( 2.5066282746310005 * s / x );
+}
+
+
+/// regularized incomplete gamma: lower P(a, x), or upper Q(a, x)
+double incompleteGamma( const double a, const double x, const bool isUpper )
+{
+   if( x <= 0.0 )
+   {
+      return isUpper ? 1.0 : 0.0;
+   }
+
+   const double front = std::exp( (a * std::log( x )) - x - logGamma( a ) );
+
+   // series for P
+   if( x < (a + 1.0) )
+   {
+      double ap  = a;
+      double del = 1.0 / a;
+      double sum = del;
+      for( dword n = 0;  (n < 1000) &&
+         (std::fabs( del ) > (std::fabs( sum ) * 1e-15));  ++n )
+      {
+         ap  += 1.0;
+         del *= x / ap;
+         sum += del;
+      }
+
+      const double p = sum * front;
+      return isUpper ? 1.0 - p : p;
+   }
+   // continued fraction for Q (modified Lentz)
+   else
+   {
+      static const double TINY = 1e-300;
+
+      double b = x + 1.0 - a;
+      double c = 1.0 / TINY;
+      double d = 1.0 / b;
+      double h = d;
+      for( dword i = 1;  i < 1000;  ++i )
+      {
+         const double an = -i * (i - a);
+         b += 2.0;
+         d  = (an * d) + b;
+         d  = (std::fabs( d ) < TINY) ? TINY : d;
+         c  = b + (an / c);
+         c  = (std::fabs( c ) < TINY) ? TINY : c;
+         d  = 1.0 / d;
+
+         const double del = d * c;
+         h *= del;
+         if( std::fabs( del - 1.0 ) < 1e-15 )
+         {
+            break;
+         }
+      }
+
+      const double q = front * h;
+      return isUpper ? q : 1.0 - q;
+   }
+}
+
+
+/// p-value of at least count, for poisson distribution of mean
+double getPoissonP( const dword count, const double mean )
+{
+   return (count > 0) ? incompleteGamma( count, mean, false ) : 1.0;
+}
+
+
+/// p-value of chi-square, from counts and expected counts
+double getChiSquareP
+(
+   const dword*  pCounts,
+   const double* pExpected,
+   const dword   length
+)
+{
+   double chi = 0.0;
+   for( dword i = 0;  i < length;  ++i )
+   {
+      const double difference = pCounts[i] - pExpected[i];
+      chi += (difference * difference) / pExpected[i];
+   }
+
+   return incompleteGamma( (length - 1) * 0.5, chi * 0.5, true );
+}
+
+
+/// statistical smoke tests ----------------------------------------------------
+/// (after TestU01 SmallCrush, smaller)
+
+/// repeated spacings between sorted birthdays, in a 2^32 day year
+template<class RANDOM>
+double testBirthdaySpacings( const RANDOM& random )
+{
+   static const dword REPEATS   = 100;
+   static const dword BIRTHDAYS = 4096;
+
+   std::vector<udword> days( BIRTHDAYS );
+   std::vector<udword> spacings( BIRTHDAYS );
+
+   dword repeats = 0;
+   for( dword r = REPEATS;  r-- > 0; )
+   {
+      for( dword i = 0;  i < BIRTHDAYS;  ++i )
+      {
+         days[i] = random.getUdword();
+      }
+      std::sort( days.begin(), days.end() );
+
+      spacings[0] = days[0];
+      for( dword i = 1;  i < BIRTHDAYS;  ++i )
+      {
+         spacings[i] = days[i] - days[i - 1];
+      }
+      std::sort( spacings.begin(), spacings.end() );
+
+      for( dword i = 1;  i < BIRTHDAYS;  ++i )
+      {
+         repeats += (spacings[i] == spacings[i - 1]);
+      }
+   }
+
+   // poisson, mean n^3 / 4k per repeat
+   const double n = BIRTHDAYS;
+   return getPoissonP( repeats, REPEATS * (n * n * n) / (4.0 * 4294967296.0) );
+}
+
+
+/// collisions of pairs of 10 bit values, in 2^20 urns
+template<class RANDOM>
+double testCollision( const RANDOM& random )
+{
+   static const dword REPEATS = 10;
+   static const dword BALLS   = 1 << 14;
+   static const dword URNS    = 1 << 20;
+
+   std::vector<bool> urns;
+
+   dword collisions = 0;
+   for( dword r = REPEATS;  r-- > 0; )
+   {
+      urns.assign( URNS, false );
+      for( dword b = BALLS;  b-- > 0; )
+      {
+         const udword high = random.getUdword() >> 22;
+         const udword low  = random.getUdword() >> 22;
+         const udword urn  = (high << 10) | low;
+
+         collisions += urns[urn];
+         urns[urn]   = true;
+      }
+   }
+
+   // poisson (approximately), mean n - k + k(1 - 1/k)^n per repeat
+   const double k = URNS;
+   return getPoissonP( collisions, REPEATS * (BALLS - k + (k * std::pow(
+      1.0 - (1.0 / k), static_cast<double>(BALLS) ))) );
+}
+
+
+/// lengths of gaps between values in [0, 1/8)
+template<class RANDOM>
+double testGap( const RANDOM& random )
+{
+   static const dword GAPS = 100000;
+   static const dword LONG = 40;
+
+   dword counts[ LONG + 1 ];
+   std::fill( counts, counts + LONG + 1, 0 );
+
+   for( dword g = 0, length = 0;  g < GAPS; )
+   {
+      if( random.getUdword() < (1u << 29) )
+      {
+         ++counts[ (length < LONG) ? length : LONG ];
+         length = 0;
+         ++g;
+      }
+      else
+      {
+         ++length;
+      }
+   }
+
+   // geometric
+   double expected[ LONG + 1 ];
+   double miss = 1.0;
+   for( dword i = 0;  i < LONG;  ++i )
+   {
+      expected[i] = GAPS * 0.125 * miss;
+      miss       *= 0.875;
+   }
+   expected[LONG] = GAPS * miss;
+
+   return getChiSquareP( counts, expected, LONG + 1 );
+}
+
+
+/// distinct values in hands of five 4 bit values
+template<class RANDOM>
+double testPoker( const RANDOM& random )
+{
+   static const dword HANDS = 200000;
+
+   // 1 or 2, 3, 4, 5 different
+   dword counts[ 4 ] = { 0, 0, 0, 0 };
+   for( dword h = HANDS;  h-- > 0; )
+   {
+      udword seen = 0;
+      for( dword c = 5;  c-- > 0; )
+      {
+         seen |= 1u << (random.getUdword() >> 28);
+      }
+
+      dword different = 0;
+      for( ;  seen;  seen &= seen - 1 )
+      {
+         ++different;
+      }
+      ++counts[ (different > 2) ? different - 2 : 0 ];
+   }
+
+   // stirling numbers * 16! / (16 - r)!, of 16^5
+   const double expected[] = { HANDS * (16.0 + 3600.0) / 1048576.0,
+      HANDS * 84000.0 / 1048576.0, HANDS * 436800.0 / 1048576.0,
+      HANDS * 524160.0 / 1048576.0 };
+
+   return getChiSquareP( counts, expected, 4 );
+}
+
+
+/// maximums of 8 values, made uniform
+template<class RANDOM>
+double testMaxOfT( const RANDOM& random )
+{
+   static const dword GROUPS = 200000;
+   static const dword CELLS  = 64;
+
+   dword counts[ CELLS ];
+   std::fill( counts, counts + CELLS, 0 );
+
+   for( dword g = GROUPS;  g-- > 0; )
+   {
+      udword maximum = 0;
+      for( dword t = 8;  t-- > 0; )
+      {
+         maximum = std::max( maximum, random.getUdword() );
+      }
+
+      const double u    = (maximum + 0.5) / 4294967296.0;
+      const double u2   = u * u;
+      const double u4   = u2 * u2;
+      const dword  cell = static_cast<dword>(u4 * u4 * CELLS);
+      ++counts[ (cell < static_cast<dword>(CELLS)) ? cell : CELLS - 1 ];
+   }
+
+   double expected[ CELLS ];
+   std::fill( expected, expected + CELLS,
+      static_cast<double>(GROUPS) / CELLS );
+
+   return getChiSquareP( counts, expected, CELLS );
+}
+
+
+/// prints p-values, * if suspect -- returns false if clearly failed
+template<class RANDOM>
+bool testStatistics
+(
+   const RANDOM& random,
+   const char*   pName,
+   std::ostream& out
+)
+{
+   static const char* NAMES[] = { "birthday", "collision", "gap", "poker",
+      "maxOfT" };
+
+   const double p[] = { testBirthdaySpacings( random ),
+      testCollision( random ), testGap( random ), testPoker( random ),
+      testMaxOfT( random ) };
+
+   bool is = true;
+   out << "   " << pName << "\n     ";
+   for( dword i = 0;  i < 5;  ++i )
+   {
+      const bool isSuspect = (p[i] < 0.001) | (p[i] > 0.999);
+      is &= (p[i] >= 1e-10) & (p[i] <= (1.0 - 1e-10));
+
+      out << " " << NAMES[i] << " " << p[i] << (isSuspect ? "*" : "");
+   }
+   out << "\n";
+
+   return is;
+}
+
+
+/// benchmark ------------------------------------------------------------------
+
+template<class RANDOM, class VALUE>
+double getValuesPerNs
+(
+   const RANDOM& random,
+   VALUE (RANDOM::*get)() const,
+   VALUE&        sink
+)
+{
+   static const dword COUNT = 1 << 24;
+
+   Stopwatch stopwatch;
+   stopwatch.start();
+
+   VALUE sum = VALUE();
+   for( dword i = COUNT;  i-- > 0; )
+   {
+      sum += (random.*get)();
+   }
+
+   const double seconds = stopwatch.getSeconds();
+   sink += sum;
+
+   return (COUNT * 1e-9) / seconds;
+}
+
+
+void benchmark
+(
+   std::ostream& out
+)
+{
+   const RandomMwc2    mwc2;
+   const RandomXoshiro xoshiro;
+
+   udword udwords = 0;
+   uqword uqwords = 0;
+   float  floats  = 0.0f;
+   double doubles = 0.0;
+
+   out << "benchmark  (values per ns)\n";
+   out << "   RandomMwc2     udword " <<
+      getValuesPerNs( mwc2, &RandomMwc2::getUdword, udwords ) << "  float " <<
+      getValuesPerNs( mwc2, &RandomMwc2::getFloat, floats ) << "\n";
+   out << "   RandomXoshiro  udword " <<
+      getValuesPerNs( xoshiro, &RandomXoshiro::getUdword, udwords ) <<
+      "  float " <<
+      getValuesPerNs( xoshiro, &RandomXoshiro::getFloat, floats ) <<
+      "  uqword " <<
+      getValuesPerNs( xoshiro, &RandomXoshiro::getUqword, uqwords ) <<
+      "  double " <<
+      getValuesPerNs( xoshiro, &RandomXoshiro::getDouble, doubles ) << "\n";
+   out << "   (check " << udwords << " " << static_cast<udword>(uqwords) <<
+      " " << floats << " " << doubles << ")\n\n";
+}
+
+}
+
+
+namespace hxa7241_general
+{
+
+
+bool test_RandomXoshiro
+(
+   std::ostream* pOut,
+   const bool    isVerbose,
+   const dword   seed
+)
+{
+   bool isOk = true;
+
+   if( pOut ) *pOut << "[ test_RandomXoshiro ]\n\n";
+
+
+   // documented values
+   {
+      bool is = true;
+
+      static const udword VALUES[][2] = { { 0xDAAC60E1u, 0xED6A4F9Bu },
+         { 0x3156A1DAu, 0x0DC08435u }, { 0xF9BA3E32u, 0x85D046ABu },
+         { 0x4FD19461u, 0x1DBA7B01u } };
+
+      const RandomXoshiro random;
+      for( dword i = 0;  i < 4;  ++i )
+      {
+         is &= (makeUqword( VALUES[i][0], VALUES[i][1] ) ==
+            random.getUqword());
+      }
+      for( dword i = 4;  i < 999999;  ++i )
+      {
+         random.getUqword();
+      }
+      is &= (makeUqword( 0xA7A07F20u, 0x34543FF8u ) == random.getUqword());
+
+      // other types from the top bits
+      const RandomXoshiro other( 0 );
+      is &= (0xDAAC60E1u == other.getUdword());
+      is &= (other.getFloat() == (static_cast<float>(0x3156A1DAu >> 9) /
+         8388608.0f));
+      is &= (other.getDouble() == (static_cast<double>(makeUqword(
+         0xF9BA3E32u, 0x85D046ABu ) >> 12) / 4503599627370496.0));
+
+      if( pOut ) *pOut << "values : " <<
+         (is ? "--- succeeded" : "*** failed") << "\n\n";
+
+      isOk &= is;
+   }
+
+   // ranges
+   {
+      bool is = true;
+
+      const RandomXoshiro random( static_cast<udword>(seed) );
+      float  minF = 1.0f;
+      float  maxF = 0.0f;
+      double minD = 1.0;
+      double maxD = 0.0;
+      double sum  = 0.0;
+      for( dword i = 0;  i < 1000000;  ++i )
+      {
+         const float  f = random.getFloat();
+         const double d = random.getDouble();
+         minF = (f < minF) ? f : minF;
+         maxF = (f > maxF) ? f : maxF;
+         minD = (d < minD) ? d : minD;
+         maxD = (d > maxD) ? d : maxD;
+         sum += d;
+      }
+
+      is &= (minF >= 0.0f) & (maxF < 1.0f) & (minD >= 0.0) & (maxD < 1.0);
+      is &= (minF < 1e-4f) & (maxF > 0.9999f) & (minD < 1e-4) &
+         (maxD > 0.9999) & (std::fabs( (sum / 1000000.0) - 0.5 ) < 0.002);
+
+      if( pOut ) *pOut << "ranges : " <<
+         (is ? "--- succeeded" : "*** failed") << "\n\n";
+
+      isOk &= is;
+   }
+
+   if( pOut && isVerbose )
+   {
+      benchmark( *pOut );
+
+      // optional, since long-ish
+      bool is = true;
+
+      *pOut << "statistical smoke tests  (p-values, * suspect)\n";
+      is &= testStatistics( RandomMwc1( seed ), "RandomMwc1", *pOut );
+      is &= testStatistics( RandomMwc2( seed ), "RandomMwc2", *pOut );
+      is &= testStatistics( RandomXoshiro( seed ), "RandomXoshiro", *pOut );
+      *pOut << "\n";
+
+      *pOut << "statistical : " <<
+         (is ? "--- succeeded" : "*** failed") << "\n\n";
+
+      isOk &= is;
+   }
+
+
+   if( pOut ) *pOut << (isOk ? "--- successfully" : "*** failurefully") <<
+      " completed " << "\n\n\n";
+
+   if( pOut ) pOut->flush();
+
+
+   return isOk;
+}
+
+
+}//namespace
+
+
+#endif//TESTING
@@ -0,0 +1,84 @@
+/*------------------------------------------------------------------------------
+
+   HXA7241 General library.
+   Copyright (c) 2004-2007,  Harrison Ainsworth / HXA7241.
+
+   http://www.hxa7241.org/
+
+------------------------------------------------------------------------------*/
+
+
+#ifndef RandomXoshiro_h
+#define RandomXoshiro_h
+
+
+
+
+#include "hxa7241_general.hpp"
+namespace hxa7241_general
+{
+
+
+/**
+ * Fast, good, 64-bit random number generator (xoshiro256+).<br/><br/>
+ *
+ * A 64-bit alternative to RandomMwc2: twice the bits per call, 52 bit
+ * doubles, and a period of 2^256 - 1.<br/><br/>
+ *
+ * getFloat and getDouble put the top bits into the mantissa of a number in
+ * [1,2) and subtract 1 -- no divide, no branch. So they give [0,1), in steps
+ * of 2^-23 and 2^-52.<br/><br/>
+ *
+ * Constant (sort-of: internally/non-semantically modifying).
+ *
+ * @implementation
+ * xoshiro256+ (Blackman and Vigna, 2018), seeded by splitmix64 from the seed.
+ * The lowest bits of its sum are weaker, so only the top bits are used for
+ * udwords, floats and doubles.<br/><br/>
+ *
+ * <cite>http://prng.di.unimi.it/</cite>
+ *
+ * The first 4 and the 1000000th values (getUqword) are:
+ * DAAC60E1 ED6A4F9B
+ * 3156A1DA 0DC08435
+ * F9BA3E32 85D046AB
+ * 4FD19461 1DBA7B01
+ *
+ * A7A07F20 34543FF8
+ */
+class RandomXoshiro
+{
+/// standard object services ---------------------------------------------------
+public:
+   explicit RandomXoshiro( udword seed = 0 );
+
+// use defaults
+//         ~RandomXoshiro();
+//          RandomXoshiro( const RandomXoshiro& );
+private:
+   RandomXoshiro& operator=( const RandomXoshiro& );
+public:
+
+
+/// commands -------------------------------------------------------------------
+
+
+/// queries --------------------------------------------------------------------
+           uqword getUqword()                                             const;
+           udword getUdword()                                             const;
+           float  getFloat()                                              const;
+           double getDouble()                                             const;
+
+
+/// fields ---------------------------------------------------------------------
+private:
+   mutable uqword state_m[4];
+};
+
+
+}//namespace
+
+
+
+
+#endif//RandomXoshiro_h
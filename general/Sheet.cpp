@@ -23,22 +23,98 @@
 
 #include <iostream>
 
+#include "Stopwatch.hpp"
 
+
+/// copy-on-write counts -------------------------------------------------------
 namespace hxa7241_general
 {
 
+static dword shareCount     = 0;
+static dword shareCopyCount = 0;
 
-bool test_Sheet
+
+dword getSheetShareCount()
+{
+   return shareCount;
+}
+
+
+dword getSheetShareCopyCount()
+{
+   return shareCopyCount;
+}
+
+
+dword getSheetCopiesAvoided()
+{
+   return shareCount - shareCopyCount;
+}
+
+
+void resetSheetShareCounts()
+{
+   shareCount     = 0;
+   shareCopyCount = 0;
+}
+
+
+void countSheetShare_
+(
+   const bool isCopied
+)
+{
+   if( isCopied )
+   {
+      ++shareCopyCount;
+   }
+   else
+   {
+      ++shareCount;
+   }
+}
+
+
+}//namespace
+
+
+
+
+namespace
+{
+using namespace hxa7241_general;
+
+
+/// an element size that is not a power of two
+struct Rgb16
+{
+   word c[3];
+};
+
+
+/**
+ * Storage for adopting, from the policy the container will free it with.
+ */
+template<class STORAGE>
+word* newWords
+(
+   const dword length
+)
+{
+   return STORAGE().template allocate<word>( length );
+}
+
+
+template<template<class, class> class SHEET, class STORAGE>
+bool testSheet
 (
    std::ostream* pOut,
    const bool    isVerbose,
-   const dword   //seed
+   const char*   name
 )
 {
    bool isOk = true;
 
-   if( pOut ) *pOut << "[ test_Sheet ]\n\n";
-
 
    // this is a *long* method, but do not panic! -- it is very simple:
    // (almost) every 'test-expression' is isolated and atomic.
@@ -52,7 +128,7 @@ bool test_Sheet
       {
          // default
          {
-            const Sheet<word> aw;
+            const SHEET<word, STORAGE> aw;
 
             bool ok = (0 == aw.getStorage()) & (0 == aw.getLength()) &
                (0 == aw.getWidth()) & (0 == aw.getHeight()) &
@@ -69,7 +145,7 @@ bool test_Sheet
             const dword awsw = 3;
             const dword awsh = 2;
             const dword awl  = 6;
-            const Sheet<word> aw( awsw, awsh );
+            const SHEET<word, STORAGE> aw( awsw, awsh );
 
             bool ok = (0 != aw.getStorage()) & (awl == aw.getLength()) &
                (awsw == aw.getWidth()) & (awsh == aw.getHeight()) &
@@ -84,7 +160,7 @@ bool test_Sheet
             bool ok;
             try
             {
-               const Sheet<word> aw( -3, 2 );
+               const SHEET<word, STORAGE> aw( -3, 2 );
                ok = false;
             }
             catch( ... )
@@ -99,7 +175,7 @@ bool test_Sheet
             bool ok;
             try
             {
-               const Sheet<word> aw( 0x00100000, 0x00100000 );
+               const SHEET<word, STORAGE> aw( 0x00100000, 0x00100000 );
                ok = false;
             }
             catch( ... )
@@ -117,7 +193,7 @@ bool test_Sheet
          const dword awash = 2;
          const dword awal  = 6;
          {
-            const Sheet<word> aw( awa, awasw, awash, false );
+            const SHEET<word, STORAGE> aw( awa, awasw, awash, false );
 
             bool ok = (awa == aw.getStorage()) & (awal == aw.getLength()) &
                (awasw == aw.getWidth()) & (awash == aw.getHeight()) &
@@ -129,8 +205,8 @@ bool test_Sheet
                "\n";
          }
          {
-            word* pawa = new word[ awal ];
-            const Sheet<word> aw( pawa, awasw, awash, true );
+            word* pawa = newWords<STORAGE>( awal );
+            const SHEET<word, STORAGE> aw( pawa, awasw, awash, true );
 
             bool ok = (pawa == aw.getStorage()) & (awal == aw.getLength()) &
                (awasw == aw.getWidth()) & (awash == aw.getHeight()) &
@@ -142,7 +218,7 @@ bool test_Sheet
                "\n";
          }
          {
-            const Sheet<word> aw( 0, 3, 2, false );
+            const SHEET<word, STORAGE> aw( 0, 3, 2, false );
 
             bool ok = (0 == aw.getStorage()) & ((3 * 2) == aw.getLength()) &
                (3 == aw.getWidth()) & (2 == aw.getHeight()) &
@@ -154,7 +230,7 @@ bool test_Sheet
                "\n";
          }
          {
-            const Sheet<word> aw( 0, 3, 2, true );
+            const SHEET<word, STORAGE> aw( 0, 3, 2, true );
 
             bool ok = (0 == aw.getStorage()) & ((3 * 2) == aw.getLength()) &
                (3 == aw.getWidth()) & (2 == aw.getHeight()) &
@@ -169,7 +245,7 @@ bool test_Sheet
             bool ok;
             try
             {
-               const Sheet<word> aw( awa, -3, 2, false );
+               const SHEET<word, STORAGE> aw( awa, -3, 2, false );
                ok = false;
             }
             catch( ... )
@@ -184,7 +260,8 @@ bool test_Sheet
             bool ok;
             try
             {
-               const Sheet<word> aw( awa, 0x00010000, 0x01000000, false );
+               const SHEET<word, STORAGE> aw( awa, 0x00010000, 0x01000000,
+                  false );
                ok = false;
             }
             catch( ... )
@@ -199,8 +276,8 @@ bool test_Sheet
             bool ok;
             try
             {
-               word* pawa = new word[ awal ];
-               const Sheet<word> aw( pawa, -3, 2, true );
+               word* pawa = newWords<STORAGE>( awal );
+               const SHEET<word, STORAGE> aw( pawa, -3, 2, true );
                ok = false;
             }
             catch( ... )
@@ -214,8 +291,8 @@ bool test_Sheet
 
          // copy
          {
-            const Sheet<word> aww( awa, awasw, awash, false );
-            const Sheet<word> aw( aww );
+            const SHEET<word, STORAGE> aww( awa, awasw, awash, false );
+            const SHEET<word, STORAGE> aw( aww );
 
             bool ok = (aww.getStorage() != aw.getStorage()) &
                (aww.getWidth() == aw.getWidth()) &
@@ -233,9 +310,9 @@ bool test_Sheet
                "\n";
          }
          {
-            word* pawa = new word[ awal ];
-            const Sheet<word> awo( pawa, awasw, awash, true );
-            const Sheet<word> aw( awo );
+            word* pawa = newWords<STORAGE>( awal );
+            const SHEET<word, STORAGE> awo( pawa, awasw, awash, true );
+            const SHEET<word, STORAGE> aw( awo );
 
             bool ok = (awo.getStorage() != aw.getStorage()) &
                (awo.getWidth() == aw.getWidth()) &
@@ -256,9 +333,9 @@ bool test_Sheet
             const dword awasw = 3;
             const dword awash = 2;
             //const dword awal  = 6;
-            const Sheet<word> aww( awa, awasw, awash, false );
+            const SHEET<word, STORAGE> aww( awa, awasw, awash, false );
 
-            Sheet<word> aw( 4, 5 );
+            SHEET<word, STORAGE> aw( 4, 5 );
             aw = aww;
 
             bool ok = (aww.getStorage() != aw.getStorage()) &
@@ -285,8 +362,8 @@ bool test_Sheet
 //          bool ok;
 //          try
 //          {
-//             const Sheet<word> aww( 0, 3, 2, false );
-//             Sheet<word> aw( 4, 5 );
+//             const SHEET<word, STORAGE> aww( 0, 3, 2, false );
+//             SHEET<word, STORAGE> aw( 4, 5 );
 //             aw = aww;
 //             ok = false;
 //          }
@@ -302,7 +379,7 @@ bool test_Sheet
 
       if( pOut && isVerbose ) *pOut << "\n";
 
-      if( pOut ) *pOut << "basics : " <<
+      if( pOut ) *pOut << name << " basics : " <<
          (is ? "--- succeeded" : "*** failed") << "\n\n";
 
       isOk &= is;
@@ -319,12 +396,12 @@ bool test_Sheet
          const dword waw = 3;
          const dword wah = 2;
          const dword wal = 6;
-         Sheet<word> aww( wa, waw, wah, false );
+         SHEET<word, STORAGE> aww( wa, waw, wah, false );
 
-         word* pwa = new word[ wal ];
-         Sheet<word> awo( pwa, waw, wah, true );
+         word* pwa = newWords<STORAGE>( wal );
+         SHEET<word, STORAGE> awo( pwa, waw, wah, true );
 
-         Sheet<word> awm( waw, wah );
+         SHEET<word, STORAGE> awm( waw, wah );
 
          for( dword i = wal;  i-- > 0; )
          {
@@ -332,12 +409,12 @@ bool test_Sheet
             awm[i] = wa[i];
          }
 
-         Sheet<word>* aws[] = { &aww, &awo, &awm };
+         SHEET<word, STORAGE>* aws[] = { &aww, &awo, &awm };
 
          // using made, adopted, reffed
          for( dword a = 0;  a < 3;  ++a )
          {
-            Sheet<word>& ar = *(aws[a]);
+            SHEET<word, STORAGE>& ar = *(aws[a]);
 
             bool ok = true;
 
@@ -374,7 +451,7 @@ bool test_Sheet
                   const dword paw = 2;
                   const dword pah = 3;
                   const dword pal = 6;
-                  word* pa = new word[ pal ];
+                  word* pa = newWords<STORAGE>( pal );
                   ar.setStorage( pa, paw, pah, true );
                   ok &= (pa == ar.getStorage()) & (pal == ar.getLength()) &
                      (2 == ar.getWidth()) & (3 == ar.getHeight()) &
@@ -468,7 +545,7 @@ bool test_Sheet
 
       if( pOut && isVerbose ) *pOut << "\n";
 
-      if( pOut ) *pOut << "commands : " <<
+      if( pOut ) *pOut << name << " commands : " <<
          (is ? "--- succeeded" : "*** failed") << "\n\n";
 
       isOk &= is;
@@ -483,12 +560,12 @@ bool test_Sheet
       const dword waw = 3;
       const dword wah = 2;
       const dword wal = 6;
-      Sheet<word> aww( wa, waw, wah, false );
+      SHEET<word, STORAGE> aww( wa, waw, wah, false );
 
-      word* pwa = new word[ wal ];
-      Sheet<word> awo( pwa, waw, wah, true );
+      word* pwa = newWords<STORAGE>( wal );
+      SHEET<word, STORAGE> awo( pwa, waw, wah, true );
 
-      Sheet<word> awm( waw, wah );
+      SHEET<word, STORAGE> awm( waw, wah );
 
       for( dword i = wal;  i-- > 0; )
       {
@@ -496,12 +573,12 @@ bool test_Sheet
          awm[i] = wa[i];
       }
 
-      Sheet<word>* aws[] = { &aww, &awo, &awm };
+      SHEET<word, STORAGE>* aws[] = { &aww, &awo, &awm };
 
       // using made, adopted, reffed
       for( dword a = 0;  a < 3;  ++a )
       {
-         Sheet<word>& ar = *(aws[a]);
+         SHEET<word, STORAGE>& ar = *(aws[a]);
 
          // getLength
          is &= (wal == ar.getLength());
@@ -559,23 +636,328 @@ bool test_Sheet
             "\n";
       }
 
-      is &= !Sheet<word>::isSizeWithinRange( -10, 20 ) &
-         !Sheet<word>::isSizeWithinRange( 10, -20 ) &
-         !Sheet<word>::isSizeWithinRange( 0x00100000, 0x00000800 );
+      is &= !SHEET<word, STORAGE>::isSizeWithinRange( -10, 20 ) &
+         !SHEET<word, STORAGE>::isSizeWithinRange( 10, -20 ) &
+         !SHEET<word, STORAGE>::isSizeWithinRange( 0x00100000, 0x00000800 );
 
       // getMaxSize
-      is &= (DWORD_MAX == Sheet<word>::getMaxSize());
+      is &= (DWORD_MAX == SHEET<word, STORAGE>::getMaxSize());
       if( pOut && isVerbose ) *pOut << "getMaxSize " << is << "\n";
 
       if( pOut && isVerbose ) *pOut << "\n";
 
-      if( pOut ) *pOut << "queries : " <<
+      if( pOut ) *pOut << name << " queries : " <<
          (is ? "--- succeeded" : "*** failed") << "\n\n";
 
       isOk &= is;
    }
 
 
+   return isOk;
+}
+
+
+template<class SHEET>
+udword sumPixels
+(
+   const SHEET& s,
+   const dword  passes,
+   const bool   isWrapped
+)
+{
+   udword sum = 0;
+
+   const dword width  = s.getWidth();
+   const dword height = s.getHeight();
+   for( dword p = passes;  p-- > 0; )
+   {
+      for( dword y = 0;  y < height;  ++y )
+      {
+         if( !isWrapped )
+         {
+            for( dword x = 0;  x < width;  ++x )
+            {
+               sum += s.get( x, y );
+            }
+         }
+         else
+         {
+            for( dword x = 0;  x < width;  ++x )
+            {
+               sum += s.getElement( x, y );
+            }
+         }
+      }
+   }
+
+   return sum;
+}
+
+
+/**
+ * Time per-pixel access through Sheet (virtual) and SheetFlat.
+ */
+void benchmarkSheet
+(
+   std::ostream& out
+)
+{
+   static const dword WIDTH  = 256;
+   static const dword HEIGHT = 256;
+   static const dword PASSES = 1000;
+
+   Sheet<udword> sv( WIDTH, HEIGHT );
+   for( dword i = sv.getLength();  i-- > 0; )
+   {
+      sv[i] = static_cast<udword>(i & 0xFF);
+   }
+   const SheetFlat<udword>& sf = sv.getFlat();
+
+   // hide the dynamic type, so virtual calls are not resolved statically
+   const Sheet<udword>* volatile pV = &sv;
+
+   static const char* NAMES[] = { "get", "getElement" };
+   for( dword w = 0;  w < 2;  ++w )
+   {
+      udword sums[2];
+      double times[2];
+
+      Stopwatch stopwatch;
+      sums[0]  = sumPixels( *pV, PASSES, (0 != w) );
+      times[0] = stopwatch.getSeconds();
+
+      stopwatch.start();
+      sums[1]  = sumPixels( sf, PASSES, (0 != w) );
+      times[1] = stopwatch.getSeconds();
+
+      const double scale = 1e9 / (static_cast<double>(WIDTH * HEIGHT) *
+         static_cast<double>(PASSES));
+      out << "benchmark " << NAMES[w] << "  Sheet " << (times[0] * scale) <<
+         " ns  SheetFlat " << (times[1] * scale) << " ns  speedup " <<
+         (times[0] / (times[1] > 0.0 ? times[1] : 1e-9)) << "  (" <<
+         (sums[0] == sums[1]) << ")\n";
+   }
+   out << "\n";
+}
+
+}
+
+
+namespace hxa7241_general
+{
+
+
+bool test_Sheet
+(
+   std::ostream* pOut,
+   const bool    isVerbose,
+   const dword   //seed
+)
+{
+   bool isOk = true;
+
+   if( pOut ) *pOut << "[ test_Sheet ]\n\n";
+
+
+   isOk &= testSheet<Sheet, StorageNew>( pOut, isVerbose, "Sheet" );
+   isOk &= testSheet<SheetFlat, StorageNew>( pOut, isVerbose, "SheetFlat" );
+   isOk &= testSheet<SheetFlat, StorageAligned<32> >( pOut, isVerbose,
+      "SheetFlat aligned" );
+
+   // row padding
+   {
+      bool is = true;
+
+      Sheet<float, StorageAligned<32> > s( 13, 5, 32 );
+      is &= (13 == s.getWidth()) & (5 == s.getHeight()) &
+         (16 == s.getStride()) & (80 == s.getLength());
+      for( dword y = 0;  y < 5;  ++y )
+      {
+         is &= isAligned( s.getRow( y ), 32 );
+         for( dword x = 0;  x < 13;  ++x )
+         {
+            s.get( x, y ) = static_cast<float>(x + (y * 100));
+            is &= (&s.get( x, y ) == s.getRow( y ) + x);
+         }
+      }
+      is &= (204.0f == s.getElement( 4, 2 ));
+      is &= (412.0f == s.getWrapped<WrapRepeat>( -1, -1 ));
+      is &= (s.getRow( 4 ) == s.getRow( -4 ));
+
+      // copy keeps padding
+      const Sheet<float, StorageAligned<32> > c( s );
+      is &= (16 == c.getStride()) & (312.0f == c.get( 12, 3 ));
+
+      // unpadded
+      s.setSize( 13, 5 );
+      is &= (13 == s.getStride()) & (65 == s.getLength());
+      s.setSize( 13, 5, 1 );
+      is &= (13 == s.getStride());
+
+      // non-power-of-two element size
+      is &= (16 == SheetFlat<Rgb16>::getAlignedStride( 13, 32 ));
+      is &= (12 == SheetFlat<Rgb16>::getAlignedStride( 12, 8 ));
+      is &= (3  == SheetFlat<float>::getAlignedStride( 3, 0 ));
+
+      // out of range by padding
+      {
+         bool isThrown = false;
+         try
+         {
+            Sheet<float> t( DWORD_MAX, 1, 64 );
+         }
+         catch( const char* )
+         {
+            isThrown = true;
+         }
+         is &= isThrown;
+      }
+
+      if( pOut ) *pOut << "row padding : " <<
+         (is ? "--- succeeded" : "*** failed") << "\n\n";
+
+      isOk &= is;
+   }
+
+   // moving
+   {
+      bool is = true;
+
+      // swap
+      Sheet<float> s( 7, 3, 16 );
+      Sheet<float> t( 2, 2 );
+      const float* pS = s.getStorage();
+      s.swap( t );
+      is &= (pS == t.getStorage()) & (7 == t.getWidth()) &
+         (8 == t.getStride()) & (2 == s.getWidth()) & (2 == s.getStride());
+
+      // factory, by value
+      float* p = new float[ 6 ];
+      p[5] = 5.0f;
+      Sheet<float> a( adoptSheet( p, 3, 2 ) );
+      is &= (3 == a.getWidth()) & a.isOwning() & (5.0f == a.get( 2, 1 ));
+
+#if __cplusplus >= 201103L
+      // (with C++98, only return value optimization avoids a copy)
+      is &= (p == a.getStorage());
+
+      // move construct
+      Sheet<float> b( std::move( a ) );
+      is &= (p == b.getStorage()) & (3 == b.getWidth()) & b.isOwning();
+      is &= (0 == a.getStorage()) & (0 == a.getWidth()) & (0 == a.getHeight());
+
+      // move assign (copy-on-write setting goes too)
+      t.setCopyOnWrite( true );
+      b = std::move( t );
+      is &= (pS == b.getStorage()) & (8 == b.getStride()) &
+         (0 == t.getStorage()) & (0 == t.getStride()) & b.isCopyOnWrite();
+
+      SheetFlat<float> f( adoptSheetFlat( new float[ 4 ], 2, 2 ) );
+      const float* pF = f.getStorage();
+      SheetFlat<float> g( std::move( f ) );
+      is &= (pF == g.getStorage()) & (0 == f.getLength());
+#endif
+
+      if( pOut ) *pOut << "moving : " <<
+         (is ? "--- succeeded" : "*** failed") << "\n\n";
+
+      isOk &= is;
+   }
+
+   // copy-on-write
+   {
+      bool is = true;
+
+      resetSheetShareCounts();
+
+      Sheet<float, StorageAligned<32> > s( 5, 4, 32 );
+      s.zeroStorage();
+      s.get( 1, 1 ) = 3.0f;
+      is &= !s.isCopyOnWrite() & !s.isShared();
+
+      // off: deep copy
+      {
+         const Sheet<float, StorageAligned<32> > c( s );
+         is &= (c.getStorage() != s.getStorage()) & !c.isShared();
+      }
+
+      s.setCopyOnWrite( true );
+      const float* pS = s.getStorage();
+
+      // clone shares, reading keeps sharing
+      Sheet<float, StorageAligned<32> >* pClone = s.clone();
+      const Sheet<float, StorageAligned<32> >& clone = *pClone;
+      is &= (clone.getStorage() == pS) & clone.isShared() & s.isShared() &
+         clone.isCopyOnWrite() & (8 == clone.getStride()) &
+         (3.0f == clone.get( 1, 1 ));
+      is &= (1 == getSheetShareCount()) & (1 == getSheetCopiesAvoided());
+
+      // copies and assignment share too
+      Sheet<float, StorageAligned<32> > c2( clone );
+      Sheet<float, StorageAligned<32> > a;
+      a = s;
+      is &= (3 == getSheetShareCount()) &
+         (static_cast<const Sheet<float, StorageAligned<32> >&>(a).
+         getStorage() == pS);
+
+      // first write copies, the others still share
+      c2.get( 2, 2 ) = 7.0f;
+      is &= (c2.getStorage() != pS) & !c2.isShared() &
+         isAligned( c2.getStorage(), 32 ) & (8 == c2.getStride()) &
+         (3.0f == c2.get( 1, 1 )) & (0.0f == clone.get( 2, 2 ));
+      is &= (1 == getSheetShareCopyCount()) & (2 == getSheetCopiesAvoided());
+
+      // the last sharer takes the storage back, without copying
+      a.setSize( 9, 9 );
+      delete pClone;
+      is &= !s.isShared() & (s.getStorage() == pS);
+      s.get( 0, 0 ) = 1.0f;
+      is &= (s.getStorage() == pS) & (1 == getSheetShareCopyCount());
+
+      // non-owning refs are copied
+      float buffer[ 4 ] = { 1.0f, 2.0f, 3.0f, 4.0f };
+      Sheet<float> ref( buffer, 2, 2, false );
+      ref.setCopyOnWrite( true );
+      const Sheet<float> refCopy( ref );
+      is &= (refCopy.getStorage() != buffer) & refCopy.isOwning() &
+         (4.0f == refCopy.get( 1, 1 ));
+
+      // swap and self-assignment keep it together
+      Sheet<float> t( 3, 3 );
+      t.setCopyOnWrite( true );
+      t.zeroStorage();
+      Sheet<float> u( t );
+      Sheet<float> v;
+      u.swap( v );
+      v = v;
+      is &= v.isShared() & (0 == u.getWidth()) & (3 == v.getWidth());
+      t.setStorage( 0, 0, 0, false );
+      is &= !v.isShared() & (0.0f == v.get( 2, 2 ));
+
+#if __cplusplus >= 201103L
+      // sharing from a const Sheet, not yet sharing
+      Sheet<float> w( 2, 2 );
+      w.setCopyOnWrite( true );
+      const float* pW = w.getStorage();
+      const Sheet<float> k( std::move( w ) );
+      const Sheet<float> l( k );
+      is &= k.isShared() & l.isShared() & (pW == k.getFlat().getStorage()) &
+         (pW == l.getFlat().getStorage());
+#endif
+
+      if( pOut && isVerbose ) *pOut << getSheetShareCount() << " shared  " <<
+         getSheetShareCopyCount() << " copied  " << getSheetCopiesAvoided() <<
+         " avoided\n\n";
+
+      if( pOut ) *pOut << "copy-on-write : " <<
+         (is ? "--- succeeded" : "*** failed") << "\n\n";
+
+      isOk &= is;
+   }
+
+   if( pOut && isVerbose ) benchmarkSheet( *pOut );
+
+
    if( pOut ) *pOut << (isOk ? "--- successfully" : "*** failurefully") <<
       " completed " << "\n\n\n";
 
@@ -12,7 +12,11 @@
 #define Sheet_h
 
 
-#include "Array.hpp"
+#if __cplusplus >= 201103L
+#include <utility>
+#endif
+
+#include "SheetFlat.hpp"
 
 
 
@@ -38,41 +42,85 @@ namespace hxa7241_general
  * Copy constructor and copy assignor always make new owned storage (rather
  * than copy ref-status from a non-owning ref).<br/><br/>
  *
+ * Move constructor and move assignor (C++11) transfer the storage as it is
+ * (owned, or a non-owning ref), leaving the source empty -- no allocation or
+ * element copying. In C++98, swap does the same.<br/><br/>
+ *
  * Non-default constructor, copy constructor, copy assignor and setSize all can
  * throw.<br/><br/>
  *
+ * STORAGE is the allocation policy (see Storage.hpp): StorageNew (the
+ * default), StorageAligned<ALIGNMENT> for storage aligned for SIMD loads, or
+ * StorageArena or StoragePool for temporaries. A policy instance can be given
+ * at construction, and goes along with copies, moves and swaps.<br/><br/>
+ *
+ * rowAlignment (bytes, for the constructor and setSize) pads each row, so
+ * that with aligned storage every row starts aligned: the stride (elements
+ * from one row start to the next) becomes width rounded up to the alignment.
+ * 0 means no padding (stride equals width). The padding is part of the
+ * storage: getLength, operator[], getElement( i ) and zeroStorage all cover
+ * stride * height elements.<br/><br/>
+ *
+ * Copy-on-write is opt-in, by setCopyOnWrite: then copies and clones (of an
+ * owning Sheet) share its storage, through a reference count, and any of the
+ * sharers copies it only at its first mutable access -- a non-const
+ * getStorage, getRow, get, getElement, operator[], getWrapped, getFlat, or
+ * zeroStorage, or setSize to the same length. So read through a const
+ * reference to keep sharing. Copies keep the mode; assignment shares if the
+ * source is in the mode. Pointers taken before a share alias the shared
+ * storage. Sharing is not thread-safe: Sheets sharing storage must be used
+ * from one thread. getSheetCopiesAvoided counts the copies saved (in TESTING
+ * builds).<br/><br/>
+ *
  * getRow and getElement wrap around out of bound indexs (length-wise).
+ * getWrapped wraps each axis, by the addressing mode given as template
+ * parameter: WrapRepeat, WrapMirror, or WrapClamp (non-virtual, as member
+ * templates cannot be).
  *
  * @implementation
- * A variant of a 'Decorator' for Array -- which does all the storage
- * management, Sheet just mapping two dimensions to one.
+ * A virtual, derivable, 'Decorator' for SheetFlat -- which does all the
+ * storage management and mapping. For per-pixel loops, getFlat gives the
+ * non-virtual core.
  */
-template<class TYPE>
+template<class TYPE, class STORAGE = StorageNew>
 class Sheet
 {
 /// standard object services ---------------------------------------------------
 public:
                   Sheet();
-                  Sheet( dword width,
-                         dword height );
-                  Sheet( TYPE* pStorage,
-                         dword width,
-                         dword height,
-                         bool  isAdopt );
+   explicit       Sheet( const STORAGE& storage );
+                  Sheet( dword          width,
+                         dword          height,
+                         dword          rowAlignment = 0,
+                         const STORAGE& storage = STORAGE() );
+                  Sheet( TYPE*          pStorage,
+                         dword          width,
+                         dword          height,
+                         bool           isAdopt,
+                         const STORAGE& storage = STORAGE() );
 
    virtual       ~Sheet();
                   Sheet( const Sheet& );
            Sheet& operator=( const Sheet& );
+#if __cplusplus >= 201103L
+                  Sheet( Sheet&& )                                   noexcept;
+           Sheet& operator=( Sheet&& )                               noexcept;
+#endif
 
 
 /// commands -------------------------------------------------------------------
    virtual void   setSize( dword width,
-                           dword height );
+                           dword height,
+                           dword rowAlignment = 0 );
    virtual void   setStorage( TYPE* pStorage,
                               dword width,
                               dword height,
                               bool  isAdopt );
 
+   virtual void   swap( Sheet& );
+
+   virtual void   setCopyOnWrite( bool isCopyOnWrite );
+
    virtual void   zeroStorage();
 
    virtual TYPE*  getStorage();
@@ -82,16 +130,25 @@ public:
                               dword y );
    virtual TYPE&  get( dword x,
                        dword y );
+   template<class WRAP>
+           TYPE&  getWrapped( dword x,
+                              dword y );
 
    virtual TYPE&  getElement( dword i );
    virtual TYPE&  operator[]( int i );
 
+           SheetFlat<TYPE, STORAGE>& getFlat();
+
 
 /// queries --------------------------------------------------------------------
    virtual dword  getLength()                                             const;
    virtual dword  getWidth()                                              const;
    virtual dword  getHeight()                                             const;
+   virtual dword  getStride()                                             const;
    virtual bool   isOwning()                                              const;
+   virtual bool   isCopyOnWrite()                                         const;
+   /** storage currently shared with a copy. */
+   virtual bool   isShared()                                              const;
 
    static  bool   isSizeWithinRange( dword width,
                                      dword height );
@@ -107,44 +164,98 @@ public:
                                    dword y )                              const;
    virtual const TYPE& get( dword x,
                             dword y )                                     const;
+   template<class WRAP>
+           const TYPE& getWrapped( dword x,
+                                   dword y )                              const;
 
    virtual const TYPE& getElement( dword i )                              const;
    virtual const TYPE& operator[]( int i )                                const;
 
    virtual Sheet* clone()                                                 const;
 
+           const SheetFlat<TYPE, STORAGE>& getFlat()                      const;
+
 
 /// implementation -------------------------------------------------------------
 protected:
-   virtual void   assign( const Sheet<TYPE>& );
+   virtual void   assign( const Sheet<TYPE, STORAGE>& );
+
+private:
+           void   share( const Sheet<TYPE, STORAGE>& );
+           void   unshare();
+           void   release();
 
 
 /// fields ---------------------------------------------------------------------
 private:
-   Array<TYPE> array_m;
+   /// storage of copy-on-write sharers
+   struct Shared
+   {
+      explicit Shared( const STORAGE& storage ) : sheet( storage ), count( 1 )
+      {}
+
+      SheetFlat<TYPE, STORAGE> sheet;
+      dword                    count;
+   };
 
-   dword       width_m;
-   dword       height_m;
+   // (mutable: moving storage into a share, from a const source, changes no
+   // contents)
+   mutable SheetFlat<TYPE, STORAGE> sheet_m;
+   mutable Shared*                  pShared_m;
+   bool                             isCopyOnWrite_m;
 
    static const char ALLOCATION_EXCEPTION_MESSAGE[];
-   static const char SIZE_EXCEPTION_MESSAGE[];
 };
 
 
 
 
+/**
+ * Make a Sheet owning orphaned storage (from new[]), returned by value.<br/>
+ * <br/>
+ *
+ * The elements are never copied: C++11 moves the result out, C++98 relies on
+ * return value optimization.
+ */
+template<class TYPE>
+Sheet<TYPE> adoptSheet
+(
+   TYPE* pStorage,
+   dword width,
+   dword height
+);
+
+
 
 
 
 
-template<class TYPE1, class TYPE2>
+
+
+template<class TYPE1, class STORAGE1, class TYPE2, class STORAGE2>
 bool isSameSize
 (
-   const Sheet<TYPE1>&,
-   const Sheet<TYPE2>&
+   const Sheet<TYPE1, STORAGE1>&,
+   const Sheet<TYPE2, STORAGE2>&
 );
 
 
+#ifdef TESTING
+/**
+ * Copy-on-write counts, over all Sheets: copies that shared storage, and how
+ * many of those later had to copy it after all. Their difference is the deep
+ * copies avoided (so far). TESTING builds only, and not thread-safe.
+ */
+dword getSheetShareCount();
+dword getSheetShareCopyCount();
+dword getSheetCopiesAvoided();
+void  resetSheetShareCounts();
+
+/// for Sheet
+void  countSheetShare_( bool isCopied );
+#endif
+
+
 
 
 
@@ -152,79 +263,90 @@ bool isSameSize
 
 
 /// statics --------------------------------------------------------------------
-template<class TYPE>
-const char Sheet<TYPE>::ALLOCATION_EXCEPTION_MESSAGE[] =
+template<class TYPE, class STORAGE>
+const char Sheet<TYPE, STORAGE>::ALLOCATION_EXCEPTION_MESSAGE[] =
    "Sheet<>::clone() - storage allocation failed";
-template<class TYPE>
-const char Sheet<TYPE>::SIZE_EXCEPTION_MESSAGE[] =
-   "Sheet<>::setSize() - size outside range";
 
 
 
 
 /// standard object services ---------------------------------------------------
-template<class TYPE>
-Sheet<TYPE>::Sheet()
- : array_m ()
- , width_m ( 0 )
- , height_m( 0 )
+template<class TYPE, class STORAGE>
+Sheet<TYPE, STORAGE>::Sheet()
+ : sheet_m        ()
+ , pShared_m      ( 0 )
+ , isCopyOnWrite_m( false )
 {
 }
 
 
-template<class TYPE>
-Sheet<TYPE>::Sheet
+template<class TYPE, class STORAGE>
+Sheet<TYPE, STORAGE>::Sheet
 (
-   const dword width,
-   const dword height
+   const STORAGE& storage
 )
- : array_m ()
- , width_m ( 0 )
- , height_m( 0 )
+ : sheet_m        ( storage )
+ , pShared_m      ( 0 )
+ , isCopyOnWrite_m( false )
 {
-   Sheet<TYPE>::setSize( width, height );
 }
 
 
-template<class TYPE>
-Sheet<TYPE>::Sheet
+template<class TYPE, class STORAGE>
+Sheet<TYPE, STORAGE>::Sheet
 (
-   TYPE*const  pStorage,
-   const dword width,
-   const dword height,
-   const bool  isAdopt
+   const dword    width,
+   const dword    height,
+   const dword    rowAlignment,
+   const STORAGE& storage
 )
- : array_m ()
- , width_m ( 0 )
- , height_m( 0 )
+ : sheet_m        ( width, height, rowAlignment, storage )
+ , pShared_m      ( 0 )
+ , isCopyOnWrite_m( false )
 {
-   Sheet<TYPE>::setStorage( pStorage, width, height, isAdopt );
 }
 
 
-template<class TYPE>
-Sheet<TYPE>::~Sheet()
+template<class TYPE, class STORAGE>
+Sheet<TYPE, STORAGE>::Sheet
+(
+   TYPE*const     pStorage,
+   const dword    width,
+   const dword    height,
+   const bool     isAdopt,
+   const STORAGE& storage
+)
+ : sheet_m        ( pStorage, width, height, isAdopt, storage )
+ , pShared_m      ( 0 )
+ , isCopyOnWrite_m( false )
 {
 }
 
 
-template<class TYPE>
-Sheet<TYPE>::Sheet
+template<class TYPE, class STORAGE>
+Sheet<TYPE, STORAGE>::~Sheet()
+{
+   release();
+}
+
+
+template<class TYPE, class STORAGE>
+Sheet<TYPE, STORAGE>::Sheet
 (
-   const Sheet<TYPE>& other
+   const Sheet<TYPE, STORAGE>& other
 )
- : array_m ()
- , width_m ( 0 )
- , height_m( 0 )
+ : sheet_m        ( other.getFlat().getStoragePolicy() )
+ , pShared_m      ( 0 )
+ , isCopyOnWrite_m( other.isCopyOnWrite_m )
 {
-   Sheet<TYPE>::assign( other );
+   Sheet<TYPE, STORAGE>::assign( other );
 }
 
 
-template<class TYPE>
-Sheet<TYPE>& Sheet<TYPE>::operator=
+template<class TYPE, class STORAGE>
+Sheet<TYPE, STORAGE>& Sheet<TYPE, STORAGE>::operator=
 (
-   const Sheet<TYPE>& other
+   const Sheet<TYPE, STORAGE>& other
 )
 {
    assign( other );
@@ -233,30 +355,72 @@ Sheet<TYPE>& Sheet<TYPE>::operator=
 }
 
 
+#if __cplusplus >= 201103L
+template<class TYPE, class STORAGE>
+Sheet<TYPE, STORAGE>::Sheet
+(
+   Sheet<TYPE, STORAGE>&& other
+) noexcept
+ : sheet_m        ( std::move( other.sheet_m ) )
+ , pShared_m      ( other.pShared_m )
+ , isCopyOnWrite_m( other.isCopyOnWrite_m )
+{
+   other.pShared_m = 0;
+}
+
+
+template<class TYPE, class STORAGE>
+Sheet<TYPE, STORAGE>& Sheet<TYPE, STORAGE>::operator=
+(
+   Sheet<TYPE, STORAGE>&& other
+) noexcept
+{
+   if( &other != this )
+   {
+      sheet_m = std::move( other.sheet_m );
+
+      release();
+      pShared_m       = other.pShared_m;
+      other.pShared_m = 0;
+
+      isCopyOnWrite_m = other.isCopyOnWrite_m;
+   }
+
+   return *this;
+}
+#endif
+
+
 
 
 /// commands -------------------------------------------------------------------
-template<class TYPE>
-void Sheet<TYPE>::setSize
+template<class TYPE, class STORAGE>
+void Sheet<TYPE, STORAGE>::setSize
 (
    const dword width,
-   const dword height
+   const dword height,
+   const dword rowAlignment
 )
 {
-   if( !isSizeWithinRange( width, height ) )
+   // a different length is new storage anyway: leave the share, not copy it
+   if( pShared_m )
    {
-      throw SIZE_EXCEPTION_MESSAGE;
+      const dword stride = isSizeWithinRange( width, height ) ?
+         SheetFlat<TYPE, STORAGE>::getAlignedStride( width, rowAlignment ) :
+         -1;
+      if( isSizeWithinRange( stride, height ) &&
+         ((stride * height) != getLength()) )
+      {
+         release();
+      }
    }
 
-   array_m.setLength( width * height );
-
-   width_m  = width;
-   height_m = height;
+   getFlat().setSize( width, height, rowAlignment );
 }
 
 
-template<class TYPE>
-void Sheet<TYPE>::setStorage
+template<class TYPE, class STORAGE>
+void Sheet<TYPE, STORAGE>::setStorage
 (
    TYPE*const  pStorage,
    const dword width,
@@ -264,237 +428,304 @@ void Sheet<TYPE>::setStorage
    const bool  isAdopt
 )
 {
-   if( !isSizeWithinRange( width, height ) )
-   {
-      throw SIZE_EXCEPTION_MESSAGE;
-   }
+   release();
+   sheet_m.setStorage( pStorage, width, height, isAdopt );
+}
+
+
+template<class TYPE, class STORAGE>
+void Sheet<TYPE, STORAGE>::swap
+(
+   Sheet<TYPE, STORAGE>& other
+)
+{
+   sheet_m.swap( other.sheet_m );
 
-   array_m.setStorage( pStorage, width * height, isAdopt );
+   Shared*const pShared = pShared_m;
+   pShared_m            = other.pShared_m;
+   other.pShared_m      = pShared;
 
-   width_m  = width;
-   height_m = height;
+   const bool isCopyOnWrite = isCopyOnWrite_m;
+   isCopyOnWrite_m          = other.isCopyOnWrite_m;
+   other.isCopyOnWrite_m    = isCopyOnWrite;
 }
 
 
-template<class TYPE>
-void Sheet<TYPE>::zeroStorage()
+template<class TYPE, class STORAGE>
+void Sheet<TYPE, STORAGE>::setCopyOnWrite
+(
+   const bool isCopyOnWrite
+)
 {
-   array_m.zeroStorage();
+   isCopyOnWrite_m = isCopyOnWrite;
 }
 
 
-template<class TYPE>
+template<class TYPE, class STORAGE>
+void Sheet<TYPE, STORAGE>::zeroStorage()
+{
+   getFlat().zeroStorage();
+}
+
+
+template<class TYPE, class STORAGE>
 inline
-TYPE* Sheet<TYPE>::getStorage()
+TYPE* Sheet<TYPE, STORAGE>::getStorage()
 {
-   return array_m.getStorage();
+   return getFlat().getStorage();
 }
 
 
-template<class TYPE>
-TYPE* Sheet<TYPE>::getRow
+template<class TYPE, class STORAGE>
+TYPE* Sheet<TYPE, STORAGE>::getRow
+(
+   const dword y
+)
+{
+   return getFlat().getRow( y );
+}
+
+
+template<class TYPE, class STORAGE>
+TYPE& Sheet<TYPE, STORAGE>::getElement
 (
-   dword y
+   const dword x,
+   const dword y
 )
 {
-   y = (y >= 0) ? y : -y;
-   return array_m.getStorage() + ((y % height_m) * width_m);
+   return getFlat().getElement( x, y );
 }
 
 
-template<class TYPE>
-TYPE& Sheet<TYPE>::getElement
+template<class TYPE, class STORAGE>
+TYPE& Sheet<TYPE, STORAGE>::get
 (
    const dword x,
    const dword y
 )
 {
-   return array_m.get( x + (y * width_m) );
+   return getFlat().get( x, y );
 }
 
 
-template<class TYPE>
-TYPE& Sheet<TYPE>::get
+template<class TYPE, class STORAGE>
+template<class WRAP>
+inline
+TYPE& Sheet<TYPE, STORAGE>::getWrapped
 (
    const dword x,
    const dword y
 )
 {
-   return array_m[ x + (y * width_m) ];
+   return getFlat().template getWrapped<WRAP>( x, y );
 }
 
 
-template<class TYPE>
+template<class TYPE, class STORAGE>
 inline
-TYPE& Sheet<TYPE>::getElement
+TYPE& Sheet<TYPE, STORAGE>::getElement
 (
    const dword i
 )
 {
-   return array_m.get( i );
+   return getFlat().getElement( i );
 }
 
 
-template<class TYPE>
+template<class TYPE, class STORAGE>
 inline
-TYPE& Sheet<TYPE>::operator[]
+TYPE& Sheet<TYPE, STORAGE>::operator[]
 (
    const int i
 )
 {
-   return array_m[ i ];
+   return getFlat()[ i ];
+}
+
+
+template<class TYPE, class STORAGE>
+inline
+SheetFlat<TYPE, STORAGE>& Sheet<TYPE, STORAGE>::getFlat()
+{
+   if( pShared_m )
+   {
+      unshare();
+   }
+
+   return sheet_m;
 }
 
 
 
 
 /// queries --------------------------------------------------------------------
-template<class TYPE>
+template<class TYPE, class STORAGE>
 inline
-dword Sheet<TYPE>::getLength() const
+dword Sheet<TYPE, STORAGE>::getLength() const
 {
-   return array_m.getLength();
+   return getFlat().getLength();
 }
 
 
-template<class TYPE>
+template<class TYPE, class STORAGE>
 inline
-dword Sheet<TYPE>::getWidth() const
+dword Sheet<TYPE, STORAGE>::getWidth() const
 {
-   return width_m;
+   return getFlat().getWidth();
 }
 
 
-template<class TYPE>
+template<class TYPE, class STORAGE>
 inline
-dword Sheet<TYPE>::getHeight() const
+dword Sheet<TYPE, STORAGE>::getHeight() const
 {
-   return height_m;
+   return getFlat().getHeight();
 }
 
 
-template<class TYPE>
+template<class TYPE, class STORAGE>
 inline
-bool Sheet<TYPE>::isOwning() const
+dword Sheet<TYPE, STORAGE>::getStride() const
 {
-   return array_m.isOwning();
+   return getFlat().getStride();
 }
 
 
-template<class TYPE>
-bool Sheet<TYPE>::isSizeWithinRange
+template<class TYPE, class STORAGE>
+inline
+bool Sheet<TYPE, STORAGE>::isOwning() const
+{
+   return getFlat().isOwning();
+}
+
+
+template<class TYPE, class STORAGE>
+inline
+bool Sheet<TYPE, STORAGE>::isCopyOnWrite() const
+{
+   return isCopyOnWrite_m;
+}
+
+
+template<class TYPE, class STORAGE>
+inline
+bool Sheet<TYPE, STORAGE>::isShared() const
+{
+   return (0 != pShared_m) && (pShared_m->count > 1);
+}
+
+
+template<class TYPE, class STORAGE>
+inline
+bool Sheet<TYPE, STORAGE>::isSizeWithinRange
 (
    const dword width,
    const dword height
 )
 {
-   bool isWithin = true;
-
-   // is negative ?
-   if( (width < 0) | (height < 0) )
-   {
-      isWithin = false;
-   }
-   else if( height != 0 )   // prevent divide by zero
-   {
-      // is the total number of elements greater than max length ?
-      if( width > (getMaxSize() / height) )
-      {
-         isWithin = false;
-      }
-   }
-
-   return isWithin;
+   return SheetFlat<TYPE, STORAGE>::isSizeWithinRange( width, height );
 }
 
 
-template<class TYPE>
+template<class TYPE, class STORAGE>
 inline
-dword Sheet<TYPE>::getMaxSize()
+dword Sheet<TYPE, STORAGE>::getMaxSize()
 {
-   return Array<TYPE>::getMaxLength();
+   return SheetFlat<TYPE, STORAGE>::getMaxSize();
 }
 
 
-template<class TYPE>
-bool Sheet<TYPE>::isInRange
+template<class TYPE, class STORAGE>
+bool Sheet<TYPE, STORAGE>::isInRange
 (
    const dword x,
    const dword y
 ) const
 {
-   return (x >= 0) && (x < width_m) && (y >= 0) && (y < height_m);
+   return getFlat().isInRange( x, y );
 }
 
 
-template<class TYPE>
+template<class TYPE, class STORAGE>
 inline
-const TYPE* Sheet<TYPE>::getStorage() const
+const TYPE* Sheet<TYPE, STORAGE>::getStorage() const
 {
-   return array_m.getStorage();
+   return getFlat().getStorage();
 }
 
 
-template<class TYPE>
-const TYPE* Sheet<TYPE>::getRow
+template<class TYPE, class STORAGE>
+const TYPE* Sheet<TYPE, STORAGE>::getRow
 (
-   dword y
+   const dword y
 ) const
 {
-   y = (y >= 0) ? y : -y;
-   return array_m.getStorage() + ((y % height_m) * width_m);
+   return getFlat().getRow( y );
 }
 
 
-template<class TYPE>
-const TYPE& Sheet<TYPE>::getElement
+template<class TYPE, class STORAGE>
+const TYPE& Sheet<TYPE, STORAGE>::getElement
 (
    const dword x,
    const dword y
 ) const
 {
-   return array_m.get( x + (y * width_m) );
+   return getFlat().getElement( x, y );
 }
 
 
-template<class TYPE>
-const TYPE& Sheet<TYPE>::get
+template<class TYPE, class STORAGE>
+const TYPE& Sheet<TYPE, STORAGE>::get
 (
    const dword x,
    const dword y
 ) const
 {
-   return array_m[ x + (y * width_m) ];
+   return getFlat().get( x, y );
 }
 
 
-template<class TYPE>
+template<class TYPE, class STORAGE>
+template<class WRAP>
 inline
-const TYPE& Sheet<TYPE>::getElement
+const TYPE& Sheet<TYPE, STORAGE>::getWrapped
+(
+   const dword x,
+   const dword y
+) const
+{
+   return getFlat().template getWrapped<WRAP>( x, y );
+}
+
+
+template<class TYPE, class STORAGE>
+inline
+const TYPE& Sheet<TYPE, STORAGE>::getElement
 (
    const dword i
 ) const
 {
-   return array_m.get( i );
+   return getFlat().getElement( i );
 }
 
 
-template<class TYPE>
+template<class TYPE, class STORAGE>
 inline
-const TYPE& Sheet<TYPE>::operator[]
+const TYPE& Sheet<TYPE, STORAGE>::operator[]
 (
    const int i
 ) const
 {
-   return array_m[ i ];
+   return getFlat()[ i ];
 }
 
 
-template<class TYPE1, class TYPE2>
+template<class TYPE1, class STORAGE1, class TYPE2, class STORAGE2>
 bool isSameSize
 (
-   const Sheet<TYPE1>& first,
-   const Sheet<TYPE2>& second
+   const Sheet<TYPE1, STORAGE1>& first,
+   const Sheet<TYPE2, STORAGE2>& second
 )
 {
    return (first.getWidth()  == second.getWidth()) &
@@ -502,10 +733,10 @@ bool isSameSize
 }
 
 
-template<class TYPE>
-Sheet<TYPE>* Sheet<TYPE>::clone() const
+template<class TYPE, class STORAGE>
+Sheet<TYPE, STORAGE>* Sheet<TYPE, STORAGE>::clone() const
 {
-   Sheet<TYPE>* pClone = new Sheet<TYPE>( *this );
+   Sheet<TYPE, STORAGE>* pClone = new Sheet<TYPE, STORAGE>( *this );
    if( 0 == pClone )
    {
       throw ALLOCATION_EXCEPTION_MESSAGE;
@@ -515,19 +746,121 @@ Sheet<TYPE>* Sheet<TYPE>::clone() const
 }
 
 
+template<class TYPE, class STORAGE>
+inline
+const SheetFlat<TYPE, STORAGE>& Sheet<TYPE, STORAGE>::getFlat() const
+{
+   return pShared_m ? pShared_m->sheet : sheet_m;
+}
+
+
 
 
 /// implementation -------------------------------------------------------------
+template<class TYPE, class STORAGE>
+void Sheet<TYPE, STORAGE>::assign
+(
+   const Sheet<TYPE, STORAGE>& other
+)
+{
+   if( &other != this )
+   {
+      if( other.isCopyOnWrite_m & other.isOwning() )
+      {
+         share( other );
+      }
+      else
+      {
+         // (this may be sharing other's storage: copy before leaving)
+         SheetFlat<TYPE, STORAGE> copy( sheet_m.getStoragePolicy() );
+         copy = other.getFlat();
+         release();
+         sheet_m.swap( copy );
+      }
+   }
+}
+
+
+template<class TYPE, class STORAGE>
+void Sheet<TYPE, STORAGE>::share
+(
+   const Sheet<TYPE, STORAGE>& other
+)
+{
+   // move other's storage into a share, if not already (its fields are
+   // mutable for this)
+   if( !other.pShared_m )
+   {
+      other.pShared_m = new Shared( other.sheet_m.getStoragePolicy() );
+      other.pShared_m->sheet.swap( other.sheet_m );
+   }
+
+   if( pShared_m != other.pShared_m )
+   {
+      release();
+      SheetFlat<TYPE, STORAGE> empty( sheet_m.getStoragePolicy() );
+      sheet_m.swap( empty );
+
+      pShared_m = other.pShared_m;
+      ++pShared_m->count;
+#ifdef TESTING
+      countSheetShare_( false );
+#endif
+   }
+}
+
+
+template<class TYPE, class STORAGE>
+void Sheet<TYPE, STORAGE>::unshare()
+{
+   // last sharer takes it back, others copy
+   if( pShared_m->count <= 1 )
+   {
+      sheet_m.swap( pShared_m->sheet );
+      release();
+   }
+   else
+   {
+      SheetFlat<TYPE, STORAGE> copy( sheet_m.getStoragePolicy() );
+      copy = pShared_m->sheet;
+      release();
+      sheet_m.swap( copy );
+
+#ifdef TESTING
+      countSheetShare_( true );
+#endif
+   }
+}
+
+
+template<class TYPE, class STORAGE>
+void Sheet<TYPE, STORAGE>::release()
+{
+   if( pShared_m )
+   {
+      if( --pShared_m->count <= 0 )
+      {
+         delete pShared_m;
+      }
+      pShared_m = 0;
+   }
+}
+
+
+
+
+/// other ----------------------------------------------------------------------
 template<class TYPE>
-void Sheet<TYPE>::assign
+Sheet<TYPE> adoptSheet
 (
-   const Sheet<TYPE>& other
+   TYPE*const  pStorage,
+   const dword width,
+   const dword height
 )
 {
-   array_m  = other.array_m;
+   Sheet<TYPE> sheet( pStorage, width, height, true );
 
-   width_m  = other.width_m;
-   height_m = other.height_m;
+   return sheet;
 }
 
 
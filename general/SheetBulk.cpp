@@ -0,0 +1,493 @@
+/*------------------------------------------------------------------------------
+
+   HXA7241 General library.
+   Copyright (c) 2004-2007,  Harrison Ainsworth / HXA7241.
+
+   http://www.hxa7241.org/
+
+------------------------------------------------------------------------------*/
+
+
+#include "SheetBulk.hpp"
+
+
+using namespace hxa7241_general;
+
+
+
+
+
+
+
+
+/// test -----------------------------------------------------------------------
+#ifdef TESTING
+
+
+#include <ostream>
+
+#include "Stopwatch.hpp"
+
+
+namespace
+{
+
+/// not plain data
+class Tag
+{
+public:
+   Tag() : value_m( 0 ) {}
+   Tag( const Tag& other ) : value_m( other.value_m ) {}
+   Tag& operator=( const Tag& o ) { value_m = o.value_m;  return *this; }
+
+   dword value_m;
+};
+
+
+/// distinct value per position
+void setSequence
+(
+   SheetFlat<dword>& sheet
+)
+{
+   for( dword y = 0;  y < sheet.getHeight();  ++y )
+   {
+      for( dword x = 0;  x < sheet.getWidth();  ++x )
+      {
+         sheet.get( x, y ) = (y << 16) | x;
+      }
+   }
+}
+
+
+/// source (x, y) should be at destination (toX, toY), given by MAP
+template<class MAP>
+bool isMapped
+(
+   const SheetFlat<dword>& source,
+   const SheetFlat<dword>& destination
+)
+{
+   const dword width  = source.getWidth();
+   const dword height = source.getHeight();
+
+   bool is = true;
+   for( dword y = 0;  y < height;  ++y )
+   {
+      for( dword x = 0;  x < width;  ++x )
+      {
+         const dword toX = MAP::x( x, y, width, height );
+         const dword toY = MAP::y( x, y, width, height );
+         is &= (source.get( x, y ) == destination.get( toX, toY ));
+      }
+   }
+
+   return is;
+}
+
+
+struct MapTranspose
+{
+   static dword x( dword, dword y, dword, dword )    { return y; }
+   static dword y( dword x, dword, dword, dword )    { return x; }
+};
+
+struct MapRotate90
+{
+   static dword x( dword, dword y, dword, dword h )  { return h - 1 - y; }
+   static dword y( dword x, dword, dword, dword )    { return x; }
+};
+
+struct MapRotate180
+{
+   static dword x( dword x, dword, dword w, dword )  { return w - 1 - x; }
+   static dword y( dword, dword y, dword, dword h )  { return h - 1 - y; }
+};
+
+struct MapRotate270
+{
+   static dword x( dword, dword y, dword, dword )    { return y; }
+   static dword y( dword x, dword, dword w, dword )  { return w - 1 - x; }
+};
+
+struct MapFlipHorizontal
+{
+   static dword x( dword x, dword, dword w, dword )  { return w - 1 - x; }
+   static dword y( dword, dword y, dword, dword )    { return y; }
+};
+
+struct MapFlipVertical
+{
+   static dword x( dword x, dword, dword, dword )    { return x; }
+   static dword y( dword, dword y, dword, dword h )  { return h - 1 - y; }
+};
+
+
+/// naive element loops, for comparison
+
+void naiveTranspose
+(
+   const SheetFlat<float>& source,
+   SheetFlat<float>&       destination
+)
+{
+   for( dword y = 0;  y < source.getHeight();  ++y )
+   {
+      for( dword x = 0;  x < source.getWidth();  ++x )
+      {
+         destination.get( y, x ) = source.get( x, y );
+      }
+   }
+}
+
+
+void naiveRotate90
+(
+   const SheetFlat<float>& source,
+   SheetFlat<float>&       destination
+)
+{
+   const dword height = source.getHeight();
+   for( dword y = 0;  y < height;  ++y )
+   {
+      for( dword x = 0;  x < source.getWidth();  ++x )
+      {
+         destination.get( height - 1 - y, x ) = source.get( x, y );
+      }
+   }
+}
+
+
+void naiveFlipHorizontal
+(
+   SheetFlat<float>& sheet
+)
+{
+   const dword width = sheet.getWidth();
+   for( dword y = 0;  y < sheet.getHeight();  ++y )
+   {
+      for( dword x = 0;  x < (width / 2);  ++x )
+      {
+         const float t = sheet.get( x, y );
+         sheet.get( x, y ) = sheet.get( width - 1 - x, y );
+         sheet.get( width - 1 - x, y ) = t;
+      }
+   }
+}
+
+
+void naiveFlipVertical
+(
+   SheetFlat<float>& sheet
+)
+{
+   const dword height = sheet.getHeight();
+   for( dword y = 0;  y < (height / 2);  ++y )
+   {
+      for( dword x = 0;  x < sheet.getWidth();  ++x )
+      {
+         const float t = sheet.get( x, y );
+         sheet.get( x, y ) = sheet.get( x, height - 1 - y );
+         sheet.get( x, height - 1 - y ) = t;
+      }
+   }
+}
+
+
+void naiveBlit
+(
+   const SheetFlat<float>& source,
+   SheetFlat<float>&       destination
+)
+{
+   for( dword y = 0;  y < source.getHeight();  ++y )
+   {
+      for( dword x = 0;  x < source.getWidth();  ++x )
+      {
+         destination.get( x, y ) = source.get( x, y );
+      }
+   }
+}
+
+
+void naiveFill
+(
+   SheetFlat<float>& sheet,
+   const float       value
+)
+{
+   for( dword y = 0;  y < sheet.getHeight();  ++y )
+   {
+      for( dword x = 0;  x < sheet.getWidth();  ++x )
+      {
+         sheet.get( x, y ) = value;
+      }
+   }
+}
+
+
+void benchmarkBulk
+(
+   std::ostream& out
+)
+{
+   static const dword SIZE = 2048;
+
+   SheetFlat<float> a( SIZE, SIZE );
+   SheetFlat<float> b( SIZE, SIZE );
+   for( dword i = a.getLength();  i-- > 0; )
+   {
+      a[i] = static_cast<float>(i);
+   }
+   b.zeroStorage();
+
+   const SheetView<float> viewA( a );
+   const SheetView<float> viewB( b );
+
+   const double pixels = static_cast<double>(SIZE) * static_cast<double>(SIZE);
+   double times[6][2];
+   Stopwatch stopwatch;
+
+   stopwatch.start();  naiveFill( b, 1.0f );
+   times[0][0] = stopwatch.getSeconds();
+   stopwatch.start();  fill( viewB, 2.0f );
+   times[0][1] = stopwatch.getSeconds();
+
+   stopwatch.start();  naiveBlit( a, b );
+   times[1][0] = stopwatch.getSeconds();
+   stopwatch.start();  blit( viewA, viewB );
+   times[1][1] = stopwatch.getSeconds();
+
+   stopwatch.start();  naiveTranspose( a, b );
+   times[2][0] = stopwatch.getSeconds();
+   stopwatch.start();  transpose( viewA, viewB );
+   times[2][1] = stopwatch.getSeconds();
+
+   stopwatch.start();  naiveRotate90( a, b );
+   times[3][0] = stopwatch.getSeconds();
+   stopwatch.start();  rotate90( viewA, viewB );
+   times[3][1] = stopwatch.getSeconds();
+
+   stopwatch.start();  naiveFlipHorizontal( b );
+   times[4][0] = stopwatch.getSeconds();
+   stopwatch.start();  flipHorizontal( viewB );
+   times[4][1] = stopwatch.getSeconds();
+
+   stopwatch.start();  naiveFlipVertical( b );
+   times[5][0] = stopwatch.getSeconds();
+   stopwatch.start();  flipVertical( viewB );
+   times[5][1] = stopwatch.getSeconds();
+
+   static const char* NAMES[] = { "fill           ", "blit           ",
+      "transpose      ", "rotate90       ", "flipHorizontal ",
+      "flipVertical   " };
+
+   out << "benchmark  " << SIZE << " x " << SIZE <<
+      " float  (ns per pixel: naive, bulk)\n";
+   for( dword i = 0;  i < 6;  ++i )
+   {
+      out << "   " << NAMES[i] << (times[i][0] * 1e9 / pixels) << "  " <<
+         (times[i][1] * 1e9 / pixels) << "\n";
+   }
+   out << "   (check " << b.get( 5, 7 ) << ")\n\n";
+}
+
+}
+
+
+namespace hxa7241_general
+{
+
+
+bool test_SheetBulk
+(
+   std::ostream* pOut,
+   const bool    isVerbose,
+   const dword   //seed
+)
+{
+   bool isOk = true;
+
+   if( pOut ) *pOut << "[ test_SheetBulk ]\n\n";
+
+
+   // fill and blit
+   {
+      bool is = true;
+
+      SheetFlat<dword> sheet( 19, 11, 32 );
+      const SheetView<dword> view( sheet );
+
+      // whole, then a sub-view
+      fill( view, 7 );
+      fill( view.getSubView( 3, 2, 5, 4 ), -1 );
+      for( dword y = 0;  y < sheet.getHeight();  ++y )
+      {
+         for( dword x = 0;  x < sheet.getWidth();  ++x )
+         {
+            const bool isIn = (x >= 3) & (x < 8) & (y >= 2) & (y < 6);
+            is &= (sheet.get( x, y ) == (isIn ? -1 : 7));
+         }
+      }
+
+      // region to region, clipped
+      SheetFlat<dword> source( 13, 9 );
+      setSequence( source );
+      blit( SheetView<const dword>( source ).getSubView( 2, 1, 4, 3 ),
+         view.getSubView( 16, 9, 4, 3 ) );
+      is &= (source.get( 2, 1 ) == sheet.get( 16, 9 )) &
+         (source.get( 4, 2 ) == sheet.get( 18, 10 )) &
+         (7 == sheet.get( 15, 9 ));
+
+      // overlapping, both directions
+      setSequence( sheet );
+      const SheetFlat<dword> before( sheet );
+      blit( view.getSubView( 0, 0, 10, 6 ), view.getSubView( 1, 1, 10, 6 ) );
+      is &= (before.get( 0, 0 ) == sheet.get( 1, 1 )) &
+         (before.get( 9, 5 ) == sheet.get( 10, 6 ));
+      blit( view.getSubView( 1, 1, 10, 6 ), view.getSubView( 0, 0, 10, 6 ) );
+      for( dword y = 0;  y < 6;  ++y )
+      {
+         for( dword x = 0;  x < 10;  ++x )
+         {
+            is &= (before.get( x, y ) == sheet.get( x, y ));
+         }
+      }
+
+      // not plain
+      is &= !IsPlainData<Tag>::VALUE;
+      Sheet<Tag> tags( 4, 3 );
+      Tag tag;
+      tag.value_m = 2;
+      fill( tags, tag );
+      tags.get( 0, 0 ).value_m = 1;
+      blit( SheetView<Tag>( tags ).getSubView( 0, 0, 3, 2 ),
+         SheetView<Tag>( tags ).getSubView( 1, 1, 3, 2 ) );
+      is &= (1 == tags.get( 0, 0 ).value_m) & (1 == tags.get( 1, 1 ).value_m) &
+         (2 == tags.get( 2, 2 ).value_m) & (2 == tags.get( 3, 2 ).value_m);
+
+      // Sheet overload, at offsets: negative, positive, partly and wholly
+      // off each edge
+      Sheet<float> small( 3, 3 );
+      Sheet<float> large( 8, 8 );
+      for( dword y = 0;  y < 3;  ++y )
+      {
+         for( dword x = 0;  x < 3;  ++x )
+         {
+            small.get( x, y ) = static_cast<float>((10 * y) + x);
+         }
+      }
+      static const dword OFFSETS[][2] = { { -1, -1 }, { 6, -1 }, { -2, 6 },
+         { 2, 3 }, { 7, 7 }, { 0, -2 }, { -3, 0 }, { 8, 1 } };
+      for( dword o = 0;  o < 8;  ++o )
+      {
+         const dword ox = OFFSETS[o][0];
+         const dword oy = OFFSETS[o][1];
+         fill( large, -1.0f );
+         blit( small, large, ox, oy );
+
+         for( dword y = 0;  y < 8;  ++y )
+         {
+            for( dword x = 0;  x < 8;  ++x )
+            {
+               const dword sx = x - ox;
+               const dword sy = y - oy;
+               const float expected = ((sx >= 0) & (sx < 3) & (sy >= 0) &
+                  (sy < 3)) ? static_cast<float>((10 * sy) + sx) : -1.0f;
+               is &= (expected == large.get( x, y ));
+            }
+         }
+      }
+
+      if( pOut ) *pOut << "fill and blit : " <<
+         (is ? "--- succeeded" : "*** failed") << "\n\n";
+
+      isOk &= is;
+   }
+
+   // flips, transpose, rotations
+   {
+      bool is = true;
+
+      // odd and even sizes, padded, and not a multiple of the block
+      static const dword SIZES[][2] = { {37, 53}, {64, 33}, {1, 5}, {6, 1} };
+      for( dword s = 0;  s < 4;  ++s )
+      {
+         const dword width  = SIZES[s][0];
+         const dword height = SIZES[s][1];
+
+         SheetFlat<dword> source( width, height, 16 );
+         setSequence( source );
+         const SheetView<const dword> in( source );
+
+         SheetFlat<dword> across( height, width );
+         SheetFlat<dword> along( width, height );
+
+         transpose( in, SheetView<dword>( across ) );
+         is &= isMapped<MapTranspose>( source, across );
+         rotate90( in, SheetView<dword>( across ) );
+         is &= isMapped<MapRotate90>( source, across );
+         rotate270( in, SheetView<dword>( across ) );
+         is &= isMapped<MapRotate270>( source, across );
+         rotate180( in, SheetView<dword>( along ) );
+         is &= isMapped<MapRotate180>( source, along );
+
+         along = source;
+         flipHorizontal( SheetView<dword>( along ) );
+         is &= isMapped<MapFlipHorizontal>( source, along );
+         along = source;
+         flipVertical( SheetView<dword>( along ) );
+         is &= isMapped<MapFlipVertical>( source, along );
+      }
+
+      // Sheet overloads: resizing, and round trips
+      Sheet<float> sheet( 40, 23 );
+      for( dword i = sheet.getLength();  i-- > 0; )
+      {
+         sheet[i] = static_cast<float>(i);
+      }
+      Sheet<float> turned;
+      Sheet<float> back;
+      rotate90( sheet, turned );
+      is &= (23 == turned.getWidth()) & (40 == turned.getHeight());
+      rotate270( turned, back );
+      for( dword i = sheet.getLength();  i-- > 0; )
+      {
+         is &= (sheet[i] == back[i]);
+      }
+      transpose( sheet, turned );
+      transpose( turned, back );
+      rotate180( back, turned );
+      rotate180( turned, back );
+      flipHorizontal( back );
+      flipVertical( back );
+      flipHorizontal( back );
+      flipVertical( back );
+      for( dword i = sheet.getLength();  i-- > 0; )
+      {
+         is &= (sheet[i] == back[i]);
+      }
+
+      if( pOut ) *pOut << "flips, transpose, rotations : " <<
+         (is ? "--- succeeded" : "*** failed") << "\n\n";
+
+      isOk &= is;
+   }
+
+   if( pOut && isVerbose ) benchmarkBulk( *pOut );
+
+
+   if( pOut ) *pOut << (isOk ? "--- successfully" : "*** failurefully") <<
+      " completed " << "\n\n\n";
+
+   if( pOut ) pOut->flush();
+
+
+   return isOk;
+}
+
+
+}//namespace
+
+
+#endif//TESTING
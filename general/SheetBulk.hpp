@@ -0,0 +1,537 @@
+/*------------------------------------------------------------------------------
+
+   HXA7241 General library.
+   Copyright (c) 2004-2007,  Harrison Ainsworth / HXA7241.
+
+   http://www.hxa7241.org/
+
+------------------------------------------------------------------------------*/
+
+
+#ifndef SheetBulk_h
+#define SheetBulk_h
+
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+
+#include "SheetView.hpp"
+#include "hxa7241vector.hpp"
+
+
+
+
+#include "hxa7241_general.hpp"
+namespace hxa7241_general
+{
+
+
+/**
+ * Whole-sheet operations: fill, blit, transpose, flips, and rotations.<br/>
+ * <br/>
+ *
+ * Each works on SheetViews -- so on any rectangle of a Sheet, SheetFlat, or
+ * raw buffer -- and also has a Sheet overload. They go a row at a time, with
+ * memmove for plain data (IsPlainData) and std algorithms (which the compiler
+ * vectorizes) otherwise. Transposes and 90 degree rotations go in square
+ * blocks, so both sides stay in cache.<br/><br/>
+ *
+ * Sizes need not match: the overlapping part, from the top-left, is done.
+ * For the Sheet overloads, the destination is resized (unpadded) if not
+ * already the right size.<br/><br/>
+ *
+ * The source and destination of transposes and rotations must not overlap.
+ * blit allows any overlap. Rotations are clockwise, with y down (as images).
+ */
+
+
+/// fill and copy
+
+template<class TYPE>
+void fill( const SheetView<TYPE>& view,
+           const TYPE&            value );
+
+/** copies source into the top-left of destination. */
+template<class IN, class TYPE>
+void blit( const SheetView<IN>&   source,
+           const SheetView<TYPE>& destination );
+
+
+/// in place
+
+/** left-right. */
+template<class TYPE>
+void flipHorizontal( const SheetView<TYPE>& view );
+
+/** top-bottom. */
+template<class TYPE>
+void flipVertical( const SheetView<TYPE>& view );
+
+
+/// source to destination
+
+/** destination (y, x) = source (x, y). */
+template<class IN, class TYPE>
+void transpose( const SheetView<IN>&   source,
+                const SheetView<TYPE>& destination );
+
+template<class IN, class TYPE>
+void rotate90( const SheetView<IN>&   source,
+               const SheetView<TYPE>& destination );
+
+template<class IN, class TYPE>
+void rotate180( const SheetView<IN>&   source,
+                const SheetView<TYPE>& destination );
+
+template<class IN, class TYPE>
+void rotate270( const SheetView<IN>&   source,
+                const SheetView<TYPE>& destination );
+
+
+/// Sheet overloads
+
+template<class TYPE, class STORAGE>
+void fill( Sheet<TYPE, STORAGE>& sheet,
+           const TYPE&           value );
+
+/** copies source into destination at (x, y), clipped. */
+template<class TYPE, class STORAGE1, class STORAGE2>
+void blit( const Sheet<TYPE, STORAGE1>& source,
+           Sheet<TYPE, STORAGE2>&       destination,
+           dword                        x = 0,
+           dword                        y = 0 );
+
+template<class TYPE, class STORAGE>
+void flipHorizontal( Sheet<TYPE, STORAGE>& sheet );
+
+template<class TYPE, class STORAGE>
+void flipVertical( Sheet<TYPE, STORAGE>& sheet );
+
+template<class TYPE, class STORAGE1, class STORAGE2>
+void transpose( const Sheet<TYPE, STORAGE1>& source,
+                Sheet<TYPE, STORAGE2>&       destination );
+
+template<class TYPE, class STORAGE1, class STORAGE2>
+void rotate90( const Sheet<TYPE, STORAGE1>& source,
+               Sheet<TYPE, STORAGE2>&       destination );
+
+template<class TYPE, class STORAGE1, class STORAGE2>
+void rotate180( const Sheet<TYPE, STORAGE1>& source,
+                Sheet<TYPE, STORAGE2>&       destination );
+
+template<class TYPE, class STORAGE1, class STORAGE2>
+void rotate270( const Sheet<TYPE, STORAGE1>& source,
+                Sheet<TYPE, STORAGE2>&       destination );
+
+
+
+
+/**
+ * Row copy, allowing overlap: memmove for plain data, else std::copy in a
+ * safe direction.
+ */
+template<bool IS_PLAIN>
+struct CopyRow_
+{
+   template<class TYPE>
+   static void copy( const TYPE* pSource,
+                     TYPE*       pDestination,
+                     dword       length );
+};
+
+template<>
+struct CopyRow_<true>
+{
+   template<class TYPE>
+   static void copy( const TYPE* pSource,
+                     TYPE*       pDestination,
+                     dword       length );
+};
+
+
+/**
+ * Block copy with axes swapped (and optionally reversed): source (x, y) goes
+ * to destination row x (or width - 1 - x), column y (or height - 1 - y).
+ */
+template<class TYPE>
+void transposeBlocks_( const SheetView<const TYPE>& source,
+                       const SheetView<TYPE>&       destination,
+                       bool                         isReverseRows,
+                       bool                         isReverseColumns );
+
+template<class TYPE, class STORAGE1, class STORAGE2>
+void setSizeIfNot_( const Sheet<TYPE, STORAGE1>& source,
+                    Sheet<TYPE, STORAGE2>&       destination,
+                    bool                         isAcross );
+
+
+
+
+
+
+
+
+/// INLINES ///
+
+/// implementation
+
+template<bool IS_PLAIN>
+template<class TYPE>
+inline
+void CopyRow_<IS_PLAIN>::copy
+(
+   const TYPE*const pSource,
+   TYPE*const       pDestination,
+   const dword      length
+)
+{
+   if( std::less<const TYPE*>()( pDestination, pSource ) |
+      std::less<const TYPE*>()( pSource + length, pDestination + 1 ) )
+   {
+      std::copy( pSource, pSource + length, pDestination );
+   }
+   else
+   {
+      std::copy_backward( pSource, pSource + length, pDestination + length );
+   }
+}
+
+
+template<class TYPE>
+inline
+void CopyRow_<true>::copy
+(
+   const TYPE*const pSource,
+   TYPE*const       pDestination,
+   const dword      length
+)
+{
+   std::memmove( pDestination, pSource, length * sizeof(TYPE) );
+}
+
+
+template<class TYPE>
+void transposeBlocks_
+(
+   const SheetView<const TYPE>& source,
+   const SheetView<TYPE>&       destination,
+   const bool                   isReverseRows,
+   const bool                   isReverseColumns
+)
+{
+   // 32 x 32 blocks: the block's source rows and destination rows stay in
+   // cache while done. Each destination row is written contiguously (strided
+   // writes cost more than strided reads)
+   static const dword BLOCK = 32;
+
+   const dword width  = std::min( source.getWidth(),  destination.getHeight() );
+   const dword height = std::min( source.getHeight(), destination.getWidth() );
+   if( (width <= 0) | (height <= 0) )
+   {
+      return;
+   }
+
+   // destination steps for source x and y
+   const dword inStride = source.getStride();
+   const dword stride   = destination.getStride();
+   const dword xStep    = isReverseRows    ? -stride : stride;
+   const dword yStep    = isReverseColumns ? -1      : 1;
+   TYPE*const  pOrigin  = destination.getStorage() +
+      (isReverseRows ? (width - 1) * stride : 0) +
+      (isReverseColumns ? height - 1 : 0);
+
+   for( dword by = 0;  by < height;  by += BLOCK )
+   {
+      const dword yEnd = std::min( by + BLOCK, height );
+      for( dword bx = 0;  bx < width;  bx += BLOCK )
+      {
+         const dword xEnd = std::min( bx + BLOCK, width );
+         for( dword x = bx;  x < xEnd;  ++x )
+         {
+            const TYPE* pIn  = source.getStorage() + (by * inStride) + x;
+            TYPE*       pOut = pOrigin + (x * xStep) + (by * yStep);
+            for( dword y = by;  y < yEnd;  ++y, pIn += inStride, pOut += yStep )
+            {
+               *pOut = *pIn;
+            }
+         }
+      }
+   }
+}
+
+
+template<class TYPE, class STORAGE1, class STORAGE2>
+void setSizeIfNot_
+(
+   const Sheet<TYPE, STORAGE1>& source,
+   Sheet<TYPE, STORAGE2>&       destination,
+   const bool                   isAcross
+)
+{
+   const dword width  = isAcross ? source.getHeight() : source.getWidth();
+   const dword height = isAcross ? source.getWidth()  : source.getHeight();
+   if( (destination.getWidth() != width) | (destination.getHeight() != height) )
+   {
+      destination.setSize( width, height );
+   }
+}
+
+
+
+
+/// views
+
+template<class TYPE>
+void fill
+(
+   const SheetView<TYPE>& view,
+   const TYPE&            value
+)
+{
+   // contiguous: one run
+   if( view.getStride() == view.getWidth() )
+   {
+      std::fill( view.getStorage(), view.getStorage() +
+         (view.getWidth() * view.getHeight()), value );
+   }
+   else
+   {
+      for( dword y = 0;  y < view.getHeight();  ++y )
+      {
+         TYPE*const pRow = view.getStorage() + (y * view.getStride());
+         std::fill( pRow, pRow + view.getWidth(), value );
+      }
+   }
+}
+
+
+template<class IN, class TYPE>
+void blit
+(
+   const SheetView<IN>&   sourceIn,
+   const SheetView<TYPE>& destination
+)
+{
+   const SheetView<const TYPE> source( sourceIn );
+
+   const dword width  = std::min( source.getWidth(),  destination.getWidth() );
+   const dword height = std::min( source.getHeight(), destination.getHeight() );
+
+   // if the destination is later in storage, go bottom-up, for overlap
+   const bool  isUp  = std::less<const TYPE*>()( source.getStorage(),
+      destination.getStorage() );
+   const dword yStep = isUp ? -1 : 1;
+   for( dword i = 0, y = isUp ? height - 1 : 0;  i < height;  ++i, y += yStep )
+   {
+      CopyRow_<IsPlainData<TYPE>::VALUE>::copy(
+         source.getStorage() + (y * source.getStride()),
+         destination.getStorage() + (y * destination.getStride()), width );
+   }
+}
+
+
+template<class TYPE>
+void flipHorizontal
+(
+   const SheetView<TYPE>& view
+)
+{
+   for( dword y = 0;  y < view.getHeight();  ++y )
+   {
+      TYPE*const pRow = view.getStorage() + (y * view.getStride());
+      std::reverse( pRow, pRow + view.getWidth() );
+   }
+}
+
+
+template<class TYPE>
+void flipVertical
+(
+   const SheetView<TYPE>& view
+)
+{
+   for( dword y = 0, half = view.getHeight() / 2;  y < half;  ++y )
+   {
+      TYPE*const pTop    = view.getStorage() + (y * view.getStride());
+      TYPE*const pBottom = view.getStorage() +
+         ((view.getHeight() - 1 - y) * view.getStride());
+      std::swap_ranges( pTop, pTop + view.getWidth(), pBottom );
+   }
+}
+
+
+template<class IN, class TYPE>
+inline
+void transpose
+(
+   const SheetView<IN>&   source,
+   const SheetView<TYPE>& destination
+)
+{
+   transposeBlocks_( SheetView<const TYPE>( source ), destination, false,
+      false );
+}
+
+
+template<class IN, class TYPE>
+inline
+void rotate90
+(
+   const SheetView<IN>&   source,
+   const SheetView<TYPE>& destination
+)
+{
+   // source (x, y) -> (height - 1 - y, x)
+   transposeBlocks_( SheetView<const TYPE>( source ), destination, false,
+      true );
+}
+
+
+template<class IN, class TYPE>
+void rotate180
+(
+   const SheetView<IN>&   source,
+   const SheetView<TYPE>& destination
+)
+{
+   const dword width  = std::min( source.getWidth(),  destination.getWidth() );
+   const dword height = std::min( source.getHeight(), destination.getHeight() );
+
+   for( dword y = 0;  y < height;  ++y )
+   {
+      const TYPE* pIn = source.getStorage() + (y * source.getStride());
+      std::reverse_copy( pIn, pIn + width, destination.getStorage() +
+         ((height - 1 - y) * destination.getStride()) );
+   }
+}
+
+
+template<class IN, class TYPE>
+inline
+void rotate270
+(
+   const SheetView<IN>&   source,
+   const SheetView<TYPE>& destination
+)
+{
+   // source (x, y) -> (y, width - 1 - x)
+   transposeBlocks_( SheetView<const TYPE>( source ), destination, true,
+      false );
+}
+
+
+
+
+/// Sheets
+
+template<class TYPE, class STORAGE>
+inline
+void fill
+(
+   Sheet<TYPE, STORAGE>& sheet,
+   const TYPE&           value
+)
+{
+   fill( SheetView<TYPE>( sheet ), value );
+}
+
+
+template<class TYPE, class STORAGE1, class STORAGE2>
+inline
+void blit
+(
+   const Sheet<TYPE, STORAGE1>& source,
+   Sheet<TYPE, STORAGE2>&       destination,
+   const dword                  x,
+   const dword                  y
+)
+{
+   // overlap: source from where the destination edge cuts it, destination
+   // from (x, y) clipped (sub-views clip to the far edges)
+   const dword sx = (x < 0) ? -x : 0;
+   const dword sy = (y < 0) ? -y : 0;
+
+   blit( SheetView<const TYPE>( source ).getSubView( sx, sy,
+      source.getWidth() - sx, source.getHeight() - sy ),
+      SheetView<TYPE>( destination ).getSubView( x + sx, y + sy,
+      source.getWidth() - sx, source.getHeight() - sy ) );
+}
+
+
+template<class TYPE, class STORAGE>
+inline
+void flipHorizontal
+(
+   Sheet<TYPE, STORAGE>& sheet
+)
+{
+   flipHorizontal( SheetView<TYPE>( sheet ) );
+}
+
+
+template<class TYPE, class STORAGE>
+inline
+void flipVertical
+(
+   Sheet<TYPE, STORAGE>& sheet
+)
+{
+   flipVertical( SheetView<TYPE>( sheet ) );
+}
+
+
+template<class TYPE, class STORAGE1, class STORAGE2>
+void transpose
+(
+   const Sheet<TYPE, STORAGE1>& source,
+   Sheet<TYPE, STORAGE2>&       destination
+)
+{
+   setSizeIfNot_( source, destination, true );
+   transpose( SheetView<const TYPE>( source ), SheetView<TYPE>( destination ) );
+}
+
+
+template<class TYPE, class STORAGE1, class STORAGE2>
+void rotate90
+(
+   const Sheet<TYPE, STORAGE1>& source,
+   Sheet<TYPE, STORAGE2>&       destination
+)
+{
+   setSizeIfNot_( source, destination, true );
+   rotate90( SheetView<const TYPE>( source ), SheetView<TYPE>( destination ) );
+}
+
+
+template<class TYPE, class STORAGE1, class STORAGE2>
+void rotate180
+(
+   const Sheet<TYPE, STORAGE1>& source,
+   Sheet<TYPE, STORAGE2>&       destination
+)
+{
+   setSizeIfNot_( source, destination, false );
+   rotate180( SheetView<const TYPE>( source ), SheetView<TYPE>( destination ) );
+}
+
+
+template<class TYPE, class STORAGE1, class STORAGE2>
+void rotate270
+(
+   const Sheet<TYPE, STORAGE1>& source,
+   Sheet<TYPE, STORAGE2>&       destination
+)
+{
+   setSizeIfNot_( source, destination, true );
+   rotate270( SheetView<const TYPE>( source ), SheetView<TYPE>( destination ) );
+}
+
+
+}//namespace
+
+
+
+
+#endif//SheetBulk_h
@@ -0,0 +1,668 @@
+/*------------------------------------------------------------------------------
+
+   HXA7241 General library.
+   Copyright (c) 2004-2007,  Harrison Ainsworth / HXA7241.
+
+   http://www.hxa7241.org/
+
+------------------------------------------------------------------------------*/
+
+
+/// conditional compilations
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <cstddef>
+#include <cstring>
+
+#include "SheetFile.hpp"
+
+
+using namespace hxa7241_general;
+
+
+
+
+/// header /////////////////////////////////////////////////////////////////////
+namespace
+{
+
+/// layout: udwords
+enum
+{
+   HEADER_MAGIC_0,     // "HXAS"
+   HEADER_MAGIC_1,     // "HEET"
+   HEADER_BYTE_ORDER,
+   HEADER_VERSION,
+   HEADER_BYTES,
+   HEADER_WIDTH,
+   HEADER_HEIGHT,
+   HEADER_ELEMENT_BYTES,
+   HEADER_LAYOUT,      // 0: rows, unpadded
+   HEADER_LENGTH = 16
+};
+
+const char   MAGIC[]         = "HXASHEET";
+const udword BYTE_ORDER_MARK = 0x01020304u;
+const udword VERSION_1       = 1;
+const udword ROWS            = 0;
+const dword  HEADER_SIZE     = HEADER_LENGTH * sizeof(udword);
+
+
+/// bytes of elements -- false if size invalid or too big for this platform
+bool getElementsBytes
+(
+   const dword width,
+   const dword height,
+   const dword elementBytes,
+   size_t&     bytes
+)
+{
+   bool isOk = (elementBytes > 0) &&
+      Sheet<ubyte>::isSizeWithinRange( width, height );
+
+   if( isOk )
+   {
+      const size_t elements = static_cast<size_t>(width) *
+         static_cast<size_t>(height);
+      const size_t maximum  = (~static_cast<size_t>(0) - HEADER_SIZE) /
+         static_cast<size_t>(elementBytes);
+
+      isOk  = (elements <= maximum);
+      bytes = isOk ? elements * static_cast<size_t>(elementBytes) : 0;
+   }
+
+   return isOk;
+}
+
+}
+
+
+
+
+/// statics ////////////////////////////////////////////////////////////////////
+const char SheetFile::OPEN_EXCEPTION_MESSAGE[] =
+   "SheetFile::SheetFile() - file open or mapping failed";
+const char SheetFile::HEADER_EXCEPTION_MESSAGE[] =
+   "SheetFile::SheetFile() - not a sheet file, or other byte order or version";
+const char SheetFile::SIZE_EXCEPTION_MESSAGE[] =
+   "SheetFile::SheetFile() - size invalid or too big";
+const char SheetFile::FLUSH_EXCEPTION_MESSAGE[] =
+   "SheetFile::flush() - write to file failed";
+const char SheetFile::ELEMENT_EXCEPTION_MESSAGE[] =
+   "SheetFile::attach() - element size differs";
+
+
+
+
+/// mapping ////////////////////////////////////////////////////////////////////
+class SheetFile::Mapping
+{
+public:
+   /// file of bytes (create), or existing (bytes 0)
+            Mapping( const char* pPathname,
+                     bool        isWritable,
+                     size_t      bytes );
+           ~Mapping();
+
+   bool     flush();
+
+   void*    pBytes;
+   size_t   bytes;
+   bool     isWritable;
+
+private:
+            Mapping( const Mapping& );
+   Mapping& operator=( const Mapping& );
+
+   void     close();
+
+#ifdef _WIN32
+   HANDLE   file_m;
+   HANDLE   mapping_m;
+#else
+   int      file_m;
+#endif
+};
+
+
+#ifdef _WIN32
+
+
+SheetFile::Mapping::Mapping
+(
+   const char*  pPathname,
+   const bool   isWritable,
+   const size_t newBytes
+)
+ : pBytes    ( 0 )
+ , bytes     ( 0 )
+ , isWritable( isWritable )
+ , file_m    ( INVALID_HANDLE_VALUE )
+ , mapping_m ( 0 )
+{
+   file_m = ::CreateFileA( pPathname, GENERIC_READ | (isWritable ?
+      GENERIC_WRITE : 0), FILE_SHARE_READ, 0, (newBytes > 0) ? CREATE_ALWAYS :
+      OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0 );
+
+   LARGE_INTEGER size;
+   size.QuadPart = static_cast<LONGLONG>(newBytes);
+   bool isOk = (INVALID_HANDLE_VALUE != file_m) && ((newBytes == 0) ||
+      (::SetFilePointerEx( file_m, size, 0, FILE_BEGIN ) &&
+      ::SetEndOfFile( file_m ))) && ::GetFileSizeEx( file_m, &size ) &&
+      (static_cast<ULONGLONG>(size.QuadPart) <=
+      static_cast<ULONGLONG>(~static_cast<size_t>(0))) && (size.QuadPart > 0);
+
+   if( isOk )
+   {
+      bytes      = static_cast<size_t>(size.QuadPart);
+      mapping_m  = ::CreateFileMappingA( file_m, 0, isWritable ?
+         PAGE_READWRITE : PAGE_WRITECOPY, 0, 0, 0 );
+      pBytes     = (0 != mapping_m) ? ::MapViewOfFile( mapping_m, isWritable ?
+         FILE_MAP_WRITE : FILE_MAP_COPY, 0, 0, 0 ) : 0;
+      isOk       = (0 != pBytes);
+   }
+
+   if( !isOk )
+   {
+      close();
+      throw SheetFile::OPEN_EXCEPTION_MESSAGE;
+   }
+}
+
+
+bool SheetFile::Mapping::flush()
+{
+   return !isWritable || (::FlushViewOfFile( pBytes, 0 ) &&
+      ::FlushFileBuffers( file_m ));
+}
+
+
+void SheetFile::Mapping::close()
+{
+   if( 0 != pBytes )
+   {
+      ::UnmapViewOfFile( pBytes );
+      pBytes = 0;
+   }
+   if( 0 != mapping_m )
+   {
+      ::CloseHandle( mapping_m );
+      mapping_m = 0;
+   }
+   if( INVALID_HANDLE_VALUE != file_m )
+   {
+      ::CloseHandle( file_m );
+      file_m = INVALID_HANDLE_VALUE;
+   }
+}
+
+
+#else
+
+
+SheetFile::Mapping::Mapping
+(
+   const char*  pPathname,
+   const bool   isWritable,
+   const size_t newBytes
+)
+ : pBytes    ( 0 )
+ , bytes     ( 0 )
+ , isWritable( isWritable )
+ , file_m    ( -1 )
+{
+   file_m = ::open( pPathname, (newBytes > 0) ? (O_RDWR | O_CREAT | O_TRUNC) :
+      (isWritable ? O_RDWR : O_RDONLY), 0666 );
+
+   // new files are sized (sparse, so reading zeros)
+   struct stat status;
+   bool isOk = (-1 != file_m) && ((newBytes == 0) ||
+      ((static_cast<off_t>(newBytes) > 0) &&
+      (static_cast<size_t>(static_cast<off_t>(newBytes)) == newBytes) &&
+      (0 == ::ftruncate( file_m, static_cast<off_t>(newBytes) )))) &&
+      (0 == ::fstat( file_m, &status )) && (status.st_size > 0) &&
+      (static_cast<off_t>(static_cast<size_t>(status.st_size)) ==
+      status.st_size);
+
+   if( isOk )
+   {
+      // writable shared, else private: the file is never changed
+      bytes  = static_cast<size_t>(status.st_size);
+      pBytes = ::mmap( 0, bytes, PROT_READ | PROT_WRITE, isWritable ?
+         MAP_SHARED : MAP_PRIVATE, file_m, 0 );
+      if( MAP_FAILED == pBytes )
+      {
+         pBytes = 0;
+         isOk   = false;
+      }
+   }
+
+   if( !isOk )
+   {
+      close();
+      throw SheetFile::OPEN_EXCEPTION_MESSAGE;
+   }
+}
+
+
+bool SheetFile::Mapping::flush()
+{
+   return !isWritable || (0 == ::msync( pBytes, bytes, MS_SYNC ));
+}
+
+
+void SheetFile::Mapping::close()
+{
+   if( 0 != pBytes )
+   {
+      ::munmap( pBytes, bytes );
+      pBytes = 0;
+   }
+   if( -1 != file_m )
+   {
+      ::close( file_m );
+      file_m = -1;
+   }
+}
+
+
+#endif
+
+
+SheetFile::Mapping::~Mapping()
+{
+   close();
+}
+
+
+
+
+/// SheetFile //////////////////////////////////////////////////////////////////
+
+
+/// standard object services ---------------------------------------------------
+SheetFile::SheetFile
+(
+   const char* pPathname,
+   const bool  isWritable
+)
+ : pMapping_m    ( new Mapping( pPathname, isWritable, 0 ) )
+ , width_m       ( 0 )
+ , height_m      ( 0 )
+ , elementBytes_m( 0 )
+{
+   // check header, and that the file holds all the elements
+   const udword* pHeader = static_cast<const udword*>(pMapping_m->pBytes);
+
+   bool isOk = (pMapping_m->bytes >= static_cast<size_t>(HEADER_SIZE)) &&
+      (0 == std::memcmp( pHeader, MAGIC, 8 )) &&
+      (BYTE_ORDER_MARK == pHeader[HEADER_BYTE_ORDER]) &&
+      (VERSION_1 == pHeader[HEADER_VERSION]) &&
+      (static_cast<udword>(HEADER_SIZE) == pHeader[HEADER_BYTES]) &&
+      (ROWS == pHeader[HEADER_LAYOUT]);
+
+   const char* pMessage = HEADER_EXCEPTION_MESSAGE;
+   if( isOk )
+   {
+      width_m        = static_cast<dword>(pHeader[HEADER_WIDTH]);
+      height_m       = static_cast<dword>(pHeader[HEADER_HEIGHT]);
+      elementBytes_m = static_cast<dword>(pHeader[HEADER_ELEMENT_BYTES]);
+
+      size_t bytes = 0;
+      isOk = getElementsBytes( width_m, height_m, elementBytes_m, bytes ) &&
+         ((pMapping_m->bytes - HEADER_SIZE) >= bytes);
+      pMessage = SIZE_EXCEPTION_MESSAGE;
+   }
+
+   if( !isOk )
+   {
+      delete pMapping_m;
+      throw pMessage;
+   }
+}
+
+
+SheetFile::SheetFile
+(
+   const char* pPathname,
+   const dword width,
+   const dword height,
+   const dword elementBytes
+)
+ : pMapping_m    ( 0 )
+ , width_m       ( width )
+ , height_m      ( height )
+ , elementBytes_m( elementBytes )
+{
+   size_t bytes = 0;
+   if( !getElementsBytes( width, height, elementBytes, bytes ) )
+   {
+      throw SIZE_EXCEPTION_MESSAGE;
+   }
+
+   pMapping_m = new Mapping( pPathname, true, HEADER_SIZE + bytes );
+
+   udword header[ HEADER_LENGTH ];
+   std::memset( header, 0, sizeof(header) );
+   std::memcpy( header, MAGIC, 8 );
+   header[HEADER_BYTE_ORDER]    = BYTE_ORDER_MARK;
+   header[HEADER_VERSION]       = VERSION_1;
+   header[HEADER_BYTES]         = static_cast<udword>(HEADER_SIZE);
+   header[HEADER_WIDTH]         = static_cast<udword>(width);
+   header[HEADER_HEIGHT]        = static_cast<udword>(height);
+   header[HEADER_ELEMENT_BYTES] = static_cast<udword>(elementBytes);
+   header[HEADER_LAYOUT]        = ROWS;
+   std::memcpy( pMapping_m->pBytes, header, sizeof(header) );
+}
+
+
+SheetFile::~SheetFile()
+{
+   delete pMapping_m;
+}
+
+
+
+
+/// commands -------------------------------------------------------------------
+void SheetFile::flush()
+{
+   if( !pMapping_m->flush() )
+   {
+      throw FLUSH_EXCEPTION_MESSAGE;
+   }
+}
+
+
+
+
+/// queries --------------------------------------------------------------------
+bool SheetFile::isWritable() const
+{
+   return pMapping_m->isWritable;
+}
+
+
+void* SheetFile::getElements() const
+{
+   return static_cast<ubyte*>(pMapping_m->pBytes) + HEADER_SIZE;
+}
+
+
+
+
+/// implementation -------------------------------------------------------------
+void SheetFile::checkElementBytes
+(
+   const dword elementBytes
+) const
+{
+   if( elementBytes != elementBytes_m )
+   {
+      throw ELEMENT_EXCEPTION_MESSAGE;
+   }
+}
+
+
+
+
+
+
+
+
+/// test -----------------------------------------------------------------------
+#ifdef TESTING
+
+
+#include <ostream>
+#include <fstream>
+#include <cstdio>
+
+#include "Stopwatch.hpp"
+
+
+namespace
+{
+
+/// three channel float pixel
+struct Rgb
+{
+   float c[3];
+};
+
+
+const char TEST_PATHNAME[] = "hxa7241_SheetFile_test.tmp";
+
+
+bool isThrown
+(
+   const char* pPathname,
+   const bool  isWritable
+)
+{
+   bool is = false;
+   try
+   {
+      SheetFile file( pPathname, isWritable );
+   }
+   catch( const char* )
+   {
+      is = true;
+   }
+
+   return is;
+}
+
+}
+
+
+namespace hxa7241_general
+{
+
+
+bool test_SheetFile
+(
+   std::ostream* pOut,
+   const bool    isVerbose,
+   const dword   //seed
+)
+{
+   bool isOk = true;
+
+   if( pOut ) *pOut << "[ test_SheetFile ]\n\n";
+
+
+   // create, reopen, write
+   {
+      bool is = true;
+
+      try
+      {
+         // create, and fill through a Sheet
+         {
+            SheetFile file( TEST_PATHNAME, 37, 23, sizeof(Rgb) );
+            is &= (37 == file.getWidth()) & (23 == file.getHeight()) &
+               (sizeof(Rgb) == file.getElementBytes()) & file.isWritable();
+            is &= isAligned( file.getElements(), 64 );
+
+            Sheet<Rgb> sheet;
+            file.attach( sheet );
+            is &= (37 == sheet.getWidth()) & (37 == sheet.getStride()) &
+               !sheet.isOwning() & (0.0f == sheet.get( 36, 22 ).c[2]);
+            for( dword y = 0;  y < 23;  ++y )
+            {
+               for( dword x = 0;  x < 37;  ++x )
+               {
+                  for( dword c = 0;  c < 3;  ++c )
+                  {
+                     sheet.get( x, y ).c[c] =
+                        static_cast<float>((y * 1000) + (x * 10) + c);
+                  }
+               }
+            }
+            file.flush();
+
+            // wrong element type
+            SheetFlat<float> wrong;
+            bool isWrong = false;
+            try
+            {
+               file.attach( wrong );
+            }
+            catch( const char* )
+            {
+               isWrong = true;
+            }
+            is &= isWrong & (0 == wrong.getLength());
+         }
+
+         // reopen read-only: private writes do not reach the file
+         {
+            const SheetFile file( TEST_PATHNAME, false );
+            is &= (37 == file.getWidth()) & !file.isWritable();
+
+            SheetFlat<Rgb> sheet;
+            file.attach( sheet );
+            is &= (22362.0f == sheet.get( 36, 22 ).c[2]) &
+               (1.0f == sheet.get( 0, 0 ).c[1]);
+            sheet.get( 1, 1 ).c[0] = -1.0f;
+         }
+
+         // reopen writable, change, and see it after
+         {
+            SheetFile file( TEST_PATHNAME, true );
+            Sheet<Rgb> sheet;
+            file.attach( sheet );
+            is &= (1010.0f == sheet.get( 1, 1 ).c[0]);
+            sheet.get( 2, 2 ).c[1] = -2.0f;
+         }
+         {
+            const SheetFile file( TEST_PATHNAME, false );
+            const Rgb* pElements = static_cast<const Rgb*>(file.getElements());
+            is &= (-2.0f == pElements[(2 * 37) + 2].c[1]) &
+               (1010.0f == pElements[37 + 1].c[0]);
+         }
+
+         // empty
+         {
+            SheetFile file( TEST_PATHNAME, 0, 5, 4 );
+            Sheet<float> sheet( 3, 3 );
+            file.attach( sheet );
+            is &= (0 == sheet.getLength());
+         }
+      }
+      catch( const char* )
+      {
+         is = false;
+      }
+
+      if( pOut ) *pOut << "create, reopen, write : " <<
+         (is ? "--- succeeded" : "*** failed") << "\n\n";
+
+      isOk &= is;
+   }
+
+   // invalid
+   {
+      bool is = true;
+
+      is &= isThrown( "hxa7241_SheetFile_test_absent.tmp", false );
+
+      // not a sheet file
+      {
+         std::ofstream out( TEST_PATHNAME, std::ios::binary );
+         for( dword i = 0;  i < 100;  ++i )
+         {
+            out << "junk ";
+         }
+      }
+      is &= isThrown( TEST_PATHNAME, false );
+
+      // truncated elements
+      {
+         SheetFile file( TEST_PATHNAME, 100, 100, 4 );
+      }
+      {
+         std::fstream io( TEST_PATHNAME, std::ios::binary | std::ios::in |
+            std::ios::out );
+         io.seekp( 5 * 4 );
+         const udword bigger = 200;
+         io.write( reinterpret_cast<const char*>(&bigger), sizeof(bigger) );
+      }
+      is &= isThrown( TEST_PATHNAME, true );
+
+      // sizes
+      bool isSizeThrown = false;
+      try
+      {
+         SheetFile file( TEST_PATHNAME, -1, 5, 4 );
+      }
+      catch( const char* )
+      {
+         isSizeThrown = true;
+      }
+      is &= isSizeThrown;
+
+      if( pOut ) *pOut << "invalid : " <<
+         (is ? "--- succeeded" : "*** failed") << "\n\n";
+
+      isOk &= is;
+   }
+
+   // big, reopened and partly read
+   if( pOut && isVerbose )
+   {
+      static const dword SIZE = 4096;
+
+      try
+      {
+         {
+            SheetFile file( TEST_PATHNAME, SIZE, SIZE, sizeof(Rgb) );
+            Sheet<Rgb> sheet;
+            file.attach( sheet );
+            sheet.get( SIZE - 1, SIZE - 1 ).c[0] = 1.0f;
+         }
+
+         Stopwatch stopwatch;
+         const SheetFile file( TEST_PATHNAME, false );
+         Sheet<Rgb> sheet;
+         file.attach( sheet );
+         const float value = static_cast<const Sheet<Rgb>&>(sheet).get(
+            SIZE - 1, SIZE - 1 ).c[0];
+         const double seconds = stopwatch.getSeconds();
+
+         *pOut << SIZE << " x " << SIZE << " Rgb (" << ((static_cast<double>(
+            SIZE) * SIZE * sizeof(Rgb)) / (1024.0 * 1024.0)) <<
+            "MB): reopen and read a pixel " << (seconds * 1e6) << " us  (" <<
+            value << ")\n\n";
+      }
+      catch( const char* )
+      {
+         *pOut << "big file not possible here\n\n";
+      }
+   }
+
+   std::remove( TEST_PATHNAME );
+
+
+   if( pOut ) *pOut << (isOk ? "--- successfully" : "*** failurefully") <<
+      " completed " << "\n\n\n";
+
+   if( pOut ) pOut->flush();
+
+
+   return isOk;
+}
+
+
+}//namespace
+
+
+#endif//TESTING
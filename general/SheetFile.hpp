@@ -0,0 +1,176 @@
+/*------------------------------------------------------------------------------
+
+   HXA7241 General library.
+   Copyright (c) 2004-2007,  Harrison Ainsworth / HXA7241.
+
+   http://www.hxa7241.org/
+
+------------------------------------------------------------------------------*/
+
+
+#ifndef SheetFile_h
+#define SheetFile_h
+
+
+#include "Sheet.hpp"
+
+
+
+
+#include "hxa7241_general.hpp"
+namespace hxa7241_general
+{
+
+
+/**
+ * Sheet storage in a memory-mapped file, with a small header.<br/><br/>
+ *
+ * The file is a 64 byte header -- width, height, element size, and layout --
+ * then the elements, in rows, unpadded. Opening maps it and checks the header,
+ * nothing more: there is no parse or read step, and elements are paged in
+ * from the file only when touched (and can be paged out again). So a
+ * framebuffer bigger than is wanted resident can be reopened instantly.<br/>
+ * <br/>
+ *
+ * attach points a Sheet or SheetFlat at the mapped elements, as a non-owning
+ * reference (setStorage with isAdopt false). The SheetFile must outlive that
+ * use. (Copying such a Sheet makes an owned, in-memory, copy.)<br/><br/>
+ *
+ * Writable (and created) files are mapped shared: element writes go to the
+ * file -- eventually, or at flush. Read-only files are mapped private: the
+ * file is never changed, and any writes stay in this process.<br/><br/>
+ *
+ * The header is in native byte order, and a file from a machine of other
+ * order is rejected. Elements are not converted: TYPE should be plain data.
+ * Element storage is 64 byte aligned.<br/><br/>
+ *
+ * POSIX (mmap), or Win32. Files over 2GB need a 64-bit platform (or 64-bit
+ * file offsets).
+ *
+ * @implementation
+ * Platform parts are hidden in the .cpp.
+ */
+class SheetFile
+{
+/// standard object services ---------------------------------------------------
+public:
+   /** open an existing file. */
+            SheetFile( const char* pPathname,
+                       bool        isWritable );                      // throws
+   /** create (or replace) a file, elements zeroed, writable. */
+            SheetFile( const char* pPathname,
+                       dword       width,
+                       dword       height,
+                       dword       elementBytes );                    // throws
+
+           ~SheetFile();
+private:
+            SheetFile( const SheetFile& );
+   SheetFile& operator=( const SheetFile& );
+public:
+
+
+/// commands -------------------------------------------------------------------
+   /** throws if sizeof(TYPE) is not the element size. */
+   template<class TYPE, class STORAGE>
+           void   attach( Sheet<TYPE, STORAGE>& )                         const;
+   template<class TYPE, class STORAGE>
+           void   attach( SheetFlat<TYPE, STORAGE>& )                     const;
+
+           /** write changed elements to the file, and wait. */
+           void   flush();                                             // throws
+
+
+/// queries --------------------------------------------------------------------
+           dword  getWidth()                                              const;
+           dword  getHeight()                                             const;
+           dword  getElementBytes()                                       const;
+           bool   isWritable()                                            const;
+
+           void*  getElements()                                           const;
+
+
+/// implementation -------------------------------------------------------------
+private:
+           void   checkElementBytes( dword elementBytes )                 const;
+
+
+/// fields ---------------------------------------------------------------------
+   class Mapping;
+   Mapping* pMapping_m;
+
+   dword    width_m;
+   dword    height_m;
+   dword    elementBytes_m;
+
+   static const char OPEN_EXCEPTION_MESSAGE[];
+   static const char HEADER_EXCEPTION_MESSAGE[];
+   static const char SIZE_EXCEPTION_MESSAGE[];
+   static const char FLUSH_EXCEPTION_MESSAGE[];
+   static const char ELEMENT_EXCEPTION_MESSAGE[];
+};
+
+
+
+
+
+
+
+
+/// INLINES ///
+
+/// commands
+template<class TYPE, class STORAGE>
+void SheetFile::attach
+(
+   Sheet<TYPE, STORAGE>& sheet
+) const
+{
+   checkElementBytes( sizeof(TYPE) );
+
+   sheet.setStorage( static_cast<TYPE*>(getElements()), width_m, height_m,
+      false );
+}
+
+
+template<class TYPE, class STORAGE>
+void SheetFile::attach
+(
+   SheetFlat<TYPE, STORAGE>& sheet
+) const
+{
+   checkElementBytes( sizeof(TYPE) );
+
+   sheet.setStorage( static_cast<TYPE*>(getElements()), width_m, height_m,
+      false );
+}
+
+
+/// queries
+inline
+dword SheetFile::getWidth() const
+{
+   return width_m;
+}
+
+
+inline
+dword SheetFile::getHeight() const
+{
+   return height_m;
+}
+
+
+inline
+dword SheetFile::getElementBytes() const
+{
+   return elementBytes_m;
+}
+
+
+}//namespace
+
+
+
+
+#endif//SheetFile_h
@@ -0,0 +1,754 @@
+/*------------------------------------------------------------------------------
+
+   HXA7241 General library.
+   Copyright (c) 2004-2006,  Harrison Ainsworth / HXA7241.
+
+   http://www.hxa7241.org/
+
+------------------------------------------------------------------------------*/
+
+
+#ifndef SheetFlat_h
+#define SheetFlat_h
+
+
+#if __cplusplus >= 201103L
+#include <utility>
+#endif
+
+#include "ArrayFlat.hpp"
+
+
+
+
+#include "hxa7241_general.hpp"
+namespace hxa7241_general
+{
+
+
+/**
+ * Sheet with no dynamic dispatch: same interface and semantics as Sheet, but
+ * all members non-virtual.<br/><br/>
+ *
+ * No vtable pointer, and every accessor can be inlined -- for per-pixel
+ * loops. Not for deriving from (destructor is non-virtual).<br/><br/>
+ *
+ * Non-owning reference, copying, moving, exception, wrap-around, storage and
+ * row padding semantics are exactly as documented for Sheet.
+ *
+ * @see Sheet -- the virtual, derivable, version, implemented with this.
+ *
+ * @implementation
+ * A variant of a 'Decorator' for ArrayFlat -- which does all the storage
+ * management, SheetFlat just mapping two dimensions to one.
+ */
+template<class TYPE, class STORAGE = StorageNew>
+class SheetFlat
+{
+/// standard object services ---------------------------------------------------
+public:
+                      SheetFlat();
+   explicit           SheetFlat( const STORAGE& storage );
+                      SheetFlat( dword          width,
+                                 dword          height,
+                                 dword          rowAlignment = 0,
+                                 const STORAGE& storage = STORAGE() );
+                      SheetFlat( TYPE*          pStorage,
+                                 dword          width,
+                                 dword          height,
+                                 bool           isAdopt,
+                                 const STORAGE& storage = STORAGE() );
+
+                     ~SheetFlat();
+                      SheetFlat( const SheetFlat& );
+           SheetFlat& operator=( const SheetFlat& );
+#if __cplusplus >= 201103L
+                      SheetFlat( SheetFlat&& )                       noexcept;
+           SheetFlat& operator=( SheetFlat&& )                       noexcept;
+#endif
+
+
+/// commands -------------------------------------------------------------------
+           void   setSize( dword width,
+                           dword height,
+                           dword rowAlignment = 0 );
+           void   setStorage( TYPE* pStorage,
+                              dword width,
+                              dword height,
+                              bool  isAdopt );
+
+           void   swap( SheetFlat& );
+
+           void   zeroStorage();
+
+           TYPE*  getStorage();
+           TYPE*  getRow( dword y );
+
+           TYPE&  getElement( dword x,
+                              dword y );
+           TYPE&  get( dword x,
+                       dword y );
+   template<class WRAP>
+           TYPE&  getWrapped( dword x,
+                              dword y );
+
+           TYPE&  getElement( dword i );
+           TYPE&  operator[]( int i );
+
+
+/// queries --------------------------------------------------------------------
+           dword  getLength()                                             const;
+           dword  getWidth()                                              const;
+           dword  getHeight()                                             const;
+           dword  getStride()                                             const;
+           bool   isOwning()                                              const;
+           const STORAGE& getStoragePolicy()                              const;
+
+   static  bool   isSizeWithinRange( dword width,
+                                     dword height );
+   static  dword  getMaxSize();
+   static  dword  getAlignedStride( dword width,
+                                    dword rowAlignment );
+
+           bool   isInRange( dword x,
+                             dword y )                                    const;
+
+           const TYPE* getStorage()                                       const;
+           const TYPE* getRow( dword y )                                  const;
+
+           const TYPE& getElement( dword x,
+                                   dword y )                              const;
+           const TYPE& get( dword x,
+                            dword y )                                     const;
+   template<class WRAP>
+           const TYPE& getWrapped( dword x,
+                                   dword y )                              const;
+
+           const TYPE& getElement( dword i )                              const;
+           const TYPE& operator[]( int i )                                const;
+
+           SheetFlat*  clone()                                            const;
+
+
+/// implementation -------------------------------------------------------------
+private:
+           void   assign( const SheetFlat<TYPE, STORAGE>& );
+
+
+/// fields ---------------------------------------------------------------------
+private:
+   ArrayFlat<TYPE, STORAGE> array_m;
+
+   dword           width_m;
+   dword           height_m;
+   dword           stride_m;
+
+   static const char ALLOCATION_EXCEPTION_MESSAGE[];
+   static const char SIZE_EXCEPTION_MESSAGE[];
+};
+
+
+
+
+/**
+ * Make a SheetFlat owning orphaned storage (from new[]), returned by value.
+ * <br/><br/>
+ *
+ * The elements are never copied: C++11 moves the result out, C++98 relies on
+ * return value optimization.
+ */
+template<class TYPE>
+SheetFlat<TYPE> adoptSheetFlat
+(
+   TYPE* pStorage,
+   dword width,
+   dword height
+);
+
+
+
+
+
+
+
+
+template<class TYPE1, class STORAGE1, class TYPE2, class STORAGE2>
+bool isSameSize
+(
+   const SheetFlat<TYPE1, STORAGE1>&,
+   const SheetFlat<TYPE2, STORAGE2>&
+);
+
+
+
+
+
+
+
+
+/// statics --------------------------------------------------------------------
+template<class TYPE, class STORAGE>
+const char SheetFlat<TYPE, STORAGE>::ALLOCATION_EXCEPTION_MESSAGE[] =
+   "SheetFlat<>::clone() - storage allocation failed";
+template<class TYPE, class STORAGE>
+const char SheetFlat<TYPE, STORAGE>::SIZE_EXCEPTION_MESSAGE[] =
+   "SheetFlat<>::setSize() - size outside range";
+
+
+
+
+/// standard object services ---------------------------------------------------
+template<class TYPE, class STORAGE>
+SheetFlat<TYPE, STORAGE>::SheetFlat()
+ : array_m ()
+ , width_m ( 0 )
+ , height_m( 0 )
+ , stride_m( 0 )
+{
+}
+
+
+template<class TYPE, class STORAGE>
+SheetFlat<TYPE, STORAGE>::SheetFlat
+(
+   const STORAGE& storage
+)
+ : array_m ( storage )
+ , width_m ( 0 )
+ , height_m( 0 )
+ , stride_m( 0 )
+{
+}
+
+
+template<class TYPE, class STORAGE>
+SheetFlat<TYPE, STORAGE>::SheetFlat
+(
+   const dword    width,
+   const dword    height,
+   const dword    rowAlignment,
+   const STORAGE& storage
+)
+ : array_m ( storage )
+ , width_m ( 0 )
+ , height_m( 0 )
+ , stride_m( 0 )
+{
+   SheetFlat<TYPE, STORAGE>::setSize( width, height, rowAlignment );
+}
+
+
+template<class TYPE, class STORAGE>
+SheetFlat<TYPE, STORAGE>::SheetFlat
+(
+   TYPE*const     pStorage,
+   const dword    width,
+   const dword    height,
+   const bool     isAdopt,
+   const STORAGE& storage
+)
+ : array_m ( storage )
+ , width_m ( 0 )
+ , height_m( 0 )
+ , stride_m( 0 )
+{
+   SheetFlat<TYPE, STORAGE>::setStorage( pStorage, width, height, isAdopt );
+}
+
+
+template<class TYPE, class STORAGE>
+SheetFlat<TYPE, STORAGE>::~SheetFlat()
+{
+}
+
+
+template<class TYPE, class STORAGE>
+SheetFlat<TYPE, STORAGE>::SheetFlat
+(
+   const SheetFlat<TYPE, STORAGE>& other
+)
+ : array_m ( other.array_m.getStoragePolicy() )
+ , width_m ( 0 )
+ , height_m( 0 )
+ , stride_m( 0 )
+{
+   SheetFlat<TYPE, STORAGE>::assign( other );
+}
+
+
+template<class TYPE, class STORAGE>
+SheetFlat<TYPE, STORAGE>& SheetFlat<TYPE, STORAGE>::operator=
+(
+   const SheetFlat<TYPE, STORAGE>& other
+)
+{
+   assign( other );
+
+   return *this;
+}
+
+
+#if __cplusplus >= 201103L
+template<class TYPE, class STORAGE>
+SheetFlat<TYPE, STORAGE>::SheetFlat
+(
+   SheetFlat<TYPE, STORAGE>&& other
+) noexcept
+ : array_m ( std::move( other.array_m ) )
+ , width_m ( other.width_m )
+ , height_m( other.height_m )
+ , stride_m( other.stride_m )
+{
+   other.width_m  = 0;
+   other.height_m = 0;
+   other.stride_m = 0;
+}
+
+
+template<class TYPE, class STORAGE>
+SheetFlat<TYPE, STORAGE>& SheetFlat<TYPE, STORAGE>::operator=
+(
+   SheetFlat<TYPE, STORAGE>&& other
+) noexcept
+{
+   // take other's, leaving it empty (with its own policy, as move construct
+   // does), and free the old at scope end
+   SheetFlat<TYPE, STORAGE> old( other.getStoragePolicy() );
+   old.swap( other );
+   swap( old );
+
+   return *this;
+}
+#endif
+
+
+
+
+/// commands -------------------------------------------------------------------
+template<class TYPE, class STORAGE>
+void SheetFlat<TYPE, STORAGE>::setSize
+(
+   const dword width,
+   const dword height,
+   const dword rowAlignment
+)
+{
+   const dword stride = isSizeWithinRange( width, height ) ?
+      getAlignedStride( width, rowAlignment ) : -1;
+   if( !isSizeWithinRange( stride, height ) )
+   {
+      throw SIZE_EXCEPTION_MESSAGE;
+   }
+
+   array_m.setLength( stride * height );
+
+   width_m  = width;
+   height_m = height;
+   stride_m = stride;
+}
+
+
+template<class TYPE, class STORAGE>
+void SheetFlat<TYPE, STORAGE>::setStorage
+(
+   TYPE*const  pStorage,
+   const dword width,
+   const dword height,
+   const bool  isAdopt
+)
+{
+   if( !isSizeWithinRange( width, height ) )
+   {
+      throw SIZE_EXCEPTION_MESSAGE;
+   }
+
+   array_m.setStorage( pStorage, width * height, isAdopt );
+
+   width_m  = width;
+   height_m = height;
+   stride_m = width;
+}
+
+
+template<class TYPE, class STORAGE>
+void SheetFlat<TYPE, STORAGE>::swap
+(
+   SheetFlat<TYPE, STORAGE>& other
+)
+{
+   array_m.swap( other.array_m );
+
+   const dword tmpW = width_m;
+   width_m          = other.width_m;
+   other.width_m    = tmpW;
+
+   const dword tmpH = height_m;
+   height_m         = other.height_m;
+   other.height_m   = tmpH;
+
+   const dword tmpS = stride_m;
+   stride_m         = other.stride_m;
+   other.stride_m   = tmpS;
+}
+
+
+template<class TYPE, class STORAGE>
+void SheetFlat<TYPE, STORAGE>::zeroStorage()
+{
+   array_m.zeroStorage();
+}
+
+
+template<class TYPE, class STORAGE>
+inline
+TYPE* SheetFlat<TYPE, STORAGE>::getStorage()
+{
+   return array_m.getStorage();
+}
+
+
+template<class TYPE, class STORAGE>
+inline
+TYPE* SheetFlat<TYPE, STORAGE>::getRow
+(
+   dword y
+)
+{
+   y = (y >= 0) ? y : -y;
+   return array_m.getStorage() + (WrapRepeat::index( y, height_m ) * stride_m);
+}
+
+
+template<class TYPE, class STORAGE>
+inline
+TYPE& SheetFlat<TYPE, STORAGE>::getElement
+(
+   const dword x,
+   const dword y
+)
+{
+   return array_m.get( x + (y * stride_m) );
+}
+
+
+template<class TYPE, class STORAGE>
+inline
+TYPE& SheetFlat<TYPE, STORAGE>::get
+(
+   const dword x,
+   const dword y
+)
+{
+   return array_m[ x + (y * stride_m) ];
+}
+
+
+template<class TYPE, class STORAGE>
+template<class WRAP>
+inline
+TYPE& SheetFlat<TYPE, STORAGE>::getWrapped
+(
+   const dword x,
+   const dword y
+)
+{
+   return array_m[ WRAP::index( x, width_m ) +
+      (WRAP::index( y, height_m ) * stride_m) ];
+}
+
+
+template<class TYPE, class STORAGE>
+inline
+TYPE& SheetFlat<TYPE, STORAGE>::getElement
+(
+   const dword i
+)
+{
+   return array_m.get( i );
+}
+
+
+template<class TYPE, class STORAGE>
+inline
+TYPE& SheetFlat<TYPE, STORAGE>::operator[]
+(
+   const int i
+)
+{
+   return array_m[ i ];
+}
+
+
+
+
+/// queries --------------------------------------------------------------------
+template<class TYPE, class STORAGE>
+inline
+dword SheetFlat<TYPE, STORAGE>::getLength() const
+{
+   return array_m.getLength();
+}
+
+
+template<class TYPE, class STORAGE>
+inline
+dword SheetFlat<TYPE, STORAGE>::getWidth() const
+{
+   return width_m;
+}
+
+
+template<class TYPE, class STORAGE>
+inline
+dword SheetFlat<TYPE, STORAGE>::getHeight() const
+{
+   return height_m;
+}
+
+
+template<class TYPE, class STORAGE>
+inline
+dword SheetFlat<TYPE, STORAGE>::getStride() const
+{
+   return stride_m;
+}
+
+
+template<class TYPE, class STORAGE>
+inline
+bool SheetFlat<TYPE, STORAGE>::isOwning() const
+{
+   return array_m.isOwning();
+}
+
+
+template<class TYPE, class STORAGE>
+inline
+const STORAGE& SheetFlat<TYPE, STORAGE>::getStoragePolicy() const
+{
+   return array_m.getStoragePolicy();
+}
+
+
+template<class TYPE, class STORAGE>
+bool SheetFlat<TYPE, STORAGE>::isSizeWithinRange
+(
+   const dword width,
+   const dword height
+)
+{
+   bool isWithin = true;
+
+   // is negative ?
+   if( (width < 0) | (height < 0) )
+   {
+      isWithin = false;
+   }
+   else if( height != 0 )   // prevent divide by zero
+   {
+      // is the total number of elements greater than max length ?
+      if( width > (getMaxSize() / height) )
+      {
+         isWithin = false;
+      }
+   }
+
+   return isWithin;
+}
+
+
+template<class TYPE, class STORAGE>
+inline
+dword SheetFlat<TYPE, STORAGE>::getMaxSize()
+{
+   return ArrayFlat<TYPE, STORAGE>::getMaxLength();
+}
+
+
+template<class TYPE, class STORAGE>
+dword SheetFlat<TYPE, STORAGE>::getAlignedStride
+(
+   const dword width,
+   const dword rowAlignment
+)
+{
+   dword stride = width;
+
+   if( (rowAlignment > 0) & (width > 0) )
+   {
+      // step: smallest element count that is a whole number of alignments
+      dword a = rowAlignment;
+      dword b = static_cast<dword>(sizeof(TYPE));
+      while( 0 != b )
+      {
+         const dword t = a % b;
+         a = b;
+         b = t;
+      }
+      const dword step = rowAlignment / a;
+
+      // round up to step (or overflow to negative, so out of range)
+      const dword extra = (width % step) ? (step - (width % step)) : 0;
+      stride = (width <= (getMaxSize() - extra)) ? (width + extra) : -1;
+   }
+
+   return stride;
+}
+
+
+template<class TYPE, class STORAGE>
+bool SheetFlat<TYPE, STORAGE>::isInRange
+(
+   const dword x,
+   const dword y
+) const
+{
+   return (x >= 0) && (x < width_m) && (y >= 0) && (y < height_m);
+}
+
+
+template<class TYPE, class STORAGE>
+inline
+const TYPE* SheetFlat<TYPE, STORAGE>::getStorage() const
+{
+   return array_m.getStorage();
+}
+
+
+template<class TYPE, class STORAGE>
+inline
+const TYPE* SheetFlat<TYPE, STORAGE>::getRow
+(
+   dword y
+) const
+{
+   y = (y >= 0) ? y : -y;
+   return array_m.getStorage() + (WrapRepeat::index( y, height_m ) * stride_m);
+}
+
+
+template<class TYPE, class STORAGE>
+inline
+const TYPE& SheetFlat<TYPE, STORAGE>::getElement
+(
+   const dword x,
+   const dword y
+) const
+{
+   return array_m.get( x + (y * stride_m) );
+}
+
+
+template<class TYPE, class STORAGE>
+inline
+const TYPE& SheetFlat<TYPE, STORAGE>::get
+(
+   const dword x,
+   const dword y
+) const
+{
+   return array_m[ x + (y * stride_m) ];
+}
+
+
+template<class TYPE, class STORAGE>
+template<class WRAP>
+inline
+const TYPE& SheetFlat<TYPE, STORAGE>::getWrapped
+(
+   const dword x,
+   const dword y
+) const
+{
+   return array_m[ WRAP::index( x, width_m ) +
+      (WRAP::index( y, height_m ) * stride_m) ];
+}
+
+
+template<class TYPE, class STORAGE>
+inline
+const TYPE& SheetFlat<TYPE, STORAGE>::getElement
+(
+   const dword i
+) const
+{
+   return array_m.get( i );
+}
+
+
+template<class TYPE, class STORAGE>
+inline
+const TYPE& SheetFlat<TYPE, STORAGE>::operator[]
+(
+   const int i
+) const
+{
+   return array_m[ i ];
+}
+
+
+template<class TYPE1, class STORAGE1, class TYPE2, class STORAGE2>
+bool isSameSize
+(
+   const SheetFlat<TYPE1, STORAGE1>& first,
+   const SheetFlat<TYPE2, STORAGE2>& second
+)
+{
+   return (first.getWidth()  == second.getWidth()) &
+          (first.getHeight() == second.getHeight());
+}
+
+
+template<class TYPE, class STORAGE>
+SheetFlat<TYPE, STORAGE>* SheetFlat<TYPE, STORAGE>::clone() const
+{
+   SheetFlat<TYPE, STORAGE>* pClone = new SheetFlat<TYPE, STORAGE>( *this );
+   if( 0 == pClone )
+   {
+      throw ALLOCATION_EXCEPTION_MESSAGE;
+   }
+
+   return  pClone;
+}
+
+
+
+
+/// implementation -------------------------------------------------------------
+template<class TYPE, class STORAGE>
+void SheetFlat<TYPE, STORAGE>::assign
+(
+   const SheetFlat<TYPE, STORAGE>& other
+)
+{
+   array_m  = other.array_m;
+
+   width_m  = other.width_m;
+   height_m = other.height_m;
+   stride_m = other.stride_m;
+}
+
+
+
+
+/// other ----------------------------------------------------------------------
+template<class TYPE>
+SheetFlat<TYPE> adoptSheetFlat
+(
+   TYPE*const  pStorage,
+   const dword width,
+   const dword height
+)
+{
+   SheetFlat<TYPE> sheet( pStorage, width, height, true );
+
+   return sheet;
+}
+
+
+}//namespace
+
+
+
+
+#endif//SheetFlat_h
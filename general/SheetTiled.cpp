@@ -0,0 +1,393 @@
+/*------------------------------------------------------------------------------
+
+   HXA7241 General library.
+   Copyright (c) 2004-2007,  Harrison Ainsworth / HXA7241.
+
+   http://www.hxa7241.org/
+
+------------------------------------------------------------------------------*/
+
+
+#include "SheetTiled.hpp"
+
+
+using namespace hxa7241_general;
+
+
+
+
+
+
+
+
+/// test -----------------------------------------------------------------------
+#ifdef TESTING
+
+
+#include <ostream>
+
+#include "Array.hpp"
+#include "Storage.hpp"
+#include "Stopwatch.hpp"
+
+
+namespace
+{
+
+/// index mapping, tiles, conversion, and element access, for one layout
+template<class LAYOUT>
+bool testLayout
+(
+   std::ostream* pOut,
+   const bool    isVerbose,
+   const char    name[]
+)
+{
+   bool is = true;
+
+   static const dword SIZES[][2] = { {1, 1}, {7, 13}, {8, 8}, {33, 9},
+      {64, 64}, {100, 3}, {3, 100}, {130, 70} };
+
+   const dword count = static_cast<dword>(sizeof(SIZES) / sizeof(SIZES[0]));
+   for( dword s = 0;  s < count;  ++s )
+   {
+      const dword width  = SIZES[s][0];
+      const dword height = SIZES[s][1];
+
+      SheetTiled<dword, LAYOUT> tiled( width, height );
+      is &= (width == tiled.getWidth()) & (height == tiled.getHeight());
+      is &= (tiled.getLength() >= width * height);
+
+      // every element in a distinct place within storage
+      {
+         Array<bool> isUsed( tiled.getLength() );
+         for( dword i = 0;  i < isUsed.getLength();  ++i )
+         {
+            isUsed[i] = false;
+         }
+         for( dword y = 0;  y < height;  ++y )
+         {
+            for( dword x = 0;  x < width;  ++x )
+            {
+               const dword i = static_cast<dword>(&tiled.get( x, y ) -
+                  tiled.getStorage());
+               is &= (i >= 0) && (i < tiled.getLength()) && !isUsed[i];
+               if( (i >= 0) & (i < tiled.getLength()) )
+               {
+                  isUsed[i] = true;
+               }
+            }
+         }
+      }
+
+      // tiles cover the sheet, contiguous
+      {
+         const dword size = tiled.getTileSize();
+         is &= (tiled.getTilesAcross() * size >= width) &
+            (tiled.getTilesDown() * size >= height);
+
+         for( dword ty = 0;  ty < tiled.getTilesDown();  ++ty )
+         {
+            for( dword tx = 0;  tx < tiled.getTilesAcross();  ++tx )
+            {
+               const dword* pTile = tiled.getTile( tx, ty );
+               for( dword v = 0;  v < size;  ++v )
+               {
+                  for( dword u = 0;  u < size;  ++u )
+                  {
+                     const dword i = tiled.getIndexInTile( u, v );
+                     is &= (i >= 0) & (i < size * size);
+                     is &= (pTile + i == &tiled.get( tx * size + u,
+                        ty * size + v ));
+                  }
+               }
+            }
+         }
+      }
+
+      // conversion round trip, with padded rows
+      {
+         SheetFlat<dword> rows( width, height, 16 );
+         for( dword y = 0;  y < height;  ++y )
+         {
+            for( dword x = 0;  x < width;  ++x )
+            {
+               rows.get( x, y ) = (y * 1000) + x;
+            }
+         }
+
+         SheetTiled<dword, LAYOUT> t;
+         copyToTiled( rows, t );
+         for( dword y = 0;  y < height;  ++y )
+         {
+            for( dword x = 0;  x < width;  ++x )
+            {
+               is &= ((y * 1000) + x == t.get( x, y ));
+            }
+         }
+
+         SheetFlat<dword> back;
+         copyToRows( t, back );
+         is &= isSameSize( rows, back );
+         for( dword y = 0;  y < height;  ++y )
+         {
+            for( dword x = 0;  x < width;  ++x )
+            {
+               is &= (rows.get( x, y ) == back.get( x, y ));
+            }
+         }
+
+         // element access wraps as SheetFlat
+         for( dword y = -3;  y < height + 3;  ++y )
+         {
+            for( dword x = -3;  x < width + 3;  ++x )
+            {
+               is &= (t.template getWrapped<WrapMirror>( x, y ) ==
+                  rows.getWrapped<WrapMirror>( x, y ));
+               is &= (t.template getWrapped<WrapClamp>( x, y ) ==
+                  rows.getWrapped<WrapClamp>( x, y ));
+               is &= (t.getElement( x, y ) ==
+                  rows.getWrapped<WrapRepeat>( x, y ));
+            }
+         }
+      }
+   }
+
+   if( pOut && isVerbose ) *pOut << name << "  " << is << "\n";
+
+   return is;
+}
+
+
+/// hash down each column (order-dependent, so the loops cannot be swapped)
+template<class SHEET>
+udword walkColumns
+(
+   const SHEET& sheet
+)
+{
+   udword sum = 0;
+
+   for( dword x = 0;  x < sheet.getWidth();  ++x )
+   {
+      for( dword y = 0;  y < sheet.getHeight();  ++y )
+      {
+         sum = (sum * 3u) + sheet.get( x, y );
+      }
+   }
+
+   return sum;
+}
+
+
+/// sum 5x5 neighbourhoods over the interior
+template<class SHEET>
+udword sumNeighbourhoods
+(
+   const SHEET& sheet
+)
+{
+   udword sum = 0;
+
+   for( dword y = 2;  y < sheet.getHeight() - 2;  ++y )
+   {
+      for( dword x = 2;  x < sheet.getWidth() - 2;  ++x )
+      {
+         for( dword j = -2;  j <= 2;  ++j )
+         {
+            for( dword i = -2;  i <= 2;  ++i )
+            {
+               sum += sheet.get( x + i, y + j );
+            }
+         }
+      }
+   }
+
+   return sum;
+}
+
+
+template<class SHEET>
+void benchmarkOne
+(
+   std::ostream& out,
+   const SHEET&  sheet,
+   const char    name[]
+)
+{
+   const double pixels = static_cast<double>(sheet.getWidth()) *
+      static_cast<double>(sheet.getHeight());
+
+   Stopwatch stopwatch;
+   const udword sumColumns = walkColumns( sheet );
+   const double timeColumns = stopwatch.getSeconds();
+
+   stopwatch.start();
+   const udword sumBlocks = sumNeighbourhoods( sheet );
+   const double timeBlocks = stopwatch.getSeconds();
+
+   out << "   " << name << "  column walk " << (timeColumns * 1e9 / pixels) <<
+      " ns  5x5 " << (timeBlocks * 1e9 / pixels) << " ns  (sums " <<
+      sumColumns << " " << sumBlocks << ")\n";
+}
+
+
+void benchmarkLayouts
+(
+   std::ostream& out
+)
+{
+   static const dword SIZE = 2048;
+
+   SheetFlat<udword> rows( SIZE, SIZE );
+   for( dword i = rows.getLength();  i-- > 0; )
+   {
+      rows[i] = static_cast<udword>(i);
+   }
+
+   SheetTiled<udword, LayoutTiles<3> > tiles8;
+   SheetTiled<udword, LayoutTiles<5> > tiles32;
+   SheetTiled<udword, LayoutMorton>    morton;
+   copyToTiled( rows, tiles8 );
+   copyToTiled( rows, tiles32 );
+   copyToTiled( rows, morton );
+
+   out << "benchmark  " << SIZE << " x " << SIZE << "  (per pixel)\n";
+   benchmarkOne( out, rows,    "rows     " );
+   benchmarkOne( out, tiles8,  "tiles 8  " );
+   benchmarkOne( out, tiles32, "tiles 32 " );
+   benchmarkOne( out, morton,  "morton   " );
+   out << "\n";
+}
+
+}
+
+
+namespace hxa7241_general
+{
+
+
+bool test_SheetTiled
+(
+   std::ostream* pOut,
+   const bool    isVerbose,
+   const dword   //seed
+)
+{
+   bool isOk = true;
+
+   if( pOut ) *pOut << "[ test_SheetTiled ]\n\n";
+
+
+   // layouts
+   {
+      bool is = true;
+
+      is &= testLayout< LayoutTiles<3> >( pOut, isVerbose, "tiles 8" );
+      is &= testLayout< LayoutTiles<5> >( pOut, isVerbose, "tiles 32" );
+      is &= testLayout< LayoutMorton >( pOut, isVerbose, "morton" );
+
+      // padding
+      is &= (8 == LayoutTiles<3>::pad( 1 )) & (16 == LayoutTiles<3>::pad( 9 ));
+      is &= (8 == LayoutMorton::pad( 3 )) & (128 == LayoutMorton::pad( 100 ));
+      is &= (0x40000000 == LayoutMorton::pad( 0x3FFFFFFF ));
+      is &= (-1 == LayoutMorton::pad( 0x40000001 ));
+      is &= (-1 == LayoutTiles<5>::pad( DWORD_MAX - 3 ));
+
+      // morton order
+      is &= (0 == LayoutMorton::index( 0, 0, 3 )) &
+         (1 == LayoutMorton::index( 1, 0, 3 )) &
+         (2 == LayoutMorton::index( 0, 1, 3 )) &
+         (3 == LayoutMorton::index( 1, 1, 3 )) &
+         (4 == LayoutMorton::index( 2, 0, 3 )) &
+         (64 == LayoutMorton::index( 8, 0, 3 ));
+
+      if( pOut && isVerbose ) *pOut << "\n";
+
+      if( pOut ) *pOut << "layouts : " <<
+         (is ? "--- succeeded" : "*** failed") << "\n\n";
+
+      isOk &= is;
+   }
+
+   // object services
+   {
+      bool is = true;
+
+      SheetTiled<float, LayoutTiles<3>, StorageAligned<64> > a( 20, 10 );
+      a.zeroStorage();
+      a.get( 19, 9 ) = 5.0f;
+      is &= isAligned( a.getStorage(), 64 );
+
+      // copy
+      SheetTiled<float, LayoutTiles<3>, StorageAligned<64> > b( a );
+      is &= (5.0f == b.get( 19, 9 )) & (0.0f == b.get( 0, 0 ));
+      is &= (a.getStorage() != b.getStorage());
+
+      // swap
+      SheetTiled<float, LayoutTiles<3>, StorageAligned<64> > c( 3, 3 );
+      c.swap( b );
+      is &= (20 == c.getWidth()) & (3 == b.getWidth()) &
+         (5.0f == c.get( 19, 9 ));
+
+      // assign, resize
+      b = a;
+      is &= (10 == b.getHeight()) & (5.0f == b.getElement( -1, -1 ));
+      b.setSize( 0, 7 );
+      is &= (0 == b.getLength()) & (0 == b.getTilesAcross());
+
+#if __cplusplus >= 201103L
+      // move assign, leaving the source with its own policy
+      {
+         Pool pool1;
+         Pool pool2;
+         SheetTiled<float, LayoutTiles<3>, StoragePool> d( 20, 10,
+            StoragePool( &pool1 ) );
+         SheetTiled<float, LayoutTiles<3>, StoragePool> e( 3, 3,
+            StoragePool( &pool2 ) );
+         e = std::move( d );
+         is &= (20 == e.getWidth()) & (0 == d.getWidth()) &
+            (&pool1 == e.getStoragePolicy().getPool()) &
+            (&pool1 == d.getStoragePolicy().getPool());
+      }
+#endif
+
+      // size range
+      is &= SheetTiled<float>::isSizeWithinRange( 100, 100 );
+      is &= !SheetTiled<float>::isSizeWithinRange( -1, 100 );
+      is &= !SheetTiled<float, LayoutMorton>::isSizeWithinRange(
+         0x20000000, 0x20000000 );
+      bool isThrown = false;
+      try
+      {
+         b.setSize( 0x20000000, 0x20000000 );
+      }
+      catch( const char* )
+      {
+         isThrown = true;
+      }
+      is &= isThrown;
+
+      if( pOut ) *pOut << "object services : " <<
+         (is ? "--- succeeded" : "*** failed") << "\n\n";
+
+      isOk &= is;
+   }
+
+   if( pOut && isVerbose ) benchmarkLayouts( *pOut );
+
+
+   if( pOut ) *pOut << (isOk ? "--- successfully" : "*** failurefully") <<
+      " completed " << "\n\n\n";
+
+   if( pOut ) pOut->flush();
+
+
+   return isOk;
+}
+
+
+}//namespace
+
+
+#endif//TESTING
@@ -0,0 +1,903 @@
+/*------------------------------------------------------------------------------
+
+   HXA7241 General library.
+   Copyright (c) 2004-2007,  Harrison Ainsworth / HXA7241.
+
+   http://www.hxa7241.org/
+
+------------------------------------------------------------------------------*/
+
+
+#ifndef SheetTiled_h
+#define SheetTiled_h
+
+
+#if __cplusplus >= 201103L
+#include <utility>
+#endif
+
+#include "ArrayFlat.hpp"
+#include "SheetFlat.hpp"
+
+
+
+
+#include "hxa7241_general.hpp"
+namespace hxa7241_general
+{
+
+
+/**
+ * Storage layouts, for the LAYOUT template parameter of SheetTiled.<br/><br/>
+ *
+ * * LayoutTiles<LOG2_SIZE> -- square tiles of 2 ^ LOG2_SIZE (3 for 8x8, 5 for
+ *   32x32), rows within each tile, tiles in rows<br/>
+ * * LayoutMorton -- Z-order (bits of x and y interleaved) over the whole
+ *   sheet<br/><br/>
+ *
+ * Each has static members:<br/>
+ * * TILE_LOG2 -- log2 of the tile size<br/>
+ * * pad( size ) -- a dimension rounded up to what the layout needs (-1 if
+ *   too big)<br/>
+ * * getPitch( paddedWidth, paddedHeight ) -- constant for index<br/>
+ * * index( x, y, pitch ) -- storage position of (x, y)<br/>
+ * * indexInTile( u, v ) -- position of (u, v) from its tile's start<br/><br/>
+ *
+ * No division: only shifts, masks, adds, and one multiply (tiles).
+ */
+template<dword LOG2_SIZE>
+class LayoutTiles
+{
+public:
+   static const dword TILE_LOG2 = LOG2_SIZE;
+
+   static dword pad( dword size );
+   static dword getPitch( dword paddedWidth,
+                          dword paddedHeight );
+   static dword index( dword x,
+                       dword y,
+                       dword pitch );
+   static dword indexInTile( dword u,
+                             dword v );
+};
+
+
+/**
+ * Dimensions are padded to powers of two (at least 8). For non-square
+ * sheets, the longer dimension continues as a row (or column) of Z-ordered
+ * squares.
+ */
+class LayoutMorton
+{
+public:
+   static const dword TILE_LOG2 = 3;
+
+   static dword pad( dword size );
+   static dword getPitch( dword paddedWidth,
+                          dword paddedHeight );
+   static dword index( dword x,
+                       dword y,
+                       dword pitch );
+   static dword indexInTile( dword u,
+                             dword v );
+
+   /** bits moved to the even positions (low 16 bits of i). */
+   static udword spreadBits( dword i );
+};
+
+
+
+
+/**
+ * 2D array in a cache-friendly layout: tiled or Z-ordered, rather than row
+ * by row.<br/><br/>
+ *
+ * For vertical and 2D-neighbourhood access (filter kernels, mip generation,
+ * rotations): nearby elements in both directions are nearby in memory, so
+ * large sheets miss the cache much less. But each access computes its index
+ * (shifts, masks, adds -- more for Morton), so row-wise loops, and kernels
+ * that vectorize along rows, are faster in row-major.<br/><br/>
+ *
+ * Element access is as SheetFlat: getElement wraps around (each axis),
+ * get is unchecked, getWrapped wraps by the given mode. There are no row
+ * pointers -- rows are not contiguous.<br/><br/>
+ *
+ * Tile iteration: the sheet is covered by getTilesAcross by getTilesDown
+ * tiles, each getTileSize square, and contiguous in storage. Element (u, v) of
+ * tile (tx, ty) is getTile( tx, ty )[ getIndexInTile( u, v ) ]. Tiles at the
+ * right and bottom edges extend into padding (elements beyond width and
+ * height, which are storage but not content).<br/><br/>
+ *
+ * copyToTiled and copyToRows convert to and from row-major (SheetFlat),
+ * tile by tile.<br/><br/>
+ *
+ * setSize does not keep contents in place. Copying, moving, swapping,
+ * exceptions and STORAGE are as for SheetFlat.
+ *
+ * @see SheetFlat -- the row-major version.
+ *
+ * @implementation
+ * Storage is an ArrayFlat of the padded size. LAYOUT maps (x, y) to an index,
+ * with a per-size constant (the pitch) computed once by setSize.
+ */
+template<class TYPE, class LAYOUT = LayoutTiles<3>, class STORAGE = StorageNew>
+class SheetTiled
+{
+/// standard object services ---------------------------------------------------
+public:
+                       SheetTiled();
+   explicit            SheetTiled( const STORAGE& storage );
+                       SheetTiled( dword          width,
+                                   dword          height,
+                                   const STORAGE& storage = STORAGE() );
+
+                      ~SheetTiled();
+                       SheetTiled( const SheetTiled& );
+           SheetTiled& operator=( const SheetTiled& );
+#if __cplusplus >= 201103L
+                       SheetTiled( SheetTiled&& )                    noexcept;
+           SheetTiled& operator=( SheetTiled&& )                     noexcept;
+#endif
+
+
+/// commands -------------------------------------------------------------------
+           void   setSize( dword width,
+                           dword height );
+           void   swap( SheetTiled& );
+
+           void   zeroStorage();
+
+           TYPE*  getStorage();
+
+           TYPE&  getElement( dword x,
+                              dword y );
+           TYPE&  get( dword x,
+                       dword y );
+   template<class WRAP>
+           TYPE&  getWrapped( dword x,
+                              dword y );
+
+           TYPE*  getTile( dword tx,
+                           dword ty );
+
+
+/// queries --------------------------------------------------------------------
+           dword  getLength()                                             const;
+           dword  getWidth()                                              const;
+           dword  getHeight()                                             const;
+           bool   isOwning()                                              const;
+           const STORAGE& getStoragePolicy()                              const;
+
+           dword  getTilesAcross()                                        const;
+           dword  getTilesDown()                                          const;
+   static  dword  getTileSize();
+   static  dword  getIndexInTile( dword u,
+                                  dword v );
+
+   static  bool   isSizeWithinRange( dword width,
+                                     dword height );
+
+           bool   isInRange( dword x,
+                             dword y )                                    const;
+
+           const TYPE* getStorage()                                       const;
+
+           const TYPE& getElement( dword x,
+                                   dword y )                              const;
+           const TYPE& get( dword x,
+                            dword y )                                     const;
+   template<class WRAP>
+           const TYPE& getWrapped( dword x,
+                                   dword y )                              const;
+
+           const TYPE* getTile( dword tx,
+                                dword ty )                                const;
+
+
+/// fields ---------------------------------------------------------------------
+private:
+   ArrayFlat<TYPE, STORAGE> array_m;
+
+   dword           width_m;
+   dword           height_m;
+   dword           paddedWidth_m;
+   dword           paddedHeight_m;
+   dword           pitch_m;
+
+   static const char SIZE_EXCEPTION_MESSAGE[];
+};
+
+
+
+
+/**
+ * Copy row-major to tiled, setting the tiled's size.
+ */
+template<class TYPE, class STORAGE1, class LAYOUT, class STORAGE2>
+void copyToTiled
+(
+   const SheetFlat<TYPE, STORAGE1>&    rows,
+   SheetTiled<TYPE, LAYOUT, STORAGE2>& tiled
+);
+
+/**
+ * Copy tiled to row-major, setting the row-major's size (unpadded).
+ */
+template<class TYPE, class LAYOUT, class STORAGE1, class STORAGE2>
+void copyToRows
+(
+   const SheetTiled<TYPE, LAYOUT, STORAGE1>& tiled,
+   SheetFlat<TYPE, STORAGE2>&                rows
+);
+
+
+
+
+
+
+
+
+/// INLINES ///
+
+/// LayoutTiles ----------------------------------------------------------------
+template<dword LOG2_SIZE>
+inline
+dword LayoutTiles<LOG2_SIZE>::pad
+(
+   const dword size
+)
+{
+   const dword MASK = (1 << LOG2_SIZE) - 1;
+
+   return (size <= (DWORD_MAX - MASK)) ? ((size + MASK) & ~MASK) : -1;
+}
+
+
+template<dword LOG2_SIZE>
+inline
+dword LayoutTiles<LOG2_SIZE>::getPitch
+(
+   const dword paddedWidth,
+   const dword
+)
+{
+   // elements per row of tiles
+   return paddedWidth << LOG2_SIZE;
+}
+
+
+template<dword LOG2_SIZE>
+inline
+dword LayoutTiles<LOG2_SIZE>::index
+(
+   const dword x,
+   const dword y,
+   const dword pitch
+)
+{
+   const dword MASK = (1 << LOG2_SIZE) - 1;
+
+   return ((y >> LOG2_SIZE) * pitch) + ((x & ~MASK) << LOG2_SIZE) +
+      ((y & MASK) << LOG2_SIZE) + (x & MASK);
+}
+
+
+template<dword LOG2_SIZE>
+inline
+dword LayoutTiles<LOG2_SIZE>::indexInTile
+(
+   const dword u,
+   const dword v
+)
+{
+   return (v << LOG2_SIZE) + u;
+}
+
+
+
+
+/// LayoutMorton ---------------------------------------------------------------
+inline
+dword LayoutMorton::pad
+(
+   const dword size
+)
+{
+   dword padded = 1 << TILE_LOG2;
+   while( (padded < size) & (padded <= (DWORD_MAX >> 1)) )
+   {
+      padded <<= 1;
+   }
+
+   return (padded >= size) ? padded : -1;
+}
+
+
+inline
+dword LayoutMorton::getPitch
+(
+   const dword paddedWidth,
+   const dword paddedHeight
+)
+{
+   // log2 of the shorter side
+   const dword shorter = (paddedWidth < paddedHeight) ? paddedWidth :
+      paddedHeight;
+   dword log2 = 0;
+   while( (1 << log2) < shorter )
+   {
+      ++log2;
+   }
+
+   return log2;
+}
+
+
+inline
+dword LayoutMorton::index
+(
+   const dword x,
+   const dword y,
+   const dword pitch
+)
+{
+   const dword mask = (1 << pitch) - 1;
+
+   // interleave within the square, then squares along the longer side (one of
+   // the high parts is always zero)
+   return static_cast<dword>( spreadBits( x & mask ) |
+      (spreadBits( y & mask ) << 1) |
+      (static_cast<udword>((x >> pitch) | (y >> pitch)) << (pitch << 1)) );
+}
+
+
+inline
+dword LayoutMorton::indexInTile
+(
+   const dword u,
+   const dword v
+)
+{
+   return static_cast<dword>( spreadBits( u ) | (spreadBits( v ) << 1) );
+}
+
+
+inline
+udword LayoutMorton::spreadBits
+(
+   const dword i
+)
+{
+   udword b = static_cast<udword>(i) & 0x0000FFFFu;
+   b = (b | (b << 8)) & 0x00FF00FFu;
+   b = (b | (b << 4)) & 0x0F0F0F0Fu;
+   b = (b | (b << 2)) & 0x33333333u;
+   b = (b | (b << 1)) & 0x55555555u;
+
+   return b;
+}
+
+
+
+
+/// SheetTiled -----------------------------------------------------------------
+
+/// statics
+template<class TYPE, class LAYOUT, class STORAGE>
+const char SheetTiled<TYPE, LAYOUT, STORAGE>::SIZE_EXCEPTION_MESSAGE[] =
+   "SheetTiled<>::setSize() - size outside range";
+
+
+
+
+/// standard object services
+template<class TYPE, class LAYOUT, class STORAGE>
+SheetTiled<TYPE, LAYOUT, STORAGE>::SheetTiled()
+ : array_m       ()
+ , width_m       ( 0 )
+ , height_m      ( 0 )
+ , paddedWidth_m ( 0 )
+ , paddedHeight_m( 0 )
+ , pitch_m       ( 0 )
+{
+}
+
+
+template<class TYPE, class LAYOUT, class STORAGE>
+SheetTiled<TYPE, LAYOUT, STORAGE>::SheetTiled
+(
+   const STORAGE& storage
+)
+ : array_m       ( storage )
+ , width_m       ( 0 )
+ , height_m      ( 0 )
+ , paddedWidth_m ( 0 )
+ , paddedHeight_m( 0 )
+ , pitch_m       ( 0 )
+{
+}
+
+
+template<class TYPE, class LAYOUT, class STORAGE>
+SheetTiled<TYPE, LAYOUT, STORAGE>::SheetTiled
+(
+   const dword    width,
+   const dword    height,
+   const STORAGE& storage
+)
+ : array_m       ( storage )
+ , width_m       ( 0 )
+ , height_m      ( 0 )
+ , paddedWidth_m ( 0 )
+ , paddedHeight_m( 0 )
+ , pitch_m       ( 0 )
+{
+   SheetTiled<TYPE, LAYOUT, STORAGE>::setSize( width, height );
+}
+
+
+template<class TYPE, class LAYOUT, class STORAGE>
+SheetTiled<TYPE, LAYOUT, STORAGE>::~SheetTiled()
+{
+}
+
+
+template<class TYPE, class LAYOUT, class STORAGE>
+SheetTiled<TYPE, LAYOUT, STORAGE>::SheetTiled
+(
+   const SheetTiled<TYPE, LAYOUT, STORAGE>& other
+)
+ : array_m       ( other.array_m )
+ , width_m       ( other.width_m )
+ , height_m      ( other.height_m )
+ , paddedWidth_m ( other.paddedWidth_m )
+ , paddedHeight_m( other.paddedHeight_m )
+ , pitch_m       ( other.pitch_m )
+{
+}
+
+
+template<class TYPE, class LAYOUT, class STORAGE>
+SheetTiled<TYPE, LAYOUT, STORAGE>& SheetTiled<TYPE, LAYOUT, STORAGE>::operator=
+(
+   const SheetTiled<TYPE, LAYOUT, STORAGE>& other
+)
+{
+   if( &other != this )
+   {
+      array_m        = other.array_m;
+
+      width_m        = other.width_m;
+      height_m       = other.height_m;
+      paddedWidth_m  = other.paddedWidth_m;
+      paddedHeight_m = other.paddedHeight_m;
+      pitch_m        = other.pitch_m;
+   }
+
+   return *this;
+}
+
+
+#if __cplusplus >= 201103L
+template<class TYPE, class LAYOUT, class STORAGE>
+SheetTiled<TYPE, LAYOUT, STORAGE>::SheetTiled
+(
+   SheetTiled<TYPE, LAYOUT, STORAGE>&& other
+) noexcept
+ : array_m       ( std::move( other.array_m ) )
+ , width_m       ( other.width_m )
+ , height_m      ( other.height_m )
+ , paddedWidth_m ( other.paddedWidth_m )
+ , paddedHeight_m( other.paddedHeight_m )
+ , pitch_m       ( other.pitch_m )
+{
+   other.width_m        = 0;
+   other.height_m       = 0;
+   other.paddedWidth_m  = 0;
+   other.paddedHeight_m = 0;
+   other.pitch_m        = 0;
+}
+
+
+template<class TYPE, class LAYOUT, class STORAGE>
+SheetTiled<TYPE, LAYOUT, STORAGE>& SheetTiled<TYPE, LAYOUT, STORAGE>::operator=
+(
+   SheetTiled<TYPE, LAYOUT, STORAGE>&& other
+) noexcept
+{
+   // take other's, leaving it empty (with its own policy, as move construct
+   // does), and free the old at scope end
+   SheetTiled<TYPE, LAYOUT, STORAGE> old( other.getStoragePolicy() );
+   old.swap( other );
+   swap( old );
+
+   return *this;
+}
+#endif
+
+
+
+
+/// commands
+template<class TYPE, class LAYOUT, class STORAGE>
+void SheetTiled<TYPE, LAYOUT, STORAGE>::setSize
+(
+   const dword width,
+   const dword height
+)
+{
+   if( !isSizeWithinRange( width, height ) )
+   {
+      throw SIZE_EXCEPTION_MESSAGE;
+   }
+
+   // empty if either dimension is
+   const bool  isEmpty      = (0 == width) | (0 == height);
+   const dword paddedWidth  = isEmpty ? 0 : LAYOUT::pad( width );
+   const dword paddedHeight = isEmpty ? 0 : LAYOUT::pad( height );
+
+   array_m.setLength( paddedWidth * paddedHeight );
+
+   width_m        = width;
+   height_m       = height;
+   paddedWidth_m  = paddedWidth;
+   paddedHeight_m = paddedHeight;
+   pitch_m        = LAYOUT::getPitch( paddedWidth, paddedHeight );
+}
+
+
+template<class TYPE, class LAYOUT, class STORAGE>
+void SheetTiled<TYPE, LAYOUT, STORAGE>::swap
+(
+   SheetTiled<TYPE, LAYOUT, STORAGE>& other
+)
+{
+   array_m.swap( other.array_m );
+
+   const dword tmpW     = width_m;
+   width_m              = other.width_m;
+   other.width_m        = tmpW;
+
+   const dword tmpH     = height_m;
+   height_m             = other.height_m;
+   other.height_m       = tmpH;
+
+   const dword tmpPW    = paddedWidth_m;
+   paddedWidth_m        = other.paddedWidth_m;
+   other.paddedWidth_m  = tmpPW;
+
+   const dword tmpPH    = paddedHeight_m;
+   paddedHeight_m       = other.paddedHeight_m;
+   other.paddedHeight_m = tmpPH;
+
+   const dword tmpP     = pitch_m;
+   pitch_m              = other.pitch_m;
+   other.pitch_m        = tmpP;
+}
+
+
+template<class TYPE, class LAYOUT, class STORAGE>
+void SheetTiled<TYPE, LAYOUT, STORAGE>::zeroStorage()
+{
+   array_m.zeroStorage();
+}
+
+
+template<class TYPE, class LAYOUT, class STORAGE>
+inline
+TYPE* SheetTiled<TYPE, LAYOUT, STORAGE>::getStorage()
+{
+   return array_m.getStorage();
+}
+
+
+template<class TYPE, class LAYOUT, class STORAGE>
+inline
+TYPE& SheetTiled<TYPE, LAYOUT, STORAGE>::getElement
+(
+   const dword x,
+   const dword y
+)
+{
+   return getWrapped<WrapRepeat>( x, y );
+}
+
+
+template<class TYPE, class LAYOUT, class STORAGE>
+inline
+TYPE& SheetTiled<TYPE, LAYOUT, STORAGE>::get
+(
+   const dword x,
+   const dword y
+)
+{
+   return array_m.getStorage()[ LAYOUT::index( x, y, pitch_m ) ];
+}
+
+
+template<class TYPE, class LAYOUT, class STORAGE>
+template<class WRAP>
+inline
+TYPE& SheetTiled<TYPE, LAYOUT, STORAGE>::getWrapped
+(
+   const dword x,
+   const dword y
+)
+{
+   return array_m.getStorage()[ LAYOUT::index( WRAP::index( x, width_m ),
+      WRAP::index( y, height_m ), pitch_m ) ];
+}
+
+
+template<class TYPE, class LAYOUT, class STORAGE>
+inline
+TYPE* SheetTiled<TYPE, LAYOUT, STORAGE>::getTile
+(
+   const dword tx,
+   const dword ty
+)
+{
+   return array_m.getStorage() + LAYOUT::index( tx << LAYOUT::TILE_LOG2,
+      ty << LAYOUT::TILE_LOG2, pitch_m );
+}
+
+
+
+
+/// queries
+template<class TYPE, class LAYOUT, class STORAGE>
+inline
+dword SheetTiled<TYPE, LAYOUT, STORAGE>::getLength() const
+{
+   return array_m.getLength();
+}
+
+
+template<class TYPE, class LAYOUT, class STORAGE>
+inline
+dword SheetTiled<TYPE, LAYOUT, STORAGE>::getWidth() const
+{
+   return width_m;
+}
+
+
+template<class TYPE, class LAYOUT, class STORAGE>
+inline
+dword SheetTiled<TYPE, LAYOUT, STORAGE>::getHeight() const
+{
+   return height_m;
+}
+
+
+template<class TYPE, class LAYOUT, class STORAGE>
+inline
+bool SheetTiled<TYPE, LAYOUT, STORAGE>::isOwning() const
+{
+   return array_m.isOwning();
+}
+
+
+template<class TYPE, class LAYOUT, class STORAGE>
+inline
+const STORAGE& SheetTiled<TYPE, LAYOUT, STORAGE>::getStoragePolicy() const
+{
+   return array_m.getStoragePolicy();
+}
+
+
+template<class TYPE, class LAYOUT, class STORAGE>
+inline
+dword SheetTiled<TYPE, LAYOUT, STORAGE>::getTilesAcross() const
+{
+   return paddedWidth_m >> LAYOUT::TILE_LOG2;
+}
+
+
+template<class TYPE, class LAYOUT, class STORAGE>
+inline
+dword SheetTiled<TYPE, LAYOUT, STORAGE>::getTilesDown() const
+{
+   return paddedHeight_m >> LAYOUT::TILE_LOG2;
+}
+
+
+template<class TYPE, class LAYOUT, class STORAGE>
+inline
+dword SheetTiled<TYPE, LAYOUT, STORAGE>::getTileSize()
+{
+   return 1 << LAYOUT::TILE_LOG2;
+}
+
+
+template<class TYPE, class LAYOUT, class STORAGE>
+inline
+dword SheetTiled<TYPE, LAYOUT, STORAGE>::getIndexInTile
+(
+   const dword u,
+   const dword v
+)
+{
+   return LAYOUT::indexInTile( u, v );
+}
+
+
+template<class TYPE, class LAYOUT, class STORAGE>
+bool SheetTiled<TYPE, LAYOUT, STORAGE>::isSizeWithinRange
+(
+   const dword width,
+   const dword height
+)
+{
+   bool isWithin = true;
+
+   // is negative ?
+   if( (width < 0) | (height < 0) )
+   {
+      isWithin = false;
+   }
+   else if( (width != 0) & (height != 0) )
+   {
+      // is the padded number of elements greater than max length ?
+      const dword paddedWidth  = LAYOUT::pad( width );
+      const dword paddedHeight = LAYOUT::pad( height );
+      if( (paddedWidth < 0) | (paddedHeight < 0) ||
+         (paddedWidth > (ArrayFlat<TYPE, STORAGE>::getMaxLength() /
+         paddedHeight)) )
+      {
+         isWithin = false;
+      }
+   }
+
+   return isWithin;
+}
+
+
+template<class TYPE, class LAYOUT, class STORAGE>
+bool SheetTiled<TYPE, LAYOUT, STORAGE>::isInRange
+(
+   const dword x,
+   const dword y
+) const
+{
+   return (x >= 0) && (x < width_m) && (y >= 0) && (y < height_m);
+}
+
+
+template<class TYPE, class LAYOUT, class STORAGE>
+inline
+const TYPE* SheetTiled<TYPE, LAYOUT, STORAGE>::getStorage() const
+{
+   return array_m.getStorage();
+}
+
+
+template<class TYPE, class LAYOUT, class STORAGE>
+inline
+const TYPE& SheetTiled<TYPE, LAYOUT, STORAGE>::getElement
+(
+   const dword x,
+   const dword y
+) const
+{
+   return getWrapped<WrapRepeat>( x, y );
+}
+
+
+template<class TYPE, class LAYOUT, class STORAGE>
+inline
+const TYPE& SheetTiled<TYPE, LAYOUT, STORAGE>::get
+(
+   const dword x,
+   const dword y
+) const
+{
+   return array_m.getStorage()[ LAYOUT::index( x, y, pitch_m ) ];
+}
+
+
+template<class TYPE, class LAYOUT, class STORAGE>
+template<class WRAP>
+inline
+const TYPE& SheetTiled<TYPE, LAYOUT, STORAGE>::getWrapped
+(
+   const dword x,
+   const dword y
+) const
+{
+   return array_m.getStorage()[ LAYOUT::index( WRAP::index( x, width_m ),
+      WRAP::index( y, height_m ), pitch_m ) ];
+}
+
+
+template<class TYPE, class LAYOUT, class STORAGE>
+inline
+const TYPE* SheetTiled<TYPE, LAYOUT, STORAGE>::getTile
+(
+   const dword tx,
+   const dword ty
+) const
+{
+   return array_m.getStorage() + LAYOUT::index( tx << LAYOUT::TILE_LOG2,
+      ty << LAYOUT::TILE_LOG2, pitch_m );
+}
+
+
+
+
+/// other
+template<class TYPE, class STORAGE1, class LAYOUT, class STORAGE2>
+void copyToTiled
+(
+   const SheetFlat<TYPE, STORAGE1>&    rows,
+   SheetTiled<TYPE, LAYOUT, STORAGE2>& tiled
+)
+{
+   tiled.setSize( rows.getWidth(), rows.getHeight() );
+
+   const dword size = tiled.getTileSize();
+   for( dword ty = 0;  ty < tiled.getTilesDown();  ++ty )
+   {
+      for( dword tx = 0;  tx < tiled.getTilesAcross();  ++tx )
+      {
+         TYPE*const  pTile = tiled.getTile( tx, ty );
+         const dword x0    = tx * size;
+         const dword y0    = ty * size;
+         const dword xEnd  = (rows.getWidth()  - x0 < size) ?
+            rows.getWidth()  - x0 : size;
+         const dword yEnd  = (rows.getHeight() - y0 < size) ?
+            rows.getHeight() - y0 : size;
+
+         for( dword v = 0;  v < yEnd;  ++v )
+         {
+            const TYPE*const pRow = rows.getRow( y0 + v ) + x0;
+            for( dword u = 0;  u < xEnd;  ++u )
+            {
+               pTile[ tiled.getIndexInTile( u, v ) ] = pRow[u];
+            }
+         }
+      }
+   }
+}
+
+
+template<class TYPE, class LAYOUT, class STORAGE1, class STORAGE2>
+void copyToRows
+(
+   const SheetTiled<TYPE, LAYOUT, STORAGE1>& tiled,
+   SheetFlat<TYPE, STORAGE2>&                rows
+)
+{
+   rows.setSize( tiled.getWidth(), tiled.getHeight() );
+
+   const dword size = tiled.getTileSize();
+   for( dword ty = 0;  ty < tiled.getTilesDown();  ++ty )
+   {
+      for( dword tx = 0;  tx < tiled.getTilesAcross();  ++tx )
+      {
+         const TYPE*const pTile = tiled.getTile( tx, ty );
+         const dword      x0    = tx * size;
+         const dword      y0    = ty * size;
+         const dword      xEnd  = (tiled.getWidth()  - x0 < size) ?
+            tiled.getWidth()  - x0 : size;
+         const dword      yEnd  = (tiled.getHeight() - y0 < size) ?
+            tiled.getHeight() - y0 : size;
+
+         for( dword v = 0;  v < yEnd;  ++v )
+         {
+            TYPE*const pRow = rows.getRow( y0 + v ) + x0;
+            for( dword u = 0;  u < xEnd;  ++u )
+            {
+               pRow[u] = pTile[ tiled.getIndexInTile( u, v ) ];
+            }
+         }
+      }
+   }
+}
+
+
+}//namespace
+
+
+
+
+#endif//SheetTiled_h
@@ -0,0 +1,189 @@
+/*------------------------------------------------------------------------------
+
+   HXA7241 General library.
+   Copyright (c) 2004-2007,  Harrison Ainsworth / HXA7241.
+
+   http://www.hxa7241.org/
+
+------------------------------------------------------------------------------*/
+
+
+#include "SheetView.hpp"
+
+
+using namespace hxa7241_general;
+
+
+
+
+
+
+
+
+/// test -----------------------------------------------------------------------
+#ifdef TESTING
+
+
+#include <ostream>
+
+
+namespace hxa7241_general
+{
+
+
+bool test_SheetView
+(
+   std::ostream* pOut,
+   const bool    isVerbose,
+   const dword   //seed
+)
+{
+   bool isOk = true;
+
+   if( pOut ) *pOut << "[ test_SheetView ]\n\n";
+
+
+   // whole and sub views
+   {
+      bool is = true;
+
+      SheetFlat<dword> sheet( 13, 9, 32 );
+      for( dword y = 0;  y < sheet.getHeight();  ++y )
+      {
+         for( dword x = 0;  x < sheet.getWidth();  ++x )
+         {
+            sheet.get( x, y ) = (y * 100) + x;
+         }
+      }
+
+      // whole
+      const SheetView<dword> view( sheet );
+      is &= (13 == view.getWidth()) & (9 == view.getHeight()) &
+         (sheet.getStride() == view.getStride()) & !view.isEmpty();
+      is &= (view.getStorage() == sheet.getStorage());
+      is &= (&view.get( 12, 8 ) == &sheet.get( 12, 8 ));
+
+      // sub
+      const SheetView<dword> sub( view.getSubView( 2, 3, 8, 5 ) );
+      is &= (8 == sub.getWidth()) & (5 == sub.getHeight());
+      is &= (302 == sub.get( 0, 0 )) & (709 == sub.get( 7, 4 ));
+      is &= (sub.getRow( 1 ) == sheet.getRow( 4 ) + 2);
+
+      // nested, writing through
+      const SheetView<dword> subSub( sub.getSubView( 1, 1, 3, 2 ) );
+      is &= (403 == subSub.get( 0, 0 ));
+      subSub.get( 2, 1 ) = -1;
+      is &= (-1 == sheet.get( 5, 5 )) & (-1 == sub.get( 3, 2 ));
+
+      // wrapping within the view
+      is &= (subSub.getElement( 3, -1 ) == subSub.get( 0, 1 ));
+      is &= (subSub.getRow( -1 ) == subSub.getRow( 1 ));
+      is &= (subSub.getWrapped<WrapClamp>( 9, 9 ) == -1);
+      is &= (&subSub.getWrapped<WrapMirror>( -1, 2 ) == &subSub.get( 0, 1 ));
+
+      // clipping
+      const SheetView<dword> clipped( view.getSubView( -2, 7, 5, 10 ) );
+      is &= (3 == clipped.getWidth()) & (2 == clipped.getHeight()) &
+         (700 == clipped.get( 0, 0 ));
+      is &= view.getSubView( 13, 0, 4, 4 ).isEmpty();
+      is &= view.getSubView( 3, -5, 4, 5 ).isEmpty();
+      is &= view.getSubView( 3, 3, 0, 5 ).isEmpty();
+      is &= SheetView<dword>().getSubView( 0, 0, 1, 1 ).isEmpty();
+
+      if( pOut ) *pOut << "sub views : " <<
+         (is ? "--- succeeded" : "*** failed") << "\n\n";
+
+      isOk &= is;
+   }
+
+   // sources, and const
+   {
+      bool is = true;
+
+      // Sheet
+      Sheet<float> sheet( 4, 4 );
+      sheet.zeroStorage();
+      const SheetView<float> view( sheet );
+      view.get( 1, 2 ) = 3.0f;
+      is &= (3.0f == sheet.getElement( 1, 2 ));
+
+      // read-only, from const Sheet and from a writable view
+      const Sheet<float>&          constSheet = sheet;
+      const SheetView<const float> readOnly( constSheet );
+      const SheetView<const float> fromView( view.getSubView( 1, 1, 2, 2 ) );
+      is &= (3.0f == readOnly.get( 1, 2 )) & (3.0f == fromView.get( 0, 1 ));
+
+      // raw buffer
+      ubyte buffer[ 6 * 4 ];
+      for( dword i = 0;  i < 6 * 4;  ++i )
+      {
+         buffer[i] = static_cast<ubyte>(i);
+      }
+      const SheetView<ubyte> raw( buffer, 5, 4, 6 );
+      is &= (17 == raw.get( 5, 2 )) & (raw.getRow( 3 ) == buffer + 18);
+      is &= (14 == raw.getSubView( 1, 1, 3, 3 ).get( 1, 1 ));
+
+      if( pOut ) *pOut << "sources : " <<
+         (is ? "--- succeeded" : "*** failed") << "\n\n";
+
+      isOk &= is;
+   }
+
+   // tiles
+   {
+      bool is = true;
+
+      is &= (0 == getTileCount( 0, 8 )) & (1 == getTileCount( 8, 8 )) &
+         (2 == getTileCount( 9, 8 )) & (0 == getTileCount( 9, 0 ));
+
+      SheetFlat<dword> sheet( 37, 21 );
+      sheet.zeroStorage();
+      const SheetView<dword> view( sheet );
+
+      // every element in exactly one tile
+      const dword across = getTileCount( view.getWidth(), 8 );
+      const dword down   = getTileCount( view.getHeight(), 6 );
+      for( dword ty = 0;  ty < down;  ++ty )
+      {
+         for( dword tx = 0;  tx < across;  ++tx )
+         {
+            const SheetView<dword> tile( getTileView( view, 8, 6, tx, ty ) );
+            is &= !tile.isEmpty();
+            for( dword y = 0;  y < tile.getHeight();  ++y )
+            {
+               dword* pRow = tile.getRow( y );
+               for( dword x = 0;  x < tile.getWidth();  ++x )
+               {
+                  pRow[x] += 1;
+               }
+            }
+         }
+      }
+      for( dword i = 0;  i < sheet.getLength();  ++i )
+      {
+         is &= (1 == sheet[i]);
+      }
+
+      if( pOut && isVerbose ) *pOut << across << " x " << down << " tiles\n\n";
+
+      if( pOut ) *pOut << "tiles : " <<
+         (is ? "--- succeeded" : "*** failed") << "\n\n";
+
+      isOk &= is;
+   }
+
+
+   if( pOut ) *pOut << (isOk ? "--- successfully" : "*** failurefully") <<
+      " completed " << "\n\n\n";
+
+   if( pOut ) pOut->flush();
+
+
+   return isOk;
+}
+
+
+}//namespace
+
+
+#endif//TESTING
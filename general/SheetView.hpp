@@ -0,0 +1,413 @@
+/*------------------------------------------------------------------------------
+
+   HXA7241 General library.
+   Copyright (c) 2004-2007,  Harrison Ainsworth / HXA7241.
+
+   http://www.hxa7241.org/
+
+------------------------------------------------------------------------------*/
+
+
+#ifndef SheetView_h
+#define SheetView_h
+
+
+#include "Sheet.hpp"
+
+
+
+
+#include "hxa7241_general.hpp"
+namespace hxa7241_general
+{
+
+
+/**
+ * Window onto a rectangle of 2D storage: origin, width, height, and stride --
+ * no copying, no ownership.<br/><br/>
+ *
+ * Refers into a SheetFlat, a Sheet, or a raw buffer, and must not outlive it
+ * (nor its storage being reallocated, by setSize etc.). Sub-views nest to any
+ * depth, all referring to the same storage -- so tiles can be given to
+ * separate threads, each writing its own rectangle.<br/><br/>
+ *
+ * Constness is as a pointer: a const view still gives writable elements. For
+ * read-only, use SheetView<const TYPE> (which any SheetView<TYPE> converts
+ * to).<br/><br/>
+ *
+ * Element access is as SheetFlat: getRow and getElement wrap around out of
+ * bound indexs, get is unchecked, getWrapped wraps by the given mode -- all
+ * within the view.
+ *
+ * @see SheetFlat
+ */
+template<class TYPE>
+class SheetView
+{
+/// standard object services ---------------------------------------------------
+public:
+                     SheetView();
+                     SheetView( TYPE* pStorage,
+                                dword width,
+                                dword height,
+                                dword stride );
+   template<class ELEMENT, class STORAGE>
+                     SheetView( SheetFlat<ELEMENT, STORAGE>& );
+   template<class ELEMENT, class STORAGE>
+                     SheetView( const SheetFlat<ELEMENT, STORAGE>& );
+   template<class ELEMENT, class STORAGE>
+                     SheetView( Sheet<ELEMENT, STORAGE>& );
+   template<class ELEMENT, class STORAGE>
+                     SheetView( const Sheet<ELEMENT, STORAGE>& );
+   template<class ELEMENT>
+                     SheetView( const SheetView<ELEMENT>& );
+
+// use defaults
+//                  ~SheetView();
+//                   SheetView( const SheetView& );
+//        SheetView& operator=( const SheetView& );
+
+
+/// queries --------------------------------------------------------------------
+           /** clipped to this view (so possibly smaller, or empty). */
+           SheetView getSubView( dword x,
+                                 dword y,
+                                 dword width,
+                                 dword height )                           const;
+
+           dword  getWidth()                                              const;
+           dword  getHeight()                                             const;
+           dword  getStride()                                             const;
+           bool   isEmpty()                                               const;
+           bool   isInRange( dword x,
+                             dword y )                                    const;
+
+           TYPE*  getStorage()                                            const;
+           TYPE*  getRow( dword y )                                       const;
+
+           TYPE&  getElement( dword x,
+                              dword y )                                   const;
+           TYPE&  get( dword x,
+                       dword y )                                          const;
+   template<class WRAP>
+           TYPE&  getWrapped( dword x,
+                              dword y )                                   const;
+
+
+/// fields ---------------------------------------------------------------------
+private:
+   TYPE*  pStorage_m;
+   dword  width_m;
+   dword  height_m;
+   dword  stride_m;
+};
+
+
+
+
+/**
+ * Split a view into a grid of tiles (edge tiles smaller), giving tile
+ * (tx, ty).
+ */
+template<class TYPE>
+SheetView<TYPE> getTileView
+(
+   const SheetView<TYPE>& view,
+   dword                  tileWidth,
+   dword                  tileHeight,
+   dword                  tx,
+   dword                  ty
+);
+
+/**
+ * Number of tiles across (or down) for a length and tile size.
+ */
+dword getTileCount
+(
+   dword length,
+   dword tileSize
+);
+
+
+
+
+
+
+
+
+/// INLINES ///
+
+/// standard object services
+template<class TYPE>
+inline
+SheetView<TYPE>::SheetView()
+ : pStorage_m( 0 )
+ , width_m   ( 0 )
+ , height_m  ( 0 )
+ , stride_m  ( 0 )
+{
+}
+
+
+template<class TYPE>
+inline
+SheetView<TYPE>::SheetView
+(
+   TYPE*const  pStorage,
+   const dword width,
+   const dword height,
+   const dword stride
+)
+ : pStorage_m( pStorage )
+ , width_m   ( width )
+ , height_m  ( height )
+ , stride_m  ( stride )
+{
+}
+
+
+template<class TYPE>
+template<class ELEMENT, class STORAGE>
+inline
+SheetView<TYPE>::SheetView
+(
+   SheetFlat<ELEMENT, STORAGE>& sheet
+)
+ : pStorage_m( sheet.getStorage() )
+ , width_m   ( sheet.getWidth() )
+ , height_m  ( sheet.getHeight() )
+ , stride_m  ( sheet.getStride() )
+{
+}
+
+
+template<class TYPE>
+template<class ELEMENT, class STORAGE>
+inline
+SheetView<TYPE>::SheetView
+(
+   const SheetFlat<ELEMENT, STORAGE>& sheet
+)
+ : pStorage_m( sheet.getStorage() )
+ , width_m   ( sheet.getWidth() )
+ , height_m  ( sheet.getHeight() )
+ , stride_m  ( sheet.getStride() )
+{
+}
+
+
+template<class TYPE>
+template<class ELEMENT, class STORAGE>
+inline
+SheetView<TYPE>::SheetView
+(
+   Sheet<ELEMENT, STORAGE>& sheet
+)
+ : pStorage_m( sheet.getFlat().getStorage() )
+ , width_m   ( sheet.getFlat().getWidth() )
+ , height_m  ( sheet.getFlat().getHeight() )
+ , stride_m  ( sheet.getFlat().getStride() )
+{
+}
+
+
+template<class TYPE>
+template<class ELEMENT, class STORAGE>
+inline
+SheetView<TYPE>::SheetView
+(
+   const Sheet<ELEMENT, STORAGE>& sheet
+)
+ : pStorage_m( sheet.getFlat().getStorage() )
+ , width_m   ( sheet.getFlat().getWidth() )
+ , height_m  ( sheet.getFlat().getHeight() )
+ , stride_m  ( sheet.getFlat().getStride() )
+{
+}
+
+
+template<class TYPE>
+template<class ELEMENT>
+inline
+SheetView<TYPE>::SheetView
+(
+   const SheetView<ELEMENT>& other
+)
+ : pStorage_m( other.getStorage() )
+ , width_m   ( other.getWidth() )
+ , height_m  ( other.getHeight() )
+ , stride_m  ( other.getStride() )
+{
+}
+
+
+
+
+/// queries
+template<class TYPE>
+SheetView<TYPE> SheetView<TYPE>::getSubView
+(
+   dword x,
+   dword y,
+   dword width,
+   dword height
+) const
+{
+   // clip to this view
+   if( x < 0 )
+   {
+      width += x;
+      x      = 0;
+   }
+   if( y < 0 )
+   {
+      height += y;
+      y       = 0;
+   }
+   width  = (width  < (width_m  - x)) ? width  : (width_m  - x);
+   height = (height < (height_m - y)) ? height : (height_m - y);
+
+   // empty, or the rectangle
+   return ((width <= 0) | (height <= 0)) ? SheetView<TYPE>() :
+      SheetView<TYPE>( pStorage_m + x + (y * stride_m), width, height,
+      stride_m );
+}
+
+
+template<class TYPE>
+inline
+dword SheetView<TYPE>::getWidth() const
+{
+   return width_m;
+}
+
+
+template<class TYPE>
+inline
+dword SheetView<TYPE>::getHeight() const
+{
+   return height_m;
+}
+
+
+template<class TYPE>
+inline
+dword SheetView<TYPE>::getStride() const
+{
+   return stride_m;
+}
+
+
+template<class TYPE>
+inline
+bool SheetView<TYPE>::isEmpty() const
+{
+   return (width_m <= 0) | (height_m <= 0);
+}
+
+
+template<class TYPE>
+inline
+bool SheetView<TYPE>::isInRange
+(
+   const dword x,
+   const dword y
+) const
+{
+   return (x >= 0) && (x < width_m) && (y >= 0) && (y < height_m);
+}
+
+
+template<class TYPE>
+inline
+TYPE* SheetView<TYPE>::getStorage() const
+{
+   return pStorage_m;
+}
+
+
+template<class TYPE>
+inline
+TYPE* SheetView<TYPE>::getRow
+(
+   dword y
+) const
+{
+   y = (y >= 0) ? y : -y;
+   return pStorage_m + (WrapRepeat::index( y, height_m ) * stride_m);
+}
+
+
+template<class TYPE>
+inline
+TYPE& SheetView<TYPE>::getElement
+(
+   const dword x,
+   const dword y
+) const
+{
+   return getWrapped<WrapRepeat>( x, y );
+}
+
+
+template<class TYPE>
+inline
+TYPE& SheetView<TYPE>::get
+(
+   const dword x,
+   const dword y
+) const
+{
+   return pStorage_m[ x + (y * stride_m) ];
+}
+
+
+template<class TYPE>
+template<class WRAP>
+inline
+TYPE& SheetView<TYPE>::getWrapped
+(
+   const dword x,
+   const dword y
+) const
+{
+   return pStorage_m[ WRAP::index( x, width_m ) +
+      (WRAP::index( y, height_m ) * stride_m) ];
+}
+
+
+
+
+/// other
+template<class TYPE>
+SheetView<TYPE> getTileView
+(
+   const SheetView<TYPE>& view,
+   const dword            tileWidth,
+   const dword            tileHeight,
+   const dword            tx,
+   const dword            ty
+)
+{
+   return view.getSubView( tx * tileWidth, ty * tileHeight, tileWidth,
+      tileHeight );
+}
+
+
+inline
+dword getTileCount
+(
+   const dword length,
+   const dword tileSize
+)
+{
+   return (tileSize > 0) ? ((length + tileSize - 1) / tileSize) : 0;
+}
+
+
+}//namespace
+
+
+
+
+#endif//SheetView_h
@@ -0,0 +1,72 @@
+/*------------------------------------------------------------------------------
+
+   HXA7241 General library.
+   Copyright (c) 2004-2007,  Harrison Ainsworth / HXA7241.
+
+   http://www.hxa7241.org/
+
+------------------------------------------------------------------------------*/
+
+
+/// conditional compilations
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/time.h>
+#endif
+
+#include "Stopwatch.hpp"
+
+
+using namespace hxa7241_general;
+
+
+
+
+/// standard object services ---------------------------------------------------
+Stopwatch::Stopwatch()
+ : start_m( getTime() )
+{
+}
+
+
+
+
+/// commands -------------------------------------------------------------------
+void Stopwatch::start()
+{
+   start_m = getTime();
+}
+
+
+
+
+/// queries --------------------------------------------------------------------
+double Stopwatch::getSeconds() const
+{
+   return getTime() - start_m;
+}
+
+
+double Stopwatch::getTime()
+{
+#ifdef _WIN32
+
+   LARGE_INTEGER frequency;
+   LARGE_INTEGER count;
+   ::QueryPerformanceFrequency( &frequency );
+   ::QueryPerformanceCounter( &count );
+
+   return static_cast<double>(count.QuadPart) /
+      static_cast<double>(frequency.QuadPart);
+
+#else
+
+   struct timeval time;
+   ::gettimeofday( &time, 0 );
+
+   return static_cast<double>(time.tv_sec) +
+      (static_cast<double>(time.tv_usec) * 1e-6);
+
+#endif
+}
@@ -0,0 +1,63 @@
+/*------------------------------------------------------------------------------
+
+   HXA7241 General library.
+   Copyright (c) 2004-2007,  Harrison Ainsworth / HXA7241.
+
+   http://www.hxa7241.org/
+
+------------------------------------------------------------------------------*/
+
+
+#ifndef Stopwatch_h
+#define Stopwatch_h
+
+
+
+
+#include "hxa7241_general.hpp"
+namespace hxa7241_general
+{
+
+
+/**
+ * Wall-clock timer, for benchmarking.<br/><br/>
+ *
+ * Starts when constructed. Resolution is platform dependent -- about a
+ * microsecond.
+ */
+class Stopwatch
+{
+/// standard object services ---------------------------------------------------
+public:
+            Stopwatch();
+
+// use defaults
+//         ~Stopwatch();
+//          Stopwatch( const Stopwatch& );
+//   Stopwatch& operator=( const Stopwatch& );
+
+
+/// commands -------------------------------------------------------------------
+           void   start();
+
+
+/// queries --------------------------------------------------------------------
+           /** seconds since start. */
+           double getSeconds()                                            const;
+
+           /** seconds since some arbitrary fixed point. */
+   static  double getTime();
+
+
+/// fields ---------------------------------------------------------------------
+private:
+   double start_m;
+};
+
+
+}//namespace
+
+
+
+
+#endif//Stopwatch_h
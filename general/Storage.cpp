@@ -0,0 +1,809 @@
+/*------------------------------------------------------------------------------
+
+   HXA7241 General library.
+   Copyright (c) 2004-2007,  Harrison Ainsworth / HXA7241.
+
+   http://www.hxa7241.org/
+
+------------------------------------------------------------------------------*/
+
+
+#include "Storage.hpp"
+
+
+using namespace hxa7241_general;
+
+
+
+
+/// Arena //////////////////////////////////////////////////////////////////////
+
+
+/// standard object services ---------------------------------------------------
+Arena::Arena
+(
+   const dword blockSize
+)
+ : blockSize_m      ( (blockSize > 0) ? static_cast<size_t>(blockSize) : 1 )
+ , pFirst_m         ( 0 )
+ , pCurrent_m       ( 0 )
+ , pTop_m           ( 0 )
+ , pEnd_m           ( 0 )
+ , bytesAllocated_m ( 0 )
+ , blockCount_m     ( 0 )
+ , heapAllocations_m( 0 )
+{
+}
+
+
+Arena::~Arena()
+{
+   Arena::release();
+}
+
+
+
+
+/// commands -------------------------------------------------------------------
+void* Arena::allocate
+(
+   const size_t bytes,
+   const dword  alignment
+)
+{
+   // (size with alignment slack must not overflow)
+   if( bytes > (static_cast<size_t>(-1) - sizeof(Block) -
+      static_cast<size_t>(alignment)) )
+   {
+      throw std::bad_alloc();
+   }
+
+   const size_t mask = static_cast<size_t>(alignment) - 1;
+
+   // align top of current block
+   char* pAligned = pTop_m + ((~reinterpret_cast<size_t>(pTop_m) + 1) & mask);
+
+   // move to next block if no block, or no room
+   if( (0 == pCurrent_m) || (pAligned > pEnd_m) ||
+      (bytes > static_cast<size_t>(pEnd_m - pAligned)) )
+   {
+      Arena::nextBlock( bytes + mask );
+
+      pAligned = pTop_m + ((~reinterpret_cast<size_t>(pTop_m) + 1) & mask);
+   }
+
+   pTop_m = pAligned + bytes;
+   bytesAllocated_m += bytes;
+
+   return pAligned;
+}
+
+
+void Arena::reset()
+{
+   pCurrent_m       = 0;
+   pTop_m           = 0;
+   pEnd_m           = 0;
+   bytesAllocated_m = 0;
+}
+
+
+void Arena::release()
+{
+   while( 0 != pFirst_m )
+   {
+      Block*const pNext = pFirst_m->pNext;
+      ::operator delete( pFirst_m );
+      pFirst_m = pNext;
+   }
+   blockCount_m = 0;
+
+   Arena::reset();
+}
+
+
+
+
+/// implementation -------------------------------------------------------------
+void Arena::nextBlock
+(
+   const size_t bytes
+)
+{
+   // reuse the following block, if big enough
+   Block* pBlock = pCurrent_m ? pCurrent_m->pNext : pFirst_m;
+
+   // else insert a new one before it
+   if( (0 == pBlock) || (pBlock->size < bytes) )
+   {
+      const size_t size = (bytes > blockSize_m) ? bytes : blockSize_m;
+
+      Block*const pNew = static_cast<Block*>( ::operator new(
+         sizeof(Block) + size ) );
+      pNew->pNext = pBlock;
+      pNew->size  = size;
+      ++blockCount_m;
+      ++heapAllocations_m;
+
+      if( pCurrent_m )
+      {
+         pCurrent_m->pNext = pNew;
+      }
+      else
+      {
+         pFirst_m = pNew;
+      }
+      pBlock = pNew;
+   }
+
+   pCurrent_m = pBlock;
+   pTop_m     = reinterpret_cast<char*>( pBlock + 1 );
+   pEnd_m     = pTop_m + pBlock->size;
+}
+
+
+
+
+/// Pool ///////////////////////////////////////////////////////////////////////
+
+
+/// standard object services ---------------------------------------------------
+Pool::Pool()
+ : heapAllocations_m( 0 )
+{
+   for( dword i = CLASS_COUNT;  i-- > 0; )
+   {
+      pFree_m[i] = 0;
+   }
+}
+
+
+Pool::~Pool()
+{
+   Pool::release();
+}
+
+
+
+
+/// commands -------------------------------------------------------------------
+void* Pool::allocate
+(
+   const size_t bytes
+)
+{
+   const dword sizeClass = getSizeClass( bytes );
+   if( (static_cast<size_t>(1) << sizeClass) < bytes )
+   {
+      throw std::bad_alloc();
+   }
+
+   void* pChunk = pFree_m[ sizeClass ];
+
+   // reuse a free chunk
+   if( 0 != pChunk )
+   {
+      pFree_m[ sizeClass ] = *static_cast<void**>( pChunk );
+   }
+   // or make a new one
+   else
+   {
+      pChunk = ::operator new( static_cast<size_t>(1) << sizeClass );
+      ++heapAllocations_m;
+   }
+
+   return pChunk;
+}
+
+
+void Pool::deallocate
+(
+   void*const   pChunk,
+   const size_t bytes
+)
+{
+   if( 0 != pChunk )
+   {
+      const dword sizeClass = getSizeClass( bytes );
+
+      *static_cast<void**>( pChunk ) = pFree_m[ sizeClass ];
+      pFree_m[ sizeClass ] = pChunk;
+   }
+}
+
+
+void Pool::release()
+{
+   for( dword i = CLASS_COUNT;  i-- > 0; )
+   {
+      while( 0 != pFree_m[i] )
+      {
+         void*const pNext = *static_cast<void**>( pFree_m[i] );
+         ::operator delete( pFree_m[i] );
+         pFree_m[i] = pNext;
+      }
+   }
+}
+
+
+
+
+/// queries --------------------------------------------------------------------
+dword Pool::getSizeClass
+(
+   const size_t bytes
+)
+{
+   // smallest power of two holding bytes (top class if none)
+   dword sizeClass = MIN_CLASS;
+   while( (sizeClass < (CLASS_COUNT - 1)) &&
+      ((static_cast<size_t>(1) << sizeClass) < bytes) )
+   {
+      ++sizeClass;
+   }
+
+   return sizeClass;
+}
+
+
+
+
+
+
+
+
+/// test -----------------------------------------------------------------------
+#ifdef TESTING
+
+
+#include <ostream>
+
+#include "Array.hpp"
+#include "Sheet.hpp"
+#include "Stopwatch.hpp"
+
+
+namespace
+{
+
+/// element that counts its live instances, and can fail construction
+class Counted
+{
+public:
+   Counted()
+    : value_m( 0.0 )
+   {
+      if( 0 == --constructionsToFailure_s )
+      {
+         throw "Counted - construction failed";
+      }
+      ++instances_s;
+   }
+
+   ~Counted()
+   {
+      --instances_s;
+   }
+
+   static dword instances_s;
+   static dword constructionsToFailure_s;
+
+   double value_m;
+};
+
+dword Counted::instances_s              = 0;
+dword Counted::constructionsToFailure_s = DWORD_MAX;
+
+
+template<dword ALIGNMENT>
+bool testAligned
+(
+   std::ostream* pOut,
+   const bool    isVerbose
+)
+{
+   bool is = true;
+
+   const StorageAligned<ALIGNMENT> storage;
+
+   // alignment, construction and destruction
+   for( dword length = 0;  length < 40;  ++length )
+   {
+      float* pFloats = storage.template allocate<float>( length );
+      is &= isAligned( pFloats, ALIGNMENT );
+      for( dword i = 0;  i < length;  ++i )
+      {
+         pFloats[i] = static_cast<float>(i);
+      }
+      storage.deallocate( pFloats, length );
+
+      Counted* pCounted = storage.template allocate<Counted>( length );
+      is &= isAligned( pCounted, ALIGNMENT );
+      is &= (length == Counted::instances_s);
+      storage.deallocate( pCounted, length );
+      is &= (0 == Counted::instances_s);
+   }
+
+   // failed construction undoes the rest
+   {
+      Counted::constructionsToFailure_s = 5;
+      bool isThrown = false;
+      try
+      {
+         storage.template allocate<Counted>( 10 );
+      }
+      catch( const char* )
+      {
+         isThrown = true;
+      }
+      Counted::constructionsToFailure_s = DWORD_MAX;
+
+      is &= isThrown & (0 == Counted::instances_s);
+   }
+
+   // containers
+   {
+      Array<float, StorageAligned<ALIGNMENT> > a;
+      for( dword i = 0;  i < 1000;  ++i )
+      {
+         a.append( static_cast<float>(i) );
+         is &= isAligned( a.getStorage(), ALIGNMENT );
+      }
+      a.shrinkToFit();
+      is &= isAligned( a.getStorage(), ALIGNMENT );
+
+      Sheet<float, StorageAligned<ALIGNMENT> > s( 13, 7, ALIGNMENT );
+      for( dword y = 0;  y < s.getHeight();  ++y )
+      {
+         is &= isAligned( s.getRow( y ), ALIGNMENT );
+      }
+
+      Sheet<Counted, StorageAligned<ALIGNMENT> > c( 5, 3 );
+      is &= (15 == Counted::instances_s);
+      c.setSize( 0, 0 );
+      is &= (0 == Counted::instances_s);
+   }
+
+   if( pOut && isVerbose ) *pOut << "alignment " << ALIGNMENT << "  " << is <<
+      "\n";
+
+   return is;
+}
+
+
+/// StorageNew, counting its allocations
+class StorageCounting
+{
+public:
+   template<class TYPE>
+   TYPE* allocate( const dword length ) const
+   {
+      ++allocations_s;
+      return StorageNew().allocate<TYPE>( length );
+   }
+
+   template<class TYPE>
+   void deallocate( TYPE*const pStorage, const dword length ) const
+   {
+      StorageNew().deallocate( pStorage, length );
+   }
+
+   static dword allocations_s;
+};
+
+dword StorageCounting::allocations_s = 0;
+
+
+/// a frame's worth of temporaries: scanlines, tiles, and a growing buffer
+template<class STORAGE>
+udword makeFrame
+(
+   const STORAGE& storage
+)
+{
+   udword sum = 0;
+
+   for( dword y = 0;  y < 64;  ++y )
+   {
+      Array<udword, STORAGE> scanline( 512, storage );
+      scanline[y] = static_cast<udword>(y);
+      sum += scanline[y];
+   }
+
+   for( dword t = 0;  t < 16;  ++t )
+   {
+      Sheet<udword, STORAGE> tile( 32, 32, 0, storage );
+      tile.get( t, t ) = static_cast<udword>(t);
+      sum += tile.get( t, t );
+   }
+
+   {
+      Array<ubyte, STORAGE> runs( storage );
+      for( dword i = 0;  i < 4096;  ++i )
+      {
+         runs.append( static_cast<ubyte>(i) );
+      }
+      sum += runs[4095];
+   }
+
+   return sum;
+}
+
+
+void benchmarkFrames
+(
+   std::ostream& out
+)
+{
+   static const dword FRAMES = 1000;
+
+   static const char* NAMES[] = { "new", "pool", "arena" };
+   double times[3];
+   double allocations[3];
+   udword sums[3] = { 0, 0, 0 };
+
+   // new
+   {
+      const StorageCounting storage;
+      sums[0] += makeFrame( storage );
+
+      const dword start = StorageCounting::allocations_s;
+      Stopwatch stopwatch;
+      for( dword f = FRAMES;  f-- > 0; )
+      {
+         sums[0] += makeFrame( storage );
+      }
+      times[0] = stopwatch.getSeconds();
+      allocations[0] = static_cast<double>(StorageCounting::allocations_s -
+         start);
+   }
+
+   // pool
+   {
+      Pool pool;
+      const StoragePool storage( &pool );
+      sums[1] += makeFrame( storage );
+
+      const dword start = pool.getHeapAllocations();
+      Stopwatch stopwatch;
+      for( dword f = FRAMES;  f-- > 0; )
+      {
+         sums[1] += makeFrame( storage );
+      }
+      times[1] = stopwatch.getSeconds();
+      allocations[1] = static_cast<double>(pool.getHeapAllocations() - start);
+   }
+
+   // arena
+   {
+      Arena arena;
+      const StorageArena<> storage( &arena );
+      sums[2] += makeFrame( storage );
+      arena.reset();
+
+      const dword start = arena.getHeapAllocations();
+      Stopwatch stopwatch;
+      for( dword f = FRAMES;  f-- > 0; )
+      {
+         sums[2] += makeFrame( storage );
+         arena.reset();
+      }
+      times[2] = stopwatch.getSeconds();
+      allocations[2] = static_cast<double>(arena.getHeapAllocations() - start);
+   }
+
+   out << "benchmark  (per frame)\n";
+   for( dword m = 0;  m < 3;  ++m )
+   {
+      out << "   " << NAMES[m] << "  " << (allocations[m] / FRAMES) <<
+         " heap allocations  " << (times[m] * 1e6 / FRAMES) << " us" <<
+         "  (sum " << sums[m] << ")\n";
+   }
+   out << "\n";
+}
+
+}
+
+
+namespace hxa7241_general
+{
+
+
+bool test_Storage
+(
+   std::ostream* pOut,
+   const bool    isVerbose,
+   const dword   //seed
+)
+{
+   bool isOk = true;
+
+   if( pOut ) *pOut << "[ test_Storage ]\n\n";
+
+
+   // aligned
+   {
+      bool is = true;
+
+      is &= testAligned<16>( pOut, isVerbose );
+      is &= testAligned<32>( pOut, isVerbose );
+      is &= testAligned<64>( pOut, isVerbose );
+      is &= testAligned<4096>( pOut, isVerbose );
+
+      is &= (32 == StorageAligned<32>::getAlignment());
+
+      if( pOut && isVerbose ) *pOut << "\n";
+
+      if( pOut ) *pOut << "aligned : " <<
+         (is ? "--- succeeded" : "*** failed") << "\n\n";
+
+      isOk &= is;
+   }
+
+   // new
+   {
+      bool is = true;
+
+      const StorageNew storage;
+      Counted* pCounted = storage.allocate<Counted>( 7 );
+      is &= (7 == Counted::instances_s);
+      storage.deallocate( pCounted, 7 );
+      is &= (0 == Counted::instances_s);
+
+      if( pOut ) *pOut << "new : " <<
+         (is ? "--- succeeded" : "*** failed") << "\n\n";
+
+      isOk &= is;
+   }
+
+   // arena
+   {
+      bool is = true;
+
+      Arena arena( 1024 );
+
+      for( dword frame = 0;  frame < 3;  ++frame )
+      {
+         // alignment, and no overlap (previous unchanged by writing next)
+         ubyte* pPrevious     = 0;
+         size_t previousBytes = 0;
+         for( dword i = 0;  i < 200;  ++i )
+         {
+            const dword  alignment = 1 << (i % 13);
+            const size_t bytes     = static_cast<size_t>((i * 37) % 300);
+            ubyte*const  p = static_cast<ubyte*>( arena.allocate( bytes,
+               alignment ) );
+            is &= isAligned( p, alignment );
+
+            for( size_t b = 0;  b < bytes;  ++b )
+            {
+               p[b] = static_cast<ubyte>(i);
+            }
+            if( 0 != previousBytes )
+            {
+               is &= (static_cast<ubyte>(i - 1) == pPrevious[0]) &
+                  (static_cast<ubyte>(i - 1) == pPrevious[previousBytes - 1]);
+            }
+
+            pPrevious     = p;
+            previousBytes = bytes;
+         }
+
+         // bigger than a block
+         ubyte*const pLarge = static_cast<ubyte*>( arena.allocate( 5000,
+            64 ) );
+         is &= isAligned( pLarge, 64 );
+         pLarge[0] = pLarge[4999] = 1;
+
+         // all blocks held after the first frame
+         static dword heapAllocations = 0;
+         if( 0 != frame )
+         {
+            is &= (heapAllocations == arena.getHeapAllocations());
+         }
+         heapAllocations = arena.getHeapAllocations();
+
+         arena.reset();
+         is &= (0 == arena.getBytesAllocated());
+      }
+
+      // reset rewinds to the start
+      {
+         void*const p0 = arena.allocate( 10, 16 );
+         arena.allocate( 10, 16 );
+         arena.reset();
+         is &= (p0 == arena.allocate( 10, 16 ));
+         is &= (10 == arena.getBytesAllocated());
+      }
+
+      arena.release();
+      is &= (0 == arena.getBlockCount());
+
+      if( pOut ) *pOut << "arena : " <<
+         (is ? "--- succeeded" : "*** failed") << "\n\n";
+
+      isOk &= is;
+   }
+
+   // pool
+   {
+      bool is = true;
+
+      is &= (4  == Pool::getSizeClass( 0 ));
+      is &= (4  == Pool::getSizeClass( 16 ));
+      is &= (5  == Pool::getSizeClass( 17 ));
+      is &= (10 == Pool::getSizeClass( 1024 ));
+      is &= (11 == Pool::getSizeClass( 1025 ));
+
+      Pool pool;
+      void*const p0 = pool.allocate( 100 );
+      void*const p1 = pool.allocate( 100 );
+      is &= (p0 != p1) & (2 == pool.getHeapAllocations());
+
+      // same class reused
+      pool.deallocate( p0, 100 );
+      is &= (p0 == pool.allocate( 120 ));
+      is &= (2 == pool.getHeapAllocations());
+
+      // other class not
+      pool.deallocate( p1, 100 );
+      void*const p2 = pool.allocate( 300 );
+      is &= (3 == pool.getHeapAllocations());
+
+      pool.deallocate( p0, 120 );
+      pool.deallocate( p2, 300 );
+      pool.release();
+
+      if( pOut ) *pOut << "pool : " <<
+         (is ? "--- succeeded" : "*** failed") << "\n\n";
+
+      isOk &= is;
+   }
+
+   // arena and pool policies
+   {
+      bool is = true;
+
+      Arena arena;
+      Pool  pool;
+
+      // construction and destruction
+      {
+         const StorageArena<32> storageArena( &arena );
+         Counted* pCounted = storageArena.allocate<Counted>( 9 );
+         is &= isAligned( pCounted, 32 ) & (9 == Counted::instances_s);
+         storageArena.deallocate( pCounted, 9 );
+         is &= (0 == Counted::instances_s);
+
+         const StoragePool storagePool( &pool );
+         pCounted = storagePool.allocate<Counted>( 9 );
+         is &= (9 == Counted::instances_s);
+         storagePool.deallocate( pCounted, 9 );
+         is &= (0 == Counted::instances_s);
+
+         // failed construction returns the chunk to the pool
+         const dword heapAllocations = pool.getHeapAllocations();
+         Counted::constructionsToFailure_s = 5;
+         bool isThrown = false;
+         try
+         {
+            storagePool.allocate<Counted>( 9 );
+         }
+         catch( const char* )
+         {
+            isThrown = true;
+         }
+         Counted::constructionsToFailure_s = DWORD_MAX;
+         is &= isThrown & (0 == Counted::instances_s);
+
+         storagePool.deallocate( storagePool.allocate<Counted>( 9 ), 9 );
+         is &= (heapAllocations == pool.getHeapAllocations());
+      }
+
+      // containers
+      {
+         const StorageArena<> storage( &arena );
+
+         Array<dword, StorageArena<> > a( storage );
+         for( dword i = 0;  i < 1000;  ++i )
+         {
+            a.append( i );
+         }
+         is &= isAligned( a.getStorage(), 16 );
+         is &= (&arena == a.getFlat().getStoragePolicy().getArena());
+
+         // copies keep the policy instance
+         const Array<dword, StorageArena<> > b( a );
+         is &= (&arena == b.getFlat().getStoragePolicy().getArena());
+         is &= (999 == b[999]);
+
+         Sheet<float, StorageArena<64> > s( 13, 7, 64,
+            StorageArena<64>( &arena ) );
+         for( dword y = 0;  y < s.getHeight();  ++y )
+         {
+            is &= isAligned( s.getRow( y ), 64 );
+         }
+         is &= (&arena == s.getFlat().getStoragePolicy().getArena());
+
+         // no arena: heap
+         Array<dword, StorageArena<> > h( 100 );
+         is &= (0 == h.getFlat().getStoragePolicy().getArena());
+      }
+      arena.reset();
+
+      // swapping takes the policy along
+      {
+         Pool pool2;
+         {
+            Array<dword, StoragePool> x( 10, StoragePool( &pool ) );
+            Array<dword, StoragePool> y( 20, StoragePool( &pool2 ) );
+            x.swap( y );
+            is &= (&pool2 == x.getFlat().getStoragePolicy().getPool());
+            is &= (&pool  == y.getFlat().getStoragePolicy().getPool());
+         }
+
+         // storage went back to its own pool
+         const dword heapAllocations = pool2.getHeapAllocations();
+         void*const p = pool2.allocate( 20 * sizeof(dword) );
+         is &= (heapAllocations == pool2.getHeapAllocations());
+         pool2.deallocate( p, 20 * sizeof(dword) );
+
+#if __cplusplus >= 201103L
+         // moving leaves the source with its own policy
+         ArrayFlat<dword, StoragePool> m( 10, StoragePool( &pool ) );
+         ArrayFlat<dword, StoragePool> n( 20, StoragePool( &pool2 ) );
+         n = std::move( m );
+         is &= (&pool == n.getStoragePolicy().getPool()) &
+            (&pool == m.getStoragePolicy().getPool()) & (0 == m.getLength());
+         const ArrayFlat<dword, StoragePool> o( std::move( n ) );
+         is &= (&pool == o.getStoragePolicy().getPool()) &
+            (&pool == n.getStoragePolicy().getPool());
+
+         SheetFlat<float, StoragePool> s( 4, 3, 0, StoragePool( &pool ) );
+         SheetFlat<float, StoragePool> t( 2, 2, 0, StoragePool( &pool2 ) );
+         t = std::move( s );
+         is &= (&pool == t.getStoragePolicy().getPool()) &
+            (&pool == s.getStoragePolicy().getPool());
+#endif
+      }
+
+      // frames stop allocating from the heap
+      {
+         const StorageArena<> storage( &arena );
+         makeFrame( storage );
+         arena.reset();
+         const dword heapAllocations = arena.getHeapAllocations();
+         makeFrame( storage );
+         arena.reset();
+         is &= (heapAllocations == arena.getHeapAllocations());
+
+         const StoragePool storagePool( &pool );
+         makeFrame( storagePool );
+         const dword poolAllocations = pool.getHeapAllocations();
+         makeFrame( storagePool );
+         is &= (poolAllocations == pool.getHeapAllocations());
+      }
+
+      if( pOut ) *pOut << "arena and pool policies : " <<
+         (is ? "--- succeeded" : "*** failed") << "\n\n";
+
+      isOk &= is;
+   }
+
+   if( pOut && isVerbose ) benchmarkFrames( *pOut );
+
+
+   if( pOut ) *pOut << (isOk ? "--- successfully" : "*** failurefully") <<
+      " completed " << "\n\n\n";
+
+   if( pOut ) pOut->flush();
+
+
+   return isOk;
+}
+
+
+}//namespace
+
+
+#endif//TESTING
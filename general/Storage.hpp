@@ -0,0 +1,642 @@
+/*------------------------------------------------------------------------------
+
+   HXA7241 General library.
+   Copyright (c) 2004-2007,  Harrison Ainsworth / HXA7241.
+
+   http://www.hxa7241.org/
+
+------------------------------------------------------------------------------*/
+
+
+#ifndef Storage_h
+#define Storage_h
+
+
+#include <new>
+#include <stddef.h>
+
+
+
+
+#include "hxa7241_general.hpp"
+namespace hxa7241_general
+{
+
+
+/**
+ * Storage allocation policies, for the STORAGE template parameter of
+ * ArrayFlat, Array, SheetFlat and Sheet.<br/><br/>
+ *
+ * A STORAGE type has two members:<br/>
+ * * template<class TYPE> TYPE* allocate( dword length ) -- default-constructed
+ *   elements (throws on failure)<br/>
+ * * template<class TYPE> void deallocate( TYPE*, dword length ) -- destroys
+ *   and frees (length as allocated)<br/><br/>
+ *
+ * It must be copyable, and default constructible. A container keeps a copy of
+ * the instance given at its construction (default: STORAGE()), and uses it
+ * for all its storage.<br/><br/>
+ *
+ * Storage adopted by a container (setStorage with isAdopt true) must come
+ * from the same STORAGE instance's allocate.
+ */
+
+
+/**
+ * Plain new[] and delete[] -- the default.
+ */
+class StorageNew
+{
+public:
+   template<class TYPE>
+   TYPE* allocate( dword length )                                         const;
+   template<class TYPE>
+   void  deallocate( TYPE*  pStorage,
+                     dword  length )                                      const;
+};
+
+
+/**
+ * Storage start aligned to ALIGNMENT bytes.<br/><br/>
+ *
+ * ALIGNMENT must be a power of two, and at least the size of a pointer: 16
+ * for SSE, 32 for AVX, 64 for cache lines (and AVX-512).
+ *
+ * @implementation
+ * Over-allocates raw memory, and keeps the raw address just before the
+ * aligned start. Elements are constructed in place.
+ */
+template<dword ALIGNMENT>
+class StorageAligned
+{
+public:
+   template<class TYPE>
+   TYPE* allocate( dword length )                                         const;
+   template<class TYPE>
+   void  deallocate( TYPE*  pStorage,
+                     dword  length )                                      const;
+
+   static dword getAlignment();
+
+private:
+   // compile-time check of ALIGNMENT
+   static const dword POINTER_SIZE = sizeof(void*);
+   typedef char IsValidAlignment[ ((ALIGNMENT >= POINTER_SIZE) &
+      (0 == (ALIGNMENT & (ALIGNMENT - 1)))) ? 1 : -1 ];
+};
+
+
+/**
+ * Frame arena: bump allocation from a list of blocks, all freed at once by
+ * reset.<br/><br/>
+ *
+ * For the temporaries of one frame (or pass): many allocations, no
+ * individual freeing, then reset at the end. reset keeps the blocks, so once a
+ * frame's worth is held, later frames make no heap allocations at all.<br/>
+ * <br/>
+ *
+ * Requests bigger than the block size get a block of their own (also kept).
+ * <br/><br/>
+ *
+ * Not thread-safe. Storage given out is invalid after reset or destruction --
+ * containers using it must be gone (or emptied) by then.
+ *
+ * @see StorageArena
+ */
+class Arena
+{
+/// standard object services ---------------------------------------------------
+public:
+   explicit Arena( dword blockSize = 65536 );
+
+           ~Arena();
+private:
+            Arena( const Arena& );
+   Arena&   operator=( const Arena& );
+public:
+
+
+/// commands -------------------------------------------------------------------
+           /** bytes aligned to alignment (a power of two, up to 4096). */
+           void*  allocate( size_t bytes,
+                            dword  alignment );                        // throws
+
+           /** free everything allocated (keeping the blocks). */
+           void   reset();
+           /** free everything allocated, and the blocks. */
+           void   release();
+
+
+/// queries --------------------------------------------------------------------
+           size_t getBytesAllocated()                                     const;
+           dword  getBlockCount()                                         const;
+           /** number of blocks ever allocated from the heap. */
+           dword  getHeapAllocations()                                    const;
+
+
+/// implementation -------------------------------------------------------------
+private:
+           void   nextBlock( size_t bytes );
+
+
+/// fields ---------------------------------------------------------------------
+private:
+   struct Block
+   {
+      Block* pNext;
+      size_t size;
+   };
+
+   size_t blockSize_m;
+
+   Block* pFirst_m;
+   Block* pCurrent_m;
+   char*  pTop_m;
+   char*  pEnd_m;
+
+   size_t bytesAllocated_m;
+   dword  blockCount_m;
+   dword  heapAllocations_m;
+};
+
+
+/**
+ * Size-class pool: freed chunks are kept in free lists by power-of-two size,
+ * and reused by later allocations of the same class.<br/><br/>
+ *
+ * For storage repeatedly made and freed in similar sizes (tiles, scanlines,
+ * growing buffers): after the first round, no heap allocations. Chunks are
+ * aligned as by ::operator new. Smallest class is 16 bytes.<br/><br/>
+ *
+ * Not thread-safe. All chunks must be deallocated before release or
+ * destruction.
+ *
+ * @see StoragePool
+ */
+class Pool
+{
+/// standard object services ---------------------------------------------------
+public:
+            Pool();
+
+           ~Pool();
+private:
+            Pool( const Pool& );
+   Pool&    operator=( const Pool& );
+public:
+
+
+/// commands -------------------------------------------------------------------
+           void*  allocate( size_t bytes );                            // throws
+           /** bytes as allocated. */
+           void   deallocate( void*  pChunk,
+                              size_t bytes );
+
+           /** free all kept chunks to the heap. */
+           void   release();
+
+
+/// queries --------------------------------------------------------------------
+           /** number of chunks ever allocated from the heap. */
+           dword  getHeapAllocations()                                    const;
+
+   static  dword  getSizeClass( size_t bytes );
+
+
+/// fields ---------------------------------------------------------------------
+private:
+   static const dword MIN_CLASS   = 4;
+   static const dword CLASS_COUNT = sizeof(size_t) * 8;
+
+   void*  pFree_m[ CLASS_COUNT ];
+
+   dword  heapAllocations_m;
+};
+
+
+/**
+ * Storage from an Arena, aligned to ALIGNMENT bytes.<br/><br/>
+ *
+ * deallocate only destroys the elements: the memory returns at Arena::reset.
+ * Default constructed (no arena), it allocates from the heap, as
+ * StorageAligned.
+ */
+template<dword ALIGNMENT = 16>
+class StorageArena
+{
+public:
+   explicit StorageArena( Arena* pArena = 0 );
+
+   template<class TYPE>
+   TYPE* allocate( dword length )                                         const;
+   template<class TYPE>
+   void  deallocate( TYPE*  pStorage,
+                     dword  length )                                      const;
+
+   Arena* getArena()                                                      const;
+
+private:
+   Arena* pArena_m;
+};
+
+
+/**
+ * Storage from a Pool.<br/><br/>
+ *
+ * Default constructed (no pool), it allocates from the heap.
+ */
+class StoragePool
+{
+public:
+   explicit StoragePool( Pool* pPool = 0 );
+
+   template<class TYPE>
+   TYPE* allocate( dword length )                                         const;
+   template<class TYPE>
+   void  deallocate( TYPE*  pStorage,
+                     dword  length )                                      const;
+
+   Pool* getPool()                                                        const;
+
+private:
+   Pool* pPool_m;
+};
+
+
+/**
+ * Is an address aligned to the given (power of two) number of bytes?
+ */
+bool isAligned( const void* pAddress,
+                dword       alignment );
+
+
+/**
+ * Size in bytes of length elements (throws bad_alloc on overflow, allowing
+ * for extra bytes).
+ */
+template<class TYPE>
+size_t getStorageBytes_( dword  length,
+                         size_t extra );
+
+/**
+ * Default-construct length elements in raw memory (on exception, destroying
+ * those made, then rethrowing).
+ */
+template<class TYPE>
+TYPE*  constructElements_( void* pRaw,
+                           dword length );
+
+template<class TYPE>
+void   destroyElements_( TYPE* pStorage,
+                         dword length );
+
+
+
+
+/// INLINES ///
+
+/// StorageNew
+
+template<class TYPE>
+inline
+TYPE* StorageNew::allocate
+(
+   const dword length
+) const
+{
+   return new TYPE[ length ];
+}
+
+
+template<class TYPE>
+inline
+void StorageNew::deallocate
+(
+   TYPE*const pStorage,
+   const dword
+) const
+{
+   delete[] pStorage;
+}
+
+
+
+
+/// StorageAligned
+
+template<dword ALIGNMENT>
+template<class TYPE>
+TYPE* StorageAligned<ALIGNMENT>::allocate
+(
+   const dword length
+) const
+{
+   // raw memory, with room for alignment and the raw address
+   char*const pRaw = static_cast<char*>( ::operator new(
+      getStorageBytes_<TYPE>( length, ALIGNMENT + sizeof(void*) - 1 ) ) );
+
+   // align, leaving a place for the raw address before
+   char*const pStart = pRaw + sizeof(void*);
+   char*const pAligned = pStart + ((ALIGNMENT -
+      (reinterpret_cast<size_t>(pStart) & (ALIGNMENT - 1))) & (ALIGNMENT - 1));
+   reinterpret_cast<void**>(pAligned)[-1] = pRaw;
+
+   // construct elements (undoing on exception)
+   TYPE*const pStorage = reinterpret_cast<TYPE*>(pAligned);
+   dword i = 0;
+   try
+   {
+      for( ;  i < length;  ++i )
+      {
+         new( pStorage + i ) TYPE;
+      }
+   }
+   catch( ... )
+   {
+      destroyElements_( pStorage, i );
+      ::operator delete( pRaw );
+
+      throw;
+   }
+
+   return pStorage;
+}
+
+
+template<dword ALIGNMENT>
+template<class TYPE>
+void StorageAligned<ALIGNMENT>::deallocate
+(
+   TYPE*const  pStorage,
+   const dword length
+) const
+{
+   if( 0 != pStorage )
+   {
+      destroyElements_( pStorage, length );
+
+      ::operator delete( reinterpret_cast<void**>(pStorage)[-1] );
+   }
+}
+
+
+template<dword ALIGNMENT>
+inline
+dword StorageAligned<ALIGNMENT>::getAlignment()
+{
+   return ALIGNMENT;
+}
+
+
+
+
+/// Arena
+
+inline
+size_t Arena::getBytesAllocated() const
+{
+   return bytesAllocated_m;
+}
+
+
+inline
+dword Arena::getBlockCount() const
+{
+   return blockCount_m;
+}
+
+
+inline
+dword Arena::getHeapAllocations() const
+{
+   return heapAllocations_m;
+}
+
+
+
+
+/// Pool
+
+inline
+dword Pool::getHeapAllocations() const
+{
+   return heapAllocations_m;
+}
+
+
+
+
+/// StorageArena
+
+template<dword ALIGNMENT>
+inline
+StorageArena<ALIGNMENT>::StorageArena
+(
+   Arena*const pArena
+)
+ : pArena_m( pArena )
+{
+}
+
+
+template<dword ALIGNMENT>
+template<class TYPE>
+TYPE* StorageArena<ALIGNMENT>::allocate
+(
+   const dword length
+) const
+{
+   if( 0 != pArena_m )
+   {
+      // (on exception, the memory just stays in the arena)
+      return constructElements_<TYPE>( pArena_m->allocate(
+         getStorageBytes_<TYPE>( length, 0 ), ALIGNMENT ), length );
+   }
+   else
+   {
+      return StorageAligned<ALIGNMENT>().template allocate<TYPE>( length );
+   }
+}
+
+
+template<dword ALIGNMENT>
+template<class TYPE>
+void StorageArena<ALIGNMENT>::deallocate
+(
+   TYPE*const  pStorage,
+   const dword length
+) const
+{
+   if( 0 != pArena_m )
+   {
+      if( 0 != pStorage )
+      {
+         destroyElements_( pStorage, length );
+      }
+   }
+   else
+   {
+      StorageAligned<ALIGNMENT>().deallocate( pStorage, length );
+   }
+}
+
+
+template<dword ALIGNMENT>
+inline
+Arena* StorageArena<ALIGNMENT>::getArena() const
+{
+   return pArena_m;
+}
+
+
+
+
+/// StoragePool
+
+inline
+StoragePool::StoragePool
+(
+   Pool*const pPool
+)
+ : pPool_m( pPool )
+{
+}
+
+
+template<class TYPE>
+TYPE* StoragePool::allocate
+(
+   const dword length
+) const
+{
+   const size_t bytes  = getStorageBytes_<TYPE>( length, 0 );
+   void*const   pChunk = pPool_m ? pPool_m->allocate( bytes ) :
+      ::operator new( bytes );
+
+   // construct elements (freeing on exception)
+   TYPE* pStorage = 0;
+   try
+   {
+      pStorage = constructElements_<TYPE>( pChunk, length );
+   }
+   catch( ... )
+   {
+      if( pPool_m ) pPool_m->deallocate( pChunk, bytes );
+      else          ::operator delete( pChunk );
+
+      throw;
+   }
+
+   return pStorage;
+}
+
+
+template<class TYPE>
+void StoragePool::deallocate
+(
+   TYPE*const  pStorage,
+   const dword length
+) const
+{
+   if( 0 != pStorage )
+   {
+      destroyElements_( pStorage, length );
+
+      if( pPool_m ) pPool_m->deallocate( pStorage,
+         static_cast<size_t>(length) * sizeof(TYPE) );
+      else          ::operator delete( pStorage );
+   }
+}
+
+
+inline
+Pool* StoragePool::getPool() const
+{
+   return pPool_m;
+}
+
+
+
+
+/// other
+
+inline
+bool isAligned
+(
+   const void*const pAddress,
+   const dword      alignment
+)
+{
+   return 0 == (reinterpret_cast<size_t>(pAddress) &
+      static_cast<size_t>(alignment - 1));
+}
+
+
+template<class TYPE>
+inline
+size_t getStorageBytes_
+(
+   const dword  length,
+   const size_t extra
+)
+{
+   // (size in bytes must not overflow)
+   if( static_cast<size_t>(length) > ((static_cast<size_t>(-1) - extra) /
+      sizeof(TYPE)) )
+   {
+      throw std::bad_alloc();
+   }
+
+   return (static_cast<size_t>(length) * sizeof(TYPE)) + extra;
+}
+
+
+template<class TYPE>
+TYPE* constructElements_
+(
+   void*const  pRaw,
+   const dword length
+)
+{
+   TYPE*const pStorage = static_cast<TYPE*>(pRaw);
+
+   dword i = 0;
+   try
+   {
+      for( ;  i < length;  ++i )
+      {
+         new( pStorage + i ) TYPE;
+      }
+   }
+   catch( ... )
+   {
+      destroyElements_( pStorage, i );
+
+      throw;
+   }
+
+   return pStorage;
+}
+
+
+template<class TYPE>
+inline
+void destroyElements_
+(
+   TYPE*const  pStorage,
+   const dword length
+)
+{
+   for( dword i = length;  i-- > 0; )
+   {
+      pStorage[i].~TYPE();
+   }
+}
+
+
+}//namespace
+
+
+
+
+#endif//Storage_h
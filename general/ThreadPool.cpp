@@ -0,0 +1,543 @@
+/*------------------------------------------------------------------------------
+
+   HXA7241 General library.
+   Copyright (c) 2004-2007,  Harrison Ainsworth / HXA7241.
+
+   http://www.hxa7241.org/
+
+------------------------------------------------------------------------------*/
+
+
+/// conditional compilations
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+#include "ThreadPool.hpp"
+
+
+using namespace hxa7241_general;
+
+
+
+
+/// platform ///////////////////////////////////////////////////////////////////
+namespace
+{
+
+/// mutual exclusion lock
+class Mutex
+{
+public:
+#ifdef _WIN32
+   Mutex()        { ::InitializeCriticalSection( &section_m ); }
+   ~Mutex()       { ::DeleteCriticalSection( &section_m ); }
+   void lock()    { ::EnterCriticalSection( &section_m ); }
+   void unlock()  { ::LeaveCriticalSection( &section_m ); }
+#else
+   Mutex()        { ::pthread_mutex_init( &mutex_m, 0 ); }
+   ~Mutex()       { ::pthread_mutex_destroy( &mutex_m ); }
+   void lock()    { ::pthread_mutex_lock( &mutex_m ); }
+   void unlock()  { ::pthread_mutex_unlock( &mutex_m ); }
+#endif
+
+private:
+   Mutex( const Mutex& );
+   Mutex& operator=( const Mutex& );
+
+#ifdef _WIN32
+   CRITICAL_SECTION section_m;
+#else
+   pthread_mutex_t  mutex_m;
+#endif
+};
+
+
+/// holds a Mutex locked for its scope
+class Lock
+{
+public:
+   explicit Lock( Mutex& mutex ) : mutex_m( mutex ) { mutex_m.lock(); }
+   ~Lock()                                          { mutex_m.unlock(); }
+
+private:
+   Lock( const Lock& );
+   Lock& operator=( const Lock& );
+
+   Mutex& mutex_m;
+};
+
+
+/// auto-reset event: wait blocks until set, then clears it
+class Event
+{
+public:
+#ifdef _WIN32
+   Event() : handle_m( ::CreateEvent( 0, FALSE, FALSE, 0 ) ) {}
+   ~Event()       { ::CloseHandle( handle_m ); }
+   void set()     { ::SetEvent( handle_m ); }
+   void wait()    { ::WaitForSingleObject( handle_m, INFINITE ); }
+#else
+   Event()
+    : isSet_m( false )
+   {
+      ::pthread_mutex_init( &mutex_m, 0 );
+      ::pthread_cond_init( &condition_m, 0 );
+   }
+
+   ~Event()
+   {
+      ::pthread_cond_destroy( &condition_m );
+      ::pthread_mutex_destroy( &mutex_m );
+   }
+
+   void set()
+   {
+      ::pthread_mutex_lock( &mutex_m );
+      isSet_m = true;
+      ::pthread_cond_signal( &condition_m );
+      ::pthread_mutex_unlock( &mutex_m );
+   }
+
+   void wait()
+   {
+      ::pthread_mutex_lock( &mutex_m );
+      while( !isSet_m )
+      {
+         ::pthread_cond_wait( &condition_m, &mutex_m );
+      }
+      isSet_m = false;
+      ::pthread_mutex_unlock( &mutex_m );
+   }
+#endif
+
+private:
+   Event( const Event& );
+   Event& operator=( const Event& );
+
+#ifdef _WIN32
+   HANDLE          handle_m;
+#else
+   bool            isSet_m;
+   pthread_mutex_t mutex_m;
+   pthread_cond_t  condition_m;
+#endif
+};
+
+}
+
+
+
+
+/// threads ////////////////////////////////////////////////////////////////////
+class ThreadPool::Threads
+{
+public:
+   explicit Threads( dword count );
+   ~Threads();
+
+   bool start();
+   void stop();
+
+   void work( dword thread );
+
+private:
+   bool take( dword  thread,
+              dword& item );
+   bool steal( dword thread );
+
+#ifdef _WIN32
+   static DWORD WINAPI entry( LPVOID pWorker );
+#else
+   static void*        entry( void*  pWorker );
+#endif
+
+public:
+   /// items still to do for one thread: [begin, end)
+   struct Range
+   {
+      Mutex mutex;
+      dword begin;
+      dword end;
+   };
+
+   struct Worker
+   {
+      Threads* pThreads;
+      dword    index;
+      Event    start;
+      bool     isStarted;
+#ifdef _WIN32
+      HANDLE    handle;
+#else
+      pthread_t handle;
+#endif
+   };
+
+   dword   count_m;
+   Range*  pRanges_m;
+   Worker* pWorkers_m;
+
+   ThreadPool::Job* pJob_m;
+   bool             isQuitting_m;
+
+   Mutex   control_m;
+   Event   done_m;
+   dword   finished_m;
+   dword   steals_m;
+   bool    isFailed_m;
+};
+
+
+ThreadPool::Threads::Threads
+(
+   const dword count
+)
+ : count_m     ( count )
+ , pRanges_m   ( new Range[ count ] )
+ , pWorkers_m  ( 0 )
+ , pJob_m      ( 0 )
+ , isQuitting_m( false )
+ , finished_m  ( 0 )
+ , steals_m    ( 0 )
+ , isFailed_m  ( false )
+{
+   try
+   {
+      pWorkers_m = new Worker[ count ];
+   }
+   catch( ... )
+   {
+      delete[] pRanges_m;
+      throw;
+   }
+
+   for( dword i = 0;  i < count;  ++i )
+   {
+      pRanges_m[i].begin     = 0;
+      pRanges_m[i].end       = 0;
+      pWorkers_m[i].pThreads  = this;
+      pWorkers_m[i].index     = i;
+      pWorkers_m[i].isStarted = false;
+   }
+}
+
+
+ThreadPool::Threads::~Threads()
+{
+   delete[] pWorkers_m;
+   delete[] pRanges_m;
+}
+
+
+bool ThreadPool::Threads::start()
+{
+   // thread 0 is the caller's: start the others
+   bool isOk = true;
+   for( dword i = 1;  isOk & (i < count_m);  ++i )
+   {
+      Worker& worker = pWorkers_m[i];
+#ifdef _WIN32
+      worker.handle    = ::CreateThread( 0, 0, &entry, &worker, 0, 0 );
+      worker.isStarted = (0 != worker.handle);
+#else
+      worker.isStarted = (0 == ::pthread_create( &worker.handle, 0, &entry,
+         &worker ));
+#endif
+      isOk = worker.isStarted;
+   }
+
+   return isOk;
+}
+
+
+void ThreadPool::Threads::stop()
+{
+   {
+      Lock lock( control_m );
+      isQuitting_m = true;
+   }
+
+   for( dword i = 1;  i < count_m;  ++i )
+   {
+      Worker& worker = pWorkers_m[i];
+      if( worker.isStarted )
+      {
+         worker.start.set();
+#ifdef _WIN32
+         ::WaitForSingleObject( worker.handle, INFINITE );
+         ::CloseHandle( worker.handle );
+#else
+         ::pthread_join( worker.handle, 0 );
+#endif
+         worker.isStarted = false;
+      }
+   }
+}
+
+
+void ThreadPool::Threads::work
+(
+   const dword thread
+)
+{
+   // own items first, then stolen ones, until none anywhere
+   dword item = 0;
+   while( take( thread, item ) || (steal( thread ) && take( thread, item )) )
+   {
+      try
+      {
+         pJob_m->run( item, thread );
+      }
+      catch( ... )
+      {
+         Lock lock( control_m );
+         isFailed_m = true;
+      }
+   }
+}
+
+
+bool ThreadPool::Threads::take
+(
+   const dword thread,
+   dword&      item
+)
+{
+   Range& range = pRanges_m[ thread ];
+   Lock   lock( range.mutex );
+
+   const bool isTaken = (range.begin < range.end);
+   if( isTaken )
+   {
+      item = range.begin++;
+   }
+
+   return isTaken;
+}
+
+
+bool ThreadPool::Threads::steal
+(
+   const dword thread
+)
+{
+   // look round the others, from the next one
+   for( dword i = 1;  i < count_m;  ++i )
+   {
+      Range& victim = pRanges_m[ (thread + i) % count_m ];
+
+      dword begin = 0;
+      dword end   = 0;
+      {
+         // take the back half (or the last one)
+         Lock lock( victim.mutex );
+         if( victim.begin < victim.end )
+         {
+            begin      = victim.begin + ((victim.end - victim.begin) >> 1);
+            end        = victim.end;
+            victim.end = begin;
+         }
+      }
+
+      if( begin < end )
+      {
+         {
+            Range& own = pRanges_m[ thread ];
+            Lock   lock( own.mutex );
+            own.begin = begin;
+            own.end   = end;
+         }
+         {
+            Lock lock( control_m );
+            ++steals_m;
+         }
+
+         return true;
+      }
+   }
+
+   return false;
+}
+
+
+#ifdef _WIN32
+DWORD WINAPI ThreadPool::Threads::entry
+(
+   LPVOID pWorker
+)
+#else
+void* ThreadPool::Threads::entry
+(
+   void* pWorker
+)
+#endif
+{
+   Worker&  worker   = *static_cast<Worker*>( pWorker );
+   Threads& threads  = *worker.pThreads;
+
+   for( ;; )
+   {
+      worker.start.wait();
+
+      bool isQuitting = false;
+      {
+         Lock lock( threads.control_m );
+         isQuitting = threads.isQuitting_m;
+      }
+      if( isQuitting )
+      {
+         break;
+      }
+
+      threads.work( worker.index );
+
+      // last one to finish tells the caller
+      Lock lock( threads.control_m );
+      if( ++threads.finished_m == (threads.count_m - 1) )
+      {
+         threads.done_m.set();
+      }
+   }
+
+   return 0;
+}
+
+
+
+
+/// ThreadPool /////////////////////////////////////////////////////////////////
+
+
+/// statics --------------------------------------------------------------------
+const char ThreadPool::CREATION_EXCEPTION_MESSAGE[] =
+   "ThreadPool::ThreadPool() - thread creation failed";
+const char ThreadPool::JOB_EXCEPTION_MESSAGE[] =
+   "ThreadPool::run() - job threw exception";
+
+
+
+
+/// standard object services ---------------------------------------------------
+ThreadPool::Job::~Job()
+{
+}
+
+
+ThreadPool::ThreadPool
+(
+   const dword threadCount
+)
+ : pThreads_m( new Threads( (threadCount > 0) ? threadCount :
+      getProcessorCount() ) )
+{
+   if( !pThreads_m->start() )
+   {
+      pThreads_m->stop();
+      delete pThreads_m;
+
+      throw CREATION_EXCEPTION_MESSAGE;
+   }
+}
+
+
+ThreadPool::~ThreadPool()
+{
+   pThreads_m->stop();
+   delete pThreads_m;
+}
+
+
+
+
+/// commands -------------------------------------------------------------------
+void ThreadPool::run
+(
+   Job&        job,
+   const dword itemCount
+)
+{
+   Threads&    threads = *pThreads_m;
+   const dword count   = threads.count_m;
+
+   if( itemCount > 0 )
+   {
+      // divide items evenly, in order
+      const dword share     = itemCount / count;
+      const dword remainder = itemCount % count;
+      for( dword i = 0;  i < count;  ++i )
+      {
+         Threads::Range& range = threads.pRanges_m[i];
+         Lock lock( range.mutex );
+         range.begin = (share * i) + ((i < remainder) ? i : remainder);
+         range.end   = range.begin + share + ((i < remainder) ? 1 : 0);
+      }
+
+      {
+         Lock lock( threads.control_m );
+         threads.pJob_m     = &job;
+         threads.finished_m = 0;
+         threads.steals_m   = 0;
+         threads.isFailed_m = false;
+      }
+
+      // start the workers, join in, and wait for the rest
+      for( dword i = 1;  i < count;  ++i )
+      {
+         threads.pWorkers_m[i].start.set();
+      }
+      threads.work( 0 );
+      if( count > 1 )
+      {
+         threads.done_m.wait();
+      }
+
+      bool isFailed = false;
+      {
+         Lock lock( threads.control_m );
+         isFailed = threads.isFailed_m;
+      }
+      if( isFailed )
+      {
+         throw JOB_EXCEPTION_MESSAGE;
+      }
+   }
+}
+
+
+
+
+/// queries --------------------------------------------------------------------
+dword ThreadPool::getThreadCount() const
+{
+   return pThreads_m->count_m;
+}
+
+
+dword ThreadPool::getStealCount() const
+{
+   Lock lock( pThreads_m->control_m );
+
+   return pThreads_m->steals_m;
+}
+
+
+dword ThreadPool::getProcessorCount()
+{
+#ifdef _WIN32
+
+   SYSTEM_INFO info;
+   ::GetSystemInfo( &info );
+   const dword count = static_cast<dword>(info.dwNumberOfProcessors);
+
+#else
+
+   const dword count = static_cast<dword>(::sysconf( _SC_NPROCESSORS_ONLN ));
+
+#endif
+
+   return (count > 0) ? count : 1;
+}
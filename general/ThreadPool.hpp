@@ -0,0 +1,103 @@
+/*------------------------------------------------------------------------------
+
+   HXA7241 General library.
+   Copyright (c) 2004-2007,  Harrison Ainsworth / HXA7241.
+
+   http://www.hxa7241.org/
+
+------------------------------------------------------------------------------*/
+
+
+#ifndef ThreadPool_h
+#define ThreadPool_h
+
+
+
+
+#include "hxa7241_general.hpp"
+namespace hxa7241_general
+{
+
+
+/**
+ * Fixed set of worker threads, running batches of independent work items,
+ * with work-stealing.<br/><br/>
+ *
+ * run( job, itemCount ) calls job.run( item, thread ) once for every item in
+ * [0, itemCount), spread over the threads, and returns when all are done. The
+ * calling thread takes part (as thread 0), so a pool of one thread has no
+ * workers and runs everything in the caller.<br/><br/>
+ *
+ * Items are first divided into one contiguous range per thread. Each thread
+ * takes from the front of its own; when that is empty, it steals the back half
+ * of another's. So uneven items still balance, and neighbouring items mostly
+ * stay on one thread.<br/><br/>
+ *
+ * One run at a time: run must not be called concurrently, nor from within a
+ * job. If any job.run throws, the rest still run, then run throws.<br/><br/>
+ *
+ * POSIX threads, or Win32.
+ *
+ * @implementation
+ * Each range has its own lock, and workers wait on an event per thread, so
+ * there is no shared hot lock. Platform parts are hidden in the .cpp.
+ */
+class ThreadPool
+{
+/// types ----------------------------------------------------------------------
+public:
+   /**
+    * A batch of work: run is called concurrently from several threads, with
+    * different items.
+    */
+   class Job
+   {
+   public:
+      virtual ~Job();
+
+      virtual void run( dword item,
+                        dword thread ) = 0;
+   };
+
+
+/// standard object services ---------------------------------------------------
+public:
+   /** threadCount 0 means one per processor. */
+   explicit ThreadPool( dword threadCount = 0 );                      // throws
+
+           ~ThreadPool();
+private:
+            ThreadPool( const ThreadPool& );
+   ThreadPool& operator=( const ThreadPool& );
+public:
+
+
+/// commands -------------------------------------------------------------------
+           void   run( Job&  job,
+                       dword itemCount );                              // throws
+
+
+/// queries --------------------------------------------------------------------
+           dword  getThreadCount()                                        const;
+           /** number of steals in the last run. */
+           dword  getStealCount()                                         const;
+
+   static  dword  getProcessorCount();
+
+
+/// fields ---------------------------------------------------------------------
+private:
+   class Threads;
+   Threads* pThreads_m;
+
+   static const char CREATION_EXCEPTION_MESSAGE[];
+   static const char JOB_EXCEPTION_MESSAGE[];
+};
+
+
+}//namespace
+
+
+
+
+#endif//ThreadPool_h
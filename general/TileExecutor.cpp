@@ -0,0 +1,559 @@
+/*------------------------------------------------------------------------------
+
+   HXA7241 General library.
+   Copyright (c) 2004-2007,  Harrison Ainsworth / HXA7241.
+
+   http://www.hxa7241.org/
+
+------------------------------------------------------------------------------*/
+
+
+#include "TileExecutor.hpp"
+
+
+using namespace hxa7241_general;
+
+
+
+
+namespace
+{
+
+/// one item per tile, in row order
+class TileJob
+   : public ThreadPool::Job
+{
+public:
+   TileJob( TileKernel& kernel,
+            dword       width,
+            dword       height,
+            dword       tileWidth,
+            dword       tileHeight,
+            dword       halo );
+
+   virtual void run( dword item,
+                     dword thread );
+
+   dword getCount()                                                       const;
+
+private:
+   TileKernel& kernel_m;
+   dword       width_m;
+   dword       height_m;
+   dword       tileWidth_m;
+   dword       tileHeight_m;
+   dword       halo_m;
+   dword       across_m;
+   dword       down_m;
+};
+
+
+TileJob::TileJob
+(
+   TileKernel& kernel,
+   const dword width,
+   const dword height,
+   const dword tileWidth,
+   const dword tileHeight,
+   const dword halo
+)
+ : kernel_m    ( kernel )
+ , width_m     ( width )
+ , height_m    ( height )
+ , tileWidth_m ( tileWidth )
+ , tileHeight_m( tileHeight )
+ , halo_m      ( halo )
+ , across_m    ( getTileCount( width, tileWidth ) )
+ , down_m      ( getTileCount( height, tileHeight ) )
+{
+}
+
+
+void TileJob::run
+(
+   const dword item,
+   const dword thread
+)
+{
+   // tile, clipped to the domain
+   TileRect tile;
+   tile.x      = (item % across_m) * tileWidth_m;
+   tile.y      = (item / across_m) * tileHeight_m;
+   tile.width  = (width_m  - tile.x < tileWidth_m)  ? (width_m  - tile.x) :
+      tileWidth_m;
+   tile.height = (height_m - tile.y < tileHeight_m) ? (height_m - tile.y) :
+      tileHeight_m;
+
+   // region: tile with halo, clipped to the domain
+   TileRect region;
+   region.x      = (tile.x > halo_m) ? (tile.x - halo_m) : 0;
+   region.y      = (tile.y > halo_m) ? (tile.y - halo_m) : 0;
+   region.width  = ((width_m  - (tile.x + tile.width) > halo_m) ?
+      (tile.x + tile.width + halo_m) : width_m) - region.x;
+   region.height = ((height_m - (tile.y + tile.height) > halo_m) ?
+      (tile.y + tile.height + halo_m) : height_m) - region.y;
+
+   kernel_m.processTile( tile, region, thread );
+}
+
+
+dword TileJob::getCount() const
+{
+   return across_m * down_m;
+}
+
+}
+
+
+
+
+/// TileKernel /////////////////////////////////////////////////////////////////
+TileKernel::~TileKernel()
+{
+}
+
+
+
+
+/// other //////////////////////////////////////////////////////////////////////
+void hxa7241_general::executeTiles
+(
+   ThreadPool& pool,
+   TileKernel& kernel,
+   const dword width,
+   const dword height,
+   const dword tileWidth,
+   const dword tileHeight,
+   const dword halo
+)
+{
+   if( (width > 0) & (height > 0) & (tileWidth > 0) & (tileHeight > 0) )
+   {
+      TileJob job( kernel, width, height, tileWidth, tileHeight,
+         (halo > 0) ? halo : 0 );
+
+      pool.run( job, job.getCount() );
+   }
+}
+
+
+dword hxa7241_general::getCacheTileSize
+(
+   const dword elementBytes,
+   const dword halo,
+   const dword cacheBytes
+)
+{
+   // grow while the next size still fits (in double, so no overflow)
+   dword size = 8;
+   for( ;; )
+   {
+      const double next   = static_cast<double>(size + 8);
+      const double region = next + (2.0 * static_cast<double>(halo));
+      const double bytes  = ((region * region) + (next * next)) *
+         static_cast<double>(elementBytes);
+      if( (bytes > static_cast<double>(cacheBytes)) | (size >= 0x4000) )
+      {
+         break;
+      }
+      size += 8;
+   }
+
+   return size;
+}
+
+
+
+
+
+
+
+
+/// test -----------------------------------------------------------------------
+#ifdef TESTING
+
+
+#include <ostream>
+
+#include "Array.hpp"
+#include "Stopwatch.hpp"
+
+
+namespace
+{
+
+/// counts how often each item runs, and checks the thread index
+class CountJob
+   : public ThreadPool::Job
+{
+public:
+   CountJob( Array<dword>& counts, const dword threadCount,
+      const dword failItem )
+    : counts_m     ( counts )
+    , threadCount_m( threadCount )
+    , failItem_m   ( failItem )
+    , isThreadOk_m ( true )
+   {
+      counts_m.zeroStorage();
+   }
+
+   virtual void run( const dword item, const dword thread )
+   {
+      // uneven work: some items much longer
+      volatile dword spin = (item % 7) ? 10 : 20000;
+      while( spin-- > 0 ) {}
+
+      ++counts_m[ item ];
+      if( (thread < 0) | (thread >= threadCount_m) )
+      {
+         isThreadOk_m = false;
+      }
+
+      if( item == failItem_m )
+      {
+         throw "CountJob - deliberate failure";
+      }
+   }
+
+   bool isEachOnce() const
+   {
+      bool is = isThreadOk_m;
+      for( dword i = 0;  i < counts_m.getLength();  ++i )
+      {
+         is &= (1 == counts_m[i]);
+      }
+      return is;
+   }
+
+private:
+   Array<dword>& counts_m;
+   dword         threadCount_m;
+   dword         failItem_m;
+   bool          isThreadOk_m;
+};
+
+
+/// marks each element of its tile, and checks the region
+class MarkKernel
+   : public TileKernel
+{
+public:
+   MarkKernel( SheetFlat<dword>& marks, const dword halo )
+    : marks_m ( marks )
+    , halo_m  ( halo )
+    , isOk_m  ( true )
+   {
+   }
+
+   virtual void processTile( const TileRect& tile, const TileRect& region,
+      const dword )
+   {
+      bool is = (tile.width > 0) & (tile.height > 0);
+
+      // region is the tile grown by halo, clipped
+      const dword x0 = (tile.x - halo_m > 0) ? (tile.x - halo_m) : 0;
+      const dword y0 = (tile.y - halo_m > 0) ? (tile.y - halo_m) : 0;
+      const dword x1 = (tile.x + tile.width + halo_m < marks_m.getWidth()) ?
+         (tile.x + tile.width + halo_m) : marks_m.getWidth();
+      const dword y1 = (tile.y + tile.height + halo_m < marks_m.getHeight()) ?
+         (tile.y + tile.height + halo_m) : marks_m.getHeight();
+      is &= (x0 == region.x) & (y0 == region.y) &
+         (x1 - x0 == region.width) & (y1 - y0 == region.height);
+
+      for( dword y = tile.y;  y < tile.y + tile.height;  ++y )
+      {
+         for( dword x = tile.x;  x < tile.x + tile.width;  ++x )
+         {
+            ++marks_m.get( x, y );
+         }
+      }
+
+      // (a benign race, only ever clearing)
+      if( !is ) isOk_m = false;
+   }
+
+   bool isOk() const
+   {
+      bool is = isOk_m;
+      for( dword i = 0;  i < marks_m.getLength();  ++i )
+      {
+         is &= (1 == marks_m[i]);
+      }
+      return is;
+   }
+
+private:
+   SheetFlat<dword>& marks_m;
+   dword             halo_m;
+   volatile bool     isOk_m;
+};
+
+
+/// 5x5 box sum, clamped at the edges
+template<class TYPE>
+class BoxKernel
+   : public SheetTileKernel<TYPE, TYPE>
+{
+public:
+   BoxKernel( const SheetView<const TYPE>& source,
+      const SheetView<TYPE>& destination )
+    : SheetTileKernel<TYPE, TYPE>( source, destination )
+   {
+   }
+
+   virtual void processViews( const SheetView<const TYPE>& source,
+      const SheetView<TYPE>& destination, const dword tileX,
+      const dword tileY, const dword )
+   {
+      for( dword y = 0;  y < destination.getHeight();  ++y )
+      {
+         TYPE*const pRow = destination.getRow( y );
+         for( dword x = 0;  x < destination.getWidth();  ++x )
+         {
+            TYPE sum = TYPE();
+            for( dword j = -2;  j <= 2;  ++j )
+            {
+               for( dword i = -2;  i <= 2;  ++i )
+               {
+                  sum += source.template getWrapped<WrapClamp>( tileX + x + i,
+                     tileY + y + j );
+               }
+            }
+            pRow[x] = sum;
+         }
+      }
+   }
+};
+
+
+/// the same, whole sheet, one thread
+template<class TYPE>
+void boxSerial
+(
+   const SheetFlat<TYPE>& source,
+   SheetFlat<TYPE>&       destination
+)
+{
+   for( dword y = 0;  y < source.getHeight();  ++y )
+   {
+      for( dword x = 0;  x < source.getWidth();  ++x )
+      {
+         TYPE sum = TYPE();
+         for( dword j = -2;  j <= 2;  ++j )
+         {
+            for( dword i = -2;  i <= 2;  ++i )
+            {
+               sum += source.template getWrapped<WrapClamp>( x + i, y + j );
+            }
+         }
+         destination.get( x, y ) = sum;
+      }
+   }
+}
+
+
+void benchmarkScaling
+(
+   std::ostream& out
+)
+{
+   static const dword SIZE = 2048;
+
+   SheetFlat<float> source( SIZE, SIZE );
+   SheetFlat<float> destination( SIZE, SIZE );
+   for( dword i = source.getLength();  i-- > 0; )
+   {
+      source[i] = static_cast<float>(i & 0xFF);
+   }
+
+   const dword tileSize = getCacheTileSize( sizeof(float), 2 );
+   const dword maxThreads = ThreadPool::getProcessorCount();
+
+   out << "benchmark  5x5 box, " << SIZE << " x " << SIZE << " floats, tiles " <<
+      tileSize << ", processors " << maxThreads << "\n";
+
+   double time1 = 0.0;
+   for( dword threads = 1;  threads <= maxThreads; )
+   {
+      ThreadPool pool( threads );
+      BoxKernel<float> kernel( source, destination );
+
+      Stopwatch stopwatch;
+      executeTiles( pool, kernel, SIZE, SIZE, tileSize, tileSize, 2 );
+      const double time = stopwatch.getSeconds();
+      time1 = (1 == threads) ? time : time1;
+
+      out << "   threads " << threads << "  " << (time * 1e3) << " ms  speedup " <<
+         (time1 / time) << "  steals " << pool.getStealCount() << "\n";
+
+      // powers of two, and the maximum
+      threads = ((threads < maxThreads) & ((threads * 2) > maxThreads)) ?
+         maxThreads : (threads * 2);
+   }
+   out << "\n";
+}
+
+}
+
+
+namespace hxa7241_general
+{
+
+
+bool test_TileExecutor
+(
+   std::ostream* pOut,
+   const bool    isVerbose,
+   const dword   //seed
+)
+{
+   bool isOk = true;
+
+   if( pOut ) *pOut << "[ test_TileExecutor ]\n\n";
+
+
+   // pool
+   {
+      bool is = true;
+
+      static const dword THREADS[] = { 1, 2, 3, 8 };
+      static const dword ITEMS[]   = { 0, 1, 5, 1000 };
+      for( dword t = 0;  t < 4;  ++t )
+      {
+         ThreadPool pool( THREADS[t] );
+         is &= (THREADS[t] == pool.getThreadCount());
+
+         // each item exactly once, repeatedly
+         for( dword i = 0;  i < 4;  ++i )
+         {
+            Array<dword> counts( ITEMS[i] );
+            CountJob job( counts, THREADS[t], -1 );
+            pool.run( job, ITEMS[i] );
+            is &= job.isEachOnce();
+
+            if( pOut && isVerbose && (1000 == ITEMS[i]) ) *pOut << "threads " <<
+               THREADS[t] << "  steals " << pool.getStealCount() << "\n";
+         }
+
+         // a failing item: the rest still done, then throws
+         {
+            Array<dword> counts( 100 );
+            CountJob job( counts, THREADS[t], 37 );
+            bool isThrown = false;
+            try
+            {
+               pool.run( job, 100 );
+            }
+            catch( const char* )
+            {
+               isThrown = true;
+            }
+            is &= isThrown & job.isEachOnce();
+         }
+
+         // still usable
+         Array<dword> counts( 50 );
+         CountJob job( counts, THREADS[t], -1 );
+         pool.run( job, 50 );
+         is &= job.isEachOnce();
+      }
+
+      is &= (ThreadPool::getProcessorCount() >= 1);
+      is &= (ThreadPool( 0 ).getThreadCount() ==
+         ThreadPool::getProcessorCount());
+
+      if( pOut && isVerbose ) *pOut << "\n";
+
+      if( pOut ) *pOut << "pool : " <<
+         (is ? "--- succeeded" : "*** failed") << "\n\n";
+
+      isOk &= is;
+   }
+
+   // tiles and regions
+   {
+      bool is = true;
+
+      static const dword SIZES[][2] = { {1, 1}, {37, 21}, {64, 64}, {5, 200} };
+      static const dword TILES[][2] = { {8, 8}, {13, 7}, {64, 1}, {100, 100} };
+      ThreadPool pool( 4 );
+      for( dword s = 0;  s < 4;  ++s )
+      {
+         for( dword t = 0;  t < 4;  ++t )
+         {
+            for( dword halo = 0;  halo < 4;  halo += 3 )
+            {
+               SheetFlat<dword> marks( SIZES[s][0], SIZES[s][1] );
+               marks.zeroStorage();
+
+               MarkKernel kernel( marks, halo );
+               executeTiles( pool, kernel, marks.getWidth(), marks.getHeight(),
+                  TILES[t][0], TILES[t][1], halo );
+               is &= kernel.isOk();
+            }
+         }
+      }
+
+      // cache tile size
+      is &= (0 == getCacheTileSize( 4 ) % 8) & (getCacheTileSize( 4 ) >= 8);
+      is &= (getCacheTileSize( 4, 16 ) < getCacheTileSize( 4 ));
+      is &= (8 == getCacheTileSize( 1000000 ));
+
+      if( pOut && isVerbose ) *pOut << "cache tile size (float) " <<
+         getCacheTileSize( 4 ) << "\n\n";
+
+      if( pOut ) *pOut << "tiles and regions : " <<
+         (is ? "--- succeeded" : "*** failed") << "\n\n";
+
+      isOk &= is;
+   }
+
+   // neighbourhood kernel, against serial
+   {
+      bool is = true;
+
+      SheetFlat<udword> source( 101, 67 );
+      for( dword i = source.getLength();  i-- > 0; )
+      {
+         source[i] = static_cast<udword>(i * 2654435761u) >> 20;
+      }
+      SheetFlat<udword> serial( source.getWidth(), source.getHeight() );
+      boxSerial( source, serial );
+
+      for( dword threads = 1;  threads <= 4;  threads += 3 )
+      {
+         ThreadPool pool( threads );
+         SheetFlat<udword> parallel( source.getWidth(), source.getHeight() );
+         BoxKernel<udword> kernel( source, parallel );
+         executeTiles( pool, kernel, source.getWidth(), source.getHeight(),
+            16, 9, 2 );
+
+         for( dword i = 0;  i < serial.getLength();  ++i )
+         {
+            is &= (serial[i] == parallel[i]);
+         }
+      }
+
+      if( pOut ) *pOut << "neighbourhood kernel : " <<
+         (is ? "--- succeeded" : "*** failed") << "\n\n";
+
+      isOk &= is;
+   }
+
+   if( pOut && isVerbose ) benchmarkScaling( *pOut );
+
+
+   if( pOut ) *pOut << (isOk ? "--- successfully" : "*** failurefully") <<
+      " completed " << "\n\n\n";
+
+   if( pOut ) pOut->flush();
+
+
+   return isOk;
+}
+
+
+}//namespace
+
+
+#endif//TESTING
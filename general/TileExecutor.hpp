@@ -0,0 +1,159 @@
+/*------------------------------------------------------------------------------
+
+   HXA7241 General library.
+   Copyright (c) 2004-2007,  Harrison Ainsworth / HXA7241.
+
+   http://www.hxa7241.org/
+
+------------------------------------------------------------------------------*/
+
+
+#ifndef TileExecutor_h
+#define TileExecutor_h
+
+
+#include "SheetView.hpp"
+#include "ThreadPool.hpp"
+
+
+
+
+#include "hxa7241_general.hpp"
+namespace hxa7241_general
+{
+
+
+/**
+ * Rectangle of a 2D domain.
+ */
+struct TileRect
+{
+   dword x;
+   dword y;
+   dword width;
+   dword height;
+};
+
+
+/**
+ * Per-tile operation, for executeTiles.<br/><br/>
+ *
+ * processTile is called concurrently from several threads, each with a
+ * different tile. region is the tile grown by the halo on every side, clipped
+ * to the domain -- the area a neighbourhood kernel reads. thread is in
+ * [0, ThreadPool::getThreadCount), for any per-thread scratch storage.
+ */
+class TileKernel
+{
+public:
+   virtual ~TileKernel();
+
+   virtual void processTile( const TileRect& tile,
+                             const TileRect& region,
+                             dword           thread ) = 0;
+};
+
+
+/**
+ * TileKernel from one Sheet to another (possibly the same, if the kernel only
+ * reads what it writes).<br/><br/>
+ *
+ * processViews gets the source region (with halo) and the destination tile,
+ * as views, and where the tile starts within the source region.
+ */
+template<class IN, class OUT>
+class SheetTileKernel
+   : public TileKernel
+{
+public:
+            SheetTileKernel( const SheetView<const IN>& source,
+                             const SheetView<OUT>&      destination );
+
+   virtual void processTile( const TileRect& tile,
+                             const TileRect& region,
+                             dword           thread );
+
+   virtual void processViews( const SheetView<const IN>& source,
+                              const SheetView<OUT>&      destination,
+                              dword                      tileX,
+                              dword                      tileY,
+                              dword                      thread ) = 0;
+
+private:
+   SheetView<const IN> source_m;
+   SheetView<OUT>      destination_m;
+};
+
+
+
+
+/**
+ * Run kernel over a width by height domain, divided into tiles, on the pool's
+ * threads.<br/><br/>
+ *
+ * Tiles are tileWidth by tileHeight (smaller at the right and bottom edges),
+ * in row order -- so each thread starts with a band. Every element is in
+ * exactly one tile. If the kernel throws, the other tiles are still done, then
+ * this throws.
+ *
+ * @see getCacheTileSize
+ */
+void executeTiles( ThreadPool& pool,
+                   TileKernel& kernel,
+                   dword       width,
+                   dword       height,
+                   dword       tileWidth,
+                   dword       tileHeight,
+                   dword       halo = 0 );                             // throws
+
+/**
+ * Tile side for which source region (with halo) and destination tile fit
+ * together in cacheBytes (default: a typical per-core L2 share). A multiple of
+ * 8, at least 8.
+ */
+dword getCacheTileSize( dword elementBytes,
+                        dword halo = 0,
+                        dword cacheBytes = 256 * 1024 );
+
+
+
+
+
+
+
+
+/// INLINES ///
+
+template<class IN, class OUT>
+SheetTileKernel<IN, OUT>::SheetTileKernel
+(
+   const SheetView<const IN>& source,
+   const SheetView<OUT>&      destination
+)
+ : source_m     ( source )
+ , destination_m( destination )
+{
+}
+
+
+template<class IN, class OUT>
+void SheetTileKernel<IN, OUT>::processTile
+(
+   const TileRect& tile,
+   const TileRect& region,
+   const dword     thread
+)
+{
+   processViews(
+      source_m.getSubView( region.x, region.y, region.width, region.height ),
+      destination_m.getSubView( tile.x, tile.y, tile.width, tile.height ),
+      tile.x - region.x, tile.y - region.y, thread );
+}
+
+
+}//namespace
+
+
+
+
+#endif//TileExecutor_h
@@ -0,0 +1,310 @@
+/*------------------------------------------------------------------------------
+
+   HXA7241 General library.
+   Copyright (c) 2004-2007,  Harrison Ainsworth / HXA7241.
+
+   http://www.hxa7241.org/
+
+------------------------------------------------------------------------------*/
+
+
+#include "Wrap.hpp"
+
+
+using namespace hxa7241_general;
+
+
+
+
+
+
+
+
+/// test -----------------------------------------------------------------------
+#ifdef TESTING
+
+
+#include <math.h>
+#include <ostream>
+
+#include "RandomMwc2.hpp"
+#include "Array.hpp"
+#include "Sheet.hpp"
+#include "Stopwatch.hpp"
+
+
+namespace
+{
+
+/// reference versions, with division
+
+dword repeatRef( const dword i, const dword length )
+{
+   dword r = i % length;
+   return (r >= 0) ? r : r + length;
+}
+
+dword mirrorRef( const dword i, const dword length )
+{
+   const dword  r = repeatRef( i, length );
+   const double q = ::floor( ((static_cast<double>(i) -
+      static_cast<double>(r)) / static_cast<double>(length)) + 0.5 );
+   const bool isOdd = (0.0 != (q - (2.0 * ::floor( q * 0.5 ))));
+   return isOdd ? (length - 1 - r) : r;
+}
+
+dword clampRef( const dword i, const dword length )
+{
+   return (i < 0) ? 0 : ((i >= length) ? (length - 1) : i);
+}
+
+
+/// check all modes at one index
+bool checkOne( std::ostream* pOut, const dword i, const dword length )
+{
+   const bool is[] = {
+      WrapRepeat::index( i, length ) == repeatRef( i, length ),
+      WrapMirror::index( i, length ) == mirrorRef( i, length ),
+      WrapClamp::index( i, length )  == clampRef( i, length ) };
+
+   const bool isOk = is[0] & is[1] & is[2];
+   if( !isOk && pOut )
+   {
+      *pOut << "mismatch  i " << i << "  length " << length << "  " <<
+         is[0] << is[1] << is[2] << "\n";
+   }
+
+   return isOk;
+}
+
+
+/// time summing wrapped lookups over a range of indexs
+template<class WRAP>
+udword sumWrapped
+(
+   const udword* pTable,
+   const dword   length,
+   const dword   passes
+)
+{
+   udword sum = 0;
+
+   for( dword p = passes;  p-- > 0; )
+   {
+      for( dword i = -3 * length;  i < 3 * length;  ++i )
+      {
+         sum += pTable[ WRAP::index( i, length ) ];
+      }
+   }
+
+   return sum;
+}
+
+
+/// the former wrapping, for comparison
+class WrapModulo
+{
+public:
+   static dword index( const dword i, const dword length )
+   {
+      return (i >= 0 ? i : -i) % length;
+   }
+};
+
+
+void benchmarkWrap
+(
+   std::ostream& out
+)
+{
+   static const dword PASSES = 2000;
+
+   // lengths through volatile, so not known at compile time
+   volatile dword lengths[] = { 4096, 4099 };
+
+   Array<udword> table( 4099 );
+   for( dword i = table.getLength();  i-- > 0; )
+   {
+      table[i] = static_cast<udword>(i);
+   }
+
+   for( dword l = 0;  l < 2;  ++l )
+   {
+      const dword length = lengths[l];
+      const double scale = 1e9 / (6.0 * static_cast<double>(length) *
+         static_cast<double>(PASSES));
+
+      static const char* NAMES[] = { "modulo", "repeat", "mirror", "clamp" };
+      double times[4];
+      udword sums[4];
+
+      Stopwatch stopwatch;
+      sums[0]  = sumWrapped<WrapModulo>( table.getStorage(), length, PASSES );
+      times[0] = stopwatch.getSeconds();
+
+      stopwatch.start();
+      sums[1]  = sumWrapped<WrapRepeat>( table.getStorage(), length, PASSES );
+      times[1] = stopwatch.getSeconds();
+
+      stopwatch.start();
+      sums[2]  = sumWrapped<WrapMirror>( table.getStorage(), length, PASSES );
+      times[2] = stopwatch.getSeconds();
+
+      stopwatch.start();
+      sums[3]  = sumWrapped<WrapClamp>( table.getStorage(), length, PASSES );
+      times[3] = stopwatch.getSeconds();
+
+      out << "benchmark  length " << length << "\n";
+      for( dword m = 0;  m < 4;  ++m )
+      {
+         out << "   " << NAMES[m] << "  " << (times[m] * scale) << " ns" <<
+            "  (sum " << sums[m] << ")\n";
+      }
+   }
+   out << "\n";
+}
+
+}
+
+
+namespace hxa7241_general
+{
+
+
+bool test_Wrap
+(
+   std::ostream* pOut,
+   const bool    isVerbose,
+   const dword   seed
+)
+{
+   bool isOk = true;
+
+   if( pOut ) *pOut << "[ test_Wrap ]\n\n";
+
+
+   // exhaustive, small lengths
+   {
+      bool is = true;
+
+      for( dword length = 1;  length <= 70;  ++length )
+      {
+         for( dword i = -5 * length - 3;  i <= 5 * length + 3;  ++i )
+         {
+            is &= checkOne( pOut, i, length );
+         }
+      }
+
+      if( pOut ) *pOut << "small lengths : " <<
+         (is ? "--- succeeded" : "*** failed") << "\n\n";
+
+      isOk &= is;
+   }
+
+   // extremes
+   {
+      bool is = true;
+
+      static const dword LENGTHS[] = { 1, 2, 3, 1000003, 0x00100000,
+         0x3FFFFFFF, 0x40000000, 0x40000001, 0x7FFFFFFE, DWORD_MAX };
+      static const dword INDEXS[]  = { 0, 1, -1, DWORD_MAX, DWORD_MAX - 1,
+         DWORD_MIN, DWORD_MIN + 1, 1000003, -1000003, 0x40000000,
+         -0x40000000, 0x3FFFFFFF, -0x3FFFFFFF, 0x7FFFFFFE, -0x7FFFFFFE };
+
+      const dword lCount = sizeof(LENGTHS) / sizeof(LENGTHS[0]);
+      const dword iCount = sizeof(INDEXS)  / sizeof(INDEXS[0]);
+      for( dword l = 0;  l < lCount;  ++l )
+      {
+         for( dword i = 0;  i < iCount;  ++i )
+         {
+            for( dword d = -2;  d <= 2;  ++d )
+            {
+               // offset, skipping any overflow
+               const double index = static_cast<double>(INDEXS[i]) +
+                  static_cast<double>(d);
+               if( (index >= DWORD_MIN) & (index <= DWORD_MAX) )
+               {
+                  is &= checkOne( pOut, static_cast<dword>(index),
+                     LENGTHS[l] );
+               }
+            }
+         }
+      }
+
+      if( pOut ) *pOut << "extremes : " <<
+         (is ? "--- succeeded" : "*** failed") << "\n\n";
+
+      isOk &= is;
+   }
+
+   // random
+   {
+      bool is = true;
+
+      const RandomMwc2 random( seed );
+      for( dword j = 1000000;  j-- > 0; )
+      {
+         const dword i      = static_cast<dword>(random.getUdword());
+         const dword shift  = static_cast<dword>(random.getUdword() % 31);
+         const dword length = static_cast<dword>(
+            (random.getUdword() >> (1 + shift)) | 1u );
+
+         is &= checkOne( pOut, i, length );
+      }
+
+      if( pOut ) *pOut << "random : " <<
+         (is ? "--- succeeded" : "*** failed") << "\n\n";
+
+      isOk &= is;
+   }
+
+   // containers
+   {
+      bool is = true;
+
+      Array<dword> a( 5 );
+      Sheet<dword> s( 3, 2 );
+      for( dword i = 0;  i < 5;  ++i )
+      {
+         a[i] = i;
+      }
+      for( dword i = 0;  i < 6;  ++i )
+      {
+         s[i] = i;
+      }
+
+      is &= (4 == a.get( -9 )) & (1 == a.getFlat().get( 6 ));
+      is &= (1 == a.getWrapped<WrapRepeat>( -9 ));
+      is &= (1 == a.getWrapped<WrapMirror>( -2 ));
+      is &= (4 == a.getFlat().getWrapped<WrapMirror>( 5 ));
+      is &= (0 == a.getWrapped<WrapClamp>( -7 ));
+      is &= (4 == a.getWrapped<WrapClamp>( 7 ));
+
+      is &= (5 == s.getWrapped<WrapRepeat>( -1, 3 ));
+      is &= (4 == s.getWrapped<WrapMirror>( -2, 2 ));
+      is &= (2 == s.getFlat().getWrapped<WrapClamp>( 9, -4 ));
+      is &= (s.getRow( 1 ) == s.getRow( -3 ));
+
+      if( pOut ) *pOut << "containers : " <<
+         (is ? "--- succeeded" : "*** failed") << "\n\n";
+
+      isOk &= is;
+   }
+
+   if( pOut && isVerbose ) benchmarkWrap( *pOut );
+
+
+   if( pOut ) *pOut << (isOk ? "--- successfully" : "*** failurefully") <<
+      " completed " << "\n\n\n";
+
+   if( pOut ) pOut->flush();
+
+
+   return isOk;
+}
+
+
+}//namespace
+
+
+#endif//TESTING
@@ -0,0 +1,184 @@
+/*------------------------------------------------------------------------------
+
+   HXA7241 General library.
+   Copyright (c) 2004-2007,  Harrison Ainsworth / HXA7241.
+
+   http://www.hxa7241.org/
+
+------------------------------------------------------------------------------*/
+
+
+#ifndef Wrap_h
+#define Wrap_h
+
+
+
+
+#include "hxa7241_general.hpp"
+namespace hxa7241_general
+{
+
+
+/**
+ * Addressing modes for out-of-range indexs, chosen by template parameter.<br/>
+ * <br/>
+ *
+ * Each has one static function, index( i, length ), mapping any i into
+ * [0, length). length must be > 0.<br/><br/>
+ *
+ * * WrapRepeat -- periodic tiling: ... 2 3 | 0 1 2 3 | 0 1 ...<br/>
+ * * WrapMirror -- reflected tiling: ... 1 0 | 0 1 2 3 | 3 2 ...<br/>
+ * * WrapClamp  -- edge extension:   ... 0 0 | 0 1 2 3 | 3 3 ...<br/><br/>
+ *
+ * No integer division: power-of-two lengths take a mask, others a multiply by
+ * the (double) reciprocal with a branchless correction step. In a loop over a
+ * fixed length, the reciprocal and the power-of-two test are invariant, so get
+ * hoisted out.
+ *
+ * @see ArrayFlat::getWrapped, SheetFlat::getWrapped
+ */
+class WrapRepeat
+{
+public:
+   static dword index( dword i,
+                       dword length );
+};
+
+
+class WrapMirror
+{
+public:
+   static dword index( dword i,
+                       dword length );
+};
+
+
+class WrapClamp
+{
+public:
+   static dword index( dword i,
+                       dword length );
+};
+
+
+/**
+ * Floor division, without integer divide (for the Wrap modes).<br/><br/>
+ *
+ * remainder is in [0, length), quotient is floor(i / length). length must be
+ * > 0.
+ */
+void divideFloor_( dword  i,
+                   dword  length,
+                   dword& quotient,
+                   dword& remainder );
+
+
+
+
+/// INLINES ///
+
+inline
+void divideFloor_
+(
+   const dword i,
+   const dword length,
+   dword&      quotient,
+   dword&      remainder
+)
+{
+   // approximate quotient -- truncated, and (from reciprocal rounding) at most
+   // one too small in magnitude
+   dword q = static_cast<dword>( static_cast<double>(i) *
+      (1.0 / static_cast<double>(length)) );
+
+   // remainder, in [-length, length] (unsigned arithmetic, so no overflow)
+   dword r = static_cast<dword>( static_cast<udword>(i) -
+      (static_cast<udword>(q) * static_cast<udword>(length)) );
+
+   // correct by one step either way, with masks rather than branches
+   const dword under = -static_cast<dword>(r < 0);
+   const dword over  = -static_cast<dword>(r >= length);
+   r += (length & under) - (length & over);
+   q += under - over;
+
+   quotient  = q;
+   remainder = r;
+}
+
+
+inline
+dword WrapRepeat::index
+(
+   const dword i,
+   const dword length
+)
+{
+   const udword mask = static_cast<udword>(length) - 1u;
+
+   // power of two: mask
+   if( 0u == (static_cast<udword>(length) & mask) )
+   {
+      return static_cast<dword>( static_cast<udword>(i) & mask );
+   }
+   // other: reciprocal reduction
+   else
+   {
+      dword q;
+      dword r;
+      divideFloor_( i, length, q, r );
+
+      return r;
+   }
+}
+
+
+inline
+dword WrapMirror::index
+(
+   const dword i,
+   const dword length
+)
+{
+   const udword mask = static_cast<udword>(length) - 1u;
+
+   // power of two: mask, and flip on odd periods
+   if( 0u == (static_cast<udword>(length) & mask) )
+   {
+      const udword flip = 0u - static_cast<udword>(
+         0u != (static_cast<udword>(i) & static_cast<udword>(length)) );
+
+      return static_cast<dword>( (static_cast<udword>(i) ^ flip) & mask );
+   }
+   // other: reciprocal reduction, and reflect on odd periods
+   else
+   {
+      dword q;
+      dword r;
+      divideFloor_( i, length, q, r );
+
+      const dword flip = -(q & 1);
+
+      return (r & ~flip) | ((length - 1 - r) & flip);
+   }
+}
+
+
+inline
+dword WrapClamp::index
+(
+   dword       i,
+   const dword length
+)
+{
+   i = (i >= 0) ? i : 0;
+
+   return (i < length) ? i : (length - 1);
+}
+
+
+}//namespace
+
+
+
+
+#endif//Wrap_h
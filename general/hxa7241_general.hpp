@@ -22,17 +22,44 @@ namespace hxa7241_general
    using namespace hxa7241;
 
    //class Array<>;
+   //class ArrayFlat<>;
    //class Bounded<>;
    //clamps
    class Float01o;
    class Float01c;
    //FpToInt
+   class half;
    //hxa7241vector
    //LogFast
+   //MathFast
+   //class NumaLocal<>;
+   class NumaNodes;
    //PowFast
    class RandomMwc1;
    class RandomMwc2;
+   class RandomPhilox;
+   class RandomXoshiro;
    //class Sheet<>;
+   //class SheetFlat<>;
+   //SheetBulk
+   class SheetFile;
+   //class SheetTiled<>;
+   //class SheetView<>;
+   //class LayoutTiles<>;
+   class LayoutMorton;
+   class Stopwatch;
+   class ThreadPool;
+   class TileKernel;
+   //class SheetTileKernel<>;
+   class StorageNew;
+   //class StorageAligned<>;
+   class Arena;
+   class Pool;
+   //class StorageArena<>;
+   class StoragePool;
+   class WrapRepeat;
+   class WrapMirror;
+   class WrapClamp;
 }
 
 
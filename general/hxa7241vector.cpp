@@ -0,0 +1,361 @@
+/*------------------------------------------------------------------------------
+
+   HXA7241 General library.
+   Copyright (c) 2004-2007,  Harrison Ainsworth / HXA7241.
+
+   http://www.hxa7241.org/
+
+------------------------------------------------------------------------------*/
+
+
+/// conditional compilations
+#ifdef __linux__
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include <cstddef>
+
+#include "hxa7241vector.hpp"
+
+
+using namespace hxa7241_general;
+
+
+
+
+/// functions ------------------------------------------------------------------
+void* hxa7241_general::releasePages
+(
+   void* pBegin,
+   void* pEnd
+)
+{
+#ifdef __linux__
+
+   // whole pages only: round begin up and end down
+   const std::size_t page  = static_cast<std::size_t>(::sysconf(
+      _SC_PAGESIZE ));
+   const std::size_t begin = (reinterpret_cast<std::size_t>(pBegin) +
+      (page - 1)) & ~(page - 1);
+   const std::size_t end   = reinterpret_cast<std::size_t>(pEnd) &
+      ~(page - 1);
+
+   if( (begin < end) && (0 == ::madvise( reinterpret_cast<void*>(begin),
+      end - begin, MADV_DONTNEED )) )
+   {
+      return reinterpret_cast<void*>(end);
+   }
+
+#endif
+
+   return pBegin;
+}
+
+
+
+
+
+
+
+
+/// test -----------------------------------------------------------------------
+#ifdef TESTING
+
+
+#include <ostream>
+#include <fstream>
+#include <string>
+
+
+namespace
+{
+
+/// plain vertex data
+struct Vertex
+{
+   float x;
+   float y;
+   float z;
+   float w;
+};
+
+}
+
+
+namespace hxa7241_general
+{
+   template<>
+   struct IsPlainData<Vertex> { enum { VALUE = true }; };
+}
+
+
+namespace
+{
+
+
+/// -1 if not measurable (not Linux)
+long readStatusKb( const char* pName )
+{
+   long kb = -1;
+
+   std::ifstream status( "/proc/self/status" );
+   std::string   name;
+   while( (status >> name) && (kb < 0) )
+   {
+      if( name == pName )
+      {
+         status >> kb;
+      }
+   }
+
+   return kb;
+}
+
+
+/// reset the peak RSS (VmHWM) to the current RSS
+bool resetPeakRss()
+{
+   std::ofstream clearRefs( "/proc/self/clear_refs" );
+   clearRefs << "5";
+   clearRefs.flush();
+
+   return !!clearRefs;
+}
+
+
+/// rise of peak RSS during a shrink, in KB (negative if RSS only fell)
+bool measurePeakRise( std::vector<Vertex>& v,
+                      void (*shrink)( std::vector<Vertex>& ),
+                      long&                rise )
+{
+   const bool isReset = resetPeakRss();
+   const long before  = readStatusKb( "VmRSS:" );
+   shrink( v );
+   const long peak    = readStatusKb( "VmHWM:" );
+
+   rise = peak - before;
+
+   return isReset & (before >= 0) & (peak >= 0);
+}
+
+
+/// vector with spare reserve, as from growth
+void makeVertexs( std::vector<Vertex>& v, const dword count )
+{
+   for( dword i = 0;  i < count;  ++i )
+   {
+      const Vertex vertex = { static_cast<float>(i), 1.0f, 2.0f, 3.0f };
+      v.push_back( vertex );
+   }
+}
+
+
+bool isVertexsOk( const std::vector<Vertex>& v, const dword count )
+{
+   bool is = (v.size() == static_cast<unsigned>(count)) &
+      (v.capacity() == v.size());
+   for( dword i = 0;  is & (i < count);  ++i )
+   {
+      is &= (v[i].x == static_cast<float>(i)) & (v[i].w == 3.0f);
+   }
+
+   return is;
+}
+
+
+void unreserveVertexs( std::vector<Vertex>& v )
+{
+   unreserve( v );
+}
+
+
+void compactVertexs( std::vector<Vertex>& v )
+{
+   compact( v );
+}
+
+}
+
+
+namespace hxa7241_general
+{
+
+
+bool test_hxa7241vector
+(
+   std::ostream* pOut,
+   const bool    isVerbose,
+   const dword   //seed
+)
+{
+   bool isOk = true;
+
+   if( pOut ) *pOut << "[ test_hxa7241vector ]\n\n";
+
+
+   // resizing
+   {
+      bool is = true;
+
+      std::vector<dword> v;
+      for( dword i = 0;  i < 100;  ++i )
+      {
+         v.push_back( i );
+      }
+
+      unreserve( v );
+      is &= (100 == v.size()) & (100 == v.capacity()) & (99 == v[99]);
+
+      resizeReserve( v, 150 );
+      is &= (150 == v.size()) & (150 == v.capacity()) & (99 == v[99]) &
+         (0 == v[149]);
+      resizeReserve( v, 30 );
+      is &= (30 == v.size()) & (30 == v.capacity()) & (29 == v[29]);
+      resizeReserve( v, -1 );
+      is &= (0 == v.size()) & (0 == v.capacity());
+
+      reserveExactClear( v, 40 );
+      is &= (0 == v.size()) & (40 == v.capacity());
+
+      std::vector<dword> other( 25, 7 );
+      assignUnreserve( other, v );
+      is &= (25 == v.size()) & (25 == v.capacity()) & (7 == v[24]) &
+         (25 == other.size());
+
+      rezero( v );
+      is &= (0 == v.size()) & (0 == v.capacity());
+
+      if( pOut ) *pOut << "resizing : " <<
+         (is ? "--- succeeded" : "*** failed") << "\n\n";
+
+      isOk &= is;
+   }
+
+   // moving and compacting
+   {
+      bool is = true;
+
+      is &= (!IsPlainData<std::string>::VALUE) & IsPlainData<float>::VALUE &
+         IsPlainData<Vertex>::VALUE & IsPlainData<const char*>::VALUE;
+
+      // no spare reserve: storage taken over, not copied
+      std::vector<dword> from( 1000, 3 );
+      std::vector<dword> to( 10, 1 );
+      const dword* pStorage = &from[0];
+      moveUnreserve( from, to );
+      is &= (1000 == to.size()) & (1000 == to.capacity()) &
+         (pStorage == &to[0]) & (3 == to[999]);
+      is &= (0 == from.size()) & (0 == from.capacity());
+
+      // spare reserve: compacted
+      from.reserve( 2000 );
+      from.push_back( 5 );
+      from.push_back( 6 );
+      moveUnreserve( from, to );
+      is &= (2 == to.size()) & (2 == to.capacity()) & (6 == to[1]) &
+         from.empty();
+      moveUnreserve( to, to );
+      is &= (2 == to.size()) & (5 == to[0]);
+
+      // plain, in small chunks across many pages
+      std::vector<udword> plain;
+      for( dword i = 0;  i < 300000;  ++i )
+      {
+         plain.push_back( static_cast<udword>(i) * 2654435761u );
+      }
+      compact( plain, 10000 );
+      is &= (300000 == plain.size()) & (300000 == plain.capacity());
+      for( dword i = 0;  i < 300000;  ++i )
+      {
+         is &= (static_cast<udword>(i) * 2654435761u == plain[i]);
+      }
+
+      // chunk smaller than an element
+      std::vector<Vertex> vertexs;
+      makeVertexs( vertexs, 1000 );
+      compact( vertexs, 1 );
+      is &= isVertexsOk( vertexs, 1000 );
+
+      // not plain
+      std::vector<std::string> strings( 3, std::string( 100, 'a' ) );
+      strings.reserve( 8 );
+      compact( strings );
+      is &= (3 == strings.size()) & (3 == strings.capacity()) &
+         (std::string( 100, 'a' ) == strings[2]);
+
+      // partial pages are left
+      ubyte bytes[ 100 ];
+      is &= (bytes == releasePages( bytes, bytes + 100 ));
+
+      if( pOut ) *pOut << "moving and compacting : " <<
+         (is ? "--- succeeded" : "*** failed") << "\n\n";
+
+      isOk &= is;
+   }
+
+   // peak memory
+   {
+      bool is = true;
+
+      // 24MB of vertexs, with reserve to 32MB
+      const dword count = 1500000;
+
+      bool isMeasured    = true;
+      long riseUnreserve = 0;
+      {
+         std::vector<Vertex> v;
+         makeVertexs( v, count );
+         isMeasured &= measurePeakRise( v, &unreserveVertexs, riseUnreserve );
+         is &= isVertexsOk( v, count );
+      }
+
+      long riseCompact = 0;
+      {
+         std::vector<Vertex> v;
+         makeVertexs( v, count );
+         isMeasured &= measurePeakRise( v, &compactVertexs, riseCompact );
+         is &= isVertexsOk( v, count );
+      }
+
+      // compact should need much less than a second copy
+      if( isMeasured )
+      {
+         is &= (riseCompact < (riseUnreserve / 4));
+      }
+
+      if( pOut && isVerbose )
+      {
+         if( isMeasured )
+         {
+            *pOut << "peak RSS rise, " << (count * sizeof(Vertex) >> 10) <<
+               "KB vector :  unreserve " << riseUnreserve << "KB  compact " <<
+               riseCompact << "KB\n\n";
+         }
+         else
+         {
+            *pOut << "peak RSS not measurable\n\n";
+         }
+      }
+
+      if( pOut ) *pOut << "peak memory : " <<
+         (is ? "--- succeeded" : "*** failed") << "\n\n";
+
+      isOk &= is;
+   }
+
+
+   if( pOut ) *pOut << (isOk ? "--- successfully" : "*** failurefully") <<
+      " completed " << "\n\n\n";
+
+   if( pOut ) pOut->flush();
+
+
+   return isOk;
+}
+
+
+}//namespace
+
+
+#endif//TESTING
@@ -13,6 +13,11 @@
 
 
 #include <vector>
+#if __cplusplus >= 201103L
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#endif
 
 
 
@@ -23,10 +28,81 @@ namespace hxa7241_general
 
 
 /**
- * Some functions to manipulate std::vector storage.
+ * Some functions to manipulate std::vector storage.<br/><br/>
+ *
+ * Elements are moved rather than copied where the compiler allows (C++11).
+ * But shrinking still needs a second block while the elements cross, so the
+ * peak is capacity plus size -- except with compact, which, for plain data,
+ * gives back the old block's pages as it goes.
  */
 
 
+/**
+ * Whether TYPE can be copied bytewise and needs no destruction.<br/><br/>
+ *
+ * Fundamental types and pointers are; for other types (a vertex struct, for
+ * example) specialize this. With C++11 it is worked out for any type.
+ */
+template<class TYPE>
+struct IsPlainData
+{
+#if __cplusplus >= 201103L
+   enum { VALUE = std::is_trivially_copyable<TYPE>::value &&
+      std::is_trivially_destructible<TYPE>::value };
+#else
+   enum { VALUE = false };
+#endif
+};
+
+template<class TYPE>
+struct IsPlainData<TYPE*>                     { enum { VALUE = true }; };
+template<> struct IsPlainData<bool>           { enum { VALUE = true }; };
+template<> struct IsPlainData<char>           { enum { VALUE = true }; };
+template<> struct IsPlainData<signed char>    { enum { VALUE = true }; };
+template<> struct IsPlainData<unsigned char>  { enum { VALUE = true }; };
+template<> struct IsPlainData<short>          { enum { VALUE = true }; };
+template<> struct IsPlainData<unsigned short> { enum { VALUE = true }; };
+template<> struct IsPlainData<int>            { enum { VALUE = true }; };
+template<> struct IsPlainData<unsigned int>   { enum { VALUE = true }; };
+template<> struct IsPlainData<long>           { enum { VALUE = true }; };
+template<> struct IsPlainData<unsigned long>  { enum { VALUE = true }; };
+template<> struct IsPlainData<float>          { enum { VALUE = true }; };
+template<> struct IsPlainData<double>         { enum { VALUE = true }; };
+template<> struct IsPlainData<long double>    { enum { VALUE = true }; };
+
+
+/**
+ * Gives the whole memory pages in [pBegin, pEnd) back to the system: their
+ * contents become undefined, but the range stays usable.<br/><br/>
+ *
+ * Returns the end of the pages released, or pBegin if none -- so successive
+ * calls over a growing range can pass the last result as pBegin.<br/><br/>
+ *
+ * Only on Linux (madvise); elsewhere does nothing.
+ */
+void* releasePages( void* pBegin,
+                    void* pEnd );
+
+
+/**
+ * Appends from's elements to to -- by move if possible, else by copy.
+ */
+template<class TYPE>
+void moveAppend
+(
+   std::vector<TYPE>& from,
+   std::vector<TYPE>& to
+)
+{
+#if __cplusplus >= 201103L
+   to.insert( to.end(), std::make_move_iterator( from.begin() ),
+      std::make_move_iterator( from.end() ) );
+#else
+   to.insert( to.end(), from.begin(), from.end() );
+#endif
+}
+
+
 /**
  * Deallocates a std::vector reserve.
  */
@@ -55,7 +131,9 @@ void unreserve
 {
    if( v.capacity() != v.size() )
    {
-      std::vector<TYPE> tmp( v );
+      std::vector<TYPE> tmp;
+      tmp.reserve( v.size() );
+      moveAppend( v, tmp );
       v.swap( tmp );
    }
 }
@@ -81,16 +159,12 @@ void resizeReserve
       std::vector<TYPE> tmp;
       tmp.reserve( size );
 
-      if( v.size() <= static_cast<unsigned>(size) )
-      {
-         tmp = v;
-         tmp.resize( size );
-      }
-      else
+      if( v.size() > static_cast<unsigned>(size) )
       {
          v.resize( size );
-         tmp = v;
       }
+      moveAppend( v, tmp );
+      tmp.resize( size );
 
       v.swap( tmp );
    }
@@ -151,6 +225,99 @@ void assignUnreserve
 }
 
 
+/**
+ * Makes a std::vector reserve equal its size, copying in chunks, with least
+ * peak memory.<br/><br/>
+ *
+ * For plain data (IsPlainData), each chunk's pages in the old block are
+ * released as soon as it is copied, so the peak is about the old block plus
+ * one chunk, instead of plus the whole size. For other types, this is
+ * unreserve.
+ */
+template<class TYPE>
+void compact
+(
+   std::vector<TYPE>& v,
+   int                chunkBytes = 1 << 20
+)
+{
+   if( v.capacity() != v.size() )
+   {
+      if( IsPlainData<TYPE>::VALUE && !v.empty() )
+      {
+         typedef typename std::vector<TYPE>::size_type Size;
+
+         const Size size  = v.size();
+         const Size chunk = (chunkBytes > static_cast<int>(sizeof(TYPE))) ?
+            chunkBytes / sizeof(TYPE) : 1;
+
+         std::vector<TYPE> tmp;
+         tmp.reserve( size );
+
+         TYPE* const pOld      = &v[0];
+         void*       pReleased = pOld;
+         for( Size i = 0;  i < size;  i += chunk )
+         {
+            const Size end = ((size - i) > chunk) ? (i + chunk) : size;
+            tmp.insert( tmp.end(), pOld + i, pOld + end );
+
+            pReleased = releasePages( pReleased, pOld + end );
+         }
+
+         v.swap( tmp );
+      }
+      else
+      {
+         unreserve( v );
+      }
+   }
+}
+
+
+/**
+ * Moves one std::vector's contents into another, with reserve equal to size.
+ * from is left empty.<br/><br/>
+ *
+ * to's old storage is freed first, then from's is kept if it has no spare
+ * reserve (so nothing is copied), else compacted.
+ */
+template<class TYPE>
+void moveUnreserve
+(
+   std::vector<TYPE>& from,
+   std::vector<TYPE>& to
+)
+{
+   if( &from != &to )
+   {
+      rezero( to );
+      compact( from );
+      to.swap( from );
+   }
+   else
+   {
+      compact( to );
+   }
+}
+
+
+#if __cplusplus >= 201103L
+/**
+ * Assigns a temporary to a std::vector and makes the reserve equal its size.
+ * @see moveUnreserve
+ */
+template<class TYPE>
+void assignUnreserve
+(
+   std::vector<TYPE>&& other,
+   std::vector<TYPE>&  v
+)
+{
+   moveUnreserve( other, v );
+}
+#endif
+
+
 }//namespace
 
 
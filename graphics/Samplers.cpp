@@ -0,0 +1,933 @@
+/*------------------------------------------------------------------------------
+
+   HXA7241 Graphics library.
+   Copyright (c) 2004-2007,  Harrison Ainsworth / HXA7241.
+
+   http://www.hxa7241.org/
+
+------------------------------------------------------------------------------*/
+
+
+#include <cmath>
+
+#include "Samplers.hpp"
+
+
+using namespace hxa7241_graphics;
+using hxa7241_general::RandomMwc2;
+
+
+
+
+namespace
+{
+
+/// ziggurat tables ------------------------------------------------------------
+
+/**
+ * Layers of equal area under the density, from the tail (0) inward.<br/><br/>
+ *
+ * Values are magnitude * width[layer], for 24 bit magnitudes, within the
+ * layer's rectangle if magnitude < inner[layer].
+ *
+ * @implementation
+ * 'The Ziggurat Method for Generating Random Variables' - Marsaglia, Tsang
+ * (Journal of Statistical Software, 2000). Layer and magnitude are taken from
+ * separate bits (not overlapping as in the paper).
+ */
+template<dword LAYERS>
+struct Ziggurat
+{
+   /// normal (density exp(-x^2/2)) or exponential (exp(-x))
+   Ziggurat( double edge,
+             double area,
+             bool   isNormal );
+
+   double density( double x, bool isNormal )                              const;
+
+   float  edge_m;
+   dword  inner_m [LAYERS];
+   float  width_m [LAYERS];
+   float  height_m[LAYERS];
+};
+
+
+template<dword LAYERS>
+Ziggurat<LAYERS>::Ziggurat
+(
+   const double edge,
+   const double area,
+   const bool   isNormal
+)
+ : edge_m( static_cast<float>(edge) )
+{
+   static const double SCALE = 16777216.0;
+
+   double outer = edge;
+   const double base = area / density( edge, isNormal );
+
+   inner_m[0]           = static_cast<dword>((edge / base) * SCALE);
+   inner_m[1]           = 0;
+   width_m[0]           = static_cast<float>(base / SCALE);
+   width_m[LAYERS - 1]  = static_cast<float>(edge / SCALE);
+   height_m[0]          = 1.0f;
+   height_m[LAYERS - 1] = static_cast<float>(density( edge, isNormal ));
+
+   for( dword i = LAYERS - 2;  i >= 1;  --i )
+   {
+      // x where the layer above has the same area
+      const double y = (area / outer) + density( outer, isNormal );
+      const double x = isNormal ? std::sqrt( -2.0 * std::log( y ) ) :
+         -std::log( y );
+
+      inner_m[i + 1] = static_cast<dword>((x / outer) * SCALE);
+      width_m[i]     = static_cast<float>(x / SCALE);
+      height_m[i]    = static_cast<float>(density( x, isNormal ));
+      outer          = x;
+   }
+}
+
+
+template<dword LAYERS>
+inline
+double Ziggurat<LAYERS>::density
+(
+   const double x,
+   const bool   isNormal
+) const
+{
+   return isNormal ? std::exp( -0.5 * x * x ) : std::exp( -x );
+}
+
+
+const Ziggurat<128> NORMAL( 3.442619855899, 9.91256303526217e-3, true );
+const Ziggurat<256> EXPONENTIAL( 7.697117470131487, 3.949659822581572e-3,
+   false );
+
+
+/// uniforms -------------------------------------------------------------------
+
+/// [0,1), from top 24 bits
+inline
+float toUniform
+(
+   const udword bits
+)
+{
+   return static_cast<float>(static_cast<dword>(bits >> 8)) *
+      (1.0f / 16777216.0f);
+}
+
+
+/// (0,1]
+inline
+float getUniformOpen
+(
+   const RandomMwc2& random
+)
+{
+   return static_cast<float>(static_cast<dword>(random.getUdword() >> 8) + 1) *
+      (1.0f / 16777216.0f);
+}
+
+
+/// cos and sin of (2 pi u - pi), for u in [0,1)
+inline
+void cosSin
+(
+   const float u,
+   float&      c,
+   float&      s
+)
+{
+   // polynomials of the half angle, in [-pi/2, pi/2] (error < 1e-7)
+   const float h  = (u - 0.5f) * 3.14159265f;
+   const float h2 = h * h;
+
+   const float sh = h * (1.0f + h2 * (-1.0f / 6.0f + h2 * (1.0f / 120.0f +
+      h2 * (-1.0f / 5040.0f + h2 * (1.0f / 362880.0f +
+      h2 * (-1.0f / 39916800.0f))))));
+   const float ch = 1.0f + h2 * (-1.0f / 2.0f + h2 * (1.0f / 24.0f +
+      h2 * (-1.0f / 720.0f + h2 * (1.0f / 40320.0f +
+      h2 * (-1.0f / 3628800.0f + h2 * (1.0f / 479001600.0f))))));
+
+   // double angle
+   c = (ch * ch) - (sh * sh);
+   s = 2.0f * sh * ch;
+}
+
+
+/// distributions --------------------------------------------------------------
+
+/// normal, from bits, then more randoms if needed
+float normal
+(
+   const RandomMwc2& random,
+   udword            bits
+)
+{
+   for( ;; )
+   {
+      const dword layer     = static_cast<dword>(bits & 127u);
+      const dword magnitude = static_cast<dword>((bits >> 7) & 0xFFFFFFu);
+      const float sign      = (bits >> 31) ? -1.0f : 1.0f;
+      const float x         = static_cast<float>(magnitude) *
+         NORMAL.width_m[layer];
+
+      // within rectangle
+      if( magnitude < NORMAL.inner_m[layer] )
+      {
+         return sign * x;
+      }
+
+      // tail
+      if( 0 == layer )
+      {
+         float tx;
+         float ty;
+         do
+         {
+            tx = -std::log( getUniformOpen( random ) ) / NORMAL.edge_m;
+            ty = -std::log( getUniformOpen( random ) );
+         }
+         while( (ty + ty) < (tx * tx) );
+
+         return sign * (NORMAL.edge_m + tx);
+      }
+
+      // within wedge
+      if( (NORMAL.height_m[layer] + (toUniform( random.getUdword() ) *
+         (NORMAL.height_m[layer - 1] - NORMAL.height_m[layer]))) <
+         std::exp( -0.5f * x * x ) )
+      {
+         return sign * x;
+      }
+
+      bits = random.getUdword();
+   }
+}
+
+
+/// exponential, from bits, then more randoms if needed
+float exponential
+(
+   const RandomMwc2& random,
+   udword            bits
+)
+{
+   for( ;; )
+   {
+      const dword layer     = static_cast<dword>(bits & 255u);
+      const dword magnitude = static_cast<dword>(bits >> 8);
+      const float x         = static_cast<float>(magnitude) *
+         EXPONENTIAL.width_m[layer];
+
+      if( magnitude < EXPONENTIAL.inner_m[layer] )
+      {
+         return x;
+      }
+
+      if( 0 == layer )
+      {
+         return EXPONENTIAL.edge_m - std::log( getUniformOpen( random ) );
+      }
+
+      if( (EXPONENTIAL.height_m[layer] + (toUniform( random.getUdword() ) *
+         (EXPONENTIAL.height_m[layer - 1] - EXPONENTIAL.height_m[layer]))) <
+         std::exp( -x ) )
+      {
+         return x;
+      }
+
+      bits = random.getUdword();
+   }
+}
+
+
+inline
+void disk
+(
+   const udword bitsRadius,
+   const udword bitsAngle,
+   float&       x,
+   float&       y
+)
+{
+   // area-uniform radius (std::sqrt( float ) is builtin, so vectorizes)
+   const float r = std::sqrt( toUniform( bitsRadius ) );
+
+   float c;
+   float s;
+   cosSin( toUniform( bitsAngle ), c, s );
+
+   x = r * c;
+   y = r * s;
+}
+
+
+inline
+void sphere
+(
+   const udword bitsHeight,
+   const udword bitsAngle,
+   float&       x,
+   float&       y,
+   float&       z
+)
+{
+   // uniform height (Archimedes), so r = sqrt(1 - z^2) = 2 sqrt(u (1 - u))
+   const float u = toUniform( bitsHeight );
+   const float r = 2.0f * std::sqrt( u * (1.0f - u) );
+
+   float c;
+   float s;
+   cosSin( toUniform( bitsAngle ), c, s );
+
+   x = r * c;
+   y = r * s;
+   z = 1.0f - (2.0f * u);
+}
+
+
+inline
+void cosineHemisphere
+(
+   const udword bitsRadius,
+   const udword bitsAngle,
+   float&       x,
+   float&       y,
+   float&       z
+)
+{
+   // disk projected up (Malley), so z = sqrt(1 - r^2) = sqrt(1 - u)
+   const float u = toUniform( bitsRadius );
+   const float r = std::sqrt( u );
+
+   float c;
+   float s;
+   cosSin( toUniform( bitsAngle ), c, s );
+
+   x = r * c;
+   y = r * s;
+   z = std::sqrt( 1.0f - u );
+}
+
+
+/// batches of uniform bits
+const dword CHUNK = 256;
+
+inline
+dword getChunk
+(
+   const dword count,
+   const dword done
+)
+{
+   return ((count - done) < CHUNK) ? (count - done) : CHUNK;
+}
+
+}
+
+
+
+
+/// one value ------------------------------------------------------------------
+float hxa7241_graphics::randomNormal
+(
+   const RandomMwc2& random
+)
+{
+   return normal( random, random.getUdword() );
+}
+
+
+float hxa7241_graphics::randomExponential
+(
+   const RandomMwc2& random
+)
+{
+   return exponential( random, random.getUdword() );
+}
+
+
+void hxa7241_graphics::randomDisk
+(
+   const RandomMwc2& random,
+   float&            x,
+   float&            y
+)
+{
+   const udword bitsRadius = random.getUdword();
+   disk( bitsRadius, random.getUdword(), x, y );
+}
+
+
+void hxa7241_graphics::randomSphere
+(
+   const RandomMwc2& random,
+   float&            x,
+   float&            y,
+   float&            z
+)
+{
+   const udword bitsHeight = random.getUdword();
+   sphere( bitsHeight, random.getUdword(), x, y, z );
+}
+
+
+void hxa7241_graphics::randomCosineHemisphere
+(
+   const RandomMwc2& random,
+   float&            x,
+   float&            y,
+   float&            z
+)
+{
+   const udword bitsRadius = random.getUdword();
+   cosineHemisphere( bitsRadius, random.getUdword(), x, y, z );
+}
+
+
+
+
+/// batch ----------------------------------------------------------------------
+void hxa7241_graphics::randomNormals
+(
+   const RandomMwc2& random,
+   const dword       count,
+   float*            pValues
+)
+{
+   udword bits[ CHUNK ];
+
+   for( dword done = 0;  done < count;  done += CHUNK )
+   {
+      const dword  length = getChunk( count, done );
+      float* const pOut   = pValues + done;
+      random.fillUdwords( bits, length );
+
+      // rectangles only (vectorizable)
+      dword misses = 0;
+      for( dword i = 0;  i < length;  ++i )
+      {
+         const udword u         = bits[i];
+         const dword  layer     = static_cast<dword>(u & 127u);
+         const dword  magnitude = static_cast<dword>((u >> 7) & 0xFFFFFFu);
+         const float  sign      = 1.0f - static_cast<float>(
+            static_cast<dword>(u >> 31) * 2);
+
+         pOut[i] = sign * static_cast<float>(magnitude) *
+            NORMAL.width_m[layer];
+         misses += (magnitude >= NORMAL.inner_m[layer]);
+      }
+
+      // the rest (about 1%)
+      for( dword i = 0;  (misses > 0) & (i < length);  ++i )
+      {
+         const udword u = bits[i];
+         if( static_cast<dword>((u >> 7) & 0xFFFFFFu) >=
+            NORMAL.inner_m[u & 127u] )
+         {
+            pOut[i] = normal( random, u );
+            --misses;
+         }
+      }
+   }
+}
+
+
+void hxa7241_graphics::randomExponentials
+(
+   const RandomMwc2& random,
+   const dword       count,
+   float*            pValues
+)
+{
+   udword bits[ CHUNK ];
+
+   for( dword done = 0;  done < count;  done += CHUNK )
+   {
+      const dword  length = getChunk( count, done );
+      float* const pOut   = pValues + done;
+      random.fillUdwords( bits, length );
+
+      dword misses = 0;
+      for( dword i = 0;  i < length;  ++i )
+      {
+         const udword u         = bits[i];
+         const dword  layer     = static_cast<dword>(u & 255u);
+         const dword  magnitude = static_cast<dword>(u >> 8);
+
+         pOut[i] = static_cast<float>(magnitude) * EXPONENTIAL.width_m[layer];
+         misses += (magnitude >= EXPONENTIAL.inner_m[layer]);
+      }
+
+      for( dword i = 0;  (misses > 0) & (i < length);  ++i )
+      {
+         const udword u = bits[i];
+         if( static_cast<dword>(u >> 8) >= EXPONENTIAL.inner_m[u & 255u] )
+         {
+            pOut[i] = exponential( random, u );
+            --misses;
+         }
+      }
+   }
+}
+
+
+void hxa7241_graphics::randomDisks
+(
+   const RandomMwc2& random,
+   const dword       count,
+   float*            pXs,
+   float*            pYs
+)
+{
+   udword bits[ CHUNK * 2 ];
+
+   for( dword done = 0;  done < count;  done += CHUNK )
+   {
+      const dword length = getChunk( count, done );
+      random.fillUdwords( bits, length * 2 );
+
+      for( dword i = 0;  i < length;  ++i )
+      {
+         disk( bits[i], bits[i + length], pXs[done + i], pYs[done + i] );
+      }
+   }
+}
+
+
+void hxa7241_graphics::randomSpheres
+(
+   const RandomMwc2& random,
+   const dword       count,
+   float*            pXs,
+   float*            pYs,
+   float*            pZs
+)
+{
+   udword bits[ CHUNK * 2 ];
+
+   for( dword done = 0;  done < count;  done += CHUNK )
+   {
+      const dword length = getChunk( count, done );
+      random.fillUdwords( bits, length * 2 );
+
+      for( dword i = 0;  i < length;  ++i )
+      {
+         sphere( bits[i], bits[i + length], pXs[done + i], pYs[done + i],
+            pZs[done + i] );
+      }
+   }
+}
+
+
+void hxa7241_graphics::randomCosineHemispheres
+(
+   const RandomMwc2& random,
+   const dword       count,
+   float*            pXs,
+   float*            pYs,
+   float*            pZs
+)
+{
+   udword bits[ CHUNK * 2 ];
+
+   for( dword done = 0;  done < count;  done += CHUNK )
+   {
+      const dword length = getChunk( count, done );
+      random.fillUdwords( bits, length * 2 );
+
+      for( dword i = 0;  i < length;  ++i )
+      {
+         cosineHemisphere( bits[i], bits[i + length], pXs[done + i],
+            pYs[done + i], pZs[done + i] );
+      }
+   }
+}
+
+
+
+
+
+
+
+
+/// test -----------------------------------------------------------------------
+#ifdef TESTING
+
+
+#include <ostream>
+#include <vector>
+
+#include "Stopwatch.hpp"
+
+using hxa7241_general::Stopwatch;
+
+
+namespace
+{
+
+/// moments, and fractions below two limits
+///
+/// (tolerances in the checks are about 6 standard deviations of the estimate
+/// for a million samples, so a valid seed does not fail by chance)
+struct Summary
+{
+   Summary() : count(0), sum(0.0), sum2(0.0), below1(0), below2(0) {}
+
+   void add( const double v, const double limit1, const double limit2 )
+   {
+      ++count;
+      sum    += v;
+      sum2   += v * v;
+      below1 += (v < limit1);
+      below2 += (v < limit2);
+   }
+
+   double getMean()     const { return sum / count; }
+   double getVariance() const { return (sum2 / count) - (getMean() *
+      getMean()); }
+   double getBelow1()   const { return static_cast<double>(below1) / count; }
+   double getBelow2()   const { return static_cast<double>(below2) / count; }
+
+   dword  count;
+   double sum;
+   double sum2;
+   dword  below1;
+   dword  below2;
+};
+
+
+bool isNear( const double a, const double b, const double tolerance )
+{
+   return std::fabs( a - b ) <= tolerance;
+}
+
+
+/// unit length, and z moments
+bool isDirectionsOk
+(
+   const std::vector<float>& xs,
+   const std::vector<float>& ys,
+   const std::vector<float>& zs,
+   const bool                isHemisphere
+)
+{
+   bool is = true;
+
+   Summary z;
+   Summary x;
+   for( dword i = static_cast<dword>(xs.size());  i-- > 0; )
+   {
+      is &= isNear( (xs[i] * xs[i]) + (ys[i] * ys[i]) + (zs[i] * zs[i]), 1.0,
+         1e-5 );
+      z.add( zs[i], 0.5, 0.0 );
+      x.add( xs[i], 0.0, 0.0 );
+   }
+
+   // sphere: z uniform; hemisphere: p(theta < a) = sin^2 a
+   if( isHemisphere )
+   {
+      is &= isNear( z.getMean(), 2.0 / 3.0, 0.003 ) & (0 == z.below2) &
+         isNear( 1.0 - z.getBelow1(), 0.75, 0.003 );
+   }
+   else
+   {
+      is &= isNear( z.getMean(), 0.0, 0.004 ) &
+         isNear( z.sum2 / z.count, 1.0 / 3.0, 0.003 ) &
+         isNear( z.getBelow1(), 0.75, 0.003 );
+   }
+   is &= isNear( x.getMean(), 0.0, 0.004 ) &
+      isNear( x.getBelow1(), 0.5, 0.003 );
+
+   return is;
+}
+
+
+float naiveNormal( const RandomMwc2& random )
+{
+   // Box-Muller, one of the pair
+   const float u = 1.0f - random.getFloat() * 0.99999994f;
+   const float v = random.getFloat() * 6.2831853f;
+   return std::sqrt( -2.0f * std::log( u ) ) * std::cos( v );
+}
+
+
+void benchmark
+(
+   std::ostream& out
+)
+{
+   static const dword COUNT = 1 << 20;
+
+   const RandomMwc2   random;
+   std::vector<float> xs( COUNT );
+   std::vector<float> ys( COUNT );
+   std::vector<float> zs( COUNT );
+
+   double times[4][3];
+   Stopwatch stopwatch;
+
+   stopwatch.start();
+   for( dword i = 0;  i < COUNT;  ++i )
+   {
+      xs[i] = naiveNormal( random );
+   }
+   times[0][0] = stopwatch.getSeconds();
+   stopwatch.start();
+   for( dword i = 0;  i < COUNT;  ++i )
+   {
+      xs[i] = randomNormal( random );
+   }
+   times[0][1] = stopwatch.getSeconds();
+   stopwatch.start();
+   randomNormals( random, COUNT, &xs[0] );
+   times[0][2] = stopwatch.getSeconds();
+
+   stopwatch.start();
+   for( dword i = 0;  i < COUNT;  ++i )
+   {
+      xs[i] = -std::log( 1.0f - random.getFloat() * 0.99999994f );
+   }
+   times[1][0] = stopwatch.getSeconds();
+   stopwatch.start();
+   for( dword i = 0;  i < COUNT;  ++i )
+   {
+      xs[i] = randomExponential( random );
+   }
+   times[1][1] = stopwatch.getSeconds();
+   stopwatch.start();
+   randomExponentials( random, COUNT, &xs[0] );
+   times[1][2] = stopwatch.getSeconds();
+
+   stopwatch.start();
+   for( dword i = 0;  i < COUNT;  ++i )
+   {
+      const float r = std::sqrt( random.getFloat() );
+      const float a = random.getFloat() * 6.2831853f;
+      xs[i] = r * std::cos( a );
+      ys[i] = r * std::sin( a );
+   }
+   times[2][0] = stopwatch.getSeconds();
+   stopwatch.start();
+   for( dword i = 0;  i < COUNT;  ++i )
+   {
+      randomDisk( random, xs[i], ys[i] );
+   }
+   times[2][1] = stopwatch.getSeconds();
+   stopwatch.start();
+   randomDisks( random, COUNT, &xs[0], &ys[0] );
+   times[2][2] = stopwatch.getSeconds();
+
+   stopwatch.start();
+   for( dword i = 0;  i < COUNT;  ++i )
+   {
+      const float z = 1.0f - (2.0f * random.getFloat());
+      const float r = std::sqrt( 1.0f - (z * z) );
+      const float a = random.getFloat() * 6.2831853f;
+      xs[i] = r * std::cos( a );
+      ys[i] = r * std::sin( a );
+      zs[i] = z;
+   }
+   times[3][0] = stopwatch.getSeconds();
+   stopwatch.start();
+   for( dword i = 0;  i < COUNT;  ++i )
+   {
+      randomSphere( random, xs[i], ys[i], zs[i] );
+   }
+   times[3][1] = stopwatch.getSeconds();
+   stopwatch.start();
+   randomSpheres( random, COUNT, &xs[0], &ys[0], &zs[0] );
+   times[3][2] = stopwatch.getSeconds();
+
+   static const char* NAMES[] = { "normal      ", "exponential ",
+      "disk        ", "sphere      " };
+
+   out << "benchmark  (ns per sample: std lib, one value, batch)\n";
+   for( dword i = 0;  i < 4;  ++i )
+   {
+      out << "   " << NAMES[i];
+      for( dword j = 0;  j < 3;  ++j )
+      {
+         out << "  " << (times[i][j] * 1e9 / COUNT);
+      }
+      out << "\n";
+   }
+   out << "   (check " << xs[7] << ")\n\n";
+}
+
+}
+
+
+namespace hxa7241_graphics
+{
+
+
+bool test_Samplers
+(
+   std::ostream* pOut,
+   const bool    isVerbose,
+         dword   seed
+)
+{
+   seed = (0 != seed) ? seed : 1198674274;
+
+   bool isOk = true;
+
+   if( pOut ) *pOut << "[ test_Samplers ] (" << seed << ")\n\n";
+
+
+   static const dword COUNT = 1000003;
+
+   // polynomial sin and cos
+   {
+      bool is = true;
+
+      for( dword i = 0;  i <= 100000;  ++i )
+      {
+         const float u = static_cast<float>(i) / 100000.0f;
+         const double a = (u * 6.283185307179586) - 3.141592653589793;
+
+         float c;
+         float s;
+         cosSin( u, c, s );
+         is &= isNear( c, std::cos( a ), 1e-6 ) &
+            isNear( s, std::sin( a ), 1e-6 );
+      }
+
+      if( pOut ) *pOut << "sin and cos : " <<
+         (is ? "--- succeeded" : "*** failed") << "\n\n";
+
+      isOk &= is;
+   }
+
+   // normal and exponential
+   {
+      bool is = true;
+
+      const RandomMwc2 random( seed );
+
+      std::vector<float> batch( COUNT );
+      randomNormals( random, COUNT, &batch[0] );
+
+      Summary normals[2];
+      for( dword i = 0;  i < COUNT;  ++i )
+      {
+         normals[0].add( randomNormal( random ), -1.0, -3.0 );
+         normals[1].add( batch[i], -1.0, -3.0 );
+      }
+      for( dword n = 0;  n < 2;  ++n )
+      {
+         // tail beyond the ziggurat edge is 0.000288
+         is &= isNear( normals[n].getMean(), 0.0, 0.006 ) &
+            isNear( normals[n].getVariance(), 1.0, 0.009 ) &
+            isNear( normals[n].getBelow1(), 0.158655, 0.0022 ) &
+            isNear( normals[n].getBelow2(), 0.0013499, 0.00022 );
+      }
+
+      randomExponentials( random, COUNT, &batch[0] );
+      Summary exponentials[2];
+      for( dword i = 0;  i < COUNT;  ++i )
+      {
+         exponentials[0].add( randomExponential( random ), 1.0, 7.0 );
+         exponentials[1].add( batch[i], 1.0, 7.0 );
+         is &= (batch[i] >= 0.0f);
+      }
+      for( dword n = 0;  n < 2;  ++n )
+      {
+         is &= isNear( exponentials[n].getMean(), 1.0, 0.006 ) &
+            isNear( exponentials[n].getVariance(), 1.0, 0.02 ) &
+            isNear( exponentials[n].getBelow1(), 0.632121, 0.003 ) &
+            isNear( 1.0 - exponentials[n].getBelow2(), 0.000912, 0.00018 );
+      }
+
+      if( pOut ) *pOut << "normal and exponential : " <<
+         (is ? "--- succeeded" : "*** failed") << "\n\n";
+
+      isOk &= is;
+   }
+
+   // disk, sphere, hemisphere
+   {
+      bool is = true;
+
+      const RandomMwc2 random( seed );
+
+      std::vector<float> xs( COUNT );
+      std::vector<float> ys( COUNT );
+      std::vector<float> zs( COUNT );
+
+      // disk: r^2 uniform, angles even
+      for( dword b = 0;  b < 2;  ++b )
+      {
+         if( b )
+         {
+            randomDisks( random, COUNT, &xs[0], &ys[0] );
+         }
+         else
+         {
+            for( dword i = 0;  i < COUNT;  ++i )
+            {
+               randomDisk( random, xs[i], ys[i] );
+            }
+         }
+
+         Summary radius;
+         Summary quadrant;
+         for( dword i = 0;  i < COUNT;  ++i )
+         {
+            const float r2 = (xs[i] * xs[i]) + (ys[i] * ys[i]);
+            is &= (r2 <= 1.000001f);
+            radius.add( r2, 0.25, 0.0 );
+            quadrant.add( (xs[i] >= 0.0f) + ((ys[i] >= 0.0f) * 2), 1.0, 2.0 );
+         }
+         is &= isNear( radius.getMean(), 0.5, 0.002 ) &
+            isNear( radius.getBelow1(), 0.25, 0.0026 ) &
+            isNear( quadrant.getMean(), 1.5, 0.007 ) &
+            isNear( quadrant.getBelow1(), 0.25, 0.0026 ) &
+            isNear( quadrant.getBelow2(), 0.5, 0.003 );
+      }
+
+      // sphere
+      randomSpheres( random, COUNT, &xs[0], &ys[0], &zs[0] );
+      is &= isDirectionsOk( xs, ys, zs, false );
+      for( dword i = 0;  i < COUNT;  ++i )
+      {
+         randomSphere( random, xs[i], ys[i], zs[i] );
+      }
+      is &= isDirectionsOk( xs, ys, zs, false );
+
+      // cosine-weighted hemisphere
+      randomCosineHemispheres( random, COUNT, &xs[0], &ys[0], &zs[0] );
+      is &= isDirectionsOk( xs, ys, zs, true );
+      for( dword i = 0;  i < COUNT;  ++i )
+      {
+         randomCosineHemisphere( random, xs[i], ys[i], zs[i] );
+      }
+      is &= isDirectionsOk( xs, ys, zs, true );
+
+      if( pOut ) *pOut << "disk, sphere, hemisphere : " <<
+         (is ? "--- succeeded" : "*** failed") << "\n\n";
+
+      isOk &= is;
+   }
+
+   if( pOut && isVerbose ) benchmark( *pOut );
+
+
+   if( pOut ) *pOut << (isOk ? "--- successfully" : "*** failurefully") <<
+      " completed " << "\n\n\n";
+
+   if( pOut ) pOut->flush();
+
+
+   return isOk;
+}
+
+
+}//namespace
+
+
+#endif//TESTING
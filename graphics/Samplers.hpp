@@ -0,0 +1,143 @@
+/*------------------------------------------------------------------------------
+
+   HXA7241 Graphics library.
+   Copyright (c) 2004-2007,  Harrison Ainsworth / HXA7241.
+
+   http://www.hxa7241.org/
+
+------------------------------------------------------------------------------*/
+
+
+#ifndef Samplers_h
+#define Samplers_h
+
+
+#include "RandomMwc2.hpp"
+
+
+
+
+#include "hxa7241_graphics.hpp"
+namespace hxa7241_graphics
+{
+
+
+/**
+ * Random samples of some distributions, from RandomMwc2.<br/><br/>
+ *
+ * Normal and exponential use ziggurat tables: mostly a multiply and compare
+ * per value. Disk, sphere and hemisphere are direct (no rejection), with a
+ * polynomial sin/cos, accurate to about 1e-6.<br/><br/>
+ *
+ * Each has a one-value form, and a batch form writing to separate arrays
+ * (SoA). The batch forms take uniforms by RandomMwc2::fillUdwords, and
+ * transform them in branch-free loops the compiler can vectorize (the
+ * ziggurat's rare slow path is done after, per value). So they give other
+ * values than the one-value forms.<br/><br/>
+ *
+ * @see Polar.hpp squareToDisk and squareToHemisphere, for stratified and
+ * quasi-random use
+ */
+
+
+/// one value ------------------------------------------------------------------
+
+/**
+ * Normal distribution: mean 0, standard deviation 1.
+ */
+float randomNormal
+(
+   const hxa7241_general::RandomMwc2& random
+);
+
+/**
+ * Exponential distribution: rate 1 (mean 1).
+ */
+float randomExponential
+(
+   const hxa7241_general::RandomMwc2& random
+);
+
+/**
+ * Uniform on the unit disk centered at the origin.
+ */
+void randomDisk
+(
+   const hxa7241_general::RandomMwc2& random,
+   float&                             x,
+   float&                             y
+);
+
+/**
+ * Uniform on the unit sphere surface centered at the origin.
+ */
+void randomSphere
+(
+   const hxa7241_general::RandomMwc2& random,
+   float&                             x,
+   float&                             y,
+   float&                             z
+);
+
+/**
+ * Cosine-weighted on the unit hemisphere surface centered at the origin on
+ * the positive z side.
+ */
+void randomCosineHemisphere
+(
+   const hxa7241_general::RandomMwc2& random,
+   float&                             x,
+   float&                             y,
+   float&                             z
+);
+
+
+/// batch ----------------------------------------------------------------------
+
+void randomNormals
+(
+   const hxa7241_general::RandomMwc2& random,
+   dword                              count,
+   float*                             pValues
+);
+
+void randomExponentials
+(
+   const hxa7241_general::RandomMwc2& random,
+   dword                              count,
+   float*                             pValues
+);
+
+void randomDisks
+(
+   const hxa7241_general::RandomMwc2& random,
+   dword                              count,
+   float*                             pXs,
+   float*                             pYs
+);
+
+void randomSpheres
+(
+   const hxa7241_general::RandomMwc2& random,
+   dword                              count,
+   float*                             pXs,
+   float*                             pYs,
+   float*                             pZs
+);
+
+void randomCosineHemispheres
+(
+   const hxa7241_general::RandomMwc2& random,
+   dword                              count,
+   float*                             pXs,
+   float*                             pYs,
+   float*                             pZs
+);
+
+
+}//namespace
+
+
+
+
+#endif//Samplers_h
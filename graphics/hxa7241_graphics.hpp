@@ -30,6 +30,7 @@ namespace hxa7241_graphics
    class Matrix4f;
    //Polar
    class Quaternion;
+   //Samplers
    //Spherahedron
    class SobolSequence;
    class UnitVector3f;
@@ -33,7 +33,7 @@ namespace
    "  tester [-t...] [-o...] [-s...]\n"
    "\n"
    "switches:\n"
-   "  -t<int>        which test: 1 to 14, or 0 for all\n"
+   "  -t<int>        which test: 1 to 31, or 0 for all\n"
    "  -o<0 | 1 | 2>  set output level: 0 = none, 1 = summaries, 2 = verbose\n"
    "  -s<32bit int>  set random seed\n"
    "\n";
@@ -137,6 +137,22 @@ namespace hxa7241_general
    bool test_LogFast( std::ostream* pOut, bool isVerbose, dword seed );
    bool test_PowFast( std::ostream* pOut, bool isVerbose, dword seed );
    bool test_Sheet( std::ostream* pOut, bool isVerbose, dword seed );
+   bool test_Wrap( std::ostream* pOut, bool isVerbose, dword seed );
+   bool test_Storage( std::ostream* pOut, bool isVerbose, dword seed );
+   bool test_SheetTiled( std::ostream* pOut, bool isVerbose, dword seed );
+   bool test_SheetView( std::ostream* pOut, bool isVerbose, dword seed );
+   bool test_TileExecutor( std::ostream* pOut, bool isVerbose, dword seed );
+   bool test_hxa7241vector( std::ostream* pOut, bool isVerbose, dword seed );
+   bool test_SheetBulk( std::ostream* pOut, bool isVerbose, dword seed );
+   bool test_SheetFile( std::ostream* pOut, bool isVerbose, dword seed );
+   bool test_RandomMwc1( std::ostream* pOut, bool isVerbose, dword seed );
+   bool test_RandomMwc2( std::ostream* pOut, bool isVerbose, dword seed );
+   bool test_RandomXoshiro( std::ostream* pOut, bool isVerbose, dword seed );
+   bool test_RandomPhilox( std::ostream* pOut, bool isVerbose, dword seed );
+   bool test_MathFast( std::ostream* pOut, bool isVerbose, dword seed );
+   bool test_NumaLocal( std::ostream* pOut, bool isVerbose, dword seed );
+   bool test_Half( std::ostream* pOut, bool isVerbose, dword seed );
+   bool test_Clamps( std::ostream* pOut, bool isVerbose, dword seed );
 }
 
 namespace hxa7241_graphics
@@ -146,6 +162,7 @@ namespace hxa7241_graphics
    bool test_Matrix3f( std::ostream* pOut, bool isVerbose, dword seed );
    bool test_Polar( std::ostream* pOut, bool isVerbose, dword seed );
    bool test_Quaternion( std::ostream* pOut, bool isVerbose, dword seed );
+   bool test_Samplers( std::ostream* pOut, bool isVerbose, dword seed );
    bool test_Spherahedron( std::ostream* pOut, bool isVerbose, dword seed );
 }
 
@@ -183,6 +200,23 @@ static bool (*TESTERS[])(std::ostream*, bool, dword) =
 ,  &hxa7241_image::quantizing::test_quantizing   // 12
 ,  &hxa7241_image::ppm::test_ppm                 // 13
 ,  &hxa7241_image::rgbe::test_rgbe               // 14
+,  &hxa7241_general::test_Wrap                   // 15
+,  &hxa7241_general::test_Storage                // 16
+,  &hxa7241_general::test_SheetTiled             // 17
+,  &hxa7241_general::test_SheetView              // 18
+,  &hxa7241_general::test_TileExecutor           // 19
+,  &hxa7241_general::test_hxa7241vector          // 20
+,  &hxa7241_general::test_SheetBulk              // 21
+,  &hxa7241_general::test_SheetFile              // 22
+,  &hxa7241_general::test_RandomMwc1             // 23
+,  &hxa7241_general::test_RandomMwc2             // 24
+,  &hxa7241_general::test_RandomXoshiro          // 25
+,  &hxa7241_graphics::test_Samplers             // 26
+,  &hxa7241_general::test_RandomPhilox           // 27
+,  &hxa7241_general::test_MathFast              // 28
+,  &hxa7241_general::test_NumaLocal             // 29
+,  &hxa7241_general::test_Half                  // 30
+,  &hxa7241_general::test_Clamps                // 31
 };
 
 
@@ -10,10 +10,14 @@
 
 #include <math.h>
 
+#include "Clamps.hpp"
+
 #include "ImageQuantizing.hpp"
 
 
 using namespace hxa7241_image;
+using hxa7241_general::clamp01c;
+using hxa7241_general::clampScale;
 
 
 
@@ -28,6 +32,9 @@ const float SRGB_GAMMA = 1.0f / 2.2f;
 const float GAMMA_MIN  = 1.0f / 8.0f;
 const float GAMMA_MAX  = 8.0f;
 
+/// floats converted at a time, by the clamp kernels
+const dword CHUNK_LENGTH = 1024;
+
 const char DIMENSIONS_EXCEPTION_MESSAGE[] =
    "image dimensions invalid, in ImageQuantizing";
 const char NULL_POINTER_EXCEPTION_MESSAGE[] =
@@ -48,27 +55,6 @@ void checkGamma
    float gamma
 );
 
-
-inline
-float clamp01
-(
-   const float f
-)
-{
-   return (f >= 0.0f) ? (f <= 1.0f ? f : 1.0f) : 0.0f;
-}
-
-
-inline
-dword clamp0Max
-(
-   const dword i,
-   const dword max
-)
-{
-   return (i >= 0) ? (i <= max ? i : max) : 0;
-}
-
 }
 
 
@@ -114,14 +100,14 @@ void hxa7241_image::quantizing::makeFloatImage
          const float fraction = static_cast<float>(channel) /
             static_cast<float>(i_quantMax);
 
-         // gamma decode
-         const float decoded = ::powf( fraction, deGamma );
-
-         // write, clamped to [0,1]
-         pTriplesF[t + c] = clamp01( decoded );
+         // gamma decode, and write
+         pTriplesF[t + c] = ::powf( fraction, deGamma );
       }
    }
 
+   // clamp to [0,1]
+   clamp01c( pTriplesF, pTriplesF, length );
+
    // set outputs
    if( o_pDeGamma )
    {
@@ -159,31 +145,38 @@ void hxa7241_image::quantizing::makeIntegerImage
    void* pTriplesI = i_quantMax <= 255 ? static_cast<void*>(new ubyte[length]) :
       static_cast<void*>(new uword[length]);
 
-   // convert pixels
-   for( dword t = 0;  t < length;  t += 3 )
+   // convert channels, a chunk at a time
+   float chunk[ CHUNK_LENGTH ];
+   for( dword t = 0;  t < length;  t += CHUNK_LENGTH )
    {
-      // convert channels
-      for( dword c = 0;  c < 3;  ++c )
-      {
-         // get channel value, clamped to [0,1]
-         const float channel = clamp01( i_pTriplesF[t + c] );
+      const dword count = ((length - t) < CHUNK_LENGTH) ? (length - t) :
+         CHUNK_LENGTH;
+
+      // get channel values, clamped to [0,1]
+      clamp01c( i_pTriplesF + t, chunk, count );
 
-         // gamma encode
-         const float encoded = ::powf( channel, enGamma );
+      // gamma encode
+      for( dword i = 0;  i < count;  ++i )
+      {
+         chunk[i] = ::powf( chunk[i], enGamma );
+      }
 
-         // scale, round, and clamp to [0,quantMax]
-         dword integer = static_cast<dword>( ::floorf(
-            (encoded * static_cast<float>(i_quantMax)) + 0.5f ) );
-         integer = clamp0Max( integer, i_quantMax );
+      // scale, and offset to round by truncating (clamped to [0,1] first,
+      // so within [0,quantMax])
+      clampScale( chunk, chunk, count, 0.0f, 1.0f,
+         static_cast<float>(i_quantMax), 0.5f );
 
-         // write
+      // write
+      for( dword i = 0;  i < count;  ++i )
+      {
+         const dword integer = static_cast<dword>( chunk[i] );
          if( i_quantMax <= 255 )
          {
-            static_cast<ubyte*>(pTriplesI)[t + c] = static_cast<ubyte>(integer);
+            static_cast<ubyte*>(pTriplesI)[t + i] = static_cast<ubyte>(integer);
          }
          else
          {
-            static_cast<uword*>(pTriplesI)[t + c] = static_cast<uword>(integer);
+            static_cast<uword*>(pTriplesI)[t + i] = static_cast<uword>(integer);
          }
       }
    }
@@ -252,6 +245,7 @@ void checkGamma
 #ifdef TESTING
 
 
+#include <cstring>
 #include <fstream>
 #include <vector>
 
@@ -393,6 +387,35 @@ bool test_quantizing
       if( pOut && isVerbose ) *pOut << "\n";
    }
 
+   // NaN channels become 0
+   {
+      static const dword WIDTH = 7;
+
+      const udword nanBits = 0x7FC00000u;
+      float triplesF[ WIDTH * 3 ];
+      for( dword i = 0;  i < (WIDTH * 3);  ++i )
+      {
+         triplesF[i] = 1.0f;
+         if( 0 == (i % 2) )
+         {
+            std::memcpy( &(triplesF[i]), &nanBits, sizeof(float) );
+         }
+      }
+
+      void* pTriplesI = 0;
+      makeIntegerImage( 0.0f, WIDTH, 1, 255, triplesF, 0, pTriplesI );
+
+      bool isOk4 = true;
+      for( dword i = 0;  i < (WIDTH * 3);  ++i )
+      {
+         isOk4 &= (static_cast<ubyte*>(pTriplesI)[i] == ((i % 2) ? 255 : 0));
+      }
+      if( pOut && isVerbose ) *pOut << "NaNs: " << isOk4 << "\n\n";
+      isOk &= isOk4;
+
+      delete[] static_cast<ubyte*>(pTriplesI);
+   }
+
 
    if( pOut ) *pOut << (isOk ? "--- successfully" : "*** failurefully") <<
       " completed " << "\n\n\n";
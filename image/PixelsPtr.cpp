@@ -42,6 +42,37 @@ PixelsPtr::~PixelsPtr()
 }
 
 
+#if __cplusplus >= 201103L
+PixelsPtr::PixelsPtr
+(
+   PixelsPtr&& other
+) noexcept
+ : is48Bit_m( other.is48Bit_m )
+ , ptr_m    ( other.ptr_m )
+{
+   other.ptr_m = 0;
+}
+
+
+PixelsPtr& PixelsPtr::operator=
+(
+   PixelsPtr&& other
+) noexcept
+{
+   if( &other != this )
+   {
+      PixelsPtr::destruct();
+
+      is48Bit_m   = other.is48Bit_m;
+      ptr_m       = other.ptr_m;
+      other.ptr_m = 0;
+   }
+
+   return *this;
+}
+#endif
+
+
 
 
 /// commands -------------------------------------------------------------------
@@ -69,6 +100,21 @@ void* PixelsPtr::release()
 }
 
 
+void PixelsPtr::swap
+(
+   PixelsPtr& other
+)
+{
+   const bool tmpB  = is48Bit_m;
+   is48Bit_m        = other.is48Bit_m;
+   other.is48Bit_m  = tmpB;
+
+   void*const tmpP  = ptr_m;
+   ptr_m            = other.ptr_m;
+   other.ptr_m      = tmpP;
+}
+
+
 
 
 /// implementation -------------------------------------------------------------
@@ -22,7 +22,8 @@ namespace hxa7241_image
 /**
  * Simplified auto_ptr for void-polymorphic pixels.<br/><br/>
  *
- * No copying.<br/><br/>
+ * No copying. But moving (C++11), or swap, transfers the pixels without
+ * allocation -- so a PixelsPtr can be returned by value (in C++11).<br/><br/>
  *
  * @implementation
  * ...so, can you delete[] builtins through void* ?
@@ -55,6 +56,10 @@ private:
    PixelsPtr( const PixelsPtr& );
    PixelsPtr& operator=( const PixelsPtr& );
 public:
+#if __cplusplus >= 201103L
+   PixelsPtr( PixelsPtr&& ) noexcept;
+   PixelsPtr& operator=( PixelsPtr&& ) noexcept;
+#endif
 
 
 /// commands -------------------------------------------------------------------
@@ -63,6 +68,8 @@ public:
 
    void* release();
 
+   void  swap( PixelsPtr& );
+
 
 /// queries --------------------------------------------------------------------
    bool  is48Bit() const